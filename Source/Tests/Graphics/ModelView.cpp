@@ -27,6 +27,7 @@
 #include <Urho3D/Graphics/IndexBuffer.h>
 #include <Urho3D/Graphics/Model.h>
 #include <Urho3D/Graphics/ModelView.h>
+#include <Urho3D/Math/Ray.h>
 
 TEST_CASE("Simple model is constructed and desconstructed")
 {
@@ -381,6 +382,127 @@ TEST_CASE("Model with morphs is constructed and desconstructed")
 
 }
 
+TEST_CASE("Model with quantized vertex formats is constructed and desconstructed")
+{
+    auto context = Tests::GetOrCreateContext(Tests::CreateCompleteContext);
+    auto modelView = MakeShared<ModelView>(context);
+
+    VectorBuffer modelData;
+    {
+        // Set LODs
+        auto& geometries = modelView->GetGeometries();
+        geometries.resize(1);
+        geometries[0].lods_.resize(1);
+
+        // Set geometry data
+        GeometryLODView& lod = geometries[0].lods_[0];
+        Tests::AppendQuad(lod, { 0.0f, 0.5f, 0.0f }, { 0.0f, Vector3::UP }, { 1.0f, 1.0f }, Color::WHITE);
+        for (ModelVertex& vertex : lod.vertices_)
+        {
+            vertex.tangent_ = Vector4{ 1.0f, 0.0f, 0.0f, -1.0f };
+            vertex.uv_[0] = Vector4{ vertex.position_.x_ + 0.5f, 1.0f - vertex.position_.y_, 0.0f, 0.0f };
+            vertex.uv_[1] = Vector4{ vertex.position_.x_ * 4.0f, vertex.position_.y_ * 4.0f, 0.0f, 0.0f };
+        }
+
+        // Set vertex format
+        lod.vertexFormat_ = Tests::GetVertexFormat();
+        lod.vertexFormat_.tangent_ = TYPE_VECTOR4;
+        lod.vertexFormat_.uv_[0] = TYPE_VECTOR2;
+        lod.vertexFormat_.uv_[1] = TYPE_VECTOR2;
+
+        ModelVertexQuantization quantization;
+        quantization.packPositions_ = true;
+        modelView->QuantizeVertexFormats(quantization);
+
+        // Convert
+        const auto model = modelView->ExportModel();
+        REQUIRE(model);
+
+        // Serialize
+        const bool modelSaved = model->Save(modelData);
+        REQUIRE(modelSaved);
+
+        modelData.Seek(0);
+    }
+
+    // Assert loaded
+    auto model = MakeShared<Model>(context);
+    const bool modelLoaded = model->Load(modelData);
+    REQUIRE(modelLoaded);
+
+    // Assert vertex data
+    {
+        const auto& vertexBuffers = model->GetVertexBuffers();
+        REQUIRE(vertexBuffers.size() == 1);
+
+        const auto vertexBuffer = vertexBuffers[0];
+        REQUIRE(vertexBuffer->GetVertexCount() == 4);
+        REQUIRE(vertexBuffer->GetVertexSize() == 28);
+
+        const auto vertexElements = vertexBuffer->GetElements();
+        REQUIRE(vertexElements.size() == 6);
+        CHECK(vertexElements[0].type_ == TYPE_HALF4);
+        CHECK(vertexElements[1].type_ == TYPE_BYTE4_NORM);
+        CHECK(vertexElements[2].type_ == TYPE_BYTE4_NORM);
+        CHECK(vertexElements[3].type_ == TYPE_USHORT2_NORM);
+        CHECK(vertexElements[4].type_ == TYPE_HALF2);
+        CHECK(vertexElements[5].type_ == TYPE_UBYTE4_NORM);
+
+        const auto vertexData = vertexBuffer->GetUnpackedData();
+        CHECK(vertexData[0].Equals(Vector4{ -0.5f, 0.0f, 0.0f, 1.0f }));
+        CHECK(vertexData[1].Equals(Vector4{ 0.0f, 0.0f, -1.0f, 0.0f }));
+        CHECK(vertexData[2].Equals(Vector4{ 1.0f, 0.0f, 0.0f, -1.0f }));
+        CHECK(vertexData[3].Equals(Vector4{ 0.0f, 1.0f, 0.0f, 0.0f }));
+        CHECK(vertexData[4].Equals(Vector4{ -2.0f, 0.0f, 0.0f, 0.0f }));
+        CHECK(vertexData[5].Equals(Color::WHITE.ToVector4()));
+    }
+
+    // Assert raycast against packed vertices
+    {
+        const auto geometry = model->GetGeometry(0, 0);
+        REQUIRE(geometry);
+
+        Vector3 hitNormal;
+        Vector2 hitUV;
+        const Ray ray{ Vector3{ 0.25f, 0.75f, -1.0f }, Vector3::FORWARD };
+        const float hitDistance = geometry->GetHitDistance(ray, &hitNormal, &hitUV);
+        CHECK(hitDistance == Catch::Approx(1.0f));
+        CHECK(hitUV.Equals(Vector2{ 0.75f, 0.25f }, M_LARGE_EPSILON));
+
+        // Unpacked vertices are reused
+        const float secondHitDistance = geometry->GetHitDistance(ray, &hitNormal, &hitUV);
+        CHECK(secondHitDistance == Catch::Approx(1.0f));
+    }
+
+    // Assert conversion to float formats for backends without quantized formats
+    {
+        const auto vertexBuffer = model->GetVertexBuffers()[0];
+        ea::vector<VertexElement> floatElements = vertexBuffer->GetElements();
+        for (VertexElement& element : floatElements)
+        {
+            if (element.semantic_ == SEM_POSITION || element.semantic_ == SEM_NORMAL)
+                element.type_ = TYPE_VECTOR3;
+            else if (element.semantic_ == SEM_TANGENT)
+                element.type_ = TYPE_VECTOR4;
+            else if (element.semantic_ == SEM_TEXCOORD)
+                element.type_ = TYPE_VECTOR2;
+        }
+        VertexBuffer::UpdateOffsets(floatElements);
+
+        const unsigned vertexCount = vertexBuffer->GetVertexCount();
+        ByteVector floatData(vertexCount * VertexBuffer::GetVertexSize(floatElements));
+        VertexBuffer::ConvertVertexData(vertexCount, vertexBuffer->GetShadowData(), vertexBuffer->GetElements(),
+            floatData.data(), floatElements);
+
+        const auto floats = reinterpret_cast<const float*>(floatData.data());
+        CHECK(Vector3(floats).Equals(Vector3{ -0.5f, 0.0f, 0.0f }));
+        CHECK(Vector3(floats + 3).Equals(Vector3{ 0.0f, 0.0f, -1.0f }));
+        CHECK(Vector4(floats + 6).Equals(Vector4{ 1.0f, 0.0f, 0.0f, -1.0f }));
+        CHECK(Vector2(floats + 10).Equals(Vector2{ 0.0f, 1.0f }));
+        CHECK(Vector2(floats + 12).Equals(Vector2{ -2.0f, 0.0f }));
+    }
+}
+
 TEST_CASE("Animation is serialized")
 {
     auto context = Tests::GetOrCreateContext(Tests::CreateCompleteContext);
@@ -0,0 +1,132 @@
+//
+// Copyright (c) 2021-2022 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "../CommonUtils.h"
+
+#include <Urho3D/Graphics/ConstantBufferCollection.h>
+#include <Urho3D/Graphics/ShaderParameterCollection.h>
+
+namespace
+{
+
+struct RecordedParameter
+{
+    StringHash name_;
+    ea::vector<float> data_;
+
+    bool operator==(const RecordedParameter& rhs) const { return name_ == rhs.name_ && data_ == rhs.data_; }
+};
+
+ea::vector<RecordedParameter> RecordParameters(const ShaderParameterCollection& collection)
+{
+    ea::vector<RecordedParameter> result;
+    collection.ForEach([&](StringHash name, const auto* data, unsigned arraySize)
+    {
+        const auto* floatData = reinterpret_cast<const float*>(data);
+        const unsigned numFloats = arraySize * sizeof(*data) / sizeof(float);
+        result.push_back({ name, ea::vector<float>(floatData, floatData + numFloats) });
+    });
+    return result;
+}
+
+void AddTestParameters(ShaderParameterCollection& collection, unsigned seed, unsigned count)
+{
+    for (unsigned i = 0; i < count; ++i)
+    {
+        const float value = static_cast<float>(seed * 1000 + i);
+        switch (i % 3)
+        {
+        case 0:
+            collection.AddParameter(StringHash(seed + i), Vector4(value, value + 1, value + 2, value + 3));
+            break;
+        case 1:
+            collection.AddParameter(StringHash(seed + i), Matrix3x4(Vector3::ONE * value, Quaternion::IDENTITY, value));
+            break;
+        default:
+            collection.AddParameter(StringHash(seed + i), value);
+            break;
+        }
+    }
+}
+
+}
+
+TEST_CASE("Shader parameter collections are merged in order")
+{
+    ShaderParameterCollection expected;
+    AddTestParameters(expected, 1, 10);
+    AddTestParameters(expected, 2, 50);
+    AddTestParameters(expected, 3, 1);
+
+    ShaderParameterCollection merged;
+    ShaderParameterCollection second;
+    ShaderParameterCollection third;
+    AddTestParameters(merged, 1, 10);
+    AddTestParameters(second, 2, 50);
+    AddTestParameters(third, 3, 1);
+    merged.Append(second);
+    merged.Append(ShaderParameterCollection{});
+    merged.Append(third);
+
+    REQUIRE(merged.Size() == expected.Size());
+    CHECK(RecordParameters(merged) == RecordParameters(expected));
+}
+
+TEST_CASE("Constant buffer collections are merged with preserved alignment")
+{
+    const unsigned alignment = 256;
+    ConstantBufferCollection first;
+    ConstantBufferCollection second;
+    first.ClearAndInitialize(alignment);
+    second.ClearAndInitialize(alignment);
+
+    const auto firstBlock = first.AddBlock(16);
+    memset(firstBlock.second, 1, 16);
+
+    ea::vector<ConstantBufferCollectionRef> secondBlocks;
+    for (unsigned i = 0; i < 100; ++i)
+    {
+        const auto block = second.AddBlock(64);
+        memset(block.second, i + 2, 64);
+        secondBlocks.push_back(block.first);
+    }
+    REQUIRE(second.GetNumBuffers() > 1);
+
+    ea::vector<ConstantBufferCollectionRef> bufferLocations;
+    first.Append(second, bufferLocations);
+    REQUIRE(bufferLocations.size() == second.GetNumBuffers());
+
+    for (unsigned i = 0; i < secondBlocks.size(); ++i)
+    {
+        const ConstantBufferCollectionRef& location = bufferLocations[secondBlocks[i].index_];
+        const unsigned offset = location.offset_ + secondBlocks[i].offset_;
+        CHECK(offset % alignment == 0);
+
+        const auto* data = static_cast<const unsigned char*>(first.GetBufferData(location.index_)) + offset;
+        CHECK(data[0] == i + 2);
+        CHECK(data[63] == i + 2);
+    }
+
+    const auto* firstData = static_cast<const unsigned char*>(first.GetBufferData(firstBlock.first.index_));
+    CHECK(firstData[firstBlock.first.offset_] == 1);
+}
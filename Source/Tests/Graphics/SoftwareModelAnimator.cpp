@@ -0,0 +1,245 @@
+//
+// Copyright (c) 2021-2022 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "../CommonUtils.h"
+
+#include <Urho3D/Core/ProcessUtils.h>
+#include <Urho3D/Core/WorkQueue.h>
+#include <Urho3D/Graphics/SoftwareModelAnimator.h>
+
+#include <random>
+
+namespace
+{
+
+/// Vertex with all elements affected by software animation.
+struct AnimatedVertex
+{
+    Vector3 position_;
+    Vector3 normal_;
+    Vector4 tangent_;
+};
+
+/// Randomly generated mesh data for software animation.
+struct SoftwareAnimationData
+{
+    ea::vector<AnimatedVertex> vertices_;
+    ea::vector<Matrix3x4> boneTransforms_;
+    ea::vector<unsigned char> blendIndices_;
+    ea::vector<float> blendWeights_;
+    ea::vector<unsigned char> morphData_;
+    unsigned numMorphVertices_{};
+};
+
+SoftwareAnimationData CreateRandomAnimationData(unsigned numVertices, unsigned numBones, unsigned numBoneTransforms)
+{
+    std::mt19937 rng(numVertices);
+    std::uniform_real_distribution<float> value(-10.0f, 10.0f);
+    std::uniform_real_distribution<float> angle(-180.0f, 180.0f);
+    std::uniform_real_distribution<float> weight(0.1f, 1.0f);
+
+    SoftwareAnimationData data;
+    data.vertices_.resize(numVertices);
+    for (AnimatedVertex& vertex : data.vertices_)
+    {
+        vertex.position_ = { value(rng), value(rng), value(rng) };
+        vertex.normal_ = Vector3{ value(rng), value(rng), value(rng) }.Normalized();
+        vertex.tangent_ = { Vector3{ value(rng), value(rng), value(rng) }.Normalized(), 1.0f };
+    }
+
+    data.boneTransforms_.resize(numBoneTransforms);
+    for (Matrix3x4& transform : data.boneTransforms_)
+    {
+        const Quaternion rotation{ angle(rng), angle(rng), angle(rng) };
+        transform = Matrix3x4{ Vector3{ value(rng), value(rng), value(rng) }, rotation, weight(rng) };
+    }
+
+    data.blendIndices_.resize(numVertices * numBones);
+    data.blendWeights_.resize(numVertices * numBones);
+    for (unsigned i = 0; i < numVertices; ++i)
+    {
+        float totalWeight = 0.0f;
+        for (unsigned j = 0; j < numBones; ++j)
+        {
+            data.blendIndices_[i * numBones + j] = static_cast<unsigned char>(rng() % numBoneTransforms);
+            data.blendWeights_[i * numBones + j] = weight(rng);
+            totalWeight += data.blendWeights_[i * numBones + j];
+        }
+        for (unsigned j = 0; j < numBones; ++j)
+            data.blendWeights_[i * numBones + j] /= totalWeight;
+    }
+
+    // Morph every other vertex
+    for (unsigned i = 0; i < numVertices; i += 2)
+    {
+        const Vector3 deltas[3] = {
+            { value(rng), value(rng), value(rng) },
+            { value(rng), value(rng), value(rng) },
+            { value(rng), value(rng), value(rng) },
+        };
+        const auto indexBytes = reinterpret_cast<const unsigned char*>(&i);
+        const auto deltaBytes = reinterpret_cast<const unsigned char*>(deltas);
+        data.morphData_.insert(data.morphData_.end(), indexBytes, indexBytes + sizeof(unsigned));
+        data.morphData_.insert(data.morphData_.end(), deltaBytes, deltaBytes + sizeof(deltas));
+        ++data.numMorphVertices_;
+    }
+    return data;
+}
+
+SoftwareSkinningBatch CreateSkinningBatch(SoftwareAnimationData& data, ea::vector<AnimatedVertex>& vertices, unsigned numBones)
+{
+    SoftwareSkinningBatch batch;
+    batch.vertexData_ = reinterpret_cast<unsigned char*>(vertices.data());
+    batch.vertexSize_ = sizeof(AnimatedVertex);
+    batch.normalOffset_ = offsetof(AnimatedVertex, normal_);
+    batch.tangentOffset_ = offsetof(AnimatedVertex, tangent_);
+    batch.numBones_ = numBones;
+    batch.blendIndices_ = data.blendIndices_.data();
+    batch.blendWeights_ = data.blendWeights_.data();
+    batch.boneTransforms_ = data.boneTransforms_;
+    return batch;
+}
+
+SoftwareMorphBatch CreateMorphBatch(SoftwareAnimationData& data, ea::vector<AnimatedVertex>& vertices, float weight)
+{
+    SoftwareMorphBatch batch;
+    batch.vertexData_ = reinterpret_cast<unsigned char*>(vertices.data());
+    batch.vertexSize_ = sizeof(AnimatedVertex);
+    batch.normalOffset_ = offsetof(AnimatedVertex, normal_);
+    batch.tangentOffset_ = offsetof(AnimatedVertex, tangent_);
+    batch.elementMask_ = MASK_POSITION | MASK_NORMAL | MASK_TANGENT;
+    batch.morphElementMask_ = MASK_POSITION | MASK_NORMAL | MASK_TANGENT;
+    batch.morphData_ = data.morphData_.data();
+    batch.weight_ = weight;
+    return batch;
+}
+
+bool AreVerticesEqual(const ea::vector<AnimatedVertex>& lhs, const ea::vector<AnimatedVertex>& rhs, float epsilon)
+{
+    if (lhs.size() != rhs.size())
+        return false;
+
+    for (unsigned i = 0; i < lhs.size(); ++i)
+    {
+        const float scale = ea::max(1.0f, lhs[i].position_.Length());
+        if (!lhs[i].position_.Equals(rhs[i].position_, epsilon * scale)
+            || !lhs[i].normal_.Equals(rhs[i].normal_, epsilon * scale)
+            || !lhs[i].tangent_.Equals(rhs[i].tangent_, epsilon * scale))
+            return false;
+    }
+    return true;
+}
+
+}
+
+TEST_CASE("Software skinning kernel matches scalar implementation")
+{
+    for (unsigned numBones : { 1u, 2u, 4u })
+    {
+        auto data = CreateRandomAnimationData(1001, numBones, 32);
+
+        auto scalarVertices = data.vertices_;
+        SkinVerticesScalar(CreateSkinningBatch(data, scalarVertices, numBones), 0, scalarVertices.size());
+
+        auto vertices = data.vertices_;
+        SkinVertices(CreateSkinningBatch(data, vertices, numBones), 0, vertices.size());
+        CHECK(AreVerticesEqual(vertices, scalarVertices, M_LARGE_EPSILON));
+
+        // Processing in chunks should give the same result
+        auto chunkedVertices = data.vertices_;
+        const auto batch = CreateSkinningBatch(data, chunkedVertices, numBones);
+        SkinVertices(batch, 0, 100);
+        SkinVertices(batch, 100, 777);
+        SkinVertices(batch, 777, chunkedVertices.size());
+        CHECK(AreVerticesEqual(chunkedVertices, vertices, 0.0f));
+
+        // W component of tangent is untouched
+        CHECK(vertices[0].tangent_.w_ == 1.0f);
+    }
+}
+
+TEST_CASE("Software morph kernel matches scalar implementation")
+{
+    auto data = CreateRandomAnimationData(1001, 4, 32);
+
+    auto scalarVertices = data.vertices_;
+    MorphVerticesScalar(CreateMorphBatch(data, scalarVertices, 0.3f), 0, data.numMorphVertices_);
+
+    auto vertices = data.vertices_;
+    const auto batch = CreateMorphBatch(data, vertices, 0.3f);
+    MorphVertices(batch, 0, 200);
+    MorphVertices(batch, 200, data.numMorphVertices_);
+    CHECK(AreVerticesEqual(vertices, scalarVertices, M_EPSILON));
+
+    CHECK(vertices[0].position_ != data.vertices_[0].position_);
+    CHECK(vertices[1].position_ == data.vertices_[1].position_);
+}
+
+TEST_CASE("Software skinning benchmark", "[.benchmark]")
+{
+    auto context = Tests::GetOrCreateContext(Tests::CreateCompleteContext);
+    auto workQueue = MakeShared<WorkQueue>(context);
+    workQueue->CreateThreads(ea::max(1u, GetNumLogicalCPUs() - 1));
+
+    auto data = CreateRandomAnimationData(100000, 4, 64);
+    auto vertices = data.vertices_;
+    const auto skinningBatch = CreateSkinningBatch(data, vertices, 4);
+    const auto morphBatch = CreateMorphBatch(data, vertices, 0.5f);
+
+    // Vertices are reset every time, otherwise repeated skinning degrades them into denormals
+    BENCHMARK("Scalar skinning")
+    {
+        vertices = data.vertices_;
+        SkinVerticesScalar(skinningBatch, 0, vertices.size());
+        return vertices[0].position_.x_;
+    };
+
+    BENCHMARK("SIMD skinning")
+    {
+        vertices = data.vertices_;
+        SkinVertices(skinningBatch, 0, vertices.size());
+        return vertices[0].position_.x_;
+    };
+
+    BENCHMARK("Parallel SIMD skinning")
+    {
+        vertices = data.vertices_;
+        ForEachParallel(workQueue, SoftwareModelAnimator::MinVerticesPerThread, vertices.size(),
+            [&](unsigned beginVertex, unsigned endVertex) { SkinVertices(skinningBatch, beginVertex, endVertex); });
+        return vertices[0].position_.x_;
+    };
+
+    BENCHMARK("Scalar morphing")
+    {
+        vertices = data.vertices_;
+        MorphVerticesScalar(morphBatch, 0, data.numMorphVertices_);
+        return vertices[0].position_.x_;
+    };
+
+    BENCHMARK("SIMD morphing")
+    {
+        vertices = data.vertices_;
+        MorphVertices(morphBatch, 0, data.numMorphVertices_);
+        return vertices[0].position_.x_;
+    };
+}
@@ -30,6 +30,8 @@
 #include <Urho3D/Graphics/StaticModel.h>
 #include <Urho3D/IO/ArchiveSerialization.h>
 #include <Urho3D/IO/BinaryArchive.h>
+#include <Urho3D/IO/MemoryBuffer.h>
+#include <Urho3D/IO/VectorBuffer.h>
 #include <Urho3D/Resource/BinaryFile.h>
 #include <Urho3D/Resource/ResourceCache.h>
 #include <Urho3D/Resource/JSONArchive.h>
@@ -373,6 +375,53 @@ TEST_CASE("Test structure is serialized to archive")
             REQUIRE(sourceObject == objectFromJSON);
         }
     }
+
+    SECTION("XML stream archive")
+    {
+        auto xmlFile = MakeShared<XMLFile>(context);
+        REQUIRE(xmlFile->SaveObject("test", sourceObject));
+        VectorBuffer buffer;
+        REQUIRE(xmlFile->Save(buffer));
+
+        for (const unsigned chunkSize : {64u, XMLStreamReader::DefaultChunkSize})
+        {
+            MemoryBuffer source(buffer.GetBuffer());
+            XMLStreamInputArchive archive{ context, source, true, chunkSize };
+            SerializationTestStruct objectFromXMLStream;
+            SerializeValue(archive, "test", objectFromXMLStream);
+            REQUIRE(sourceObject == objectFromXMLStream);
+        }
+    }
+
+    SECTION("JSON stream and document archives")
+    {
+        VectorBuffer buffer;
+        {
+            JSONStreamOutputArchive archive{ context, buffer };
+            SerializeValue(archive, "test", const_cast<SerializationTestStruct&>(sourceObject));
+            archive.Flush();
+        }
+
+        auto jsonFile = MakeShared<JSONFile>(context);
+        MemoryBuffer fileSource(buffer.GetBuffer());
+        REQUIRE(jsonFile->Load(fileSource));
+
+        SerializationTestStruct objectFromJSONFile;
+        REQUIRE(jsonFile->LoadObject("test", objectFromJSONFile));
+        REQUIRE(sourceObject == objectFromJSONFile);
+
+        JSONDocument document;
+        MemoryBuffer documentSource(buffer.GetBuffer());
+        REQUIRE(document.Load(documentSource));
+
+        for (int i = 0; i < 2; ++i)
+        {
+            JSONDocumentInputArchive archive{ context, document };
+            SerializationTestStruct objectFromJSONDocument;
+            SerializeValue(archive, "test", objectFromJSONDocument);
+            REQUIRE(sourceObject == objectFromJSONDocument);
+        }
+    }
 }
 
 TEST_CASE("Test structure is serialized as part of the file")
@@ -518,4 +567,38 @@ TEST_CASE("Scene is serialized to archive")
             REQUIRE(Tests::CompareNodes(*sourceScene, *objectFromJSON));
         }
     }
+
+    SECTION("XML stream archive")
+    {
+        auto xmlFile = MakeShared<XMLFile>(context);
+        REQUIRE(xmlFile->SaveObject(*sourceScene));
+        VectorBuffer buffer;
+        REQUIRE(xmlFile->Save(buffer));
+
+        MemoryBuffer source(buffer.GetBuffer());
+        XMLStreamInputArchive archive{ context, source, true, 1024 };
+        auto objectFromXMLStream = MakeShared<Scene>(context);
+        SerializeValue(archive, "Scene", *objectFromXMLStream);
+        REQUIRE(Tests::CompareNodes(*sourceScene, *objectFromXMLStream));
+        CHECK(archive.GetReader().GetMemoryUse() < buffer.GetSize());
+    }
+
+    SECTION("JSON stream and document archives")
+    {
+        VectorBuffer buffer;
+        {
+            JSONStreamOutputArchive archive{ context, buffer };
+            SerializeValue(archive, "Scene", *sourceScene);
+            archive.Flush();
+        }
+
+        JSONDocument document;
+        MemoryBuffer source(buffer.GetBuffer());
+        REQUIRE(document.Load(source));
+
+        auto objectFromJSON = MakeShared<Scene>(context);
+        JSONDocumentInputArchive archive{ context, document };
+        SerializeValue(archive, "Scene", *objectFromJSON);
+        REQUIRE(Tests::CompareNodes(*sourceScene, *objectFromJSON));
+    }
 }
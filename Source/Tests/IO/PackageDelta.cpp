@@ -0,0 +1,197 @@
+//
+// Copyright (c) 2021-2022 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "../CommonUtils.h"
+
+#include <Urho3D/IO/File.h>
+#include <Urho3D/IO/FileSystem.h>
+#include <Urho3D/IO/MemoryBuffer.h>
+#include <Urho3D/IO/PackageDelta.h>
+#include <Urho3D/IO/PackageEntryWriter.h>
+#include <Urho3D/IO/PackageFile.h>
+#include <Urho3D/IO/VectorBuffer.h>
+
+namespace
+{
+
+using PackageContents = ea::vector<ea::pair<ea::string, ByteVector>>;
+
+ByteVector CreateRandomData(unsigned size, unsigned seed)
+{
+    ByteVector data(size);
+    for (unsigned i = 0; i < size; ++i)
+    {
+        seed = seed * 1103515245 + 12345;
+        data[i] = static_cast<unsigned char>(seed >> 16);
+    }
+    return data;
+}
+
+SharedPtr<PackageFile> WritePackage(Context* context, const ea::string& fileName, const PackageContents& contents,
+    PackageCompression compression)
+{
+    PackageEntryWriter writer(nullptr);
+    unsigned packageChecksum = 0;
+
+    ea::vector<ByteVector> storedData;
+    ea::vector<unsigned> checksums;
+    for (const auto& [name, data] : contents)
+    {
+        MemoryBuffer source(data.data(), data.size());
+        VectorBuffer dest;
+        unsigned checksum{};
+        REQUIRE(writer.Write(dest, source, data.size(), compression, checksum, packageChecksum));
+        storedData.push_back(dest.GetBuffer());
+        checksums.push_back(checksum);
+    }
+
+    unsigned offset = 3 * sizeof(unsigned);
+    for (const auto& [name, data] : contents)
+        offset += name.length() + 1 + 3 * sizeof(unsigned);
+
+    File file(context, fileName, FILE_WRITE);
+    REQUIRE(file.IsOpen());
+    file.WriteFileID(compression != PackageCompression::None ? "ULZ4" : "UPAK");
+    file.WriteUInt(contents.size());
+    file.WriteUInt(packageChecksum);
+    for (unsigned i = 0; i < contents.size(); ++i)
+    {
+        file.WriteString(contents[i].first);
+        file.WriteUInt(offset);
+        file.WriteUInt(contents[i].second.size());
+        file.WriteUInt(checksums[i]);
+        offset += storedData[i].size();
+    }
+    for (const ByteVector& data : storedData)
+        file.Write(data.data(), data.size());
+    file.Close();
+
+    auto package = MakeShared<PackageFile>(context, fileName);
+    REQUIRE(package->GetNumFiles() == contents.size());
+    return package;
+}
+
+ByteVector ReadFile(Context* context, const ea::string& fileName)
+{
+    File file(context, fileName);
+    ByteVector data(file.GetSize());
+    file.Read(data.data(), data.size());
+    return data;
+}
+
+}
+
+TEST_CASE("Package delta rebuilds new package from old package")
+{
+    auto context = Tests::GetOrCreateContext(Tests::CreateCompleteContext);
+    const ea::string tempDir = context->GetSubsystem<FileSystem>()->GetTemporaryDir();
+    const ea::string oldFileName = tempDir + "PackageDeltaOld.pak";
+    const ea::string newFileName = tempDir + "PackageDeltaNew.pak";
+
+    const ByteVector unchangedData = CreateRandomData(50000, 1);
+    const ByteVector oldModifiedData = CreateRandomData(100000, 2);
+    ByteVector newModifiedData = oldModifiedData;
+    newModifiedData.insert(newModifiedData.begin() + 30000, 37, 0x55);
+    for (unsigned i = 70000; i < 70100; ++i)
+        newModifiedData[i] ^= 0xff;
+
+    const PackageContents oldContents{
+        {"Modified.bin", oldModifiedData},
+        {"Removed.bin", CreateRandomData(20000, 3)},
+        {"Unchanged.bin", unchangedData},
+    };
+    const PackageContents newContents{
+        {"Added.bin", CreateRandomData(10000, 4)},
+        {"Modified.bin", newModifiedData},
+        {"Unchanged.bin", unchangedData},
+    };
+
+    for (PackageCompression compression : {PackageCompression::None, PackageCompression::LZ4})
+    {
+        auto oldPackage = WritePackage(context, oldFileName, oldContents, compression);
+        auto newPackage = WritePackage(context, newFileName, newContents, compression);
+
+        VectorBuffer delta;
+        REQUIRE(CreatePackageDelta(oldPackage, newPackage, delta));
+
+        // Only added and modified data should be stored in delta
+        if (compression == PackageCompression::None)
+            CHECK(delta.GetSize() < 15000);
+
+        delta.Seek(0);
+        PackageDeltaHeader header;
+        REQUIRE(ReadPackageDeltaHeader(delta, header));
+        CHECK(header.oldChecksum_ == oldPackage->GetChecksum());
+        CHECK(header.oldSize_ == oldPackage->GetTotalSize());
+        CHECK(header.newChecksum_ == newPackage->GetChecksum());
+        CHECK(header.newSize_ == newPackage->GetTotalSize());
+
+        delta.Seek(0);
+        File oldFile(context, oldFileName);
+        VectorBuffer rebuiltData;
+        REQUIRE(ApplyPackageDelta(oldFile, delta, rebuiltData));
+        CHECK(rebuiltData.GetBuffer() == ReadFile(context, newFileName));
+    }
+}
+
+TEST_CASE("Package delta is not applied to wrong package or when corrupted")
+{
+    auto context = Tests::GetOrCreateContext(Tests::CreateCompleteContext);
+    const ea::string tempDir = context->GetSubsystem<FileSystem>()->GetTemporaryDir();
+    const ea::string oldFileName = tempDir + "PackageDeltaOld.pak";
+    const ea::string newFileName = tempDir + "PackageDeltaNew.pak";
+
+    ByteVector data = CreateRandomData(20000, 5);
+    auto oldPackage = WritePackage(context, oldFileName, {{"Data.bin", data}}, PackageCompression::None);
+    data[10000] ^= 0xff;
+    auto newPackage = WritePackage(context, newFileName, {{"Data.bin", data}}, PackageCompression::None);
+
+    VectorBuffer delta;
+    REQUIRE(CreatePackageDelta(oldPackage, newPackage, delta));
+
+    // Wrong base package
+    {
+        delta.Seek(0);
+        File newFile(context, newFileName);
+        VectorBuffer rebuiltData;
+        CHECK_FALSE(ApplyPackageDelta(newFile, delta, rebuiltData));
+    }
+
+    // Corrupted delta
+    {
+        ByteVector corruptedData = delta.GetBuffer();
+        corruptedData[corruptedData.size() / 2] ^= 0x01;
+
+        MemoryBuffer corruptedDelta(corruptedData.data(), corruptedData.size());
+        File oldFile(context, oldFileName);
+        VectorBuffer rebuiltData;
+        CHECK_FALSE(ApplyPackageDelta(oldFile, corruptedDelta, rebuiltData));
+    }
+
+    // Truncated delta
+    {
+        MemoryBuffer truncatedDelta(delta.GetData(), delta.GetSize() - 1);
+        File oldFile(context, oldFileName);
+        VectorBuffer rebuiltData;
+        CHECK_FALSE(ApplyPackageDelta(oldFile, truncatedDelta, rebuiltData));
+    }
+}
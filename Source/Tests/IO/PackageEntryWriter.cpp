@@ -0,0 +1,150 @@
+//
+// Copyright (c) 2021-2022 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "../CommonUtils.h"
+
+#include <Urho3D/Core/WorkQueue.h>
+#include <Urho3D/IO/Compression.h>
+#include <Urho3D/IO/MemoryBuffer.h>
+#include <Urho3D/IO/PackageEntryWriter.h>
+#include <Urho3D/IO/VectorBuffer.h>
+
+namespace
+{
+
+ByteVector CreatePackageEntryData(unsigned size)
+{
+    // Half of data is compressible and half is not
+    ByteVector data(size);
+    unsigned seed = 1;
+    for (unsigned i = 0; i < size; ++i)
+    {
+        seed = seed * 1103515245 + 12345;
+        data[i] = (i / 1000) % 2 ? static_cast<unsigned char>(seed >> 16) : static_cast<unsigned char>('a' + i % 7);
+    }
+    return data;
+}
+
+ByteVector WritePackageEntry(PackageEntryWriter& writer, const ByteVector& data, PackageCompression compression,
+    unsigned& entryChecksum, unsigned& packageChecksum)
+{
+    MemoryBuffer source(data.data(), data.size());
+    VectorBuffer dest;
+    REQUIRE(writer.Write(dest, source, data.size(), compression, entryChecksum, packageChecksum));
+    return dest.GetBuffer();
+}
+
+ByteVector ReadCompressedPackageEntry(const ByteVector& entryData)
+{
+    ByteVector result;
+    MemoryBuffer source(entryData.data(), entryData.size());
+    while (!source.IsEof())
+    {
+        const unsigned unpackedSize = source.ReadUShort();
+        const unsigned packedSize = source.ReadUShort();
+
+        ByteVector packedData(packedSize);
+        source.Read(packedData.data(), packedSize);
+
+        const unsigned offset = result.size();
+        result.resize(offset + unpackedSize);
+        REQUIRE(DecompressData(&result[offset], packedData.data(), unpackedSize) == packedSize);
+    }
+    return result;
+}
+
+}
+
+TEST_CASE("Package entries are written identically regardless of number of threads")
+{
+    auto context = Tests::GetOrCreateContext(Tests::CreateCompleteContext);
+    auto workQueue = MakeShared<WorkQueue>(context);
+    workQueue->CreateThreads(3);
+
+    const ByteVector data = CreatePackageEntryData(PackageEntryWriter::DEFAULT_BLOCK_SIZE * 9 + 123);
+
+    unsigned expectedChecksum = 0;
+    for (unsigned char value : data)
+        expectedChecksum = SDBMHash(expectedChecksum, value);
+
+    PackageEntryWriter sequentialWriter(nullptr);
+    PackageEntryWriter parallelWriter(workQueue);
+    PackageEntryWriter smallBatchWriter(workQueue, PackageEntryWriter::DEFAULT_BLOCK_SIZE, 2);
+
+    for (PackageCompression compression : {PackageCompression::None, PackageCompression::LZ4, PackageCompression::LZ4HC})
+    {
+        unsigned sequentialChecksum{};
+        unsigned sequentialPackageChecksum = 0;
+        const ByteVector sequentialData = WritePackageEntry(
+            sequentialWriter, data, compression, sequentialChecksum, sequentialPackageChecksum);
+
+        unsigned parallelChecksum{};
+        unsigned parallelPackageChecksum = 0;
+        const ByteVector parallelData = WritePackageEntry(
+            parallelWriter, data, compression, parallelChecksum, parallelPackageChecksum);
+
+        unsigned smallBatchChecksum{};
+        unsigned smallBatchPackageChecksum = 0;
+        const ByteVector smallBatchData = WritePackageEntry(
+            smallBatchWriter, data, compression, smallBatchChecksum, smallBatchPackageChecksum);
+
+        CHECK(sequentialChecksum == expectedChecksum);
+        CHECK(sequentialPackageChecksum == expectedChecksum);
+        CHECK(parallelChecksum == expectedChecksum);
+        CHECK(parallelPackageChecksum == expectedChecksum);
+        CHECK(smallBatchChecksum == expectedChecksum);
+        CHECK(smallBatchPackageChecksum == expectedChecksum);
+
+        CHECK(sequentialData == parallelData);
+        CHECK(sequentialData == smallBatchData);
+
+        if (compression == PackageCompression::None)
+            CHECK(sequentialData == data);
+        else
+        {
+            CHECK(sequentialData.size() < data.size());
+            CHECK(ReadCompressedPackageEntry(sequentialData) == data);
+        }
+    }
+}
+
+TEST_CASE("Package checksum is accumulated across entries")
+{
+    auto context = Tests::GetOrCreateContext(Tests::CreateCompleteContext);
+
+    const ByteVector firstData = CreatePackageEntryData(50000);
+    const ByteVector secondData = CreatePackageEntryData(PackageEntryWriter::DEFAULT_BLOCK_SIZE);
+
+    unsigned expectedChecksum = 0;
+    for (unsigned char value : firstData)
+        expectedChecksum = SDBMHash(expectedChecksum, value);
+    for (unsigned char value : secondData)
+        expectedChecksum = SDBMHash(expectedChecksum, value);
+
+    PackageEntryWriter writer(nullptr);
+    unsigned packageChecksum = 0;
+    unsigned entryChecksum{};
+    WritePackageEntry(writer, firstData, PackageCompression::LZ4, entryChecksum, packageChecksum);
+    WritePackageEntry(writer, secondData, PackageCompression::LZ4, entryChecksum, packageChecksum);
+
+    CHECK(packageChecksum == expectedChecksum);
+}
@@ -0,0 +1,336 @@
+//
+// Copyright (c) 2021-2022 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "../CommonUtils.h"
+
+#include <Urho3D/Core/Timer.h>
+#include <Urho3D/IO/Compression.h>
+#include <Urho3D/IO/File.h>
+#include <Urho3D/IO/FileSystem.h>
+#include <Urho3D/IO/MemoryBuffer.h>
+#include <Urho3D/IO/PackageDelta.h>
+#include <Urho3D/IO/PackageFile.h>
+#include <Urho3D/Network/Connection.h>
+#include <Urho3D/Network/Network.h>
+#include <Urho3D/Network/NetworkEvents.h>
+#include <Urho3D/Network/Protocol.h>
+#include <Urho3D/Resource/ResourceCache.h>
+#include <Urho3D/Scene/Scene.h>
+
+namespace
+{
+
+const unsigned short TEST_PORT = 23450;
+
+ByteVector CreatePackageData(unsigned size, unsigned seed)
+{
+    // Half of data is compressible and half is not
+    ByteVector data(size);
+    for (unsigned i = 0; i < size; ++i)
+    {
+        seed = seed * 1103515245 + 12345;
+        data[i] = (i / 1000) % 2 ? static_cast<unsigned char>(seed >> 16) : static_cast<unsigned char>('a' + i % 7);
+    }
+    return data;
+}
+
+SharedPtr<PackageFile> WritePackage(Context* context, const ea::string& fileName, const ByteVector& data)
+{
+    unsigned checksum = 0;
+    for (unsigned char value : data)
+        checksum = SDBMHash(checksum, value);
+
+    const ea::string entryName = "Data.bin";
+    const unsigned offset = 3 * sizeof(unsigned) + entryName.length() + 1 + 3 * sizeof(unsigned);
+
+    File file(context, fileName, FILE_WRITE);
+    REQUIRE(file.IsOpen());
+    file.WriteFileID("UPAK");
+    file.WriteUInt(1);
+    file.WriteUInt(checksum);
+    file.WriteString(entryName);
+    file.WriteUInt(offset);
+    file.WriteUInt(data.size());
+    file.WriteUInt(checksum);
+    file.Write(data.data(), data.size());
+    file.Close();
+
+    return MakeShared<PackageFile>(context, fileName);
+}
+
+ByteVector ReadFileData(Context* context, const ea::string& fileName)
+{
+    File file(context, fileName);
+    ByteVector data(file.GetSize());
+    file.Read(data.data(), data.size());
+    return data;
+}
+
+/// Connect client to local server and wait until the client downloads packages required by the scene.
+bool DownloadPackages(Context* context, Scene* serverScene)
+{
+    auto network = context->GetSubsystem<Network>();
+    auto clientScene = MakeShared<Scene>(context);
+
+    REQUIRE(network->StartServer(TEST_PORT));
+    REQUIRE(network->Connect("127.0.0.1", TEST_PORT, clientScene));
+
+    WeakPtr<Connection> clientConnection;
+    bool sceneLoaded = false;
+    Timer timer;
+    while (!sceneLoaded && timer.GetMSec(false) < 20000)
+    {
+        Tests::RunFrame(context, 1.0f / network->GetUpdateFps());
+        Time::Sleep(1);
+
+        const auto clientConnections = network->GetClientConnections();
+        if (!clientConnection && !clientConnections.empty())
+        {
+            clientConnection = clientConnections[0];
+            clientConnection->SetScene(serverScene);
+        }
+
+        // Wait until the server knows that the client has loaded the scene
+        sceneLoaded = clientConnection && clientConnection->IsSceneLoaded();
+    }
+
+    network->Disconnect(100);
+    network->StopServer();
+    Tests::RunFrame(context, 1.0f / network->GetUpdateFps());
+    return sceneLoaded;
+}
+
+struct PackageTransferFixture
+{
+    explicit PackageTransferFixture(Context* context)
+        : context_(context)
+    {
+        auto fileSystem = context_->GetSubsystem<FileSystem>();
+        auto network = context_->GetSubsystem<Network>();
+
+        serverDir_ = fileSystem->GetTemporaryDir() + "PackageTransfer/Server/";
+        cacheDir_ = fileSystem->GetTemporaryDir() + "PackageTransfer/Cache/";
+        fileSystem->RemoveDir(serverDir_, true);
+        fileSystem->RemoveDir(cacheDir_, true);
+        fileSystem->CreateDirsRecursive(serverDir_);
+        fileSystem->CreateDirsRecursive(cacheDir_);
+
+        oldCacheDir_ = network->GetPackageCacheDir();
+        network->SetPackageCacheDir(cacheDir_);
+    }
+
+    ~PackageTransferFixture()
+    {
+        auto cache = context_->GetSubsystem<ResourceCache>();
+        for (PackageFile* package : cache->GetPackageFiles())
+        {
+            if (package->GetName().starts_with(cacheDir_))
+                cache->RemovePackageFile(package, true);
+        }
+
+        auto network = context_->GetSubsystem<Network>();
+        network->SetPackageCacheDir(oldCacheDir_);
+        network->SetPackageFragmentSize(DEFAULT_PACKAGE_FRAGMENT_SIZE);
+        network->SetPackageWindowSize(DEFAULT_PACKAGE_WINDOW_SIZE);
+        network->SetPackageCompression(true);
+    }
+
+    ea::string GetCachedFileName(PackageFile* package) const
+    {
+        return cacheDir_ + ToStringHex(package->GetChecksum()) + "_" + GetFileNameAndExtension(package->GetName());
+    }
+
+    Context* context_{};
+    ea::string serverDir_;
+    ea::string cacheDir_;
+    ea::string oldCacheDir_;
+};
+
+}
+
+TEST_CASE("Package files are downloaded from server in windowed fragments")
+{
+    auto context = Tests::GetOrCreateContext(Tests::CreateCompleteContext);
+    auto network = context->GetSubsystem<Network>();
+    PackageTransferFixture fixture(context);
+
+    const bool compression = GENERATE(false, true);
+    network->SetPackageCompression(compression);
+    network->SetPackageFragmentSize(8192);
+    network->SetPackageWindowSize(4);
+
+    auto package = WritePackage(context, fixture.serverDir_ + "Data.pak", CreatePackageData(300000, 1));
+    auto serverScene = MakeShared<Scene>(context);
+    serverScene->AddRequiredPackageFile(package);
+
+    REQUIRE(DownloadPackages(context, serverScene));
+
+    const ea::string downloadedFileName = fixture.GetCachedFileName(package);
+    CHECK(ReadFileData(context, downloadedFileName) == ReadFileData(context, package->GetName()));
+    CHECK_FALSE(context->GetSubsystem<FileSystem>()->FileExists(downloadedFileName + ".part"));
+}
+
+TEST_CASE("Interrupted package download is resumed")
+{
+    auto context = Tests::GetOrCreateContext(Tests::CreateCompleteContext);
+    PackageTransferFixture fixture(context);
+
+    auto package = WritePackage(context, fixture.serverDir_ + "Data.pak", CreatePackageData(100000, 2));
+    auto serverScene = MakeShared<Scene>(context);
+    serverScene->AddRequiredPackageFile(package);
+
+    // Partially downloaded file is marked so it can be checked that this part is not downloaded again
+    const ea::string downloadedFileName = fixture.GetCachedFileName(package);
+    const unsigned markedOffset = 30000;
+    ByteVector expectedData = ReadFileData(context, package->GetName());
+    expectedData[markedOffset] ^= 0xff;
+    {
+        File partialFile(context, downloadedFileName + ".part", FILE_WRITE);
+        partialFile.Write(expectedData.data(), 40000);
+    }
+
+    REQUIRE(DownloadPackages(context, serverScene));
+
+    CHECK(ReadFileData(context, downloadedFileName) == expectedData);
+}
+
+TEST_CASE("Package delta is downloaded instead of package file")
+{
+    auto context = Tests::GetOrCreateContext(Tests::CreateCompleteContext);
+    PackageTransferFixture fixture(context);
+
+    // Client has old version of the package in the download cache
+    ByteVector data = CreatePackageData(100000, 3);
+    auto oldPackage = WritePackage(context, fixture.serverDir_ + "Data.pak", data);
+    const ea::string oldFileName = fixture.GetCachedFileName(oldPackage);
+    REQUIRE(context->GetSubsystem<FileSystem>()->Copy(oldPackage->GetName(), oldFileName));
+
+    // Server has new version of the package and delta for the old one
+    for (unsigned i = 50000; i < 50100; ++i)
+        data[i] ^= 0xff;
+    context->GetSubsystem<FileSystem>()->CreateDirsRecursive(fixture.serverDir_ + "NewData/");
+    auto newPackage = WritePackage(context, fixture.serverDir_ + "NewData/Data.pak", data);
+    {
+        File deltaFile(context, GetPackageDeltaFileName(newPackage->GetName(), oldPackage->GetChecksum()), FILE_WRITE);
+        REQUIRE(CreatePackageDelta(oldPackage, newPackage, deltaFile));
+    }
+
+    // Package file on server is damaged to check that it is not sent
+    const ByteVector expectedData = ReadFileData(context, newPackage->GetName());
+    {
+        File packageFile(context, newPackage->GetName(), FILE_READWRITE);
+        packageFile.Seek(packageFile.GetSize() - 1000);
+        packageFile.Write(ByteVector(1000).data(), 1000);
+    }
+
+    auto serverScene = MakeShared<Scene>(context);
+    serverScene->AddRequiredPackageFile(newPackage);
+
+    REQUIRE(DownloadPackages(context, serverScene));
+
+    CHECK(ReadFileData(context, fixture.GetCachedFileName(newPackage)) == expectedData);
+}
+
+TEST_CASE("Package download fails on truncated or corrupt compressed fragment")
+{
+    auto context = Tests::GetOrCreateContext(Tests::CreateCompleteContext);
+    auto network = context->GetSubsystem<Network>();
+    PackageTransferFixture fixture(context);
+
+    const bool truncated = GENERATE(false, true);
+    const unsigned fragmentSize = 8192;
+    network->SetPackageCompression(true);
+    network->SetPackageFragmentSize(fragmentSize);
+    network->SetPackageWindowSize(1);
+
+    auto package = WritePackage(context, fixture.serverDir_ + "Data.pak", CreatePackageData(100000, 4));
+    auto serverScene = MakeShared<Scene>(context);
+    serverScene->AddRequiredPackageFile(package);
+    auto clientScene = MakeShared<Scene>(context);
+
+    bool downloadFailed = false;
+    network->SubscribeToEvent(E_NETWORKSCENELOADFAILED, [&](StringHash, VariantMap&) { downloadFailed = true; });
+
+    REQUIRE(network->StartServer(TEST_PORT));
+    REQUIRE(network->Connect("127.0.0.1", TEST_PORT, clientScene));
+
+    // Wait until the client receives first fragments
+    WeakPtr<Connection> clientConnection;
+    Connection* serverConnection = nullptr;
+    Timer timer;
+    while (timer.GetMSec(false) < 20000)
+    {
+        Tests::RunFrame(context, 1.0f / network->GetUpdateFps());
+        Time::Sleep(1);
+
+        const auto clientConnections = network->GetClientConnections();
+        if (!clientConnection && !clientConnections.empty())
+        {
+            clientConnection = clientConnections[0];
+            clientConnection->SetScene(serverScene);
+        }
+
+        serverConnection = network->GetServerConnection();
+        const float progress = serverConnection ? serverConnection->GetDownloadProgress() : 0.0f;
+        if (progress > 0.0f && progress < 1.0f)
+            break;
+    }
+    REQUIRE(serverConnection);
+    REQUIRE(serverConnection->GetNumDownloads() == 1);
+
+    // Inject next fragment with damaged compressed data
+    const ByteVector packageData = ReadFileData(context, package->GetName());
+    const unsigned receivedSize = RoundToInt(serverConnection->GetDownloadProgress() * packageData.size());
+    const unsigned index = receivedSize / fragmentSize;
+    REQUIRE(receivedSize == index * fragmentSize);
+
+    ByteVector compressedData(EstimateCompressBound(fragmentSize));
+    const unsigned compressedSize = CompressData(compressedData.data(), packageData.data() + receivedSize, fragmentSize);
+    REQUIRE(compressedSize > 0);
+    if (truncated)
+        compressedData.resize(compressedSize / 2);
+    else
+        compressedData.assign(compressedSize, 0xff);
+
+    VectorBuffer message;
+    message.WriteStringHash(StringHash(GetFileNameAndExtension(package->GetName())));
+    message.WriteUInt(index);
+    message.WriteBool(true);
+    message.Write(compressedData.data(), compressedData.size());
+
+    VectorBuffer packedMessage;
+    packedMessage.WriteUInt(MSG_PACKAGEDATA);
+    packedMessage.WriteUInt(message.GetSize());
+    packedMessage.Write(message.GetData(), message.GetSize());
+
+    MemoryBuffer messageBuffer(packedMessage.GetData(), packedMessage.GetSize());
+    serverConnection->ProcessMessage(MSG_PACKED_MESSAGE, messageBuffer);
+
+    CHECK(downloadFailed);
+    CHECK(serverConnection->GetNumDownloads() == 0);
+
+    network->UnsubscribeFromEvent(E_NETWORKSCENELOADFAILED);
+    network->Disconnect(100);
+    network->StopServer();
+    Tests::RunFrame(context, 1.0f / network->GetUpdateFps());
+    CHECK_FALSE(context->GetSubsystem<FileSystem>()->FileExists(fixture.GetCachedFileName(package)));
+}
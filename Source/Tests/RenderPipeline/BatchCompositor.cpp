@@ -0,0 +1,125 @@
+//
+// Copyright (c) 2021-2022 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "../CommonUtils.h"
+#include "../ModelUtils.h"
+
+#include <Urho3D/Graphics/Material.h>
+#include <Urho3D/Graphics/Model.h>
+#include <Urho3D/Graphics/Octree.h>
+#include <Urho3D/Graphics/StaticModel.h>
+#include <Urho3D/Graphics/Technique.h>
+#include <Urho3D/RenderPipeline/BatchCompositor.h>
+#include <Urho3D/Scene/Scene.h>
+
+namespace
+{
+
+SharedPtr<Model> CreateQuadModel(Context* context)
+{
+    auto modelView = MakeShared<ModelView>(context);
+    auto& geometries = modelView->GetGeometries();
+    geometries.resize(1);
+    geometries[0].lods_.resize(1);
+
+    GeometryLODView& lod = geometries[0].lods_[0];
+    Tests::AppendQuad(lod, Vector3::ZERO, Quaternion::IDENTITY, Vector2::ONE, Color::WHITE);
+    lod.vertexFormat_ = Tests::GetVertexFormat();
+    return modelView->ExportModel();
+}
+
+}
+
+TEST_CASE("Cached geometry batches are invalidated when batch inputs change")
+{
+    auto context = Tests::GetOrCreateContext(Tests::CreateCompleteContext);
+    auto scene = MakeShared<Scene>(context);
+    scene->CreateComponent<Octree>();
+
+    auto technique = MakeShared<Technique>(context);
+    Pass* basePass = technique->CreatePass("base");
+    auto otherTechnique = MakeShared<Technique>(context);
+    Pass* otherBasePass = otherTechnique->CreatePass("base");
+
+    auto material = MakeShared<Material>(context);
+    material->SetTechnique(0, technique);
+    auto otherMaterial = MakeShared<Material>(context);
+    otherMaterial->SetTechnique(0, technique);
+
+    auto staticModel = scene->CreateChild()->CreateComponent<StaticModel>();
+    staticModel->SetModel(CreateQuadModel(context));
+    staticModel->SetMaterial(material);
+    REQUIRE(staticModel->GetBatches().size() == 1);
+
+    const SourceBatch& sourceBatch = staticModel->GetBatches()[0];
+    GeometryBatch geometryBatch{staticModel, 0, nullptr, basePass, nullptr, nullptr};
+
+    CachedGeometryBatch cachedBatch;
+    CHECK_FALSE(cachedBatch.IsValid(geometryBatch, sourceBatch, material, 0));
+
+    cachedBatch.Reset(geometryBatch, sourceBatch, material, 0);
+    CHECK(cachedBatch.IsValid(geometryBatch, sourceBatch, material, 0));
+
+    SECTION("material is replaced")
+    {
+        CHECK_FALSE(cachedBatch.IsValid(geometryBatch, sourceBatch, otherMaterial, 0));
+    }
+
+    SECTION("material pipeline state is changed")
+    {
+        material->SetCullMode(CULL_NONE);
+        CHECK_FALSE(cachedBatch.IsValid(geometryBatch, sourceBatch, material, 0));
+
+        cachedBatch.Reset(geometryBatch, sourceBatch, material, 0);
+        CHECK(cachedBatch.IsValid(geometryBatch, sourceBatch, material, 0));
+    }
+
+    SECTION("technique is replaced")
+    {
+        material->SetTechnique(0, otherTechnique);
+        geometryBatch.unlitBasePass_ = otherBasePass;
+        CHECK_FALSE(cachedBatch.IsValid(geometryBatch, sourceBatch, material, 0));
+    }
+
+    SECTION("pass pipeline state is changed")
+    {
+        basePass->SetBlendMode(BLEND_ADD);
+        CHECK_FALSE(cachedBatch.IsValid(geometryBatch, sourceBatch, material, 0));
+
+        cachedBatch.Reset(geometryBatch, sourceBatch, material, 0);
+        CHECK(cachedBatch.IsValid(geometryBatch, sourceBatch, material, 0));
+
+        basePass->SetPixelShaderDefines("ALPHAMASK");
+        CHECK_FALSE(cachedBatch.IsValid(geometryBatch, sourceBatch, material, 0));
+    }
+
+    SECTION("lighting is changed")
+    {
+        CHECK_FALSE(cachedBatch.IsValid(geometryBatch, sourceBatch, material, 1));
+    }
+
+    SECTION("incomplete batches are not reused")
+    {
+        cachedBatch.isComplete_ = false;
+        CHECK_FALSE(cachedBatch.IsValid(geometryBatch, sourceBatch, material, 0));
+    }
+}
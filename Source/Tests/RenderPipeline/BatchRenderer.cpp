@@ -0,0 +1,112 @@
+//
+// Copyright (c) 2021-2022 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "../CommonUtils.h"
+#include "../ModelUtils.h"
+
+#include <Urho3D/Graphics/Camera.h>
+#include <Urho3D/Graphics/Model.h>
+#include <Urho3D/Graphics/Octree.h>
+#include <Urho3D/Graphics/StaticModelGroup.h>
+#include <Urho3D/RenderPipeline/BatchCompositor.h>
+#include <Urho3D/RenderPipeline/BatchRenderer.h>
+#include <Urho3D/Scene/Scene.h>
+
+namespace
+{
+
+SharedPtr<Model> CreateQuadModel(Context* context)
+{
+    auto modelView = MakeShared<ModelView>(context);
+    auto& geometries = modelView->GetGeometries();
+    geometries.resize(1);
+    geometries[0].lods_.resize(1);
+
+    GeometryLODView& lod = geometries[0].lods_[0];
+    Tests::AppendQuad(lod, Vector3::ZERO, Quaternion::IDENTITY, Vector2::ONE, Color::WHITE);
+    lod.vertexFormat_ = Tests::GetVertexFormat();
+    return modelView->ExportModel();
+}
+
+}
+
+TEST_CASE("Instancing buffer and draw commands agree on number of instances of mixed geometry")
+{
+    auto context = Tests::GetOrCreateContext(Tests::CreateCompleteContext);
+    auto scene = MakeShared<Scene>(context);
+    scene->CreateComponent<Octree>();
+    auto model = CreateQuadModel(context);
+
+    auto camera = scene->CreateChild()->CreateComponent<Camera>();
+    FrameInfo frameInfo;
+    frameInfo.camera_ = camera;
+
+    auto staticModel = scene->CreateChild()->CreateComponent<StaticModel>();
+    staticModel->SetModel(model);
+
+    auto staticModelGroup = scene->CreateChild()->CreateComponent<StaticModelGroup>();
+    staticModelGroup->SetModel(model);
+    for (unsigned i = 0; i < 3; ++i)
+        staticModelGroup->AddInstanceNode(scene->CreateChild());
+    staticModelGroup->GetWorldBoundingBox();
+    staticModelGroup->UpdateBatches(frameInfo);
+    REQUIRE(staticModelGroup->GetBatches()[0].numWorldTransforms_ == 3);
+
+    const PipelineBatch staticBatch{staticModel, 0};
+    const PipelineBatch staticGroupBatch{staticModelGroup, 0};
+    PipelineBatch instancedGroupBatch{staticModelGroup, 0};
+    instancedGroupBatch.geometryType_ = GEOM_INSTANCED;
+    PipelineBatch skinnedBatch{staticModel, 0};
+    skinnedBatch.geometryType_ = GEOM_SKINNED;
+    PipelineBatch billboardGroupBatch{staticModelGroup, 0};
+    billboardGroupBatch.geometryType_ = GEOM_BILLBOARD;
+
+    const ea::vector<const PipelineBatch*> batches{
+        &staticBatch, &skinnedBatch, &staticGroupBatch, &instancedGroupBatch, &billboardGroupBatch};
+
+    SECTION("instancing is enabled")
+    {
+        CHECK(BatchRenderer::GetNumInstancesInBuffer(staticBatch, true) == 1);
+        CHECK(BatchRenderer::GetNumInstancesInBuffer(staticGroupBatch, true) == 3);
+        CHECK(BatchRenderer::GetNumInstancesInBuffer(instancedGroupBatch, true) == 1);
+        CHECK(BatchRenderer::GetNumInstancesInBuffer(skinnedBatch, true) == 0);
+        CHECK(BatchRenderer::GetNumInstancesInBuffer(billboardGroupBatch, true) == 0);
+
+        // Instances stored in the buffer are exactly the instances consumed by instanced draw calls
+        unsigned numStoredInstances = 0;
+        unsigned numConsumedInstances = 0;
+        for (const PipelineBatch* pipelineBatch : batches)
+        {
+            numStoredInstances += BatchRenderer::GetNumInstancesInBuffer(*pipelineBatch, true);
+            if (BatchRenderer::IsBatchInstanced(*pipelineBatch, true))
+                numConsumedInstances += BatchRenderer::GetNumBatchInstances(*pipelineBatch);
+        }
+        CHECK(numStoredInstances == 5);
+        CHECK(numConsumedInstances == numStoredInstances);
+    }
+
+    SECTION("instancing is disabled")
+    {
+        for (const PipelineBatch* pipelineBatch : batches)
+            CHECK(BatchRenderer::GetNumInstancesInBuffer(*pipelineBatch, false) == 0);
+    }
+}
@@ -0,0 +1,165 @@
+//
+// Copyright (c) 2021-2022 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "../CommonUtils.h"
+
+#include <Urho3D/Container/RadixSort.h>
+#include <Urho3D/Core/ProcessUtils.h>
+#include <Urho3D/Core/WorkQueue.h>
+#include <Urho3D/RenderPipeline/PipelineBatchSortKey.h>
+
+#include <EASTL/sort.h>
+
+#include <random>
+
+namespace
+{
+
+const PipelineBatch* GetFakeBatch(unsigned index)
+{
+    return reinterpret_cast<const PipelineBatch*>(static_cast<uintptr_t>(index + 1));
+}
+
+ea::vector<PipelineBatchByState> CreateRandomBatchesByState(unsigned numBatches, unsigned numUniqueKeys)
+{
+    std::mt19937_64 rng(numBatches);
+    ea::vector<unsigned long long> keys(numUniqueKeys);
+    for (unsigned long long& key : keys)
+        key = rng();
+
+    ea::vector<PipelineBatchByState> batches(numBatches);
+    for (unsigned i = 0; i < numBatches; ++i)
+    {
+        batches[i].primaryKey_ = keys[rng() % numUniqueKeys];
+        batches[i].secondaryKey_ = (keys[rng() % numUniqueKeys] << 16) & ~0xffffull;
+        batches[i].pipelineBatch_ = GetFakeBatch(i);
+    }
+    return batches;
+}
+
+ea::vector<PipelineBatchBackToFront> CreateRandomBatchesBackToFront(unsigned numBatches)
+{
+    std::mt19937 rng(numBatches);
+    std::uniform_real_distribution<float> distanceDistribution(-100.0f, 1000.0f);
+
+    ea::vector<PipelineBatchBackToFront> batches(numBatches);
+    for (unsigned i = 0; i < numBatches; ++i)
+    {
+        batches[i].renderOrder_ = static_cast<unsigned char>(rng() % 4 * 64);
+        batches[i].distance_ = i % 7 == 0 ? 0.0f : distanceDistribution(rng);
+        batches[i].pipelineBatch_ = GetFakeBatch(i);
+    }
+    return batches;
+}
+
+template <class T>
+void SortBatchesRadix(WorkQueue* workQueue, ea::vector<T>& batches)
+{
+    ea::vector<T> scratchBuffer(batches.size());
+    RadixSortParallel(workQueue, 256, ea::span<T>(batches), ea::span<T>(scratchBuffer),
+        T::NumSortKeyBytes, &T::GetSortKeyByte);
+}
+
+template <class T>
+bool AreBatchesEqual(const ea::vector<T>& lhs, const ea::vector<T>& rhs)
+{
+    if (lhs.size() != rhs.size())
+        return false;
+    for (unsigned i = 0; i < lhs.size(); ++i)
+    {
+        if (lhs[i].pipelineBatch_ != rhs[i].pipelineBatch_)
+            return false;
+    }
+    return true;
+}
+
+}
+
+TEST_CASE("Radix sort of pipeline batches is equivalent to stable sort")
+{
+    auto context = Tests::GetOrCreateContext(Tests::CreateCompleteContext);
+    auto workQueue = MakeShared<WorkQueue>(context);
+    workQueue->CreateThreads(3);
+
+    for (unsigned numBatches : {0u, 1u, 2u, 100u, 1000u, 10000u})
+    {
+        for (unsigned numUniqueKeys : {1u, 16u, 1000u})
+        {
+            const auto sourceBatches = CreateRandomBatchesByState(numBatches, numUniqueKeys);
+
+            auto expectedBatches = sourceBatches;
+            ea::stable_sort(expectedBatches.begin(), expectedBatches.end());
+
+            auto serialBatches = sourceBatches;
+            SortBatchesRadix(nullptr, serialBatches);
+            CHECK(AreBatchesEqual(serialBatches, expectedBatches));
+
+            auto parallelBatches = sourceBatches;
+            SortBatchesRadix(workQueue, parallelBatches);
+            CHECK(AreBatchesEqual(parallelBatches, expectedBatches));
+        }
+
+        const auto sourceBatches = CreateRandomBatchesBackToFront(numBatches);
+
+        auto expectedBatches = sourceBatches;
+        ea::stable_sort(expectedBatches.begin(), expectedBatches.end());
+
+        auto serialBatches = sourceBatches;
+        SortBatchesRadix(nullptr, serialBatches);
+        CHECK(AreBatchesEqual(serialBatches, expectedBatches));
+
+        auto parallelBatches = sourceBatches;
+        SortBatchesRadix(workQueue, parallelBatches);
+        CHECK(AreBatchesEqual(parallelBatches, expectedBatches));
+    }
+}
+
+TEST_CASE("Sorting of pipeline batches benchmark", "[.benchmark]")
+{
+    auto context = Tests::GetOrCreateContext(Tests::CreateCompleteContext);
+    auto workQueue = MakeShared<WorkQueue>(context);
+    workQueue->CreateThreads(ea::max(1u, GetNumLogicalCPUs() - 1));
+
+    const auto sourceBatches = CreateRandomBatchesByState(100000, 2000);
+
+    BENCHMARK("Comparison sort")
+    {
+        auto batches = sourceBatches;
+        ea::sort(batches.begin(), batches.end());
+        return batches.size();
+    };
+
+    BENCHMARK("Radix sort")
+    {
+        auto batches = sourceBatches;
+        SortBatchesRadix(nullptr, batches);
+        return batches.size();
+    };
+
+    BENCHMARK("Parallel radix sort")
+    {
+        auto batches = sourceBatches;
+        SortBatchesRadix(workQueue, batches);
+        return batches.size();
+    };
+}
@@ -0,0 +1,214 @@
+//
+// Copyright (c) 2021-2022 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "../CommonUtils.h"
+
+#include <Urho3D/Graphics/Octree.h>
+#include <Urho3D/Graphics/StaticModel.h>
+#include <Urho3D/RenderPipeline/ShadowSplitCache.h>
+#include <Urho3D/Scene/Scene.h>
+
+namespace
+{
+
+const Drawable* GetFakeDrawable(unsigned index)
+{
+    return reinterpret_cast<const Drawable*>(static_cast<uintptr_t>(index + 1));
+}
+
+struct FakeShadowSplit
+{
+    IntRect region_{ 0, 0, 512, 512 };
+    bool isContentPreserved_{ true };
+    Matrix3x4 view_;
+    Matrix4 projection_;
+    ea::vector<unsigned long long> casterRevisions_;
+    ea::vector<bool> dynamicCasters_;
+    ea::vector<unsigned> batches_;
+
+    bool Update(ShadowSplitCache& cache) const
+    {
+        cache.BeginFrame(region_, isContentPreserved_, view_, projection_);
+        for (unsigned i = 0; i < casterRevisions_.size(); ++i)
+        {
+            const bool isDynamic = i < dynamicCasters_.size() && dynamicCasters_[i];
+            cache.AddCaster(GetFakeDrawable(i), casterRevisions_[i], isDynamic);
+        }
+        for (unsigned batchHash : batches_)
+            cache.AddBatch(batchHash);
+        cache.EndFrame();
+        return cache.IsValid();
+    }
+};
+
+}
+
+TEST_CASE("Shadow split cache is invalidated when shadow casters change")
+{
+    ShadowSplitCache cache;
+
+    FakeShadowSplit split;
+    split.casterRevisions_ = { 1, 2, 3 };
+    split.batches_ = { 10, 20, 30 };
+
+    // Nothing is cached on the first frame
+    REQUIRE_FALSE(split.Update(cache));
+    REQUIRE(split.Update(cache));
+    REQUIRE(split.Update(cache));
+
+    // Caster is moved
+    split.casterRevisions_[1] = 5;
+    REQUIRE_FALSE(split.Update(cache));
+    REQUIRE(split.Update(cache));
+
+    // Caster is added
+    split.casterRevisions_.push_back(1);
+    REQUIRE_FALSE(split.Update(cache));
+    REQUIRE(split.Update(cache));
+
+    // Caster is removed
+    split.casterRevisions_.pop_back();
+    REQUIRE_FALSE(split.Update(cache));
+    REQUIRE(split.Update(cache));
+
+    // Batches are reordered
+    split.batches_ = { 30, 10, 20 };
+    REQUIRE(split.Update(cache));
+
+    // Batch is changed
+    split.batches_ = { 30, 10, 40 };
+    REQUIRE_FALSE(split.Update(cache));
+    REQUIRE(split.Update(cache));
+}
+
+TEST_CASE("Shadow split cache is invalidated when shadow camera or region change")
+{
+    ShadowSplitCache cache;
+
+    FakeShadowSplit split;
+    split.casterRevisions_ = { 1 };
+
+    REQUIRE_FALSE(split.Update(cache));
+    REQUIRE(split.Update(cache));
+
+    // Light is moved
+    split.view_.SetTranslation({ 1.0f, 0.0f, 0.0f });
+    REQUIRE_FALSE(split.Update(cache));
+    REQUIRE(split.Update(cache));
+
+    // Shadow map is resized
+    split.projection_.m00_ = 2.0f;
+    split.region_ = { 0, 0, 1024, 1024 };
+    REQUIRE_FALSE(split.Update(cache));
+    REQUIRE(split.Update(cache));
+
+    // Shadow map region is not preserved by allocator
+    split.isContentPreserved_ = false;
+    REQUIRE_FALSE(split.Update(cache));
+    split.isContentPreserved_ = true;
+    REQUIRE(split.Update(cache));
+
+    // Cache is invalidated explicitly
+    cache.Invalidate();
+    REQUIRE_FALSE(split.Update(cache));
+    REQUIRE(split.Update(cache));
+}
+
+TEST_CASE("Shadow split cache is not used for dynamic shadow casters")
+{
+    ShadowSplitCache cache;
+
+    FakeShadowSplit split;
+    split.casterRevisions_ = { 1, 1 };
+    split.dynamicCasters_ = { false, true };
+
+    REQUIRE_FALSE(split.Update(cache));
+    REQUIRE_FALSE(split.Update(cache));
+    REQUIRE(cache.GetNumStaticCasters() == 1);
+    REQUIRE(cache.GetNumDynamicCasters() == 1);
+
+    // Shadow map still contains dynamic caster on the first frame after it's gone
+    split.casterRevisions_.pop_back();
+    split.dynamicCasters_.pop_back();
+    REQUIRE_FALSE(split.Update(cache));
+    REQUIRE(split.Update(cache));
+}
+
+TEST_CASE("Octree update revision is incremented when drawable is moved")
+{
+    auto context = Tests::GetOrCreateContext(Tests::CreateCompleteContext);
+
+    auto scene = MakeShared<Scene>(context);
+    scene->CreateComponent<Octree>();
+
+    Node* movingNode = scene->CreateChild("Moving");
+    auto movingModel = movingNode->CreateComponent<StaticModel>();
+    Node* staticNode = scene->CreateChild("Static");
+    auto staticModel = staticNode->CreateComponent<StaticModel>();
+
+    Tests::RunFrame(context, 0.05f);
+    const unsigned long long movingRevision = movingModel->GetOctreeUpdateRevision();
+    const unsigned long long staticRevision = staticModel->GetOctreeUpdateRevision();
+    REQUIRE(movingRevision != staticRevision);
+
+    Tests::RunFrame(context, 0.05f);
+    REQUIRE(movingModel->GetOctreeUpdateRevision() == movingRevision);
+    REQUIRE(staticModel->GetOctreeUpdateRevision() == staticRevision);
+
+    movingNode->SetPosition({ 1.0f, 0.0f, 0.0f });
+    Tests::RunFrame(context, 0.05f);
+    REQUIRE(movingModel->GetOctreeUpdateRevision() != movingRevision);
+    REQUIRE(staticModel->GetOctreeUpdateRevision() == staticRevision);
+}
+
+TEST_CASE("Octree update revision is never reused when drawable is removed and added again")
+{
+    auto context = Tests::GetOrCreateContext(Tests::CreateCompleteContext);
+
+    auto scene = MakeShared<Scene>(context);
+    scene->CreateComponent<Octree>();
+    auto otherScene = MakeShared<Scene>(context);
+    otherScene->CreateComponent<Octree>();
+
+    Node* node = scene->CreateChild("Node");
+    auto staticModel = node->CreateComponent<StaticModel>();
+    Tests::RunFrame(context, 0.05f);
+
+    ea::vector<unsigned long long> revisions;
+    revisions.push_back(staticModel->GetOctreeUpdateRevision());
+
+    // Removed drawable doesn't keep its revision, so cached shadow maps can't be accepted for reused memory
+    staticModel->SetEnabled(false);
+    revisions.push_back(staticModel->GetOctreeUpdateRevision());
+    staticModel->SetEnabled(true);
+    revisions.push_back(staticModel->GetOctreeUpdateRevision());
+    Tests::RunFrame(context, 0.05f);
+
+    // Revision in a new octree doesn't collide with revisions in the old one
+    node->SetParent(otherScene);
+    Tests::RunFrame(context, 0.05f);
+    revisions.push_back(staticModel->GetOctreeUpdateRevision());
+
+    for (unsigned i = 1; i < revisions.size(); ++i)
+        CHECK(revisions[i] > revisions[i - 1]);
+}
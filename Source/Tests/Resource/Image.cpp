@@ -22,9 +22,14 @@
 
 #include "../CommonUtils.h"
 #include "Urho3D/IO/MemoryBuffer.h"
+#include <Urho3D/Core/ProcessUtils.h>
 #include <Urho3D/Core/StringUtils.h>
+#include <Urho3D/Core/WorkQueue.h>
+#include <Urho3D/Resource/Decompress.h>
 #include <Urho3D/Resource/Image.h>
 
+#include <random>
+
 namespace Tests
 {
 namespace
@@ -39,6 +44,14 @@ const char* ETC1 = "RERTIHwAAAAHEAgAEAAAABAAAACAAAAAAAAAAAEAAAAAAAAAAAAAAAAAAAAA
 const char* ETC2 = "RERTIHwAAAAHEAgAEAAAABAAAACAAAAAAAAAAAEAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAVVZFUgAAAABOVlRUAgECACAAAAAEAAAARVRDMgAAAAAAAAAAAAAAAAAAAAAAAAAAABAAAAAAAAAAAAAAAAAAAAAAAACERPmGRNBImztj8rvjq7x1MmXytmejLLWNWxSO24jbMT406782e+aPe4YEe4YHkIAuZAQvZALsgEkyBcqwHJZDICj6oirqBR06bAW7bCONg19AFd/CnfgTAWwVgu6YHZOZ/6oA//8AAFpoDFtqRa0IIwH7o4HyMD9ufgxvgEbvyA==";
 const char* PVRTC2 = "RERTIHwAAAAHEAgAEAAAABAAAABAAAAAAAAAAAEAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAVVZFUgAAAABOVlRUAgECACAAAAAEAAAAUFRDMgAAAAAAAAAAAAAAAAAAAAAAAAAAABAAAAAAAAAAAAAAAAAAAAAAAADw8PDwKADMKPH08LAFF3Af/////4IjmJIPDw8PwDpgofDw8PAINGB1Dw8PD3Ar+1oPDx8P9QCv7w8PDw9yD39C";
 const char* PVRTC4 = "RERTIHwAAAAHEAgAEAAAABAAAACAAAAAAAAAAAEAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAVVZFUgAAAABOVlRUAgECACAAAAAEAAAAUFRDNAAAAAAAAAAAAAAAAAAAAAAAAAAAABAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAJwDaNlBQUFAGFnAf/////3M03Dj/////oaFwHwAAAAAZIudn/////2UV+ltRm5ZqgGnArAAAAABjLc81/////2F3XWUAAAAAYXagHf////+EJLmDAAECAcAq5yAAAAAAj+u8IP////9hC29F/////1Mo8gAAAAAAgw/rdQ==";
+const char* CRN_DXT1 = "SHgAWh0ZAAABJj3XABAAEAUBAAAAAAAAAAAAAAAAAAAAAABaAABYABAAALIAADMADgAAAAAAAAAAAAAAAAAAAAAAJgAA5QAAAQsAAAEYAAABHAAAASAAAAEkAIHgAIAMIIO00UnPBx/h4soCA1yBAABBBf7sFwdvhwsGlS6tPH5B+6xNv4HM6wTdC7FvYcAvJSXndiR8aB/RSUXa516iA8kF78af2N51CxEfBWo0xFhIwABCYACCDADDADmeUV3wUA6geACS08+Z3ufZ//Z2e/DWqtUqoltsRrSJZYqonOdvaxjGAAImIIDAAAACD+gKJIIijgB7wGGAAACFpyEwAHRAYAAAIYYdchkAMEklxEy6LK6BHXmiaEdGubDNnMD8ptf/APCq";
+const char* CRN_DXT5 = "SHgAWgu9AAAB27AZABAAEAUBAgAAAAAAAAAAAAAAAAAAAABaAABaABAAALQAADQADgAA6AAALwAQAAEXAABTAA4APQABagAAAacAAAG/AAAByAAAAdAAAAHXAIGgAIAIIJWo5wmE6vyZQEBrACAABDokse5y5WJ0lpwpLazkOq0pT3sp3BkVR1uR6Bg5Av+q2EkxFEQ9lpP1bcjNwgliBZ91u4Mi+F8H9Z3subRz7E0hJm8wAEJgAIIMAMMAOZ5RXfBQDqB4AJLTz5ne59n/9nZ78Naq1SrJJLLEa1JJJIqtbznToxjGAAQBrgCAABEimqKUndFGCZsXkWr37yzxbxaIwAhJxYs3816+ThJj2i8vbap0CEWgAQIoAMIMQMATpj5bLBIVAmw8wb0VAr0aflUAAIICio5jmCDTabg4FFFFKp3AGYHd3QQQQ/CY6Ojbv2+/PevXjbzO/9d4xGG01Wva9r2vmczmcyABVmkAAAAAAgw9NCCCOAIPAAQAAQQQ+w0wSAHRAQAAAQYYWYGBeAIPAYYAAAISkbO4AHRAQAAAIYAeGT4AawJ0VYsw0gRGuG02jdl4UQAlRsOhFaYhWvR59Yh54DeQzrPz+NjqqIDmbdvyR/UQv6qqoA==";
+const char* CRN_DXT5_UNPACKED = "RERTIHwAAAAHEAoAEAAAABAAAAAAAQAAAAAAAAUAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAACAAAAAEAAAARFhUNQAAAAAAAAAAAAAAAAAAAAAAAAAACBBAAAAAAAAAAAAAAAAAAAAAAAAaEAAAAAAAAG0SrQGqqqqqXTwAAAAAAAD0lxp3VVVVVbWtSZIkSZIkt3ofRKqqqqr17AAAAAAAANgeaQcAAAAAKx4AAAAAAAAAsvUIqqqqqkY3SZIkSZIkIfRFswAAAAD17EmSJEmSJMBj4FGqqqqqXTzbtm3btm1N1oKVVVVVVV08bdu2bdu2ALL1CP/////Pz+iCLuiCLqJ7wWKqqqqq9ewAAAAAAABN1oKVqqqqqiseSZIkSZIk2B5pB1VVVVW1rQAAAAAAAPSXGncAAAAARjcAAAAAAAAh9EWzVVVVVYZ5AAAAAAAAt3ofRFVVVVUaEEmSJEmSJCH0RbOqqqqqXBoJkAB2aZOStuhZBQWlpexXJEACQAIkLZovX1pa+vroE7ZkS5u92bGnh2n19fDw6gvAD/xkQiYtmi9fX1+qqugT8XDDFj4zLZovX2ToeKnOPJFE27RN2y+dknVUAAAAhnlJkiRJkiRPnfCMVVVVVQ==";
+const char* CRN_ETC1 = "SHgAWo7pAAABB7K7ABAAEAUBCgAAAAAAAAAAAAAAAAAAAABaAAAzABAAAI0AADAADAAAAAAAAAAAAAAAAAAAAAAAKQAAvQAAAOYAAADzAAAA+gAAAQAAAAEEAIH0UMAIIIQCcjtUOnyh+dyP43YArMJczXOMauP0hvW+R2Vm5S2i4RRsqU4VWx6FFncEAEJgMMAIIQMATgSyM9xQC0JPHKhposv0+nbtttttmAPdf3Ul655nCSS5cttiCS2QApZxAMAAAEAATsx/TRLEEQAAIPgAgAAQYMKt43AAMiAAAAAQgw4mO0BwGiEZFNpkKJxhYaEo7LuG1ur/gP3zsYNd+NfJp2iW0qA=";
+const char* CRN_ETC2A = "SHgAWpvsAAABvKPMABAAEAUBDAAAAAAAAAAAAAAAAAAAAABaAAAzABAAAI0AADAADAAAvQAAMAAQAADtAABQABAAPwABPQAAAXwAAAGXAAABowAAAa4AAAG3AIHgQIAIMIR5dRBBov12F7HDDW99OvzlqsFnwYshCMFsDCoR78mTCbcyX7hTVM7zO9VQAEJgMMAIIQMATgSyM9xQC0JPHKhposv0+nbtttttmAPdf3Ul655nCSS5cttiCS2QA/2pgMAAIIxJoQNmKuc5mxZvWnavCPHMWDwDFiQI2PzxNqgs8ckNGynQ2ULuD5aQAQIoAMIMQMAThP7cEJCUgJrCpEZmqcigAAqquYAAsyCqEzEbGjRo/Vo0aFVVqgu4i/m/n13+7zt268c//dxcMMEkzU1xPE2WY41FQ45GRgAChm0AAAAARABOwN00SRBEE8AQeAAAAAgQmefdAAZEAAAAAhBhxMdoAQeAAwAAgQz+VD4AEIgMAAAEAINOTuRbGSNDCNQS5j00nvUzZQNQIQXgPwHYcVMCSUL1t+re1fRR3ytj//iSvbnC+Wxs1oqBgOeuYQxdX2sNhKfirUpQ";
+
+// This blob contains procedural 128x128 texture with mips
+const char* CRN_DXT5_128 = "SHgAZh7rAAAOYVtmAIAAgAgBAgAAAAAAAAAAAAAAAAAAAABmAAHfAHoAAkUAAUsApwADkAAAMgAVAAPCAADaACoArgAEnAAABUoAAAsBAAANXQAADhIAAA42AAAOQwAADk8AAA5aAIHgMAMIIMOU4oojnPSp2AID4KGmGGGL5x3SS3WlxzqRwOAsgwhLGmudn93+b31tR5oSR7V119eC97Yh8Sd9safgdlGv1omcDllovcQuxN4DNVw1cW3ObArc175FtQd5T7c9XxTY6Pew2e7AbIJHzI/3NsuVh8fil3BRoMAgOSTnacU1WWnTarfu1oF1I1czOUn2VnbWehOgnRG86i6JN0i9dp9iGrlz8Ws1rnjiEL9D/0XCSREFLmkAJWE71elXsEmiLVBUFjQxwqWKgnPBYLIK6MCIn6BjgvsO+g4fP4zXnBEYl3HnyV/U32+EtV7iPEoA7BsR6KbkUEOvOmPK9Xz2Zf+5vJWjZqw+c75z8tsZ9k8UeKfSHpFwRwT1ie63FwIMEQI4DuS6c9NlG8gySX1fJicbnXU6l2I1wMHAkX/M82NzSti89t04W+Sq2AdmMgwI3CSwk8CLKhJuNehWna39tmt4K07o63toLTRkXGxL+kJYxI5IlC6uPLtoxnbL/lt/XmePlA6xuIcZhgQxrn7CIz54D2itWGiTA9BOGLYWxX+ArRB9W6hIhgHZHj742NgKlq+7uXr3+nkipcpDGWs/Ga+WyEZCXQPQhIuJFzpxtpN0URfsyPcL1vfvQdAAQmAA3GwwwwBOMZUw0q8MAAzAzADvAGkAWAKBgBBVBVWAIzA6AdDADABQMgOgdAwDAHAHHGAGBwAEDpmHRACgZGcBjWCHEIauYKHe5ACFiBAKoAoAqkREVVWICqgCsAIgIIiKqrAEAzMBhmB0Brl9nsUBERICIiI/NQfifpH6BsAiqrA44OKr/KBVVTQJsRDWjgNdVVUREQCqoAq5EQZgdAOgAoGQBTHQMAHQBQ4gOLgNA7wCDMPLHeHshoGZmBmB99mN+9MwGtIiIAaBdqqVVUvLxxwKoAKIjEa0Aa0iIAJEEBBGtmzcmSy61rXjx48BVVQAUBYiIAIvf5Wd6ZhEOkR0AZhAEYAYFzMCAB0DowAwACALmMcDK0LN6xf28UFSv73lf/++DeAcAOkGijeGFMZ8/ub61oANa1o+z7OgDoYNiYxvnPOe899ABAHtgMAAEQTvJDAWHM0VopUFKQjKGDMSVq/7nCUDFj0ef9YIULpb2DOes0te7RWoXGABAiAAlAgxQBfZ/ldqimWa+umFFOunhLD0JqiKEHvANNAAA44hAADjiuu0tPovNzcZXVsTk5OTqioqKl8xkZHwABf0nEEJzDoAAVCinPCwAA5ii4I2js3Rkz6v6bW2r5maNL34wikUikUzDAwzMdGs7hpo12JkYmJk7HRqpznbiigG2wBCEIAXFxnpN6X3pf9pTJfCxbLPyrv19eXbcx7nh7MTzu7N/HfrR7tarVX9kU/8iQ8eDx8aKI0RjQxjnMY50pU0ylTTttXWAFhyNTWaFPK3PyzV3UHseAImMgCbDEEEEoZOC6Y9HwnnMc8FSwUDR+aRAgWA9Rgobbqogw33+ZxxudicjbrjhWFBBoBIKlUjSFqiqVohGi7TQU02Wem5G3I433vMwCneBQG01BhunPLz4jn5rmA0ea+RIEMsTQNwYfFfMBA4mjQFfwKoK5g+KrgQoMHIO5R4pxh8DRFGsEAFZsANAQIAQQTOCNDSxnmgFUwIA20gAAKK2pNHGdQkvOggj7+yiKz/8phSBASgoJSuklbnNmpIEBKCglksyrdqlDqqBASgoJ1J6Optu0jqW4TOKRq4yYaNRYN+hGESSJMmlXSUadsGNjOcJ0671yuTa4S4uLgrlcmIkWzapiiinkUoJmGop++OhYaiESKKjrJh6NjpHUyJECiuxFSB6R6Vx0DmQAkIUQ8w9HxyHLIkSyiuVFSB6R5alzkkiTJqZcstRbfwcJ17CZcuzi2RbWxW63Ls6WWvEkvlOsUuXPKKvzUISYAXXxLz3AkivcV1EyZJJlE8lflYaGO5x2OTY2Ms56RdlrZE3lMmebRIjL3V5tqqi0NKNGMncytImno7va6XU3bfulKYawxrkMjRjMiE6NW++/28GuuFNGlMUaKhlVRf2lSmsMnZWkano7X/01nyGMlMeMNyJb9ZGsMyNTo2vwv8nekprOQoZoqEXo3Nu0+vUbqnpPPcEmR8x0x8Z55MKh4SqGratqxiEYpwki69Y8aRUqMoo556Zx1Vhk45ROnU5x7uWW1rFhvnHEnTre5ZWUnWIWHIITsinHv898R6LWIHMkEEkSKOspHlqXvPPE+2Hy6mpUuA88T59TU1KliEIRS5cupLfA88T59TLni3YILMTECxTGzQUU6dO2Ld800zFFO9LMrx4mETyQlkVpNm53t/NeXEl13ONjbrNmyzsXd1u2jfLmsRCioUzq6S8N9zZtBoLrNsMmjMuTVKFXuGRCitvMntjPt2jJSvNC0KGGomqWZVDbWvmMYZbq2lnlrn2zmWS2smzWktNFVvVZKqoupa+18mmTCidCMvbu2MoaNJjDFlSh320mTkzMcbGxpKKbbqz5iZMZJK8UUaVSTJkxkkqp0vyTZKaxkyYySWlUoT9I94DzIQkwBEOYdHjyHlghJgCQOkdLI9A84H6xXZiUHSVhh0aPSPLBCTAEgdsHLl2Rcrka4uFlly5ypUZRRZZcusPnxnlqSy5dQqVGUUWWfSqb9UEkuyTSPLtOz5swa0+kQlkV0kVwRSbXOJUHIB2QpHmgoq8+IgeQCiEJ6DZtm0phP2IYRrOsrTs+jToydRYutZePYksyWqUOowYRrOuVXSS2RGtXibUWbbXZtKWZZKYWaQzDU9mnZ9k6M1ecma216Fksy8VOpmv1gzDWSyuktZEb1c3CY7bX3n3yWZLTMJMTELFYqWSjsmrdpU44TrATX2GounYidNiPF1LFZWSjpzlSSXmcJ06lmU/9ZQsnIKKTEJNCwyxtVlZXfNvkRJkEIhzLEmPVWTJs2TNNRLDjoqygeuSL2G241ixLViVimpsQooxCUqVNTfcfPozzy1JdTe8+fGeepLUy7+j59SpUqToiinCKKTEJ7JrYl6bdXqFMkyZMklaEgheiRMdcunSZxxgh115YrqFclFbWaadz5VBqWZcbg3CjXl46tIv09HQ4NwY3CXkuQYmqqKV6vRry8lumyd1ko5mfTWg0FWFQYSmHjGGURo16dXSTf06MwMMSNGmVUyZ1SgyMMa01NWyelHVo2RG6ZuExKWZKYaisyn9ESSJNBEiuf9Tp2wYySRJk2ltLfTapQcggSJEnXlUZS0kkkSZNDpz6erHQgMku8WSLMbTzHsKCjY6RywASEKQPIekaBrHOA01ZNusiiQTD0fQEOWACQhSB64eWtsx55T58utyy1CihKlS5dbLWHnpnz63LllnKKEqVLlz+aq38QRORbMgg8AhLzxSC5EJMAMiEvoit5F7RVIvsyCCytI7shOPOYUUmIR+oP7ZaWZI26EVnM5zNNnlc6krV64Ea8vMCUwqqomdOKzn4sTUrSIskuc6sjdt/DsSmMlmT0sMaoxk7NNns51JNyuzKjZjSalMeKpKLN7GlYzI+VpH5kkNc+3ZlmFv2pTF+dOnatqxtVBzK3aQ9Xdq3rlcjXEkpdl5ENsmq5sjp0ZxytIrc62dJ06M45ccl3QM//gLZXcNldku9RXrdGI7k7wu2wjqNI6Myu5OR2kjqbZvRiO4ZHa98i9fC810bEM5Fo+GDhs0M/oGluGGINiGeoNKYYZw2IZ3Q8TjDyWGXZhzIccYrh67mXkGy+YDieV72sBlDeHyzh8FkNWZeXeDFy/w+W+G6Nujg3bwM4bfSubgzBsjNujcEbei77NmVobwcG+ZnD59vRwENe0WQsXN4XARa2iyK4ucYuCkNe4WR/uHPxFwEWvui8uKweb9v7FfzQtIxYWuJsXEzgNOHFgnv7RX87mXpk3i4Qv7Ffza8vwbmDyjdHIjQ8wRwbZurEZVXTc/ZwWSNaOjkPoeU9TgVn6pDlU6bnk/99nh4WGhhhqDakM6BoYYWhtZDOwNDDBBsoZuGhhhHw874hfMdHEIasLIsw5oHBFa1q4uXG/DlBxwQ1kMjLhzUXARa+NxfLZz5v3o2bmjTFruFX47F1s8TBo3B2ps3PlXdN+7/BkO3ndbPTYPB/wvLHiyDFzpFwPFr9osgxc+4XBdFrzhkGHPwDgmGvrFkGLm34vnrxeFi0MWEi2iLPEy9K7iYM8rbTczNL+hr+EPE2eLO0Whiwj4eZVg+ePsPAUOtF3I4Nd5hDwFDrL68idzOZQ8FbU1Tc5G7I52tlxSs3Xk/t9/h58fRtWGfELR8MHDYhnAaXYsPENiGfiGlMMKBsQzth4PyF5NhkGHKDgyw1qLIMXLhwdsNZDIrsvlC4LIa0DIMObvh85fYLp7qdS1Onoe13Wu9rUPUoemBg7tuV2+bpdS6XTKu94257Q6XUvz6aLAD/P6H+yh+wpHtqw+xvofY0P2N1le2HD+f2cv6nvZ3perjr3z76Ll4mu7/henjPMHufMXr2eLEtxbkWJfxbxFiYMW5wvv5ofq3od91DiaHe9Q48uh3UjE4j3GYPU96+Jk3pb4b6MS7crcvYxH253XPp+/9i+p4t+CLExb4YsTFvrix18L3L6H1j0OJmyNyRideh3KHEt0O5yH7/y+3+O2834xb4PSb4fjr3L9Cu/GPeZ6LfV/4A3/tpNaErRetXt5xltxl5xmbfEP1ahWoE1C2on1qnlpK0fWgD6u/Oh+S6H64/6Nx/yle9z+k+P8dz6Tf6A9Tztf5mfjtfQswDqW8bxvG8A";
 
 SharedPtr<Image> ReadImage(Context* context, const char* data, CompressedFormat format)
 {
@@ -68,6 +81,38 @@ float CompareImages(const Image& lhs, const Image& rhs, bool compareAlpha, float
     return static_cast<float>(Sqrt(errorSum / (size.x_ * size.y_)));
 }
 
+ByteVector CreateRandomBytes(unsigned size, unsigned seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<unsigned> dist(0, 255);
+
+    ByteVector bytes(size);
+    for (unsigned char& value : bytes)
+        value = static_cast<unsigned char>(dist(rng));
+    return bytes;
+}
+
+unsigned GetCompressedSize(int width, int height, int depth, CompressedFormat format)
+{
+    const unsigned bytesPerBlock = format == CF_DXT1 || format == CF_ETC1 || format == CF_ETC2_RGB ? 8 : 16;
+    return ((width + 3) / 4) * ((height + 3) / 4) * depth * bytesPerBlock;
+}
+
+SharedPtr<Image> CreateRandomImage(Context* context, int width, int height, unsigned components, unsigned seed)
+{
+    auto image = MakeShared<Image>(context);
+    image->SetSize(width, height, components);
+    const ByteVector bytes = CreateRandomBytes(width * height * components, seed);
+    image->SetData(bytes.data());
+    return image;
+}
+
+bool IsSameImageData(const Image& lhs, const Image& rhs)
+{
+    return lhs.GetSize() == rhs.GetSize() && lhs.GetComponents() == rhs.GetComponents()
+        && memcmp(lhs.GetData(), rhs.GetData(), lhs.GetWidth() * lhs.GetHeight() * lhs.GetDepth() * lhs.GetComponents()) == 0;
+}
+
 } // namespace
 
 TEST_CASE("DXT, ETC and PVRTC images are decompressed")
@@ -98,4 +143,238 @@ TEST_CASE("DXT, ETC and PVRTC images are decompressed")
     REQUIRE(CompareImages(*imageReference, *imagePVRTC4, false) < 0.15f);
 }
 
+TEST_CASE("CRN images are transcoded to DXT and ETC")
+{
+    auto context = Tests::GetOrCreateContext(Tests::CreateCompleteContext);
+
+    const auto imageReference = ReadImage(context, PNG, CF_NONE);
+    const auto imageDXT1 = ReadImage(context, CRN_DXT1, CF_DXT1);
+    const auto imageDXT5 = ReadImage(context, CRN_DXT5, CF_DXT5);
+    const auto imageETC1 = ReadImage(context, CRN_ETC1, CF_ETC1);
+    const auto imageETC2A = ReadImage(context, CRN_ETC2A, CF_ETC2_RGBA);
+
+    REQUIRE(CompareImages(*imageReference, *imageDXT1, false) < 0.02f);
+    REQUIRE(CompareImages(*imageReference, *imageDXT5, true) < 0.02f);
+
+    // Shared ETC endpoint codebooks are coarse for such small image, the error is the same as crunch tool output has
+    REQUIRE(CompareImages(*imageReference, *imageETC1, false) < 0.18f);
+    REQUIRE(CompareImages(*imageReference, *imageETC2A, true) < 0.18f);
+
+    // Mip levels are transcoded to the same blocks as DDS unpacked by crunch tool
+    auto image = MakeShared<Image>(context);
+    MemoryBuffer buffer(DecodeBase64(CRN_DXT5));
+    REQUIRE(image->BeginLoad(buffer));
+
+    auto imageUnpacked = MakeShared<Image>(context);
+    MemoryBuffer bufferUnpacked(DecodeBase64(CRN_DXT5_UNPACKED));
+    REQUIRE(imageUnpacked->BeginLoad(bufferUnpacked));
+
+    REQUIRE(image->GetNumCompressedLevels() == 5);
+    REQUIRE(imageUnpacked->GetNumCompressedLevels() == 5);
+    for (unsigned i = 0; i < image->GetNumCompressedLevels(); ++i)
+    {
+        const CompressedLevel level = image->GetCompressedLevel(i);
+        const CompressedLevel levelUnpacked = imageUnpacked->GetCompressedLevel(i);
+        REQUIRE(level.width_ == levelUnpacked.width_);
+        REQUIRE(level.height_ == levelUnpacked.height_);
+        REQUIRE(level.dataSize_ == levelUnpacked.dataSize_);
+        REQUIRE(memcmp(level.data_, levelUnpacked.data_, level.dataSize_) == 0);
+    }
+    REQUIRE(image->GetDecompressedImageLevel(4)->GetSize() == IntVector3{1, 1, 1});
+}
+
+TEST_CASE("CRN images with swizzled DXT5 are rejected")
+{
+    // Format byte of CRN header, 5 is cCRNFmtDXT5_xGBR
+    ByteVector data = DecodeBase64(CRN_DXT5);
+    REQUIRE(data[18] == 2);
+    data[18] = 5;
+
+    TranscodedImage transcodedImage;
+    CHECK_FALSE(TranscodeImageCRN(transcodedImage, data.data(), data.size(), nullptr));
+    CHECK(transcodedImage.format_ == CF_NONE);
+}
+
+TEST_CASE("DXT and ETC images are decompressed in parallel")
+{
+    auto context = Tests::GetOrCreateContext(Tests::CreateCompleteContext);
+    auto workQueue = MakeShared<WorkQueue>(context);
+    workQueue->CreateThreads(3);
+
+    const int width = 37;
+    const int height = 133;
+    const int depth = 2;
+
+    for (CompressedFormat format : {CF_DXT1, CF_DXT3, CF_DXT5})
+    {
+        const ByteVector blocks = CreateRandomBytes(GetCompressedSize(width, height, depth, format), format);
+
+        ByteVector expected(width * height * depth * 4);
+        DecompressImageDXT(expected.data(), blocks.data(), width, height, depth, format);
+
+        ByteVector actual(expected.size());
+        REQUIRE(DecompressImage(nullptr, actual.data(), blocks.data(), width, height, depth, format));
+        REQUIRE(actual == expected);
+
+        ea::fill(actual.begin(), actual.end(), 0);
+        REQUIRE(DecompressImage(workQueue, actual.data(), blocks.data(), width, height, depth, format));
+        REQUIRE(actual == expected);
+    }
+
+    for (CompressedFormat format : {CF_ETC1, CF_ETC2_RGBA})
+    {
+        const ByteVector blocks = CreateRandomBytes(GetCompressedSize(width, height, 1, format), format);
+        const bool hasAlpha = format == CF_ETC2_RGBA;
+
+        ByteVector expected(width * height * 4);
+        DecompressImageETC(expected.data(), blocks.data(), width, height, hasAlpha);
+
+        ByteVector actual(expected.size());
+        REQUIRE(DecompressImage(workQueue, actual.data(), blocks.data(), width, height, 1, format));
+        REQUIRE(actual == expected);
+    }
+}
+
+TEST_CASE("Image mip levels are calculated with box and tent filters")
+{
+    auto context = Tests::GetOrCreateContext(Tests::CreateCompleteContext);
+    auto workQueue = MakeShared<WorkQueue>(context);
+    workQueue->CreateThreads(3);
+
+    SECTION("Box filter matches GetNextLevel")
+    {
+        for (unsigned components = 1; components <= 4; ++components)
+        {
+            for (const IntVector2 size : {IntVector2{37, 21}, IntVector2{256, 255}, IntVector2{2, 2}, IntVector2{16, 1}})
+            {
+                const auto image = CreateRandomImage(context, size.x_, size.y_, components, components);
+                const auto expected = image->GetNextLevel();
+
+                REQUIRE(IsSameImageData(*image->CalculateNextLevel(MipFilter::Box), *expected));
+                REQUIRE(IsSameImageData(*image->CalculateNextLevel(MipFilter::Box, workQueue), *expected));
+            }
+        }
+    }
+
+    SECTION("Tent filter keeps constant image constant")
+    {
+        auto image = MakeShared<Image>(context);
+        image->SetSize(37, 21, 4);
+        image->Clear(0x80402010_argb);
+
+        const auto mipImage = image->CalculateNextLevel(MipFilter::Tent, workQueue);
+        REQUIRE(mipImage->GetSize() == IntVector3{18, 10, 1});
+        for (const IntVector2 index : IntRect(IntVector2::ZERO, mipImage->GetSize().ToVector2()))
+            REQUIRE(mipImage->GetPixel(index.x_, index.y_) == 0x80402010_argb);
+    }
+
+    SECTION("Tent filter is smoother than box filter")
+    {
+        // Box filter keeps 2 pixels wide stripes at full contrast, tent filter blends them with neighbours
+        auto image = MakeShared<Image>(context);
+        image->SetSize(8, 8, 1);
+        for (int y = 0; y < 8; ++y)
+        {
+            for (int x = 0; x < 8; ++x)
+                image->SetPixel(x, y, (x / 2) % 2 ? Color::WHITE : Color::BLACK);
+        }
+
+        const auto mipImage = image->CalculateNextLevel(MipFilter::Tent);
+        const unsigned char* row = mipImage->GetData();
+        REQUIRE(row[0] == 32);
+        REQUIRE(row[1] == 191);
+        REQUIRE(row[2] == 64);
+        REQUIRE(row[3] == 223);
+    }
+
+    SECTION("Mip chain is calculated down to 1x1")
+    {
+        const auto image = CreateRandomImage(context, 37, 21, 4, 0);
+        const auto mipChain = image->CalculateMipChain(MipFilter::Tent, workQueue);
+
+        REQUIRE(mipChain.size() == 5);
+        REQUIRE(mipChain[0]->GetSize() == IntVector3{18, 10, 1});
+        REQUIRE(mipChain[1]->GetSize() == IntVector3{9, 5, 1});
+        REQUIRE(mipChain[2]->GetSize() == IntVector3{4, 2, 1});
+        REQUIRE(mipChain[3]->GetSize() == IntVector3{2, 1, 1});
+        REQUIRE(mipChain[4]->GetSize() == IntVector3{1, 1, 1});
+
+        image->PrecalculateLevels();
+        ea::vector<const Image*> levels;
+        image->GetLevels(levels);
+        REQUIRE(levels.size() == 6);
+    }
+}
+
+TEST_CASE("Image transcoding, decompression and mip generation benchmark", "[.benchmark]")
+{
+    auto context = Tests::GetOrCreateContext(Tests::CreateCompleteContext);
+    auto workQueue = MakeShared<WorkQueue>(context);
+    workQueue->CreateThreads(ea::max(1u, GetNumLogicalCPUs() - 1));
+
+    const int size = 2048;
+    const ByteVector blocks = CreateRandomBytes(GetCompressedSize(size, size, 1, CF_DXT5), 0);
+    ByteVector rgba(size * size * 4);
+
+    BENCHMARK("Scalar DXT5 decompression")
+    {
+        DecompressImageDXT(rgba.data(), blocks.data(), size, size, 1, CF_DXT5);
+        return rgba[0];
+    };
+
+    BENCHMARK("SIMD DXT5 decompression")
+    {
+        DecompressImage(nullptr, rgba.data(), blocks.data(), size, size, 1, CF_DXT5);
+        return rgba[0];
+    };
+
+    BENCHMARK("Parallel SIMD DXT5 decompression")
+    {
+        DecompressImage(workQueue, rgba.data(), blocks.data(), size, size, 1, CF_DXT5);
+        return rgba[0];
+    };
+
+    BENCHMARK("Parallel ETC2 decompression")
+    {
+        DecompressImage(workQueue, rgba.data(), blocks.data(), size, size, 1, CF_ETC2_RGBA);
+        return rgba[0];
+    };
+
+    const ByteVector crnData = DecodeBase64(CRN_DXT5_128);
+    BENCHMARK("CRN 128x128 transcoding")
+    {
+        TranscodedImage transcodedImage;
+        TranscodeImageCRN(transcodedImage, crnData.data(), crnData.size(), nullptr);
+        return transcodedImage.faces_[0][0];
+    };
+
+    BENCHMARK("CRN 128x128 transcoding and RGBA decompression")
+    {
+        TranscodedImage transcodedImage;
+        TranscodeImageCRN(transcodedImage, crnData.data(), crnData.size(), workQueue);
+        DecompressImage(workQueue, rgba.data(), transcodedImage.faces_[0].data(), 128, 128, 1, CF_DXT5);
+        return rgba[0];
+    };
+
+    const auto image = CreateRandomImage(context, size, size, 4, 0);
+
+    BENCHMARK("Scalar box mip chain")
+    {
+        SharedPtr<Image> level = image;
+        while (level->GetWidth() > 1 || level->GetHeight() > 1)
+            level = level->GetNextLevel();
+        return level->GetData()[0];
+    };
+
+    BENCHMARK("Parallel SIMD box mip chain")
+    {
+        return image->CalculateMipChain(MipFilter::Box, workQueue).back()->GetData()[0];
+    };
+
+    BENCHMARK("Parallel tent mip chain")
+    {
+        return image->CalculateMipChain(MipFilter::Tent, workQueue).back()->GetData()[0];
+    };
+}
+
 } // namespace Tests
@@ -0,0 +1,202 @@
+//
+// Copyright (c) 2021-2022 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "../CommonUtils.h"
+
+#include <Urho3D/IO/ArchiveSerialization.h>
+#include <Urho3D/IO/MemoryBuffer.h>
+#include <Urho3D/IO/VectorBuffer.h>
+#include <Urho3D/Resource/JSONArchive.h>
+#include <Urho3D/Resource/JSONDocument.h>
+#include <Urho3D/Resource/JSONFile.h>
+#include <Urho3D/Scene/Scene.h>
+
+namespace
+{
+
+const char* testJSON = R"({
+    // Comments and trailing commas are allowed like in JSONFile
+    "null": null,
+    "bool": true,
+    "int": -5,
+    "uint": 7,
+    "double": 0.5,
+    "string": "Line\nQuote\"",
+    "array": [1, "two", [3], {}],
+    "object": { "name": "first", "name": "last", },
+})";
+
+}
+
+TEST_CASE("JSON document is parsed in place")
+{
+    JSONDocument document;
+    REQUIRE(document.Parse(testJSON, "TestJSON"));
+    CHECK(document.GetName() == "TestJSON");
+    CHECK(document.GetNumValues() == 16);
+
+    const JSONDocumentValue& root = document.GetRoot();
+    REQUIRE(root.IsObject());
+    REQUIRE(root.Size() == 8);
+    CHECK(root[0].GetKey() == "null");
+    CHECK(root[0].IsNull());
+
+    CHECK(root.Get("bool").GetBool() == true);
+    CHECK(root.Get("int").GetInt() == -5);
+    CHECK(root.Get("int").GetNumberType() == JSONNT_INT);
+    CHECK(root.Get("uint").GetUInt() == 7);
+    CHECK(root.Get("uint").GetNumberType() == JSONNT_UINT);
+    CHECK(root.Get("double").GetDouble() == 0.5);
+    CHECK(root.Get("string").GetString() == "Line\nQuote\"");
+    CHECK(root.Get("missing").IsNull());
+    CHECK_FALSE(root.Contains("missing"));
+
+    const JSONDocumentValue& array = root.Get("array");
+    REQUIRE(array.IsArray());
+    REQUIRE(array.Size() == 4);
+    CHECK(array[0].GetInt() == 1);
+    CHECK(array[1].GetString() == "two");
+    CHECK(array[2].Size() == 1);
+    CHECK(array[2][0].GetInt() == 3);
+    CHECK(array[3].IsObject());
+    CHECK(array[3].Size() == 0);
+    CHECK(array[4].IsNull());
+
+    // Last member wins like in JSONValue
+    CHECK(root.Get("object").Get("name").GetString() == "last");
+
+    JSONValue expectedValue;
+    REQUIRE(JSONFile::ParseJSON(R"({"array": [1, "two", [3], {}], "object": {"name": "last"}})", expectedValue));
+    CHECK(root.Get("array").ToJSONValue() == expectedValue.Get("array"));
+    CHECK(root.Get("object").ToJSONValue() == expectedValue.Get("object"));
+
+    CHECK_FALSE(document.Parse(R"({"unterminated": [1, 2})"));
+    CHECK(document.GetRoot().IsNull());
+}
+
+TEST_CASE("JSON document stores 64-bit integers exactly")
+{
+    auto context = Tests::GetOrCreateContext(Tests::CreateCompleteContext);
+
+    JSONDocument document;
+    REQUIRE(document.Parse(R"({"big": 9007199254740993, "negative": -9007199254740993, "max": 18446744073709551615})"));
+
+    const JSONDocumentValue& root = document.GetRoot();
+    CHECK(root.Get("big").GetNumberType() == JSONNT_UINT);
+    CHECK(root.Get("big").GetUInt64() == 9007199254740993ull);
+    CHECK(root.Get("negative").GetNumberType() == JSONNT_INT);
+    CHECK(root.Get("negative").GetInt64() == -9007199254740993ll);
+    CHECK(root.Get("max").GetUInt64() == 18446744073709551615ull);
+
+    // Archive reads both numbers and strings written by output archives
+    JSONDocumentInputArchive archive{ context, document };
+    const auto block = archive.OpenUnorderedBlock("root");
+    unsigned long long bigValue{};
+    long long negativeValue{};
+    SerializeValue(archive, "big", bigValue);
+    SerializeValue(archive, "negative", negativeValue);
+    CHECK(bigValue == 9007199254740993ull);
+    CHECK(negativeValue == -9007199254740993ll);
+}
+
+TEST_CASE("JSON document finds members of large objects by name")
+{
+    ea::string text = "{";
+    for (unsigned i = 0; i < 100; ++i)
+        text += Format("\"member{}\": {}, ", 99 - i, i);
+    text += "\"member50\": -1}";
+
+    JSONDocument document;
+    REQUIRE(document.Parse(text));
+
+    const JSONDocumentValue& root = document.GetRoot();
+    REQUIRE(root.Size() == 101);
+    CHECK(root[0].GetKey() == "member99");
+    CHECK(root.Get("member0").GetInt() == 99);
+    CHECK(root.Get("member99").GetInt() == 0);
+    CHECK(root.Get("member7").GetInt() == 92);
+    CHECK_FALSE(root.Contains("member100"));
+    CHECK_FALSE(root.Contains(""));
+
+    // Last member wins like in small objects
+    CHECK(root.Get("member50").GetInt() == -1);
+}
+
+TEST_CASE("JSON document archive benchmark", "[.benchmark]")
+{
+    auto context = Tests::GetOrCreateContext(Tests::CreateCompleteContext);
+
+    auto scene = MakeShared<Scene>(context);
+    for (unsigned i = 0; i < 1000; ++i)
+    {
+        Node* node = scene->CreateChild(Format("Node_{}", i));
+        node->SetPosition({ i * 1.0f, 0.0f, 0.0f });
+        node->SetVar("Index", i);
+        node->CreateChild("Child")->SetScale(2.0f);
+    }
+
+    VectorBuffer buffer;
+    {
+        JSONStreamOutputArchive archive{ context, buffer };
+        SerializeValue(archive, "Scene", *scene);
+        archive.Flush();
+    }
+
+    BENCHMARK("Save scene to JSONFile")
+    {
+        auto jsonFile = MakeShared<JSONFile>(context);
+        jsonFile->SaveObject(*scene);
+        VectorBuffer dest;
+        jsonFile->Save(dest);
+        return dest.GetSize();
+    };
+
+    BENCHMARK("Save scene to JSONStreamOutputArchive")
+    {
+        VectorBuffer dest;
+        JSONStreamOutputArchive archive{ context, dest };
+        SerializeValue(archive, "Scene", *scene);
+        archive.Flush();
+        return dest.GetSize();
+    };
+
+    BENCHMARK("Load scene from JSONFile")
+    {
+        auto jsonFile = MakeShared<JSONFile>(context);
+        MemoryBuffer source(buffer.GetBuffer());
+        jsonFile->Load(source);
+        auto loadedScene = MakeShared<Scene>(context);
+        jsonFile->LoadObject(*loadedScene);
+        return loadedScene->GetNumChildren();
+    };
+
+    BENCHMARK("Load scene from JSONDocument")
+    {
+        JSONDocument document;
+        MemoryBuffer source(buffer.GetBuffer());
+        document.Load(source);
+        auto loadedScene = MakeShared<Scene>(context);
+        JSONDocumentInputArchive archive{ context, document };
+        SerializeValue(archive, "Scene", *loadedScene);
+        return loadedScene->GetNumChildren();
+    };
+}
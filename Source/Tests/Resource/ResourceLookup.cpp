@@ -0,0 +1,184 @@
+//
+// Copyright (c) 2021-2022 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "../CommonUtils.h"
+
+#include <Urho3D/Core/ProcessUtils.h>
+#include <Urho3D/Core/Timer.h>
+#include <Urho3D/Core/WorkQueue.h>
+#include <Urho3D/IO/File.h>
+#include <Urho3D/IO/FileSystem.h>
+#include <Urho3D/Resource/BinaryFile.h>
+#include <Urho3D/Resource/ResourceCache.h>
+#include <Urho3D/Resource/ResourceLookupTable.h>
+
+#include <atomic>
+
+namespace
+{
+
+ea::vector<ea::string> AddManualResources(Context* context, unsigned count)
+{
+    auto cache = context->GetSubsystem<ResourceCache>();
+
+    ea::vector<ea::string> names;
+    for (unsigned i = 0; i < count; ++i)
+    {
+        auto resource = MakeShared<BinaryFile>(context);
+        resource->SetName(Format("ResourceLookup/{}.bin", i));
+        REQUIRE(cache->AddManualResource(resource));
+        names.push_back(resource->GetName());
+    }
+    return names;
+}
+
+void ReleaseManualResources(Context* context, const ea::vector<ea::string>& names)
+{
+    auto cache = context->GetSubsystem<ResourceCache>();
+    for (const ea::string& name : names)
+        cache->ReleaseResource(BinaryFile::GetTypeStatic(), name, true);
+}
+
+}
+
+TEST_CASE("Resource lookup table finds resources by type and name")
+{
+    auto context = Tests::GetOrCreateContext(Tests::CreateCompleteContext);
+    auto resourceA = MakeShared<BinaryFile>(context);
+    auto resourceB = MakeShared<BinaryFile>(context);
+
+    ResourceLookupTable table;
+    table.Add("TypeA", "Name", resourceA.Get());
+    table.Add("TypeB", "Name", resourceB.Get());
+
+    CHECK(table.Find("TypeA", "Name") == resourceA.Get());
+    CHECK(table.Find("TypeB", "Name") == resourceB.Get());
+    CHECK(table.Find("TypeC", "Name") == nullptr);
+    CHECK(table.Find("Name") != nullptr);
+    CHECK(table.Find("OtherName") == nullptr);
+
+    table.Add("TypeA", "Name", resourceB.Get());
+    CHECK(table.Find("TypeA", "Name") == resourceB.Get());
+
+    table.Remove("TypeA", "Name");
+    CHECK(table.Find("TypeA", "Name") == nullptr);
+    CHECK(table.Find("TypeB", "Name") == resourceB.Get());
+    CHECK(table.Find("Name") == resourceB.Get());
+
+    table.Clear();
+    CHECK(table.Find("TypeB", "Name") == nullptr);
+}
+
+TEST_CASE("Existing resources are found and requested from worker threads")
+{
+    auto context = Tests::GetOrCreateContext(Tests::CreateCompleteContext);
+    auto cache = context->GetSubsystem<ResourceCache>();
+    auto workQueue = MakeShared<WorkQueue>(context);
+    workQueue->CreateThreads(ea::max(2u, GetNumLogicalCPUs() - 1));
+
+    const ea::vector<ea::string> names = AddManualResources(context, 256);
+
+    std::atomic<unsigned> numFound{};
+    ForEachParallel(workQueue, 16, names.size(),
+        [&](unsigned beginIndex, unsigned endIndex)
+    {
+        for (unsigned i = beginIndex; i < endIndex; ++i)
+        {
+            if (cache->GetExistingResource<BinaryFile>(names[i]))
+                ++numFound;
+        }
+    });
+    CHECK(numFound == names.size());
+
+    // Released resources are not found anymore
+    ReleaseManualResources(context, names);
+    CHECK_FALSE(cache->GetExistingResource<BinaryFile>(names[0]));
+
+    // Missing resource is requested from worker threads and loaded once in background
+    auto fileSystem = context->GetSubsystem<FileSystem>();
+    const ea::string resourceDir = fileSystem->GetTemporaryDir() + "ResourceLookup/";
+    fileSystem->CreateDirsRecursive(resourceDir);
+    {
+        File file(context, resourceDir + "Requested.bin", FILE_WRITE);
+        REQUIRE(file.WriteUInt(42));
+    }
+    cache->AddResourceDir(resourceDir);
+
+    std::atomic<unsigned> numRequestedFound{};
+    ForEachParallel(workQueue, 1u, 64u,
+        [&](unsigned beginIndex, unsigned endIndex)
+    {
+        for (unsigned i = beginIndex; i < endIndex; ++i)
+        {
+            if (cache->GetOrRequestResource<BinaryFile>("Requested.bin"))
+                ++numRequestedFound;
+        }
+    });
+
+    BinaryFile* requestedResource = nullptr;
+    Timer timer;
+    while (!requestedResource && timer.GetMSec(false) < 10000)
+    {
+        Tests::RunFrame(context, 0.01f);
+        requestedResource = cache->GetExistingResource<BinaryFile>("Requested.bin");
+    }
+    REQUIRE(requestedResource);
+    CHECK(requestedResource->GetData().size() == sizeof(unsigned));
+    CHECK(cache->GetOrRequestResource<BinaryFile>("Requested.bin") == requestedResource);
+
+    cache->ReleaseResource(BinaryFile::GetTypeStatic(), "Requested.bin", true);
+    cache->RemoveResourceDir(resourceDir);
+}
+
+TEST_CASE("Resource lookup benchmark", "[.benchmark]")
+{
+    auto context = Tests::GetOrCreateContext(Tests::CreateCompleteContext);
+    auto cache = context->GetSubsystem<ResourceCache>();
+    auto workQueue = MakeShared<WorkQueue>(context);
+    workQueue->CreateThreads(ea::max(1u, GetNumLogicalCPUs() - 1));
+
+    const ea::vector<ea::string> names = AddManualResources(context, 4096);
+
+    BENCHMARK("Lookup on main thread")
+    {
+        unsigned numFound = 0;
+        for (const ea::string& name : names)
+            numFound += !!cache->GetExistingResource<BinaryFile>(name);
+        return numFound;
+    };
+
+    BENCHMARK("Parallel lookup")
+    {
+        std::atomic<unsigned> numFound{};
+        ForEachParallel(workQueue, 64, names.size(),
+            [&](unsigned beginIndex, unsigned endIndex)
+        {
+            unsigned numFoundLocal = 0;
+            for (unsigned i = beginIndex; i < endIndex; ++i)
+                numFoundLocal += !!cache->GetExistingResource<BinaryFile>(names[i]);
+            numFound += numFoundLocal;
+        });
+        return numFound.load();
+    };
+
+    ReleaseManualResources(context, names);
+}
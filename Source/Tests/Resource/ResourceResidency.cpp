@@ -0,0 +1,173 @@
+//
+// Copyright (c) 2021-2022 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "../CommonUtils.h"
+
+#include <Urho3D/Core/Timer.h>
+#include <Urho3D/IO/File.h>
+#include <Urho3D/IO/FileSystem.h>
+#include <Urho3D/Resource/BinaryFile.h>
+#include <Urho3D/Resource/ResourceCache.h>
+#include <Urho3D/Resource/ResourceHandle.h>
+
+namespace
+{
+
+struct ResidencyFixture
+{
+    explicit ResidencyFixture(Context* context)
+        : cache_(context->GetSubsystem<ResourceCache>())
+    {
+        auto fileSystem = context->GetSubsystem<FileSystem>();
+        resourceDir_ = fileSystem->GetTemporaryDir() + "ResourceResidency/";
+        fileSystem->RemoveDir(resourceDir_, true);
+        fileSystem->CreateDirsRecursive(resourceDir_);
+
+        const ByteVector data(1000, 0xab);
+        for (const char* name : {"A.bin", "B.bin", "C.bin", "D.bin"})
+        {
+            File file(context, resourceDir_ + name, FILE_WRITE);
+            REQUIRE(file.Write(data.data(), data.size()) == data.size());
+        }
+
+        // Only resources of this test should be evictable
+        cache_->ReleaseAllResources();
+        cache_->AddResourceDir(resourceDir_);
+        cache_->ResetResidencyStats();
+    }
+
+    ~ResidencyFixture()
+    {
+        cache_->SetResidencyBudget(0, 0);
+        cache_->SetResidencyMinUnusedFrames(60);
+        cache_->ResetResidencyStats();
+        for (const char* name : {"A.bin", "B.bin", "C.bin", "D.bin"})
+            cache_->ReleaseResource(BinaryFile::GetTypeStatic(), name, true);
+        cache_->RemoveResourceDir(resourceDir_);
+    }
+
+    ResourceCache* cache_{};
+    ea::string resourceDir_;
+};
+
+}
+
+TEST_CASE("Least recently used resources are evicted over residency budget and reloaded on demand")
+{
+    auto context = Tests::GetOrCreateContext(Tests::CreateCompleteContext);
+    ResidencyFixture fixture(context);
+    ResourceCache* cache = fixture.cache_;
+
+    // Load resources in different frames so they are ordered by last use
+    ea::vector<ResourceHandle<BinaryFile>> handles;
+    unsigned long long resourceMemory = 0;
+    for (const char* name : {"A.bin", "B.bin", "C.bin", "D.bin"})
+    {
+        handles.emplace_back(cache, name);
+        BinaryFile* resource = handles.back().GetOrLoad();
+        REQUIRE(resource);
+        resourceMemory = resource->GetMemoryUse();
+        Tests::RunFrame(context, 0.01f);
+    }
+    const unsigned long long baseMemory = cache->GetTotalMemoryUse() - 4 * resourceMemory;
+
+    // Keep two resources under soft budget and three under hard budget
+    cache->SetResidencyMinUnusedFrames(2);
+    cache->SetResidencyBudget(baseMemory + resourceMemory * 5 / 2, baseMemory + resourceMemory * 7 / 2);
+    Tests::RunFrame(context, 0.01f);
+
+    CHECK(cache->GetResidencyStats().numHardEvictions_ == 1);
+    CHECK(cache->GetResidencyStats().numSoftEvictions_ == 1);
+    CHECK(cache->GetResidencyStats().evictedMemory_ == resourceMemory * 2);
+    CHECK(cache->GetResidencyStats().memoryUse_ == baseMemory + resourceMemory * 2);
+    CHECK_FALSE(cache->GetExistingResource<BinaryFile>("A.bin"));
+    CHECK_FALSE(cache->GetExistingResource<BinaryFile>("B.bin"));
+    CHECK(handles[2].IsResident());
+    CHECK(handles[3].IsResident());
+
+    // Evicted resource is loaded in background on next use
+    CHECK_FALSE(handles[0].Get());
+    CHECK_FALSE(handles[0].IsResident());
+
+    BinaryFile* reloadedResource = nullptr;
+    Timer timer;
+    while (!reloadedResource && timer.GetMSec(false) < 10000)
+    {
+        REQUIRE(handles[2].Get());
+        REQUIRE(handles[3].Get());
+        Tests::RunFrame(context, 0.01f);
+        reloadedResource = handles[0].Get();
+    }
+    REQUIRE(reloadedResource);
+    CHECK(reloadedResource->GetData().size() == 1000);
+    CHECK(cache->GetResidencyStats().numReloads_ == 1);
+
+    // Recently used resources are kept over soft budget
+    for (unsigned i = 0; i < 3; ++i)
+    {
+        REQUIRE(handles[0].Get());
+        REQUIRE(handles[2].Get());
+        REQUIRE(handles[3].Get());
+        Tests::RunFrame(context, 0.01f);
+    }
+    CHECK(cache->GetResidencyStats().numSoftEvictions_ == 1);
+    CHECK(cache->GetResidencyStats().memoryUse_ == baseMemory + resourceMemory * 3);
+
+    // Resource is evicted once it stays unused long enough
+    for (unsigned i = 0; i < 3; ++i)
+    {
+        REQUIRE(handles[0].Get());
+        REQUIRE(handles[3].Get());
+        Tests::RunFrame(context, 0.01f);
+    }
+    CHECK(cache->GetResidencyStats().numSoftEvictions_ == 2);
+    CHECK_FALSE(handles[2].IsResident());
+    CHECK(handles[0].IsResident());
+    CHECK(handles[3].IsResident());
+    CHECK_FALSE(cache->PrintResidencyStats().empty());
+}
+
+TEST_CASE("Resources referenced outside of resource cache are not evicted")
+{
+    auto context = Tests::GetOrCreateContext(Tests::CreateCompleteContext);
+    ResidencyFixture fixture(context);
+    ResourceCache* cache = fixture.cache_;
+
+    SharedPtr<BinaryFile> usedResource{cache->GetResource<BinaryFile>("A.bin")};
+    ResourceHandle<BinaryFile> unusedHandle(cache->GetResource<BinaryFile>("B.bin"));
+    REQUIRE(usedResource);
+    REQUIRE(unusedHandle.IsResident());
+
+    cache->SetResidencyBudget(0, 1);
+    Tests::RunFrame(context, 0.01f);
+    Tests::RunFrame(context, 0.01f);
+
+    CHECK(cache->GetExistingResource<BinaryFile>("A.bin") == usedResource);
+    CHECK(usedResource->GetLastUsedFrame() == cache->GetCurrentFrame());
+    CHECK_FALSE(unusedHandle.IsResident());
+    CHECK(cache->GetResidencyStats().numHardEvictions_ == 1);
+    CHECK(cache->GetResidencyStats().numFramesOverHardBudget_ == 2);
+    CHECK(cache->GetResidencyStats().evictableMemoryUse_ == 0);
+
+    REQUIRE(unusedHandle.GetOrLoad());
+    CHECK(cache->GetResidencyStats().numReloads_ == 1);
+}
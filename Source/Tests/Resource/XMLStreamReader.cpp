@@ -0,0 +1,219 @@
+//
+// Copyright (c) 2021-2022 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "../CommonUtils.h"
+
+#include <Urho3D/IO/ArchiveSerialization.h>
+#include <Urho3D/IO/MemoryBuffer.h>
+#include <Urho3D/IO/VectorBuffer.h>
+#include <Urho3D/Resource/XMLArchive.h>
+#include <Urho3D/Resource/XMLFile.h>
+#include <Urho3D/Resource/XMLStreamReader.h>
+#include <Urho3D/Scene/Scene.h>
+
+namespace
+{
+
+const char* testXML = R"(<?xml version="1.0"?>
+<!DOCTYPE root [ <!ELEMENT root ANY> ]>
+<!-- Comment before root -->
+<root name="Root" quote='"&lt;&amp;&gt;"' code="&#65;&#x42;">
+    <empty />
+    <text>Line &amp; <![CDATA[<raw>]]></text>
+    <!-- Comment inside root -->
+    <nested a="1" b="2"><child value="3"/><child value="4"/></nested>
+    <last/>
+</root>
+)";
+
+ea::vector<ea::string> ReadEvents(XMLStreamReader& reader)
+{
+    ea::vector<ea::string> events;
+    while (true)
+    {
+        switch (reader.Next())
+        {
+        case XMLStreamEvent::StartElement:
+            events.push_back(Format("<{}>", reader.GetName()));
+            break;
+        case XMLStreamEvent::EndElement:
+            events.push_back(Format("</{}>", reader.GetName()));
+            break;
+        case XMLStreamEvent::Text:
+            events.push_back(reader.GetText());
+            break;
+        default:
+            return events;
+        }
+    }
+}
+
+}
+
+TEST_CASE("XML stream reader produces events")
+{
+    // Small chunks make sure that tokens crossing chunk boundaries are handled
+    for (const unsigned chunkSize : {64u, XMLStreamReader::DefaultChunkSize})
+    {
+        MemoryBuffer source(testXML, strlen(testXML));
+        XMLStreamReader reader(source, chunkSize);
+
+        REQUIRE(reader.Next() == XMLStreamEvent::StartElement);
+        CHECK(reader.GetName() == "root");
+        CHECK(reader.GetNameHash() == StringHash("root"));
+        CHECK(reader.GetDepth() == 1);
+        REQUIRE(reader.GetNumAttributes() == 3);
+        CHECK(reader.GetAttributeName(0) == "name");
+        CHECK(reader.GetAttributeNameHash(1) == StringHash("quote"));
+        CHECK(ea::string(reader.FindAttribute("name")) == "Root");
+        CHECK(ea::string(reader.FindAttribute("quote")) == "\"<&>\"");
+        CHECK(ea::string(reader.FindAttribute("code")) == "AB");
+        CHECK(reader.FindAttribute("missing") == nullptr);
+
+        const auto events = ReadEvents(reader);
+        const ea::vector<ea::string> expectedEvents{
+            "<empty>", "</empty>",
+            "<text>", "Line & ", "<raw>", "</text>",
+            "<nested>", "<child>", "</child>", "<child>", "</child>", "</nested>",
+            "<last>", "</last>",
+            "</root>"};
+        CHECK(events == expectedEvents);
+        CHECK(reader.GetEvent() == XMLStreamEvent::EndDocument);
+        CHECK(reader.GetDepth() == 0);
+    }
+}
+
+TEST_CASE("XML stream reader skips elements and restores position")
+{
+    MemoryBuffer source(testXML, strlen(testXML));
+    XMLStreamReader reader(source, 64);
+
+    REQUIRE(reader.Next() == XMLStreamEvent::StartElement);
+    REQUIRE(reader.Next() == XMLStreamEvent::StartElement);
+    REQUIRE(reader.GetName() == "empty");
+
+    const XMLStreamPosition emptyPosition = reader.SavePosition();
+    REQUIRE(reader.SkipElement());
+    CHECK(reader.GetEvent() == XMLStreamEvent::EndElement);
+    CHECK(reader.GetName() == "empty");
+
+    REQUIRE(reader.Next() == XMLStreamEvent::StartElement);
+    REQUIRE(reader.Next() == XMLStreamEvent::Text);
+    REQUIRE(reader.Next() == XMLStreamEvent::Text);
+    REQUIRE(reader.Next() == XMLStreamEvent::EndElement);
+
+    REQUIRE(reader.Next() == XMLStreamEvent::StartElement);
+    REQUIRE(reader.GetName() == "nested");
+    CHECK(ea::string(reader.FindAttribute("b")) == "2");
+
+    const XMLStreamPosition nestedPosition = reader.SavePosition();
+    REQUIRE(reader.SkipElement());
+    CHECK(reader.GetName() == "nested");
+    CHECK(reader.GetDepth() == 1);
+
+    REQUIRE(reader.RestorePosition(nestedPosition));
+    CHECK(reader.GetEvent() == XMLStreamEvent::StartElement);
+    CHECK(reader.GetName() == "nested");
+    CHECK(reader.GetDepth() == 2);
+    CHECK(ea::string(reader.FindAttribute("a")) == "1");
+    REQUIRE(reader.Next() == XMLStreamEvent::StartElement);
+    CHECK(ea::string(reader.FindAttribute("value")) == "3");
+
+    REQUIRE(reader.RestorePosition(emptyPosition));
+    CHECK(reader.GetName() == "empty");
+    CHECK(reader.GetDepth() == 2);
+    REQUIRE(reader.Next() == XMLStreamEvent::EndElement);
+    CHECK(reader.GetName() == "empty");
+}
+
+TEST_CASE("XML stream reader reports malformed documents")
+{
+    const char* malformedDocuments[] = {
+        "",
+        "<root>",
+        "<root></other>",
+        "<root attribute=value/>",
+        "<root attribute=\"&unknown;\"/>",
+        "<root/><second/>",
+        "<root><!-- unterminated </root>",
+    };
+
+    for (const char* document : malformedDocuments)
+    {
+        MemoryBuffer source(document, strlen(document));
+        XMLStreamReader reader(source);
+        while (reader.Next() != XMLStreamEvent::Error)
+            REQUIRE(reader.GetEvent() != XMLStreamEvent::EndDocument);
+        CHECK_FALSE(reader.GetError().empty());
+    }
+}
+
+TEST_CASE("XML stream archive benchmark", "[.benchmark]")
+{
+    auto context = Tests::GetOrCreateContext(Tests::CreateCompleteContext);
+
+    auto scene = MakeShared<Scene>(context);
+    for (unsigned i = 0; i < 1000; ++i)
+    {
+        Node* node = scene->CreateChild(Format("Node_{}", i));
+        node->SetPosition({ i * 1.0f, 0.0f, 0.0f });
+        node->SetVar("Index", i);
+        node->CreateChild("Child")->SetScale(2.0f);
+    }
+
+    VectorBuffer buffer;
+    {
+        auto xmlFile = MakeShared<XMLFile>(context);
+        xmlFile->SaveObject(*scene);
+        xmlFile->Save(buffer);
+    }
+
+    BENCHMARK("Load scene from XMLFile")
+    {
+        auto xmlFile = MakeShared<XMLFile>(context);
+        MemoryBuffer source(buffer.GetBuffer());
+        xmlFile->Load(source);
+        auto loadedScene = MakeShared<Scene>(context);
+        xmlFile->LoadObject(*loadedScene);
+        return loadedScene->GetNumChildren();
+    };
+
+    BENCHMARK("Load scene from XMLStreamInputArchive")
+    {
+        MemoryBuffer source(buffer.GetBuffer());
+        XMLStreamInputArchive archive{ context, source };
+        auto loadedScene = MakeShared<Scene>(context);
+        SerializeValue(archive, "Scene", *loadedScene);
+        return loadedScene->GetNumChildren();
+    };
+
+    BENCHMARK("Read all events with XMLStreamReader")
+    {
+        MemoryBuffer source(buffer.GetBuffer());
+        XMLStreamReader reader(source);
+        unsigned numElements = 0;
+        XMLStreamEvent event{};
+        while ((event = reader.Next()) != XMLStreamEvent::EndDocument && event != XMLStreamEvent::Error)
+            numElements += event == XMLStreamEvent::StartElement;
+        return numElements;
+    };
+}
@@ -29,6 +29,7 @@
 #include <Urho3D/Graphics/Camera.h>
 #include <Urho3D/Graphics/Octree.h>
 #include <Urho3D/Scene/Scene.h>
+#include <Urho3D/Scene/SceneEvents.h>
 #include <Urho3D/Resource/ResourceCache.h>
 #include <Urho3D/UI/Text3D.h>
 
@@ -562,3 +563,267 @@ TEST_CASE("Variant animation tracks")
     REQUIRE(childNodeText->GetFontSize() == 27.0f);
     REQUIRE(childNodeText->GetText() == "B");
 }
+
+TEST_CASE("Nodeless skeleton animation")
+{
+    auto context = Tests::GetOrCreateContext(Tests::CreateCompleteContext);
+    auto cache = context->GetSubsystem<ResourceCache>();
+
+    auto model = Tests::CreateSkinnedQuad_Model(context)->ExportModel("@/SkinnedQuad.mdl");
+    cache->AddManualResource(model);
+
+    auto animationRotate = Tests::CreateLoopedRotationAnimation(context,
+        "Tests/Rotate.ani", "Quad 1", Vector3::UP, 2.0f);
+    auto animationTranslateX = Tests::CreateLoopedTranslationAnimation(context,
+        "Tests/TranslateX.ani", "Quad 2", { 0.0f, 1.0f, 0.0f }, { 1.0f, 0.0f, 0.0f }, 2.0f);
+    auto animationTranslateZ = Tests::CreateLoopedTranslationAnimation(context,
+        "Tests/TranslateZ.ani", "Quad 2", { 0.0f, 1.0f, 0.0f }, { 0.0f, 0.0f, 2.0f }, 2.0f);
+
+    cache->AddManualResource(animationRotate);
+    cache->AddManualResource(animationTranslateX);
+    cache->AddManualResource(animationTranslateZ);
+
+    // Setup
+    auto scene = MakeShared<Scene>(context);
+    scene->CreateComponent<Octree>();
+
+    auto node = scene->CreateChild("Node");
+    node->SetPosition({ 0.0f, 0.0f, 10.0f });
+    auto animatedModel = node->CreateComponent<AnimatedModel>();
+    animatedModel->SetNodelessSkeleton(true);
+    animatedModel->SetModel(model);
+    REQUIRE(node->GetNumChildren() == 0);
+
+    auto referenceNode = scene->CreateChild("Reference Node");
+    referenceNode->SetPosition({ 0.0f, 0.0f, 10.0f });
+    auto referenceModel = referenceNode->CreateComponent<AnimatedModel>();
+    referenceModel->SetModel(model);
+
+    for (Node* animatedNode : { node, referenceNode })
+    {
+        auto animationController = animatedNode->CreateComponent<AnimationController>();
+        animationController->Play("Tests/Rotate.ani", 0, true);
+        animationController->Play("Tests/TranslateX.ani", 0, true);
+        animationController->Play("Tests/TranslateZ.ani", 1, true);
+        animationController->SetWeight("Tests/TranslateZ.ani", 0.75f);
+    }
+
+    // Only explicitly requested bone is backed by node
+    Node* boneNode = animatedModel->CreateBoneNode("Quad 2");
+    REQUIRE(boneNode);
+    REQUIRE(boneNode->GetParent() == node);
+    REQUIRE(node->GetNumChildren() == 1);
+    REQUIRE(animatedModel->CreateBoneNode("Quad 2") == boneNode);
+
+    Tests::NodeRef quad2{ scene, "Quad 2" };
+    Tests::ComponentRef<AnimatedModel> nodelessModelRef{ scene, "Node" };
+    Tests::ComponentRef<AnimatedModel> referenceModelRef{ scene, "Reference Node" };
+
+    // Time 0.5: Translate X to -1 * 25%, Translate Z to -2 * 75%, Rotate 90 degrees (X to -Z, Z to X)
+    Tests::RunFrame(context, 0.5f, 0.05f);
+    REQUIRE(quad2->GetWorldPosition().Equals({ -1.5f, 1.0f, 10.25f }, M_LARGE_EPSILON));
+    REQUIRE(nodelessModelRef->GetBoneModelTransforms()[2].Translation().Equals({ -1.5f, 1.0f, 0.25f }, M_LARGE_EPSILON));
+    REQUIRE(nodelessModelRef->GetWorldBoundingBox().min_.Equals(referenceModelRef->GetWorldBoundingBox().min_, M_LARGE_EPSILON));
+    REQUIRE(nodelessModelRef->GetWorldBoundingBox().max_.Equals(referenceModelRef->GetWorldBoundingBox().max_, M_LARGE_EPSILON));
+
+    // Time 1.0: Translate X to 0 * 25%, Translate Z to 0 * 75%, Rotate 180 degrees (X to -X, Z to -Z)
+    Tests::SerializeAndDeserializeScene(scene);
+    Tests::RunFrame(context, 0.5f, 0.05f);
+    REQUIRE(quad2->GetWorldPosition().Equals({ 0.0f, 1.0f, 10.0f }, M_LARGE_EPSILON));
+    REQUIRE(nodelessModelRef->IsNodelessSkeleton());
+    REQUIRE(nodelessModelRef->GetWorldBoundingBox().min_.Equals(referenceModelRef->GetWorldBoundingBox().min_, M_LARGE_EPSILON));
+    REQUIRE(nodelessModelRef->GetWorldBoundingBox().max_.Equals(referenceModelRef->GetWorldBoundingBox().max_, M_LARGE_EPSILON));
+
+    // Time 1.5: Moving the model node moves the bone node as well
+    Tests::NodeRef{ scene, "Node" }->SetPosition(Vector3::ZERO);
+    Tests::RunFrame(context, 0.5f, 0.05f);
+    REQUIRE(quad2->GetWorldPosition().Equals({ -1.5f, 1.0f, 0.25f }, M_LARGE_EPSILON));
+
+    // Switch back to bone nodes
+    nodelessModelRef->SetNodelessSkeleton(false);
+    REQUIRE(nodelessModelRef->GetBoneModelTransforms().empty());
+    REQUIRE(nodelessModelRef->GetSkeleton().GetBone("Quad 1")->node_);
+}
+
+TEST_CASE("Nodeless skeletons share poses of identical animations")
+{
+    auto context = Tests::GetOrCreateContext(Tests::CreateCompleteContext);
+    auto cache = context->GetSubsystem<ResourceCache>();
+
+    auto model = Tests::CreateSkinnedQuad_Model(context)->ExportModel("@/SkinnedQuad.mdl");
+    cache->AddManualResource(model);
+
+    auto animationTranslateX = Tests::CreateLoopedTranslationAnimation(context,
+        "Tests/TranslateX.ani", "Quad 2", { 0.0f, 1.0f, 0.0f }, { 1.0f, 0.0f, 0.0f }, 2.0f);
+    cache->AddManualResource(animationTranslateX);
+
+    // Setup
+    auto scene = MakeShared<Scene>(context);
+    auto octree = scene->CreateComponent<Octree>();
+
+    ea::vector<AnimatedModel*> animatedModels;
+    for (unsigned i = 0; i < 3; ++i)
+    {
+        auto node = scene->CreateChild(Format("Node {}", i));
+        auto animatedModel = node->CreateComponent<AnimatedModel>();
+        animatedModel->SetNodelessSkeleton(true);
+        animatedModel->SetPoseCacheTimeStep(0.1f);
+        animatedModel->SetModel(model);
+        animatedModels.push_back(animatedModel);
+
+        auto animationController = node->CreateComponent<AnimationController>();
+        animationController->Play("Tests/TranslateX.ani", 0, true);
+        if (i == 2)
+            animationController->SetTime("Tests/TranslateX.ani", 1.0f);
+    }
+
+    // Time 0.55: sampled at 0.5, Translate X to -1
+    Tests::RunFrame(context, 0.55f, 0.05f);
+    REQUIRE(octree->GetAnimationPoseCache().GetNumPoses() == 2);
+    REQUIRE(octree->GetAnimationPoseCache().GetNumHits() == 1);
+
+    const Vector3 translation0 = animatedModels[0]->GetBoneModelTransforms()[2].Translation();
+    const Vector3 translation1 = animatedModels[1]->GetBoneModelTransforms()[2].Translation();
+    const Vector3 translation2 = animatedModels[2]->GetBoneModelTransforms()[2].Translation();
+    REQUIRE(translation0.Equals({ -1.0f, 1.0f, 0.0f }, M_LARGE_EPSILON));
+    REQUIRE(translation1.Equals(translation0));
+    REQUIRE(translation2.Equals({ 1.0f, 1.0f, 0.0f }, M_LARGE_EPSILON));
+}
+
+TEST_CASE("Nodeless skeleton pose is committed to bone nodes before drawable update is finished")
+{
+    auto context = Tests::GetOrCreateContext(Tests::CreateCompleteContext);
+    auto cache = context->GetSubsystem<ResourceCache>();
+
+    auto model = Tests::CreateSkinnedQuad_Model(context)->ExportModel("@/SkinnedQuad.mdl");
+    cache->AddManualResource(model);
+
+    auto animationTranslateX = Tests::CreateLoopedTranslationAnimation(context,
+        "Tests/TranslateX.ani", "Quad 2", { 0.0f, 1.0f, 0.0f }, { 1.0f, 0.0f, 0.0f }, 2.0f);
+    cache->AddManualResource(animationTranslateX);
+
+    // Setup
+    auto scene = MakeShared<Scene>(context);
+    scene->CreateComponent<Octree>();
+
+    auto node = scene->CreateChild("Node");
+    auto animatedModel = node->CreateComponent<AnimatedModel>();
+    animatedModel->SetNodelessSkeleton(true);
+    animatedModel->SetModel(model);
+
+    auto animationController = node->CreateComponent<AnimationController>();
+    animationController->Play("Tests/TranslateX.ani", 0, true);
+
+    auto attachmentNode = animatedModel->CreateBoneNode("Quad 2")->CreateChild("Attachment");
+    attachmentNode->SetPosition({ 0.0f, 0.0f, 1.0f });
+
+    Vector3 attachmentPosition;
+    scene->SubscribeToEvent(scene, E_SCENEDRAWABLEUPDATEFINISHED,
+        [&](StringHash, VariantMap&) { attachmentPosition = attachmentNode->GetWorldPosition(); });
+
+    // Time 0.5: Translate X to -1
+    Tests::RunFrame(context, 0.5f, 0.05f);
+    REQUIRE(attachmentPosition.Equals({ -1.0f, 1.0f, 1.0f }, M_LARGE_EPSILON));
+
+    // Time 1.5: Translate X to 1
+    Tests::RunFrame(context, 1.0f, 0.05f);
+    REQUIRE(attachmentPosition.Equals({ 1.0f, 1.0f, 1.0f }, M_LARGE_EPSILON));
+}
+
+TEST_CASE("Non-master model follows pose of nodeless master model")
+{
+    auto context = Tests::GetOrCreateContext(Tests::CreateCompleteContext);
+    auto cache = context->GetSubsystem<ResourceCache>();
+
+    auto model = Tests::CreateSkinnedQuad_Model(context)->ExportModel("@/SkinnedQuad.mdl");
+    cache->AddManualResource(model);
+
+    auto animationTranslateX = Tests::CreateLoopedTranslationAnimation(context,
+        "Tests/TranslateX.ani", "Quad 2", { 0.0f, 1.0f, 0.0f }, { 1.0f, 0.0f, 0.0f }, 2.0f);
+    cache->AddManualResource(animationTranslateX);
+
+    // Setup
+    auto scene = MakeShared<Scene>(context);
+    scene->CreateComponent<Octree>();
+
+    auto node = scene->CreateChild("Node");
+    node->SetPosition({ 0.0f, 0.0f, 10.0f });
+    auto masterModel = node->CreateComponent<AnimatedModel>();
+    masterModel->SetNodelessSkeleton(true);
+    masterModel->SetModel(model);
+
+    auto attachedModel = node->CreateComponent<AnimatedModel>();
+    attachedModel->SetModel(model);
+    REQUIRE(masterModel->IsMaster());
+    REQUIRE(!attachedModel->IsMaster());
+    REQUIRE(node->GetNumChildren() == 0);
+
+    auto animationController = node->CreateComponent<AnimationController>();
+    animationController->Play("Tests/TranslateX.ani", 0, true);
+
+    const FrameInfo frameInfo;
+    for (float expectedX : { -1.0f, 1.0f })
+    {
+        // Time 0.5: Translate X to -1, Time 1.5: Translate X to 1
+        Tests::RunFrame(context, expectedX < 0.0f ? 0.5f : 1.0f, 0.05f);
+        masterModel->UpdateGeometry(frameInfo);
+        attachedModel->UpdateGeometry(frameInfo);
+
+        const auto& masterSkinMatrices = masterModel->GetSkinMatrices();
+        const auto& attachedSkinMatrices = attachedModel->GetSkinMatrices();
+        REQUIRE(attachedSkinMatrices.size() == masterSkinMatrices.size());
+        for (unsigned i = 0; i < masterSkinMatrices.size(); ++i)
+            REQUIRE(attachedSkinMatrices[i].Equals(masterSkinMatrices[i]));
+
+        const Matrix3x4 boneWorldTransform = attachedSkinMatrices[2] * attachedModel->GetSkeleton().GetBone("Quad 2")->offsetMatrix_.Inverse();
+        REQUIRE(boneWorldTransform.Translation().Equals({ expectedX, 1.0f, 10.0f }, M_LARGE_EPSILON));
+    }
+}
+
+TEST_CASE("Node hierarchy animations of many controllers are sampled in parallel")
+{
+    auto context = Tests::GetOrCreateContext(Tests::CreateCompleteContext);
+    auto cache = context->GetSubsystem<ResourceCache>();
+
+    auto animationRotate = Tests::CreateLoopedRotationAnimation(context,
+        "Tests/Rotate.ani", "Quad 2", Vector3::UP, 2.0f);
+    auto animationTranslateX = Tests::CreateLoopedTranslationAnimation(context,
+        "Tests/TranslateX.ani", "Quad 2", { 0.0f, 1.0f, 0.0f }, { 1.0f, 0.0f, 0.0f }, 2.0f);
+    cache->AddManualResource(animationRotate);
+    cache->AddManualResource(animationTranslateX);
+
+    // Setup
+    auto scene = MakeShared<Scene>(context);
+    scene->CreateComponent<Octree>();
+
+    static const unsigned numNodes = 16;
+    ea::vector<Node*> animatedNodes;
+    for (unsigned i = 0; i < numNodes; ++i)
+    {
+        auto node = scene->CreateChild(Format("Node {}", i));
+        node->SetPosition({ 10.0f * i, 0.0f, 0.0f });
+        animatedNodes.push_back(node->CreateChild("Quad 2"));
+
+        auto animationController = node->CreateComponent<AnimationController>();
+        animationController->Play("Tests/TranslateX.ani", 0, true);
+        animationController->Play("Tests/Rotate.ani", 1, true);
+    }
+
+    // Time 0.5: Translate X to -1, Rotate 90 degrees
+    Tests::RunFrame(context, 0.5f, 0.05f);
+    for (unsigned i = 0; i < numNodes; ++i)
+    {
+        Node* node = animatedNodes[i];
+        REQUIRE(node->GetWorldPosition().Equals({ 10.0f * i - 1.0f, 1.0f, 0.0f }, M_LARGE_EPSILON));
+        REQUIRE(node->GetWorldRotation().Equivalent(Quaternion{ 90.0f, Vector3::UP }, M_LARGE_EPSILON));
+    }
+
+    // Time 1.5: Translate X to 1, Rotate 270 degrees
+    Tests::RunFrame(context, 1.0f, 0.05f);
+    for (unsigned i = 0; i < numNodes; ++i)
+    {
+        Node* node = animatedNodes[i];
+        REQUIRE(node->GetWorldPosition().Equals({ 10.0f * i + 1.0f, 1.0f, 0.0f }, M_LARGE_EPSILON));
+        REQUIRE(node->GetWorldRotation().Equivalent(Quaternion{ 270.0f, Vector3::UP }, M_LARGE_EPSILON));
+    }
+}
@@ -0,0 +1,199 @@
+//
+// Copyright (c) 2021-2022 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "../CommonUtils.h"
+#include "../SceneUtils.h"
+
+#include <Urho3D/Container/ObjectPool.h>
+#include <Urho3D/Graphics/StaticModel.h>
+
+TEST_CASE("Object pool reuses freed memory")
+{
+    ObjectPool* pool = ObjectPool::GetOrCreate("ObjectPoolTestType", 40, 8, 4);
+    REQUIRE(pool);
+    CHECK(ObjectPool::GetOrCreate("ObjectPoolTestType", 40, 8) == pool);
+    CHECK(ObjectPool::GetOrCreate("ObjectPoolTestTypeTiny", 2, 2) == nullptr);
+
+    ea::vector<void*> blocks;
+    for (unsigned i = 0; i < 6; ++i)
+        blocks.push_back(pool->Allocate());
+
+    int localObject{};
+    CHECK(pool->IsOwned(blocks[0]));
+    CHECK(pool->IsOwned(blocks[5]));
+    CHECK_FALSE(pool->IsOwned(&localObject));
+
+    ObjectPoolStats stats = pool->GetStats();
+    CHECK(stats.numSlabs_ == 2);
+    CHECK(stats.capacity_ == 8);
+    CHECK(stats.numObjects_ == 6);
+
+    void* freedBlock = blocks[3];
+    pool->Free(freedBlock);
+    CHECK(pool->Allocate() == freedBlock);
+
+    for (void* block : blocks)
+        pool->Free(block);
+
+    stats = pool->GetStats();
+    CHECK(stats.numSlabs_ == 2);
+    CHECK(stats.numObjects_ == 0);
+    CHECK(stats.peakNumObjects_ == 6);
+    CHECK(stats.numAllocations_ == 7);
+}
+
+TEST_CASE("Object pool releases empty slabs on trim")
+{
+    ObjectPool* pool = ObjectPool::GetOrCreate("ObjectPoolTrimTestType", 24, 8, 4);
+    REQUIRE(pool);
+
+    ea::vector<void*> blocks;
+    for (unsigned i = 0; i < 12; ++i)
+        blocks.push_back(pool->Allocate());
+    CHECK(pool->GetStats().numSlabs_ == 3);
+    CHECK(pool->Trim() == 0);
+
+    // Free the first slab completely and the second one partially
+    for (unsigned i = 0; i < 6; ++i)
+        pool->Free(blocks[i]);
+    CHECK(pool->Trim() == 1);
+
+    ObjectPoolStats stats = pool->GetStats();
+    CHECK(stats.numSlabs_ == 2);
+    CHECK(stats.numObjects_ == 6);
+    for (unsigned i = 0; i < 4; ++i)
+        CHECK_FALSE(pool->IsOwned(blocks[i]));
+    for (unsigned i = 4; i < 12; ++i)
+        CHECK(pool->IsOwned(blocks[i]));
+
+    // Remaining free blocks are reused before new slab is allocated
+    void* block4 = pool->Allocate();
+    void* block5 = pool->Allocate();
+    CHECK(((block4 == blocks[4] && block5 == blocks[5]) || (block4 == blocks[5] && block5 == blocks[4])));
+    CHECK(pool->GetStats().numSlabs_ == 2);
+
+    for (unsigned i = 4; i < 12; ++i)
+        pool->Free(blocks[i]);
+    CHECK(ObjectPool::TrimAll() >= 2);
+    CHECK(pool->GetStats().numSlabs_ == 0);
+    CHECK(pool->GetStats().numObjects_ == 0);
+}
+
+TEST_CASE("Pooled nodes and components are allocated from object pool")
+{
+    auto context = Tests::GetOrCreateContext(Tests::CreateCompleteContext);
+    ObjectPool* nodePool = context->GetReflection<Node>()->GetObjectPool();
+    ObjectPool* staticModelPool = context->GetReflection<StaticModel>()->GetObjectPool();
+    REQUIRE(nodePool);
+    REQUIRE(staticModelPool);
+
+    auto scene = MakeShared<Scene>(context);
+    const unsigned numNodesBefore = nodePool->GetStats().numObjects_;
+
+    ea::vector<void*> nodeAddresses;
+    for (unsigned i = 0; i < 100; ++i)
+    {
+        Node* node = scene->CreateChild();
+        StaticModel* staticModel = node->CreateComponent<StaticModel>();
+        CHECK(nodePool->IsOwned(node));
+        CHECK(staticModelPool->IsOwned(staticModel));
+        nodeAddresses.push_back(node);
+    }
+    CHECK(nodePool->GetStats().numObjects_ == numNodesBefore + 100);
+
+    // Memory is reused after nodes are destroyed
+    const unsigned capacity = nodePool->GetStats().capacity_;
+    scene->RemoveAllChildren();
+    CHECK(nodePool->GetStats().numObjects_ == numNodesBefore);
+
+    for (unsigned i = 0; i < 100; ++i)
+    {
+        Node* node = scene->CreateChild();
+        CHECK(ea::find(nodeAddresses.begin(), nodeAddresses.end(), node) != nodeAddresses.end());
+    }
+    CHECK(nodePool->GetStats().capacity_ == capacity);
+
+    // Statistics are reported for all pools
+    const auto allStats = ObjectPool::GetAllStats();
+    const auto hasNodeStats = ea::any_of(allStats.begin(), allStats.end(),
+        [](const ObjectPoolStats& stats) { return stats.type_ == Node::GetTypeStatic() && stats.memoryUse_ > 0; });
+    CHECK(hasNodeStats);
+}
+
+TEST_CASE("Objects of pooled types created on heap are not returned to object pool")
+{
+    auto context = Tests::GetOrCreateContext(Tests::CreateCompleteContext);
+    ObjectPool* nodePool = context->GetReflection<Node>()->GetObjectPool();
+    REQUIRE(nodePool);
+
+    auto scene = MakeShared<Scene>(context);
+    scene->CreateChild();
+    const ObjectPoolStats statsBefore = nodePool->GetStats();
+
+    {
+        auto node = MakeShared<Node>(context);
+        CHECK_FALSE(nodePool->IsOwned(node.Get()));
+        CHECK(node->RefCountPtr()->objectPool_ == nullptr);
+    }
+
+    const ObjectPoolStats statsAfter = nodePool->GetStats();
+    CHECK(statsAfter.numObjects_ == statsBefore.numObjects_);
+    CHECK(statsAfter.capacity_ == statsBefore.capacity_);
+
+    Node* pooledNode = scene->CreateChild();
+    CHECK(pooledNode->RefCountPtr()->objectPool_ == nodePool);
+    scene->RemoveAllChildren();
+    CHECK(nodePool->GetStats().numObjects_ == statsBefore.numObjects_ - 1);
+}
+
+TEST_CASE("Object pool benchmark", "[.benchmark]")
+{
+    auto context = Tests::GetOrCreateContext(Tests::CreateCompleteContext);
+    auto scene = MakeShared<Scene>(context);
+
+    const auto spawnAndDestroy = [&]
+    {
+        for (unsigned i = 0; i < 1000; ++i)
+        {
+            Node* node = scene->CreateChild();
+            node->CreateComponent<StaticModel>();
+        }
+        scene->RemoveAllChildren();
+        return scene->GetNumChildren();
+    };
+
+    BENCHMARK("Spawn and destroy pooled objects")
+    {
+        return spawnAndDestroy();
+    };
+
+    context->GetReflection<Node>()->SetObjectFactory<Node>();
+    context->GetReflection<StaticModel>()->SetObjectFactory<StaticModel>();
+
+    BENCHMARK("Spawn and destroy heap objects")
+    {
+        return spawnAndDestroy();
+    };
+
+    context->GetReflection<Node>()->SetPooledObjectFactory<Node>();
+    context->GetReflection<StaticModel>()->SetPooledObjectFactory<StaticModel>();
+}
@@ -0,0 +1,287 @@
+//
+// Copyright (c) 2021-2022 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "../CommonUtils.h"
+#include "../ModelUtils.h"
+#include "../SceneUtils.h"
+
+#include <Urho3D/Graphics/AnimatedModel.h>
+#include <Urho3D/Graphics/Model.h>
+#include <Urho3D/Graphics/Octree.h>
+#include <Urho3D/Graphics/StaticModel.h>
+#include <Urho3D/Resource/ResourceCache.h>
+#include <Urho3D/Resource/JSONFile.h>
+#include <Urho3D/Resource/XMLFile.h>
+#include <Urho3D/Scene/Prefab.h>
+#include <Urho3D/Scene/Scene.h>
+#include <Urho3D/Scene/SplinePath.h>
+#include <Urho3D/Scene/ValueAnimation.h>
+
+namespace
+{
+
+SharedPtr<Node> CreatePrefabNode(Scene* scene, unsigned numPoints)
+{
+    SharedPtr<Node> root{ scene->CreateChild("Prefab") };
+    root->AddTag("Projectile");
+    root->SetVar("Damage", 10);
+
+    auto splinePath = root->CreateComponent<SplinePath>();
+    splinePath->SetSpeed(2.0f);
+    splinePath->SetInterpolationMode(LINEAR_CURVE);
+
+    for (unsigned i = 0; i < numPoints; ++i)
+    {
+        Node* point = root->CreateChild(Format("Point {}", i));
+        point->SetPosition({ static_cast<float>(i), 0.0f, 0.0f });
+        splinePath->AddControlPoint(point);
+
+        auto staticModel = point->CreateComponent<StaticModel>();
+        staticModel->SetCastShadows(true);
+        staticModel->SetLightMask(0xff);
+
+        Node* nested = point->CreateChild(Format("Nested {}", i));
+        nested->SetScale(0.5f);
+        if (i == 0)
+            splinePath->SetControlledIdAttr(nested->GetID());
+    }
+
+    return root;
+}
+
+SharedPtr<JSONFile> ConvertNodeToJSONPrefab(Node* node)
+{
+    auto prefab = MakeShared<JSONFile>(node->GetContext());
+    node->SaveJSON(prefab->GetRoot());
+    return prefab;
+}
+
+bool IsIDAttribute(const AttributeInfo& attr)
+{
+    return !!(attr.mode_ & (AM_NODEID | AM_COMPONENTID | AM_NODEIDVECTOR));
+}
+
+ea::string GetReferencedNodeName(Scene* scene, const Variant& id)
+{
+    Node* node = scene->GetNode(id.GetUInt());
+    return node ? node->GetName() : "<null>";
+}
+
+void CheckEquivalentSerializables(const Serializable& lhs, const Serializable& rhs, Scene* scene)
+{
+    REQUIRE(lhs.GetType() == rhs.GetType());
+
+    const auto attributes = lhs.GetAttributes();
+    if (!attributes)
+        return;
+
+    for (unsigned i = 0; i < attributes->size(); ++i)
+    {
+        const AttributeInfo& attr = attributes->at(i);
+        // Network-only attributes like parent node ID are not part of prefab data
+        if (!(attr.mode_ & AM_FILE))
+            continue;
+
+        const Variant lhsValue = lhs.GetAttribute(i);
+        const Variant rhsValue = rhs.GetAttribute(i);
+        if (!IsIDAttribute(attr))
+        {
+            CHECK(lhsValue == rhsValue);
+        }
+        else if (attr.mode_ & AM_NODEIDVECTOR)
+        {
+            const VariantVector& lhsIDs = lhsValue.GetVariantVector();
+            const VariantVector& rhsIDs = rhsValue.GetVariantVector();
+            REQUIRE(lhsIDs.size() == rhsIDs.size());
+            if (!lhsIDs.empty())
+                CHECK(lhsIDs[0] == rhsIDs[0]);
+            for (unsigned j = 1; j < lhsIDs.size(); ++j)
+                CHECK(GetReferencedNodeName(scene, lhsIDs[j]) == GetReferencedNodeName(scene, rhsIDs[j]));
+        }
+        else if (attr.mode_ & AM_NODEID)
+        {
+            CHECK(GetReferencedNodeName(scene, lhsValue) == GetReferencedNodeName(scene, rhsValue));
+        }
+    }
+}
+
+void CheckEquivalentNodes(const Node& lhs, const Node& rhs, Scene* scene)
+{
+    CheckEquivalentSerializables(lhs, rhs, scene);
+    CHECK(lhs.GetWorldTransform().Equals(rhs.GetWorldTransform()));
+    CHECK(lhs.IsReplicated() == rhs.IsReplicated());
+
+    const auto& lhsComponents = lhs.GetComponents();
+    const auto& rhsComponents = rhs.GetComponents();
+    REQUIRE(lhsComponents.size() == rhsComponents.size());
+    for (unsigned i = 0; i < lhsComponents.size(); ++i)
+    {
+        CheckEquivalentSerializables(*lhsComponents[i], *rhsComponents[i], scene);
+        CHECK(lhsComponents[i]->IsReplicated() == rhsComponents[i]->IsReplicated());
+    }
+
+    const auto& lhsChildren = lhs.GetChildren();
+    const auto& rhsChildren = rhs.GetChildren();
+    REQUIRE(lhsChildren.size() == rhsChildren.size());
+    for (unsigned i = 0; i < lhsChildren.size(); ++i)
+        CheckEquivalentNodes(*lhsChildren[i], *rhsChildren[i], scene);
+}
+
+}
+
+TEST_CASE("Compiled prefab is instantiated the same way as XML and JSON prefabs")
+{
+    auto context = Tests::GetOrCreateContext(Tests::CreateCompleteContext);
+    auto scene = MakeShared<Scene>(context);
+
+    auto prefabNode = CreatePrefabNode(scene, 3);
+    auto xmlFile = Tests::ConvertNodeToPrefab(prefabNode);
+    auto jsonFile = ConvertNodeToJSONPrefab(prefabNode);
+    prefabNode->Remove();
+
+    auto xmlPrefab = MakeShared<Prefab>(context);
+    REQUIRE(xmlPrefab->LoadXML(xmlFile->GetRoot()));
+    REQUIRE(xmlPrefab->IsCompiled());
+    REQUIRE(xmlPrefab->GetNumNodes() == 7);
+    REQUIRE(xmlPrefab->GetNumComponents() == 4);
+
+    auto jsonPrefab = MakeShared<Prefab>(context);
+    REQUIRE(jsonPrefab->LoadJSON(jsonFile->GetRoot()));
+    REQUIRE(jsonPrefab->IsCompiled());
+
+    const Vector3 position{ 1.0f, 2.0f, 3.0f };
+    const Quaternion rotation{ 90.0f, Vector3::UP };
+
+    for (CreateMode mode : { REPLICATED, LOCAL })
+    {
+        Node* expectedXML = scene->InstantiateXML(xmlFile->GetRoot(), position, rotation, mode);
+        Node* actualXML = scene->Instantiate(xmlPrefab, position, rotation, mode);
+        REQUIRE(expectedXML);
+        REQUIRE(actualXML);
+        CheckEquivalentNodes(*expectedXML, *actualXML, scene);
+
+        Node* expectedJSON = scene->InstantiateJSON(jsonFile->GetRoot(), position, rotation, mode);
+        Node* actualJSON = scene->Instantiate(jsonPrefab, position, rotation, mode);
+        REQUIRE(expectedJSON);
+        REQUIRE(actualJSON);
+        CheckEquivalentNodes(*expectedJSON, *actualJSON, scene);
+
+        // Node references are resolved to the new instance
+        auto splinePath = actualXML->GetComponent<SplinePath>();
+        REQUIRE(splinePath);
+        REQUIRE(splinePath->GetControlledNode() == actualXML->GetChild("Nested 0", true));
+    }
+}
+
+TEST_CASE("Prefab with animations is instantiated from source data")
+{
+    auto context = Tests::GetOrCreateContext(Tests::CreateCompleteContext);
+    auto scene = MakeShared<Scene>(context);
+
+    auto prefabNode = CreatePrefabNode(scene, 1);
+    auto animation = MakeShared<ValueAnimation>(context);
+    animation->SetKeyFrame(0.0f, Vector3::ZERO);
+    animation->SetKeyFrame(1.0f, Vector3::ONE);
+    prefabNode->SetAttributeAnimation("Position", animation);
+
+    auto xmlFile = Tests::ConvertNodeToPrefab(prefabNode);
+    prefabNode->Remove();
+
+    auto prefab = MakeShared<Prefab>(context);
+    REQUIRE(prefab->LoadXML(xmlFile->GetRoot()));
+    REQUIRE_FALSE(prefab->IsCompiled());
+
+    Node* expected = scene->InstantiateXML(xmlFile->GetRoot(), Vector3::ZERO, Quaternion::IDENTITY);
+    Node* actual = scene->Instantiate(prefab, Vector3::ZERO, Quaternion::IDENTITY);
+    REQUIRE(expected);
+    REQUIRE(actual);
+    CheckEquivalentNodes(*expected, *actual, scene);
+    REQUIRE(actual->GetAttributeAnimation("Position"));
+}
+
+TEST_CASE("Compiled prefab with AnimatedModel reuses serialized bone nodes")
+{
+    auto context = Tests::GetOrCreateContext(Tests::CreateCompleteContext);
+    auto cache = context->GetSubsystem<ResourceCache>();
+
+    auto model = Tests::CreateSkinnedQuad_Model(context)->ExportModel("@/Tests/Prefab/SkinnedQuad.mdl");
+    cache->AddManualResource(model);
+
+    auto scene = MakeShared<Scene>(context);
+    scene->CreateComponent<Octree>();
+
+    SharedPtr<Node> prefabNode{ scene->CreateChild("Prefab") };
+    prefabNode->CreateComponent<AnimatedModel>()->SetModel(model);
+    REQUIRE(prefabNode->GetChildren(true).size() == 3);
+
+    auto xmlFile = Tests::ConvertNodeToPrefab(prefabNode);
+    prefabNode->Remove();
+
+    auto prefab = MakeShared<Prefab>(context);
+    REQUIRE(prefab->LoadXML(xmlFile->GetRoot()));
+    REQUIRE(prefab->IsCompiled());
+
+    Node* instance = scene->Instantiate(prefab, Vector3::ZERO, Quaternion::IDENTITY);
+    REQUIRE(instance);
+
+    // Bone nodes are not created twice
+    CHECK(instance->GetChildren(true).size() == 3);
+
+    auto animatedModel = instance->GetComponent<AnimatedModel>();
+    REQUIRE(animatedModel);
+    Skeleton& skeleton = animatedModel->GetSkeleton();
+    REQUIRE(skeleton.GetNumBones() == 3);
+    for (unsigned i = 0; i < skeleton.GetNumBones(); ++i)
+    {
+        const Bone* bone = skeleton.GetBone(i);
+        REQUIRE(bone->node_);
+        CHECK(bone->node_ == instance->GetChild(bone->name_, true));
+    }
+}
+
+TEST_CASE("Prefab instantiation benchmark", "[.benchmark]")
+{
+    auto context = Tests::GetOrCreateContext(Tests::CreateCompleteContext);
+    auto scene = MakeShared<Scene>(context);
+
+    auto prefabNode = CreatePrefabNode(scene, 10);
+    auto xmlFile = Tests::ConvertNodeToPrefab(prefabNode);
+    prefabNode->Remove();
+
+    auto prefab = MakeShared<Prefab>(context);
+    prefab->LoadXML(xmlFile->GetRoot());
+
+    BENCHMARK("InstantiateXML")
+    {
+        Node* node = scene->InstantiateXML(xmlFile->GetRoot(), Vector3::ZERO, Quaternion::IDENTITY);
+        node->Remove();
+        return node != nullptr;
+    };
+
+    BENCHMARK("Instantiate compiled prefab")
+    {
+        Node* node = scene->Instantiate(prefab, Vector3::ZERO, Quaternion::IDENTITY);
+        node->Remove();
+        return node != nullptr;
+    };
+}
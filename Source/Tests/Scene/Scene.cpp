@@ -23,7 +23,97 @@
 #include "../CommonUtils.h"
 #include "../SceneUtils.h"
 
+#include <Urho3D/Graphics/Material.h>
+#include <Urho3D/Graphics/Model.h>
 #include <Urho3D/Graphics/StaticModel.h>
+#include <Urho3D/IO/File.h>
+#include <Urho3D/IO/FileSystem.h>
+#include <Urho3D/Resource/ResourceCache.h>
+#include <Urho3D/Resource/XMLFile.h>
+#include <Urho3D/Scene/SplinePath.h>
+
+#include <random>
+
+namespace
+{
+
+class DirtyNotificationCounter : public Component
+{
+    URHO3D_OBJECT(DirtyNotificationCounter, Component);
+
+public:
+    using Component::Component;
+
+    void OnNodeSet(Node* node) override
+    {
+        if (node)
+            node->AddListener(this);
+    }
+
+    void OnMarkedDirty(Node* node) override { ++numNotifications_; }
+
+    unsigned numNotifications_{};
+};
+
+class DirtyNotificationMover : public Component
+{
+    URHO3D_OBJECT(DirtyNotificationMover, Component);
+
+public:
+    using Component::Component;
+
+    void OnNodeSet(Node* node) override
+    {
+        if (node)
+            node->AddListener(this);
+    }
+
+    void OnMarkedDirty(Node* node) override
+    {
+        if (!target_)
+            return;
+
+        // Evaluate the target so it becomes clean and is reported again when moved
+        target_->GetWorldPosition();
+        target_->Translate(Vector3::ONE);
+        target_ = nullptr;
+    }
+
+    WeakPtr<Node> target_;
+};
+
+void CreateRandomHierarchy(Scene* scene, unsigned numNodes, unsigned seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> value(-10.0f, 10.0f);
+    std::uniform_real_distribution<float> angle(-180.0f, 180.0f);
+
+    ea::vector<Node*> nodes{ scene };
+    for (unsigned i = 0; i < numNodes; ++i)
+    {
+        Node* parent = nodes[rng() % nodes.size()];
+        Node* node = parent->CreateChild(Format("Node_{}", i));
+        node->SetTransform({ value(rng), value(rng), value(rng) }, { angle(rng), angle(rng), angle(rng) },
+            { 1.0f + value(rng) * 0.05f, 1.0f, 1.0f - value(rng) * 0.05f });
+        nodes.push_back(node);
+    }
+}
+
+void CheckWorldTransforms(Node* expectedNode, Node* actualNode)
+{
+    REQUIRE(expectedNode->GetNumChildren() == actualNode->GetNumChildren());
+    for (unsigned i = 0; i < expectedNode->GetNumChildren(); ++i)
+    {
+        Node* expectedChild = expectedNode->GetChild(i);
+        Node* actualChild = actualNode->GetChild(i);
+        CHECK_FALSE(actualChild->IsDirty());
+        CHECK(actualChild->GetWorldTransform().Equals(expectedChild->GetWorldTransform()));
+        CHECK(actualChild->GetWorldRotation().Equals(expectedChild->GetWorldRotation()));
+        CheckWorldTransforms(expectedChild, actualChild);
+    }
+}
+
+}
 
 TEST_CASE("Scene lookup")
 {
@@ -55,3 +145,247 @@ TEST_CASE("Scene lookup")
     CHECK(Tests::GetAttributeValue(child20->FindComponentAttribute("@/Name")) == Variant(child20->GetName()));
     CHECK(Tests::GetAttributeValue(child20->FindComponentAttribute("@StaticModel/LOD Bias")) == Variant(1.0f));
 }
+
+TEST_CASE("Scene is loaded asynchronously from binary file")
+{
+    auto context = Tests::GetOrCreateContext(Tests::CreateCompleteContext);
+    auto fileSystem = context->GetSubsystem<FileSystem>();
+    auto cache = context->GetSubsystem<ResourceCache>();
+
+    const ea::string modelNames[] = {"Models/Box.mdl", "Models/Cone.mdl", "Models/Sphere.mdl", "Models/Torus.mdl"};
+
+    auto scene = MakeShared<Scene>(context);
+    for (unsigned i = 0; i < 32; ++i)
+    {
+        Node* child = scene->CreateChild(Format("Child_{}", i));
+        child->SetPosition({static_cast<float>(i), 0.0f, 0.0f});
+
+        // Components with resource references
+        auto staticModel = child->CreateComponent<StaticModel>();
+        staticModel->SetCastShadows(true);
+        staticModel->SetModel(cache->GetResource<Model>(modelNames[i % 4]));
+        staticModel->SetMaterial(cache->GetResource<Material>("Materials/DefaultGrey.xml"));
+
+        Node* nested = child->CreateChild("Nested", i % 2 ? LOCAL : REPLICATED);
+        nested->SetVar("Index", i);
+
+        // Reference node from another root-level child
+        auto splinePath = nested->CreateComponent<SplinePath>();
+        splinePath->SetControlledIdAttr(scene->GetChild(0u)->GetID());
+    }
+
+    const ea::string fileName = fileSystem->GetTemporaryDir() + "AsyncSceneLoading.bin";
+    {
+        File file(context, fileName, FILE_WRITE);
+        REQUIRE(file.IsOpen());
+        REQUIRE(scene->Save(file));
+    }
+
+    auto expectedXML = MakeShared<XMLFile>(context);
+    XMLElement expectedRoot = expectedXML->GetOrCreateRoot("scene");
+    scene->SaveXML(expectedRoot);
+
+    // Release models so they are requested again while the scene is deserialized
+    scene = nullptr;
+    for (const ea::string& modelName : modelNames)
+        cache->ReleaseResource(Model::GetTypeStatic(), modelName);
+
+    auto loadedScene = MakeShared<Scene>(context);
+    loadedScene->SetAsyncLoadingMs(1);
+    REQUIRE(loadedScene->LoadAsync(MakeShared<File>(context, fileName), LOAD_SCENE));
+
+    for (unsigned i = 0; i < 1000 && loadedScene->IsAsyncLoading(); ++i)
+        loadedScene->Update(0.0f);
+
+    REQUIRE_FALSE(loadedScene->IsAsyncLoading());
+    fileSystem->Delete(fileName);
+
+    auto actualXML = MakeShared<XMLFile>(context);
+    XMLElement actualRoot = actualXML->GetOrCreateRoot("scene");
+    loadedScene->SaveXML(actualRoot);
+    CHECK(expectedXML->ToString() == actualXML->ToString());
+
+    auto splinePath = loadedScene->GetChild("Child_3")->GetChild("Nested")->GetComponent<SplinePath>();
+    REQUIRE(splinePath);
+    CHECK(splinePath->GetControlledNode() == loadedScene->GetChild("Child_0"));
+
+    for (unsigned i = 0; i < 32; ++i)
+    {
+        auto staticModel = loadedScene->GetChild(Format("Child_{}", i))->GetComponent<StaticModel>();
+        REQUIRE(staticModel);
+        REQUIRE(staticModel->GetModel());
+        CHECK(staticModel->GetModel()->GetName() == modelNames[i % 4]);
+        REQUIRE(staticModel->GetMaterial());
+        CHECK(staticModel->GetMaterial()->GetName() == "Materials/DefaultGrey.xml");
+    }
+}
+
+TEST_CASE("Batched transform update matches lazy world transforms")
+{
+    auto context = Tests::GetOrCreateContext(Tests::CreateCompleteContext);
+
+    auto expectedScene = MakeShared<Scene>(context);
+    CreateRandomHierarchy(expectedScene, 500, 0);
+
+    auto scene = MakeShared<Scene>(context);
+    scene->SetBatchedTransformUpdate(true);
+    CreateRandomHierarchy(scene, 500, 0);
+
+    scene->Update(0.1f);
+    CheckWorldTransforms(expectedScene, scene);
+    CHECK(scene->GetTransformHierarchy().GetNumNodes() == 500);
+    CHECK(scene->GetTransformHierarchy().GetNumUpdatedNodes() == 500);
+
+    // Move some nodes, only them and their children should be updated
+    for (Scene* currentScene : { expectedScene.Get(), scene.Get() })
+    {
+        currentScene->GetChild("Node_10", true)->Translate({ 1.0f, 2.0f, 3.0f });
+        currentScene->GetChild("Node_200", true)->Rotate({ 30.0f, Vector3::UP });
+    }
+
+    scene->Update(0.1f);
+    CheckWorldTransforms(expectedScene, scene);
+    CHECK(scene->GetTransformHierarchy().GetNumUpdatedNodes() > 0);
+    CHECK(scene->GetTransformHierarchy().GetNumUpdatedNodes() < 500);
+
+    // Change hierarchy structure
+    for (Scene* currentScene : { expectedScene.Get(), scene.Get() })
+    {
+        currentScene->GetChild("Node_5", true)->Remove();
+        currentScene->GetChild("Node_300", true)->SetParent(currentScene->GetChild("Node_400", true));
+        currentScene->GetChild("Node_400", true)->SetScale(2.0f);
+    }
+
+    scene->UpdateTransforms();
+    CheckWorldTransforms(expectedScene, scene);
+    CHECK(scene->GetTransformHierarchy().GetNumNodes() < scene->GetNumChildren(true));
+
+    // Nothing is visited if nothing is dirty
+    scene->UpdateTransforms();
+    CHECK(scene->GetTransformHierarchy().GetNumNodes() == 0);
+    CHECK(scene->GetTransformHierarchy().GetNumUpdatedNodes() == 0);
+
+    // Nodes evaluated lazily between updates are handled too
+    for (Scene* currentScene : { expectedScene.Get(), scene.Get() })
+    {
+        Node* node = currentScene->GetChild("Node_20", true);
+        node->Translate({ 1.0f, 0.0f, 0.0f });
+        node->GetWorldPosition();
+        node->Translate({ 0.0f, 1.0f, 0.0f });
+        if (!node->GetChildren().empty())
+        {
+            node->GetChildren()[0]->GetWorldPosition();
+            node->GetChildren()[0]->Rotate({ 15.0f, Vector3::RIGHT });
+        }
+    }
+
+    scene->UpdateTransforms();
+    CheckWorldTransforms(expectedScene, scene);
+    CHECK(scene->GetTransformHierarchy().GetNumUpdatedNodes() > 0);
+    CHECK(scene->GetTransformHierarchy().GetNumUpdatedNodes() < scene->GetNumChildren(true));
+}
+
+TEST_CASE("Deferred dirty notification is sent once per sync point")
+{
+    auto context = Tests::GetOrCreateContext(Tests::CreateCompleteContext);
+    if (!context->IsReflected<DirtyNotificationCounter>())
+        context->RegisterFactory<DirtyNotificationCounter>();
+
+    auto scene = MakeShared<Scene>(context);
+    Node* parent = scene->CreateChild("Parent");
+    Node* child = parent->CreateChild("Child");
+    auto parentCounter = parent->CreateComponent<DirtyNotificationCounter>();
+    auto childCounter = child->CreateComponent<DirtyNotificationCounter>();
+
+    const auto moveTwice = [&]
+    {
+        child->GetWorldPosition();
+        parent->Translate(Vector3::ONE);
+        child->GetWorldPosition();
+        parent->Translate(Vector3::ONE);
+        child->Translate(Vector3::ONE);
+    };
+
+    // Every transform change is reported immediately by default
+    parentCounter->numNotifications_ = 0;
+    childCounter->numNotifications_ = 0;
+    moveTwice();
+    CHECK(parentCounter->numNotifications_ == 2);
+    CHECK(childCounter->numNotifications_ == 2);
+
+    // Deferred notifications are merged until sync point
+    parentCounter->numNotifications_ = 0;
+    childCounter->numNotifications_ = 0;
+    scene->SetDeferredDirtyNotification(true);
+
+    moveTwice();
+    CHECK(parentCounter->numNotifications_ == 0);
+    CHECK(childCounter->numNotifications_ == 0);
+
+    scene->Update(0.1f);
+    CHECK(parentCounter->numNotifications_ == 1);
+    CHECK(childCounter->numNotifications_ == 1);
+
+    // Pending notifications are sent when deferral is disabled
+    moveTwice();
+    scene->SetDeferredDirtyNotification(false);
+    CHECK(parentCounter->numNotifications_ == 2);
+    CHECK(childCounter->numNotifications_ == 2);
+
+    // Destroyed components are skipped
+    scene->SetDeferredDirtyNotification(true);
+    moveTwice();
+    child->Remove();
+    scene->Update(0.1f);
+    CHECK(parentCounter->numNotifications_ == 3);
+
+    // Component dirtied again by another listener after being notified is notified again
+    if (!context->IsReflected<DirtyNotificationMover>())
+        context->RegisterFactory<DirtyNotificationMover>();
+
+    Node* otherNode = scene->CreateChild("Other");
+    auto mover = otherNode->CreateComponent<DirtyNotificationMover>();
+    mover->target_ = parent;
+
+    parent->GetWorldPosition();
+    otherNode->GetWorldPosition();
+    parentCounter->numNotifications_ = 0;
+    parent->Translate(Vector3::ONE);
+    otherNode->Translate(Vector3::ONE);
+    scene->NotifyDirtyComponents();
+    CHECK(parentCounter->numNotifications_ == 2);
+}
+
+TEST_CASE("Batched transform update benchmark", "[.benchmark]")
+{
+    auto context = Tests::GetOrCreateContext(Tests::CreateCompleteContext);
+
+    auto scene = MakeShared<Scene>(context);
+    CreateRandomHierarchy(scene, 20000, 0);
+
+    ea::vector<Node*> nodes;
+    scene->GetChildren(nodes, true);
+
+    BENCHMARK("Lazy world transform update")
+    {
+        for (Node* node : scene->GetChildren())
+            node->Translate(Vector3::ONE);
+
+        float sum = 0.0f;
+        for (Node* node : nodes)
+            sum += node->GetWorldPosition().x_;
+        return sum;
+    };
+
+    BENCHMARK("Batched world transform update")
+    {
+        for (Node* node : scene->GetChildren())
+            node->Translate(Vector3::ONE);
+        scene->UpdateTransforms();
+
+        float sum = 0.0f;
+        for (Node* node : nodes)
+            sum += node->GetWorldPosition().x_;
+        return sum;
+    };
+}
@@ -0,0 +1,269 @@
+//
+// Copyright (c) 2021-2022 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "../CommonUtils.h"
+
+#include <Urho3D/Graphics/StaticModel.h>
+#include <Urho3D/IO/MemoryBuffer.h>
+#include <Urho3D/IO/VectorBuffer.h>
+#include <Urho3D/Scene/Scene.h>
+#include <Urho3D/Scene/Serializable.h>
+
+namespace
+{
+
+enum class TestAttributeEnum
+{
+    First,
+    Second,
+    Third
+};
+
+const char* testAttributeEnumNames[] = { "First", "Second", "Third", nullptr };
+
+class TypedAttributeObject : public Serializable
+{
+    URHO3D_OBJECT(TypedAttributeObject, Serializable);
+
+public:
+    explicit TypedAttributeObject(Context* context) : Serializable(context) {}
+
+    static void RegisterObject(Context* context)
+    {
+        context->RegisterFactory<TypedAttributeObject>();
+
+        URHO3D_ATTRIBUTE("Int", int, int_, 0, AM_DEFAULT);
+        URHO3D_ATTRIBUTE("Unsigned", unsigned, unsigned_, 0, AM_DEFAULT);
+        URHO3D_ATTRIBUTE("Int64", long long, int64_, 0, AM_DEFAULT);
+        URHO3D_ATTRIBUTE("Bool", bool, bool_, false, AM_DEFAULT);
+        URHO3D_ATTRIBUTE("Float", float, float_, 0.0f, AM_DEFAULT);
+        URHO3D_ATTRIBUTE("Double", double, double_, 0.0, AM_DEFAULT);
+        URHO3D_ATTRIBUTE("Vector3", Vector3, vector3_, Vector3::ZERO, AM_DEFAULT);
+        URHO3D_ATTRIBUTE("Quaternion", Quaternion, quaternion_, Quaternion::IDENTITY, AM_DEFAULT);
+        URHO3D_ATTRIBUTE("Color", Color, color_, Color::WHITE, AM_DEFAULT);
+        URHO3D_ATTRIBUTE("String", ea::string, string_, EMPTY_STRING, AM_DEFAULT);
+        URHO3D_ATTRIBUTE("String Hash", StringHash, stringHash_, StringHash{}, AM_DEFAULT);
+        URHO3D_ATTRIBUTE("Resource", ResourceRef, resource_, ResourceRef{}, AM_DEFAULT);
+        URHO3D_ATTRIBUTE("Strings", StringVector, strings_, Variant::emptyStringVector, AM_DEFAULT);
+        URHO3D_ATTRIBUTE("Matrix", Matrix3x4, matrix_, Matrix3x4::IDENTITY, AM_DEFAULT);
+        URHO3D_ATTRIBUTE("Variant Map", VariantMap, variantMap_, Variant::emptyVariantMap, AM_DEFAULT);
+        URHO3D_ENUM_ATTRIBUTE("Enum", enum_, testAttributeEnumNames, TestAttributeEnum::First, AM_DEFAULT);
+        URHO3D_ACCESSOR_ATTRIBUTE("Accessor", GetAccessorValue, SetAccessorValue, Vector2, Vector2::ZERO, AM_DEFAULT);
+        URHO3D_ATTRIBUTE_EX("Callback", float, callbackValue_, OnCallbackValueSet, 0.0f, AM_DEFAULT);
+    }
+
+    void Randomize()
+    {
+        int_ = -12345;
+        unsigned_ = 0xdeadbeef;
+        int64_ = -1234567890123ll;
+        bool_ = true;
+        float_ = 3.5f;
+        double_ = 1.0 / 3.0;
+        vector3_ = {1.0f, 2.0f, 3.0f};
+        quaternion_ = Quaternion{45.0f, Vector3::UP};
+        color_ = Color::RED;
+        string_ = "Hello";
+        stringHash_ = "Hash";
+        resource_ = ResourceRef{StringHash{"Material"}, "Materials/Stone.xml"};
+        strings_ = {"A", "B", "C"};
+        matrix_ = Matrix3x4{Vector3::ONE, Quaternion{30.0f, Vector3::RIGHT}, 2.0f};
+        variantMap_["Key"] = 10;
+        enum_ = TestAttributeEnum::Third;
+        accessorValue_ = {4.0f, 5.0f};
+        callbackValue_ = 7.0f;
+    }
+
+    const Vector2& GetAccessorValue() const { return accessorValue_; }
+    void SetAccessorValue(const Vector2& value) { accessorValue_ = value; }
+    void OnCallbackValueSet() { ++numCallbacks_; }
+
+    unsigned numCallbacks_{};
+
+private:
+    int int_{};
+    unsigned unsigned_{};
+    long long int64_{};
+    bool bool_{};
+    float float_{};
+    double double_{};
+    Vector3 vector3_;
+    Quaternion quaternion_;
+    Color color_;
+    ea::string string_;
+    StringHash stringHash_;
+    ResourceRef resource_;
+    StringVector strings_;
+    Matrix3x4 matrix_;
+    VariantMap variantMap_;
+    TestAttributeEnum enum_{};
+    Vector2 accessorValue_;
+    float callbackValue_{};
+};
+
+/// Save attributes through Variant the same way as Serializable::Save did before typed access was introduced.
+ByteVector SaveThroughVariant(const Serializable& serializable)
+{
+    VectorBuffer buffer;
+    for (const AttributeInfo& attr : *serializable.GetAttributes())
+    {
+        if (!attr.ShouldSave())
+            continue;
+
+        Variant value;
+        serializable.OnGetAttribute(attr, value);
+        buffer.WriteVariantData(value);
+    }
+    return buffer.GetBuffer();
+}
+
+ByteVector SaveToBuffer(const Serializable& serializable)
+{
+    VectorBuffer buffer;
+    REQUIRE(serializable.Serializable::Save(buffer));
+    return buffer.GetBuffer();
+}
+
+void CompareAttributes(const Serializable& lhs, const Serializable& rhs)
+{
+    REQUIRE(lhs.GetNumAttributes() == rhs.GetNumAttributes());
+    for (unsigned i = 0; i < lhs.GetNumAttributes(); ++i)
+        CHECK(lhs.GetAttribute(i) == rhs.GetAttribute(i));
+}
+
+}
+
+TEST_CASE("Typed attributes are serialized the same way as Variant")
+{
+    auto context = Tests::GetOrCreateContext(Tests::CreateCompleteContext);
+    if (!context->IsReflected<TypedAttributeObject>())
+        TypedAttributeObject::RegisterObject(context);
+
+    auto source = MakeShared<TypedAttributeObject>(context);
+    source->Randomize();
+
+    const ByteVector typedData = SaveToBuffer(*source);
+    REQUIRE(typedData == SaveThroughVariant(*source));
+
+    auto dest = MakeShared<TypedAttributeObject>(context);
+    MemoryBuffer buffer(typedData);
+    REQUIRE(dest->Load(buffer));
+    REQUIRE(buffer.IsEof());
+
+    CompareAttributes(*source, *dest);
+    CHECK(dest->numCallbacks_ == 1);
+    CHECK(SaveToBuffer(*dest) == typedData);
+}
+
+TEST_CASE("Typed attributes of built-in components are serialized the same way as Variant")
+{
+    auto context = Tests::GetOrCreateContext(Tests::CreateCompleteContext);
+    auto scene = MakeShared<Scene>(context);
+
+    auto node = scene->CreateChild("Node");
+    node->SetPosition({1.0f, 2.0f, 3.0f});
+    node->SetRotation(Quaternion{30.0f, Vector3::UP});
+    node->SetVar("Variable", 10);
+    auto staticModel = node->CreateComponent<StaticModel>();
+    staticModel->SetCastShadows(true);
+    staticModel->SetLightMask(0x0f);
+
+    const Serializable* serializables[] = {node, staticModel};
+    for (const Serializable* serializable : serializables)
+        CHECK(SaveToBuffer(*serializable) == SaveThroughVariant(*serializable));
+
+    auto clonedModel = MakeShared<StaticModel>(context);
+    const ByteVector data = SaveToBuffer(*staticModel);
+    MemoryBuffer buffer(data);
+    REQUIRE(clonedModel->Serializable::Load(buffer));
+    CompareAttributes(*staticModel, *clonedModel);
+}
+
+TEST_CASE("Typed attributes are loaded through Variant when instance default is set")
+{
+    auto context = Tests::GetOrCreateContext(Tests::CreateCompleteContext);
+    if (!context->IsReflected<TypedAttributeObject>())
+        TypedAttributeObject::RegisterObject(context);
+
+    auto source = MakeShared<TypedAttributeObject>(context);
+    source->Randomize();
+
+    auto dest = MakeShared<TypedAttributeObject>(context);
+    dest->SetInstanceDefault(true);
+    const ByteVector data = SaveToBuffer(*source);
+    MemoryBuffer buffer(data);
+    REQUIRE(dest->Load(buffer));
+    dest->SetInstanceDefault(false);
+
+    CompareAttributes(*source, *dest);
+    CHECK(dest->GetInstanceDefault("Float") == Variant(3.5f));
+    CHECK(dest->GetInstanceDefault("Accessor") == Variant(Vector2{4.0f, 5.0f}));
+}
+
+TEST_CASE("Typed attribute serialization benchmark", "[.benchmark]")
+{
+    auto context = Tests::GetOrCreateContext(Tests::CreateCompleteContext);
+    if (!context->IsReflected<TypedAttributeObject>())
+        TypedAttributeObject::RegisterObject(context);
+
+    auto source = MakeShared<TypedAttributeObject>(context);
+    source->Randomize();
+    const ByteVector data = SaveToBuffer(*source);
+
+    auto dest = MakeShared<TypedAttributeObject>(context);
+    static constexpr unsigned numIterations = 100000;
+
+    BENCHMARK("Typed load")
+    {
+        for (unsigned i = 0; i < numIterations; ++i)
+        {
+            MemoryBuffer buffer(data);
+            dest->Load(buffer);
+        }
+    };
+
+    BENCHMARK("Variant load")
+    {
+        for (unsigned i = 0; i < numIterations; ++i)
+        {
+            MemoryBuffer buffer(data);
+            for (const AttributeInfo& attr : *dest->GetAttributes())
+                dest->OnSetAttribute(attr, buffer.ReadVariant(attr.type_));
+        }
+    };
+
+    BENCHMARK("Typed save")
+    {
+        VectorBuffer buffer;
+        for (unsigned i = 0; i < numIterations; ++i)
+        {
+            buffer.Clear();
+            source->Save(buffer);
+        }
+    };
+
+    BENCHMARK("Variant save")
+    {
+        for (unsigned i = 0; i < numIterations; ++i)
+            SaveThroughVariant(*source);
+    };
+}
@@ -43,6 +43,8 @@ void BuildAssets::RegisterCommandLine(CLI::App& cli)
 {
     SubCommand::RegisterCommandLine(cli);
     cli.add_flag("--full", full_, "Disable out-of-date checks and rebuild cache completely.");
+    cli.add_flag("--refresh-import-cache", refreshImportCache_, "Execute importers even if their byproducts are present in import cache.");
+    cli.add_option("--import-cache", importCache_, "Directory of import cache shared between projects and machines.");
     cli.add_option("flavor", flavor_, "Flavor to build.");
 }
 
@@ -58,10 +60,16 @@ void BuildAssets::Execute()
     PipelineBuildFlags flags{PipelineBuildFlag::EXECUTE_OPTIONAL};
     if (!full_)
         flags |= PipelineBuildFlag::SKIP_UP_TO_DATE;
+    if (refreshImportCache_)
+        flags |= PipelineBuildFlag::REFRESH_IMPORT_CACHE;
 
     auto* pipeline = GetSubsystem<Pipeline>();
+    if (!importCache_.empty())
+        pipeline->SetImportCacheDirectory(importCache_);
+
     pipeline->BuildCache(pipeline->GetFlavor(flavor_), flags);
     pipeline->WaitForCompletion();
+    pipeline->LogImportCacheStatistics();
 }
 
 }
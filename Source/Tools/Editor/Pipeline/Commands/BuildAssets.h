@@ -45,6 +45,10 @@ public:
 protected:
     ///
     int full_ = 0;
+    /// Execute importers even if their byproducts are present in import cache.
+    int refreshImportCache_ = 0;
+    /// Import cache directory overriding project settings.
+    ea::string importCache_{};
     ///
     ea::string flavor_{Flavor::DEFAULT};
 };
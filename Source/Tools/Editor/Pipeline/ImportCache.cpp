@@ -0,0 +1,207 @@
+//
+// Copyright (c) 2017-2022 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include <Urho3D/Core/ProcessUtils.h>
+#include <Urho3D/IO/File.h>
+#include <Urho3D/IO/FileSystem.h>
+#include <Urho3D/IO/Log.h>
+
+#include "Pipeline/ImportCache.h"
+
+namespace Urho3D
+{
+
+namespace
+{
+
+/// Name of the file listing byproducts of the entry.
+const char* manifestFileName = "Byproducts.txt";
+/// Name of the directory containing byproducts of the entry.
+const char* filesDirectoryName = "Files/";
+
+}
+
+ImportCache::ImportCache(Context* context)
+    : Object(context)
+{
+}
+
+void ImportCache::SetPath(const ea::string& path)
+{
+    path_ = path.empty() ? EMPTY_STRING : AddTrailingSlash(path);
+}
+
+ea::string ImportCache::GetEntryPath(const ea::string& key) const
+{
+    // Entries are spread across subdirectories to keep directories reasonably small
+    return Format("{}{}/{}/", path_, key.substr(0, 2), key);
+}
+
+bool ImportCache::Restore(const ea::string& key, const ea::string& outputPath, StringVector& byproducts)
+{
+    byproducts.clear();
+    if (!IsEnabled())
+        return false;
+
+    auto* fs = GetSubsystem<FileSystem>();
+    const ea::string entryPath = GetEntryPath(key);
+
+    File manifest(context_);
+    if (!fs->FileExists(entryPath + manifestFileName) || !manifest.Open(entryPath + manifestFileName, FILE_READ))
+    {
+        ++numMisses_;
+        return false;
+    }
+
+    while (!manifest.IsEof())
+    {
+        const ea::string byproduct = manifest.ReadLine().trimmed();
+        if (!byproduct.empty())
+            byproducts.push_back(byproduct);
+    }
+
+    for (const ea::string& byproduct : byproducts)
+    {
+        const ea::string destination = outputPath + byproduct;
+        fs->CreateDirsRecursive(Urho3D::GetPath(destination));
+        if (!fs->Copy(entryPath + filesDirectoryName + byproduct, destination))
+        {
+            URHO3D_LOGWARNING("Import cache entry {} is incomplete, '{}' is missing.", key, byproduct);
+            byproducts.clear();
+            ++numMisses_;
+            return false;
+        }
+    }
+
+    ++numHits_;
+    return !byproducts.empty();
+}
+
+bool ImportCache::Store(const ea::string& key, const ea::string& outputPath, const StringVector& byproducts)
+{
+    if (!IsEnabled() || byproducts.empty())
+        return false;
+
+    auto* fs = GetSubsystem<FileSystem>();
+    const ea::string entryPath = GetEntryPath(key);
+    if (fs->DirExists(entryPath))
+        return true;
+
+    // Entry is assembled in temporary directory and renamed when complete, so other processes never see partial entry
+    const ea::string tempPath = Format("{}.{}/", RemoveTrailingSlash(entryPath), GenerateUUID());
+    fs->CreateDirsRecursive(tempPath + filesDirectoryName);
+
+    File manifest(context_);
+    bool success = manifest.Open(tempPath + manifestFileName, FILE_WRITE);
+    for (const ea::string& byproduct : byproducts)
+    {
+        if (!success)
+            break;
+
+        const ea::string destination = tempPath + filesDirectoryName + byproduct;
+        fs->CreateDirsRecursive(Urho3D::GetPath(destination));
+        success = fs->Copy(outputPath + byproduct, destination) && manifest.WriteLine(byproduct);
+    }
+    manifest.Close();
+
+    // Rename fails if the same entry was stored concurrently, which is fine
+    if (!success || !fs->Rename(RemoveTrailingSlash(tempPath), RemoveTrailingSlash(entryPath)))
+    {
+        fs->RemoveDir(tempPath, true);
+        return success && fs->DirExists(entryPath);
+    }
+
+    return true;
+}
+
+void ImportCache::ResetStatistics()
+{
+    numHits_ = 0;
+    numMisses_ = 0;
+}
+
+unsigned long long ImportCache::HashData(const void* data, unsigned size, unsigned long long hash)
+{
+    const auto* bytes = static_cast<const unsigned char*>(data);
+    for (unsigned i = 0; i < size; ++i)
+    {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+bool ImportCache::HashFile(const ea::string& fileName, unsigned long long& hash) const
+{
+    File file(context_);
+    if (!file.Open(fileName, FILE_READ))
+        return false;
+
+    unsigned char buffer[64 * 1024];
+    while (!file.IsEof())
+    {
+        const unsigned size = file.Read(buffer, sizeof(buffer));
+        if (size == 0)
+            return false;
+        hash = HashData(buffer, size, hash);
+    }
+
+    return true;
+}
+
+bool ImportCache::HashTool(const ea::string& fileName, unsigned long long& hash) const
+{
+    ea::string toolFileName = fileName;
+#ifdef _WIN32
+    // Tools are run without extension
+    if (GetExtension(toolFileName).empty())
+        toolFileName += ".exe";
+#endif
+
+    auto* fs = GetSubsystem<FileSystem>();
+    const unsigned modifiedTime = fs->GetLastModifiedTime(toolFileName);
+
+    {
+        MutexLock lock(toolHashesMutex_);
+        const auto iter = toolHashes_.find(toolFileName);
+        if (iter != toolHashes_.end() && iter->second.first == modifiedTime)
+        {
+            hash = HashData(&iter->second.second, sizeof(iter->second.second), hash);
+            return true;
+        }
+    }
+
+    // Tools may be large, so their contents are hashed only once
+    unsigned long long toolHash = HashData(nullptr, 0);
+    if (!HashFile(toolFileName, toolHash))
+        return false;
+
+    {
+        MutexLock lock(toolHashesMutex_);
+        toolHashes_[toolFileName] = { modifiedTime, toolHash };
+    }
+
+    hash = HashData(&toolHash, sizeof(toolHash), hash);
+    return true;
+}
+
+}
@@ -0,0 +1,89 @@
+//
+// Copyright (c) 2017-2022 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include <atomic>
+
+#include <EASTL/string.h>
+
+#include <EASTL/unordered_map.h>
+
+#include <Urho3D/Core/Mutex.h>
+#include <Urho3D/Core/Object.h>
+
+namespace Urho3D
+{
+
+/// Content-addressed storage of importer byproducts in a local directory.
+/// Entries are keyed by hash of source file contents, importer type, importer and tool versions and effective importer settings,
+/// therefore they stay valid when files are touched or restored by version control, and may be shared between flavors,
+/// projects and machines.
+class ImportCache : public Object
+{
+    URHO3D_OBJECT(ImportCache, Object);
+public:
+    /// Construct.
+    explicit ImportCache(Context* context);
+    /// Set directory where entries are stored. Empty path disables the cache.
+    void SetPath(const ea::string& path);
+    /// Return directory where entries are stored.
+    const ea::string& GetPath() const { return path_; }
+    /// Return true if cache directory is set.
+    bool IsEnabled() const { return !path_.empty(); }
+
+    /// Copy byproducts of the entry to the output directory. Returns byproduct file names relative to output directory. Thread-safe.
+    bool Restore(const ea::string& key, const ea::string& outputPath, StringVector& byproducts);
+    /// Store byproducts located in the output directory as new entry. Existing entry is not overwritten. Thread-safe.
+    bool Store(const ea::string& key, const ea::string& outputPath, const StringVector& byproducts);
+
+    /// Reset hit and miss counters.
+    void ResetStatistics();
+    /// Return number of entries restored since last reset.
+    unsigned GetNumHits() const { return numHits_; }
+    /// Return number of entries not found since last reset.
+    unsigned GetNumMisses() const { return numMisses_; }
+
+    /// Return 64-bit FNV-1a hash of data, continuing from given hash.
+    static unsigned long long HashData(const void* data, unsigned size, unsigned long long hash = 14695981039346656037ull);
+    /// Return hash of file contents, continuing from given hash. Returns false if file can not be read.
+    bool HashFile(const ea::string& fileName, unsigned long long& hash) const;
+    /// Return hash of external tool executable contents, continuing from given hash. Hash is computed again only when the tool is modified. Returns false if tool can not be read. Thread-safe.
+    bool HashTool(const ea::string& fileName, unsigned long long& hash) const;
+
+private:
+    /// Return directory of the entry.
+    ea::string GetEntryPath(const ea::string& key) const;
+
+    /// Directory where entries are stored.
+    ea::string path_;
+    /// Number of entries restored since last reset.
+    std::atomic<unsigned> numHits_{};
+    /// Number of entries not found since last reset.
+    std::atomic<unsigned> numMisses_{};
+    /// Mutex for tool hashes.
+    mutable Mutex toolHashesMutex_;
+    /// Modification times and content hashes of tools.
+    mutable ea::unordered_map<ea::string, ea::pair<unsigned, unsigned long long>> toolHashes_;
+};
+
+}
@@ -26,6 +26,7 @@
 #include "EditorEvents.h"
 #include "Project.h"
 #include "Pipeline/Importers/AssetImporter.h"
+#include "Pipeline/ImportCache.h"
 #include "Pipeline/Pipeline.h"
 #include "Pipeline/Asset.h"
 
@@ -121,6 +122,60 @@ bool AssetImporter::IsOutOfDate() const
     return false;
 }
 
+bool AssetImporter::HashInput(ImportCache* cache, Asset* input, unsigned long long& hash) const
+{
+    return cache->HashFile(input->GetResourcePath(), hash);
+}
+
+ea::string AssetImporter::GetImportCacheKey(ImportCache* cache, Asset* input) const
+{
+    unsigned long long hash = ImportCache::HashData(nullptr, 0);
+    if (!HashInput(cache, input, hash))
+        return EMPTY_STRING;
+
+    // Byproduct names are derived from asset name, so it is a part of the key as well
+    const ea::string& name = input->GetName();
+    const ea::string& typeName = GetTypeName();
+    const unsigned version = GetVersion();
+    const unsigned attributeHash = HashEffectiveAttributeValues();
+    hash = ImportCache::HashData(typeName.data(), typeName.length(), hash);
+    hash = ImportCache::HashData(&version, sizeof(version), hash);
+    hash = ImportCache::HashData(&attributeHash, sizeof(attributeHash), hash);
+    hash = ImportCache::HashData(name.data(), name.length(), hash);
+    return Format("{:016x}", hash);
+}
+
+bool AssetImporter::RestoreFromImportCache(ImportCache* cache, const ea::string& key, const ea::string& outputPath)
+{
+    ClearByproducts();
+
+    StringVector byproducts;
+    if (!cache->Restore(key, outputPath, byproducts))
+        return false;
+
+    lastAttributeHash_ = HashEffectiveAttributeValues();
+    for (const ea::string& byproduct : byproducts)
+        AddByproduct(outputPath + byproduct);
+    return true;
+}
+
+bool AssetImporter::StoreInImportCache(ImportCache* cache, const ea::string& key, const ea::string& outputPath) const
+{
+    auto* project = GetSubsystem<Project>();
+
+    // Byproducts are stored relative to output path, so entries are shared between flavors
+    const ea::string outputPrefix = outputPath.substr(project->GetCachePath().size());
+    StringVector byproducts;
+    for (const ea::string& byproduct : byproducts_)
+    {
+        if (!byproduct.starts_with(outputPrefix))
+            return false;
+        byproducts.push_back(byproduct.substr(outputPrefix.size()));
+    }
+
+    return cache->Store(key, outputPath, byproducts);
+}
+
 void AssetImporter::OnGetAttribute(const AttributeInfo& attr, Variant& dest) const
 {
     auto it = isAttributeSet_.find(attr.name_);
@@ -32,6 +32,7 @@ namespace Urho3D
 
 class Asset;
 class Flavor;
+class ImportCache;
 
 enum class AssetImporterFlag : unsigned
 {
@@ -67,12 +68,24 @@ public:
     void OnGetAttribute(const AttributeInfo& attr, Variant& dest) const override;
     ///
     void OnSetAttribute(const AttributeInfo& attr, const Variant& src) override;
+    ///
+    bool IsTypedAttributeAccessEnabled() const override { return false; }
     /// Returns a list of known byproduct resource names.
     const StringVector& GetByproducts() const { return byproducts_; }
     /// Implements inheritance of default importer settings.
     Variant GetInstanceDefault(const ea::string& name) const override;
     /// Returns flavor this importer belongs to.
     Flavor* GetFlavor() const { return flavor_; }
+    /// Returns version of importer. Should be incremented when importer starts producing different byproducts from the same input, so that outdated import cache entries are not reused.
+    virtual unsigned GetVersion() const { return 1; }
+    /// Hashes all input files that affect byproducts of this importer. May be called from non-main thread. Returns false if input can not be read.
+    virtual bool HashInput(ImportCache* cache, Asset* input, unsigned long long& hash) const;
+    /// Returns a key of import cache entry storing byproducts of specified asset imported with current settings. Returns empty string if input can not be read. May be called from non-main thread.
+    ea::string GetImportCacheKey(ImportCache* cache, Asset* input) const;
+    /// Restores byproducts from import cache instead of executing importer. May be called from non-main thread. Returns true on cache hit.
+    bool RestoreFromImportCache(ImportCache* cache, const ea::string& key, const ea::string& outputPath);
+    /// Stores byproducts of last execution in import cache. May be called from non-main thread.
+    bool StoreInImportCache(ImportCache* cache, const ea::string& key, const ea::string& outputPath) const;
 
 protected:
     /// Sets needed asset information. Called after creating every importer.
@@ -20,15 +20,18 @@
 // THE SOFTWARE.
 //
 
+#include <Urho3D/IO/File.h>
 #include <Urho3D/IO/FileSystem.h>
 #include <Urho3D/IO/Log.h>
 #include <Urho3D/Core/ProcessUtils.h>
 #include <Urho3D/Resource/JSONArchive.h>
+#include <Urho3D/Resource/JSONDocument.h>
 #include <Urho3D/Utility/GLTFImporter.h>
 
 #include "Editor.h"
 #include "Project.h"
 #include "Pipeline/Asset.h"
+#include "Pipeline/ImportCache.h"
 #include "Pipeline/Importers/ModelImporter.h"
 
 namespace Urho3D
@@ -77,6 +80,87 @@ bool IsBlenderAvailable()
     return result;
 }
 
+const ea::string& GetToolVersion(const ea::string& toolName)
+{
+    static Mutex mutex;
+    static ea::unordered_map<ea::string, ea::string> versions;
+
+    MutexLock lock(mutex);
+    auto iter = versions.find(toolName);
+    if (iter == versions.end())
+    {
+        ea::string version;
+        if (auto context = Context::GetInstance())
+            context->GetSubsystem<FileSystem>()->SystemRun(toolName, {"--version"}, version);
+        iter = versions.emplace(toolName, version).first;
+    }
+    return iter->second;
+}
+
+ea::string DecodeURI(ea::string_view uri)
+{
+    ea::string result;
+    for (unsigned i = 0; i < uri.size(); ++i)
+    {
+        if (uri[i] == '%' && i + 2 < uri.size())
+        {
+            result += static_cast<char>(ToUInt(ea::string(uri.substr(i + 1, 2)), 16));
+            i += 2;
+        }
+        else
+            result += uri[i];
+    }
+    return result;
+}
+
+/// Return external files referenced by glTF buffers and images. Returns false if file can not be parsed or references remote URI.
+bool ReadGLTFDependencies(Context* context, const ea::string& fileName, StringVector& dependencies)
+{
+    File file(context);
+    if (!file.Open(fileName, FILE_READ))
+        return false;
+
+    JSONDocument document;
+    if (fileName.ends_with(".glb"))
+    {
+        // Binary glTF starts with 12-byte header followed by JSON chunk
+        static const unsigned magicGLB = 0x46546C67;
+        static const unsigned chunkTypeJSON = 0x4E4F534A;
+        const unsigned magic = file.ReadUInt();
+        file.Seek(12);
+        const unsigned chunkLength = file.ReadUInt();
+        const unsigned chunkType = file.ReadUInt();
+        if (magic != magicGLB || chunkType != chunkTypeJSON)
+            return false;
+
+        ea::string text;
+        text.resize(chunkLength);
+        if (file.Read(text.data(), chunkLength) != chunkLength || !document.Parse(text, fileName))
+            return false;
+    }
+    else if (!document.Load(file))
+        return false;
+
+    const ea::string basePath = GetPath(fileName);
+    for (const char* arrayName : {"buffers", "images"})
+    {
+        const JSONDocumentValue& array = document.GetRoot().Get(arrayName);
+        for (unsigned i = 0; i < array.Size(); ++i)
+        {
+            // Embedded data and binary chunk of GLB are already hashed with the source file
+            const ea::string_view uri = array[i].Get("uri").GetString();
+            if (uri.empty() || uri.starts_with("data:"))
+                continue;
+
+            if (uri.find("://") != ea::string_view::npos)
+                return false;
+
+            dependencies.push_back(basePath + DecodeURI(uri));
+        }
+    }
+    return true;
+}
+
 static const char* MODEL_IMPORTER_OUTPUT_ANIM = "Output animations";
 static const char* MODEL_IMPORTER_OUTPUT_MAT = "Output materials";
 static const char* MODEL_IMPORTER_OUTPUT_MAT_TEX = "Output material textures";
@@ -168,6 +252,42 @@ bool ModelImporter::Execute(Urho3D::Asset* input, const ea::string& outputPath)
     return !tmpByproducts.empty();
 }
 
+bool ModelImporter::HashInput(ImportCache* cache, Asset* input, unsigned long long& hash) const
+{
+    if (!BaseClassName::HashInput(cache, input, hash))
+        return false;
+
+    auto* fs = context_->GetSubsystem<FileSystem>();
+    const ea::string& fileName = input->GetName();
+    if (IsFileNameGLTF(fileName))
+    {
+        // Byproducts depend on external buffers and images as well, cache entry is not used if they can not be read
+        StringVector dependencies;
+        if (!ReadGLTFDependencies(context_, input->GetResourcePath(), dependencies))
+            return false;
+
+        for (const ea::string& dependency : dependencies)
+        {
+            if (!cache->HashFile(dependency, hash))
+                return false;
+        }
+    }
+    else if (IsFileNameFBX(fileName) || IsFileNameBlend(fileName))
+    {
+        // Tools from system path are identified by reported version
+        const ea::string& version = GetToolVersion(IsFileNameFBX(fileName) ? "FBX2glTF" : "blender");
+        hash = ImportCache::HashData(version.data(), version.length(), hash);
+    }
+    else
+    {
+        // Legacy fallback is imported by Assimp-based tool
+        return cache->HashTool(fs->GetProgramDir() + "AssetImporter", hash);
+    }
+
+    // glTF is imported by editor instance
+    return cache->HashTool(fs->GetProgramFileName(), hash);
+}
+
 bool ModelImporter::ImportAssetToFolder(Asset* inputAsset,
     const ea::string& outputPath, const ea::string& outputResourceNamePrefix, ea::string& commandOutput)
 {
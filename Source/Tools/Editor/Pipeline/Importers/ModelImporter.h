@@ -38,6 +38,8 @@ public:
     bool Accepts(const ea::string& path) const override;
     ///
     bool Execute(Asset* input, const ea::string& outputPath) override;
+    /// Hashes source file, files referenced by glTF and tools used for import.
+    bool HashInput(ImportCache* cache, Asset* input, unsigned long long& hash) const override;
 
 protected:
     bool ImportAssetToFolder(Asset* inputAsset,
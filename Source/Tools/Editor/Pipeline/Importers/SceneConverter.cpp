@@ -27,6 +27,7 @@
 
 #include "Project.h"
 #include "Pipeline/Asset.h"
+#include "Pipeline/ImportCache.h"
 #include "Pipeline/Importers/SceneConverter.h"
 #include "Tabs/Scene/EditorSceneSettings.h"
 
@@ -45,6 +46,15 @@ void SceneConverter::RegisterObject(Context* context)
     context->RegisterFactory<SceneConverter>();
     URHO3D_COPY_BASE_ATTRIBUTES(AssetImporter);
 }
+
+bool SceneConverter::HashInput(ImportCache* cache, Asset* input, unsigned long long& hash) const
+{
+    if (!BaseClassName::HashInput(cache, input, hash))
+        return false;
+
+    return cache->HashTool(context_->GetSubsystem<FileSystem>()->GetProgramFileName(), hash);
+}
+
 bool SceneConverter::Execute(Urho3D::Asset* input, const ea::string& outputPath)
 {
     if (!BaseClassName::Execute(input, outputPath))
@@ -38,6 +38,8 @@ public:
     bool Accepts(const ea::string& path) const override;
     ///
     bool Execute(Urho3D::Asset* input, const ea::string& outputPath) override;
+    /// Hashes source file and editor executable that cooks the scene.
+    bool HashInput(ImportCache* cache, Asset* input, unsigned long long& hash) const override;
 };
 
 }
@@ -23,6 +23,7 @@
 #include <Urho3D/IO/FileSystem.h>
 #include <Urho3D/IO/Log.h>
 #include "Pipeline/Asset.h"
+#include "Pipeline/ImportCache.h"
 #include "Pipeline/Importers/TextureImporter.h"
 
 namespace Urho3D
@@ -127,6 +128,15 @@ bool TextureImporter::Accepts(const ea::string& path) const
     return path.ends_with(".png");
 }
 
+bool TextureImporter::HashInput(ImportCache* cache, Asset* input, unsigned long long& hash) const
+{
+    if (!BaseClassName::HashInput(cache, input, hash))
+        return false;
+
+    // Different crunch builds may produce different blocks
+    return cache->HashTool(context_->GetSubsystem<FileSystem>()->GetProgramDir() + "/crunch", hash);
+}
+
 bool TextureImporter::Execute(Urho3D::Asset* input, const ea::string& outputPath)
 {
     if (!BaseClassName::Execute(input, outputPath))
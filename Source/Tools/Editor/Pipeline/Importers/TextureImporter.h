@@ -109,6 +109,8 @@ public:
     bool Accepts(const ea::string& path) const override;
     ///
     bool Execute(Urho3D::Asset* input, const ea::string& outputPath) override;
+    /// Hashes source file and crunch tool.
+    bool HashInput(ImportCache* cache, Asset* input, unsigned long long& hash) const override;
 
 protected:
     ///
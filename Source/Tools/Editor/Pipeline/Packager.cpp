@@ -22,12 +22,11 @@
 
 #include <EASTL/sort.h>
 
+#include <Urho3D/Core/CoreEvents.h>
+#include <Urho3D/Core/Timer.h>
 #include <Urho3D/Core/WorkQueue.h>
-#include <Urho3D/Core/Thread.h>
 #include <Urho3D/IO/Log.h>
 #include <Urho3D/IO/FileSystem.h>
-#include <LZ4/lz4.h>
-#include <LZ4/lz4hc.h>
 
 #include "Project.h"
 #include "Pipeline/Pipeline.h"
@@ -38,11 +37,14 @@
 namespace Urho3D
 {
 
+/// Time in milliseconds spent on packaging each frame, so the editor stays responsive.
+static const long long PACKAGING_TIME_BUDGET_MS = 30;
+
 Packager::Packager(Context* context)
     : Object(context)
     , output_(context)
+    , writer_(context->GetSubsystem<WorkQueue>())
 {
-    compressBuffer_.resize(LZ4_compressBound(blockSize_));
 }
 
 Packager::~Packager()
@@ -97,52 +99,72 @@ void Packager::Start()
         return;
     }
 
-    context_->GetSubsystem<WorkQueue>()->AddWorkItem([this](unsigned /*threadIndex*/) { WritePackage(); });
-}
-
-void Packager::WritePackage()
-{
-    assert(!IsCompleted());
     logger_.Info("Packaging started.");
 
     ea::quick_sort(queuedAssets_.begin(), queuedAssets_.end(), [](const SharedPtr<Asset>& a, const SharedPtr<Asset>& b) {
         return a->GetName() < b->GetName();
     });
 
-    auto* project = GetSubsystem<Project>();
-    const ea::string& resourcePath = project->GetResourcePath();
-    ea::string cachePath = flavor_->GetCachePath();
+    nextAssetIndex_ = 0;
+    SubscribeToEvent(E_UPDATE, &Packager::OnUpdate);
+}
+
+void Packager::OnUpdate(StringHash, VariantMap&)
+{
+    assert(!IsCompleted());
 
-    for (Asset* asset : queuedAssets_)
+    HiresTimer timer;
+    while (nextAssetIndex_ < queuedAssets_.size())
     {
         // Asset may be importing at this time. We have to wait. Can not package another asset in this time because we want reproducible
         // packages.
-        while (asset->IsImporting())
-            Time::Sleep(1);
+        Asset* asset = queuedAssets_[nextAssetIndex_];
+        if (asset->IsImporting())
+            return;
+
+        AddAssetFiles(asset);
+        ++nextAssetIndex_;
+        filesDone_++;
+
+        if (timer.GetUSec(false) >= PACKAGING_TIME_BUDGET_MS * 1000)
+            return;
+    }
+
+    UnsubscribeFromEvent(E_UPDATE);
+    FinishPackage();
+}
+
+void Packager::AddAssetFiles(Asset* asset)
+{
+    auto* project = GetSubsystem<Project>();
+    const ea::string& resourcePath = project->GetResourcePath();
+    const ea::string& cachePath = flavor_->GetCachePath();
 
-        bool writtenAny = false;
-        for (AssetImporter* importer : asset->GetImporters(flavor_))
+    bool writtenAny = false;
+    for (AssetImporter* importer : asset->GetImporters(flavor_))
+    {
+        for (const ea::string& byproduct : importer->GetByproducts())   // Byproducts are sorted on import
         {
-            for (const ea::string& byproduct : importer->GetByproducts())   // Byproducts are sorted on import
-            {
-                AddFile(cachePath, byproduct);
-                writtenAny = true;
-            }
+            AddFile(cachePath, byproduct);
+            writtenAny = true;
         }
+    }
 
-        // Raw assets are only written to default flavor pak
-        if (!writtenAny && flavor_->IsDefault())
-            AddFile(resourcePath, asset->GetResourcePath());
+    // Raw assets are only written to default flavor pak
+    if (!writtenAny && flavor_->IsDefault())
+        AddFile(resourcePath, asset->GetResourcePath());
+}
 
-        filesDone_++;
-    }
+void Packager::FinishPackage()
+{
+    const ea::string cachePath = flavor_->GetCachePath();
 
     // Has to be done here in case any resources were imported during packaging.
     auto pipeline = GetSubsystem<Pipeline>();
-    pipeline->CookSettings(); // TODO: Thread safety
-    pipeline->CookCacheInfo();// TODO: Thread safety
+    pipeline->CookSettings();
+    pipeline->CookCacheInfo();
     AddFile(cachePath, "CacheInfo.json");   filesDone_++;
-    AddFile(cachePath, "Settings.json");    filesDone_++;
+    AddFile(cachePath, "Settings.json");
 
     entriesOffset_ = output_.GetSize();
 
@@ -158,8 +180,10 @@ void Packager::WritePackage()
     output_.WriteUInt(currentSize + sizeof(unsigned));
 
     WriteHeaders();
+    output_.Close();
 
     logger_.Info("Packaging completed.");
+    filesDone_++;
 }
 
 void Packager::WriteHeaders()
@@ -208,54 +232,22 @@ bool Packager::AddFile(const ea::string& root, const ea::string& path)
         return false;
     }
 
-    unsigned dataSize = entry.size_;
-    buffer_.resize(dataSize);
-
-    if (srcFile.Read(&buffer_[0], dataSize) != dataSize)
+    const PackageCompression compression = compress_ ? PackageCompression::LZ4HC : PackageCompression::None;
+    if (!writer_.Write(output_, srcFile, entry.size_, compression, entry.checksum_, checksum_))
     {
-        logger_.Error("Could not read file {}. Skipped!", fileFullPath);
+        // Partially written data can not be removed, but it is not referenced by any entry
+        logger_.Error("Could not read or compress file {}. Skipped!", fileFullPath);
         return false;
     }
-    srcFile.Close();
-
-    for (unsigned j = 0; j < dataSize; ++j)
-    {
-        checksum_ = SDBMHash(checksum_, buffer_[j]);
-        entry.checksum_ = SDBMHash(entry.checksum_, buffer_[j]);
-    }
 
     entries_.push_back(entry);
     if (!compress_)
-    {
-        logger_.Info("Added {} size {}", entry.name_, dataSize);
-        output_.Write(&buffer_[0], entry.size_);
-    }
+        logger_.Info("Added {} size {}", entry.name_, entry.size_);
     else
     {
-        unsigned pos = 0;
-
-        // TODO: This could be parallelized.
-        while (pos < dataSize)
-        {
-            int unpackedSize = blockSize_;
-            if (pos + unpackedSize > dataSize)
-                unpackedSize = static_cast<int>(dataSize) - pos;
-
-            auto packedSize = (unsigned) LZ4_compress_HC((const char*) &buffer_[pos], (char*) compressBuffer_.data(), unpackedSize,
-                LZ4_compressBound(unpackedSize), 0);
-            if (!packedSize)
-                logger_.Error("LZ4 compression failed for file {} at offset {}.", entry.name_, pos);
-
-            output_.WriteUShort((unsigned short) unpackedSize);
-            output_.WriteUShort((unsigned short) packedSize);
-            output_.Write(compressBuffer_.data(), packedSize);
-
-            pos += unpackedSize;
-        }
-
         unsigned totalPackedBytes = output_.GetSize() - lastOffset;
-        logger_.Info("{} in: {} out: {} ratio: {}", entry.name_, dataSize, totalPackedBytes,
-            totalPackedBytes ? 1.f * dataSize / totalPackedBytes : 0.f);
+        logger_.Info("{} in: {} out: {} ratio: {}", entry.name_, entry.size_, totalPackedBytes,
+            totalPackedBytes ? 1.f * entry.size_ / totalPackedBytes : 0.f);
     }
     return true;
 }
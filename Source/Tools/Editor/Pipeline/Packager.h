@@ -25,6 +25,7 @@
 
 #include <Urho3D/Core/Object.h>
 #include <Urho3D/IO/File.h>
+#include <Urho3D/IO/PackageEntryWriter.h>
 
 
 namespace Urho3D
@@ -68,6 +69,7 @@ public:
     /// Queues asset for packaging.
     void AddAsset(Asset* asset);
     /// Begins packaging process and returns immediately. Object must remain alive until IsCompleted() returns true.
+    /// Packaging is performed in main thread over multiple frames, file data is compressed by WorkQueue threads.
     void Start();
     /// Returns flavor packager is packaging.
     Flavor* GetFlavor() const { return flavor_; }
@@ -75,10 +77,14 @@ public:
 protected:
     /// Add a file to the package. This is a blocking operation.
     bool AddFile(const ea::string& root, const ea::string& path);
+    /// Add byproducts of the asset to the package.
+    void AddAssetFiles(Asset* asset);
     /// Writes file headter to the start of the file.
     void WriteHeaders();
-    /// A worker running in another thread that will handle writing the package.
-    void WritePackage();
+    /// Write settings, file entries and headers after all assets are added.
+    void FinishPackage();
+    /// Package queued assets until time budget of the frame is exhausted.
+    void OnUpdate(StringHash, VariantMap&);
 
     /// Per-package logger.
     Logger logger_{};
@@ -92,18 +98,16 @@ protected:
     WeakPtr<Flavor> flavor_;
     /// A list of assets that are to be written into the package.
     ea::vector<SharedPtr<Asset>> queuedAssets_{};
+    /// Index of next asset to be written into the package.
+    unsigned nextAssetIndex_ = 0;
     /// Flag indicating whether file content is compressed or not.
     bool compress_ = false;
     /// Checksum of all file data (uncompressed).
     unsigned checksum_ = 0;
     /// Offset to the list of file entries in this package.
     int64_t entriesOffset_ = 0;
-    /// LZ4 block size for data compression.
-    const int blockSize_ = 32768;
-    /// Buffer that holds data that was read from file. It will be written to package or used in compression.
-    ea::vector<uint8_t> buffer_{};
-    /// Buffer that holds compressed file data.
-    ea::vector<uint8_t> compressBuffer_{};
+    /// Writer of file data. Data is streamed and compressed in LZ4 blocks.
+    PackageEntryWriter writer_;
     /// Total number of assets to be processed. This number may be less than files written to the package as each asset may carry multiple byproducts.
     unsigned filesTotal_ = 0;
     /// A number of already completed written assets.
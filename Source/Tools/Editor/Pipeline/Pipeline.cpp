@@ -53,9 +53,12 @@
 namespace Urho3D
 {
 
+const ea::string Pipeline::DEFAULT_IMPORT_CACHE_DIRECTORY{"ImportCache/"};
+
 Pipeline::Pipeline(Context* context)
     : Object(context)
     , watcher_(context)
+    , importCache_(context)
 {
     if (context_->GetSubsystem<Engine>()->IsHeadless())
         return;
@@ -327,10 +330,26 @@ bool Pipeline::ExecuteImport(Asset* asset, Flavor* flavor, PipelineBuildFlags fl
         if (!importer->Accepts(asset->GetResourcePath()))
             continue;
 
-        if (importer->Execute(asset, outputPath))
+        const ea::string cacheKey = importCache_.IsEnabled()
+            ? importer->GetImportCacheKey(&importCache_, asset) : EMPTY_STRING;
+
+        bool imported = false;
+        if (!cacheKey.empty() && !(flags & PipelineBuildFlag::REFRESH_IMPORT_CACHE)
+            && importer->RestoreFromImportCache(&importCache_, cacheKey, outputPath))
+        {
+            logger_.Info("{} restored 'res://{}' from import cache.", importer->GetTypeName(), asset->GetName());
+            imported = true;
+        }
+        else if (importer->Execute(asset, outputPath))
         {
             logger_.Info("{} imported 'res://{}'.", importer->GetTypeName(), asset->GetName());
+            if (!cacheKey.empty())
+                importer->StoreInImportCache(&importCache_, cacheKey, outputPath);
+            imported = true;
+        }
 
+        if (imported)
+        {
             importedAnything = true;
             for (const ea::string& byproduct : importer->GetByproducts())
             {
@@ -351,6 +370,8 @@ void Pipeline::BuildCache(Flavor* flavor, PipelineBuildFlags flags)
     if (flavor == nullptr)
         flavor = GetDefaultFlavor();
 
+    importCache_.ResetStatistics();
+
     StringVector results;
     fs->ScanDir(results, project->GetResourcePath(), "*.*", SCAN_FILES, true);
 
@@ -369,6 +390,33 @@ void Pipeline::WaitForCompletion() const
     context_->GetSubsystem<WorkQueue>()->Complete(0);
 }
 
+void Pipeline::SetImportCacheDirectory(const ea::string& directory)
+{
+    auto* project = GetSubsystem<Project>();
+
+    importCacheDirectory_ = directory;
+    if (directory.empty())
+        importCache_.SetPath(EMPTY_STRING);
+    else if (IsAbsolutePath(directory))
+        importCache_.SetPath(directory);
+    else
+        importCache_.SetPath(project->GetProjectPath() + directory);
+}
+
+void Pipeline::LogImportCacheStatistics()
+{
+    if (!importCache_.IsEnabled())
+        return;
+
+    const unsigned numHits = importCache_.GetNumHits();
+    const unsigned numLookups = numHits + importCache_.GetNumMisses();
+    if (numLookups == 0)
+        return;
+
+    logger_.Info("Import cache: {} of {} importer executions restored ({:.1f}% hit rate).",
+        numHits, numLookups, 100.0f * numHits / numLookups);
+}
+
 void Pipeline::CreatePaksAsync(Flavor* flavor)
 {
     pendingPackageFlavor_.push_back(SharedPtr(flavor));
@@ -492,6 +540,10 @@ bool Pipeline::HasFlavorSettings(const ea::string& resourceName)
 
 void Pipeline::SerializeOptional(Archive& archive)
 {
+    // Default import cache of the project, may be overridden below
+    if (archive.IsInput())
+        SetImportCacheDirectory(importCacheDirectory_);
+
     // TODO: Revisit
     int dummy{};
     SerializeOptionalValue(archive, "pipeline", dummy, AlwaysSerialize{},
@@ -501,6 +553,12 @@ void Pipeline::SerializeOptional(Archive& archive)
         if (archive.IsInput() && archive.IsUnorderedAccessSupportedInCurrentBlock() && !archive.HasElementOrBlock("flavors"))
             return;
 
+        // Point import cache to shared directory to reuse byproducts across machines
+        ea::string importCacheDirectory = importCacheDirectory_;
+        SerializeOptionalValue(archive, "importCache", importCacheDirectory, DEFAULT_IMPORT_CACHE_DIRECTORY);
+        if (archive.IsInput())
+            SetImportCacheDirectory(importCacheDirectory);
+
         auto flavorsBlock = archive.OpenSequentialBlock("flavors");
         for (unsigned i = 0, num = archive.IsInput() ? flavorsBlock.GetSizeHint() : flavors_.size(); i < num; i++)
         {
@@ -39,6 +39,7 @@
 #include "Pipeline/Importers/SceneConverter.h"
 #include "Pipeline/Importers/TextureImporter.h"
 #include "Pipeline/Asset.h"
+#include "Pipeline/ImportCache.h"
 #include "Pipeline/Packager.h"
 #include "Pipeline/Flavor.h"
 
@@ -53,6 +54,8 @@ enum class PipelineBuildFlag : unsigned
     SKIP_UP_TO_DATE = 1U,
     /// Execute optional importers as well.
     EXECUTE_OPTIONAL = 1U << 1U,
+    /// Execute importers even if their byproducts are present in import cache. Fresh byproducts are still stored in import cache.
+    REFRESH_IMPORT_CACHE = 1U << 2U,
 };
 URHO3D_FLAGSET(PipelineBuildFlag, PipelineBuildFlags);
 
@@ -60,6 +63,9 @@ class Pipeline : public Object
 {
     URHO3D_OBJECT(Pipeline, Object);
 public:
+    /// Import cache directory of new projects, relative to project directory.
+    static const ea::string DEFAULT_IMPORT_CACHE_DIRECTORY;
+
     ///
     explicit Pipeline(Context* context);
     ///
@@ -86,6 +92,14 @@ public:
     void BuildCache(Flavor* flavor=nullptr, PipelineBuildFlags flags=PipelineBuildFlag::DEFAULT);
     /// Blocks calling thread until all pipeline tasks complete.
     void WaitForCompletion() const;
+    /// Set directory of import cache. Relative path is resolved against project directory. Empty path disables import cache.
+    void SetImportCacheDirectory(const ea::string& directory);
+    /// Returns directory of import cache as configured by user.
+    const ea::string& GetImportCacheDirectory() const { return importCacheDirectory_; }
+    /// Returns storage of importer byproducts shared between flavors and projects.
+    ImportCache* GetImportCache() { return &importCache_; }
+    /// Log import cache hit rate since last call to BuildCache().
+    void LogImportCacheStatistics();
     /// Queue packaging of resources for specified flavor. This function returns immediately, however user will be blocked from interacting with editor by modal window until process is done.
     void CreatePaksAsync(Flavor* flavor);
     /// Returns true if resource or any of it's parent directories have non-default flavor settings.
@@ -120,6 +134,10 @@ protected:
 
     /// List of file watchers responsible for watching game data folders for asset changes.
     MultiFileWatcher watcher_;
+    /// Storage of importer byproducts.
+    ImportCache importCache_;
+    /// Directory of import cache as configured by user.
+    ea::string importCacheDirectory_{DEFAULT_IMPORT_CACHE_DIRECTORY};
     /// List of pipeline flavors.
     ea::vector<SharedPtr<Flavor>> flavors_{};
     /// A list of loaded assets.
@@ -24,25 +24,23 @@
 
 #include <Urho3D/Core/Context.h>
 #include <Urho3D/Core/ProcessUtils.h>
+#include <Urho3D/Core/StringUtils.h>
+#include <Urho3D/Core/WorkQueue.h>
 #include <Urho3D/IO/File.h>
 #include <Urho3D/IO/FileSystem.h>
+#include <Urho3D/IO/PackageDelta.h>
+#include <Urho3D/IO/PackageEntryWriter.h>
 #include <Urho3D/IO/PackageFile.h>
 
 #ifdef WIN32
 #include <windows.h>
 #endif
 
-#include <EASTL/unique_ptr.h>
-#include <LZ4/lz4.h>
-#include <LZ4/lz4hc.h>
-
 #include <Urho3D/DebugNew.h>
 
 
 using namespace Urho3D;
 
-static const unsigned COMPRESSED_BLOCK_SIZE = 32768;
-
 struct FileEntry
 {
     ea::string name_;
@@ -57,8 +55,10 @@ ea::string basePath_;
 ea::vector<FileEntry> entries_;
 unsigned checksum_ = 0;
 bool compress_ = false;
+bool fastCompress_ = false;
 bool quiet_ = false;
-unsigned blockSize_ = COMPRESSED_BLOCK_SIZE;
+int numThreads_ = -1;
+StringVector highCompressionExtensions_;
 
 ea::string ignoreExtensions_[] = {
     ".bak",
@@ -70,14 +70,17 @@ void Run(const ea::vector<ea::string>& arguments);
 void ProcessFile(const ea::string& fileName, const ea::string& rootDir);
 void WritePackageFile(const ea::string& fileName, const ea::string& rootDir);
 void WriteHeader(File& dest);
+PackageCompression GetCompression(const ea::string& fileName);
 
 int main(int argc, char** argv)
 {
     SharedPtr<Context> context(new Context());
     SharedPtr<FileSystem> fileSystem(new FileSystem(context));
+    SharedPtr<WorkQueue> workQueue(new WorkQueue(context));
     ea::vector<ea::string> arguments;
     context_ = context;
     fileSystem_ = fileSystem;
+    context_->RegisterSubsystem(workQueue);
 
     #ifdef WIN32
     arguments = ParseArguments(GetCommandLineW());
@@ -97,6 +100,10 @@ void Run(const ea::vector<ea::string>& arguments)
             "\n"
             "Options:\n"
             "-c      Enable package file LZ4 compression\n"
+            "-f      Enable package file LZ4 compression, use fast mode instead of high compression mode\n"
+            "-h      Use high compression mode for files with given extensions in fast mode, e.g. -h.mdl,.ani\n"
+            "-j      Number of compression threads, e.g. -j4. All CPU cores are used by default.\n"
+            "        Package contents do not depend on number of threads.\n"
             "-q      Enable quiet mode\n"
             "\n"
             "Basepath is an optional prefix that will be added to the file entries.\n\n"
@@ -105,6 +112,10 @@ void Run(const ea::vector<ea::string>& arguments)
             "-i      Output package file information\n"
             "-l      Output file names (including their paths) contained in the package\n"
             "-L      Similar to -l but also output compression ratio (compressed package file only)\n"
+            "\n"
+            "Delta usage: PackageTool -d <package name> <old package name> [delta name]\n"
+            "Writes delta that updates old version of the package to the package. By default the delta is written\n"
+            "next to the package, where the server looks for deltas when clients download the package.\n"
         );
 
     const ea::string& dirName = arguments[0];
@@ -125,6 +136,16 @@ void Run(const ea::vector<ea::string>& arguments)
                     case 'c':
                         compress_ = true;
                         break;
+                    case 'f':
+                        compress_ = true;
+                        fastCompress_ = true;
+                        break;
+                    case 'h':
+                        highCompressionExtensions_ = arguments[i].substr(2).to_lower().split(',');
+                        break;
+                    case 'j':
+                        numThreads_ = ToInt(arguments[i].substr(2));
+                        break;
                     case 'q':
                         quiet_ = true;
                         break;
@@ -192,6 +213,14 @@ void Run(const ea::vector<ea::string>& arguments)
         for (unsigned i = 0; i < fileNames.size(); ++i)
             ProcessFile(fileNames[i], dirName);
 
+        if (compress_)
+        {
+            // Main thread is busy reading and writing files, so all worker threads are used for compression
+            const unsigned numThreads = numThreads_ >= 0 ? static_cast<unsigned>(numThreads_) : GetNumLogicalCPUs();
+            if (numThreads > 0)
+                context_->GetSubsystem<WorkQueue>()->CreateThreads(numThreads);
+        }
+
         WritePackageFile(packageName, dirName);
     }
     else
@@ -231,6 +260,30 @@ void Run(const ea::vector<ea::string>& arguments)
                 }
             }
             break;
+        case 'd':
+            {
+                if (arguments.size() < 3)
+                    ErrorExit("Old package name is not specified");
+
+                SharedPtr<PackageFile> oldPackageFile(new PackageFile(context_, arguments[2]));
+                if (!oldPackageFile->GetNumFiles() || !packageFile->GetNumFiles())
+                    ErrorExit("Could not open package files");
+
+                const ea::string deltaName = arguments.size() > 3
+                    ? arguments[3] : GetPackageDeltaFileName(packageName, oldPackageFile->GetChecksum());
+                File dest(context_);
+                if (!dest.Open(deltaName, FILE_WRITE))
+                    ErrorExit("Could not open output file " + deltaName);
+                if (!CreatePackageDelta(oldPackageFile, packageFile, dest))
+                    ErrorExit("Could not write package delta");
+
+                if (!quiet_)
+                {
+                    PrintLine("Delta size: " + ea::to_string(dest.GetSize()));
+                    PrintLine("Package size: " + ea::to_string(packageFile->GetTotalSize()));
+                }
+            }
+            break;
         default:
             ErrorExit("Unrecognized output option");
         }
@@ -276,6 +329,8 @@ void WritePackageFile(const ea::string& fileName, const ea::string& rootDir)
     unsigned totalDataSize = 0;
     unsigned lastOffset;
 
+    PackageEntryWriter writer(context_->GetSubsystem<WorkQueue>());
+
     // Write file data, calculate checksums & correct offsets
     for (unsigned i = 0; i < entries_.size(); ++i)
     {
@@ -288,48 +343,16 @@ void WritePackageFile(const ea::string& fileName, const ea::string& rootDir)
 
         unsigned dataSize = entries_[i].size_;
         totalDataSize += dataSize;
-        ea::unique_ptr<unsigned char[]> buffer(new unsigned char[dataSize]);
-
-        if (srcFile.Read(&buffer[0], dataSize) != dataSize)
-            ErrorExit("Could not read file " + fileFullPath);
-        srcFile.Close();
 
-        for (unsigned j = 0; j < dataSize; ++j)
-        {
-            checksum_ = SDBMHash(checksum_, buffer[j]);
-            entries_[i].checksum_ = SDBMHash(entries_[i].checksum_, buffer[j]);
-        }
+        const PackageCompression compression = GetCompression(entries_[i].name_);
+        if (!writer.Write(dest, srcFile, dataSize, compression, entries_[i].checksum_, checksum_))
+            ErrorExit("Could not write file " + fileFullPath);
 
-        if (!compress_)
+        if (!quiet_)
         {
-            if (!quiet_)
+            if (!compress_)
                 PrintLine(entries_[i].name_ + " size " + ea::to_string(dataSize));
-            dest.Write(&buffer[0], entries_[i].size_);
-        }
-        else
-        {
-            ea::unique_ptr<unsigned char[]> compressBuffer(new unsigned char[LZ4_compressBound(blockSize_)]);
-
-            unsigned pos = 0;
-
-            while (pos < dataSize)
-            {
-                unsigned unpackedSize = blockSize_;
-                if (pos + unpackedSize > dataSize)
-                    unpackedSize = dataSize - pos;
-
-                auto packedSize = (unsigned)LZ4_compress_HC((const char*)&buffer[pos], (char*)compressBuffer.get(), unpackedSize, LZ4_compressBound(unpackedSize), 0);
-                if (!packedSize)
-                    ErrorExit("LZ4 compression failed for file " + entries_[i].name_ + " at offset " + ea::to_string(pos));
-
-                dest.WriteUShort((unsigned short)unpackedSize);
-                dest.WriteUShort((unsigned short)packedSize);
-                dest.Write(compressBuffer.get(), packedSize);
-
-                pos += unpackedSize;
-            }
-
-            if (!quiet_)
+            else
             {
                 unsigned totalPackedBytes = dest.GetSize() - lastOffset;
                 ea::string fileEntry(entries_[i].name_);
@@ -375,3 +398,18 @@ void WriteHeader(File& dest)
     dest.WriteUInt(entries_.size());
     dest.WriteUInt(checksum_);
 }
+
+PackageCompression GetCompression(const ea::string& fileName)
+{
+    if (!compress_)
+        return PackageCompression::None;
+
+    if (!fastCompress_)
+        return PackageCompression::LZ4HC;
+
+    const ea::string extension = GetExtension(fileName);
+    if (highCompressionExtensions_.contains(extension))
+        return PackageCompression::LZ4HC;
+
+    return PackageCompression::LZ4;
+}
@@ -217,6 +217,7 @@ URHO3D_REFCOUNTED(Urho3D::RefCounted);
 %director Urho3D::RefCounted;
 %ignore Urho3D::RefCounted::RefCountPtr;
 %ignore Urho3D::RefCount;
+%ignore Urho3D::RefCounted::operator delete;
 %csmethodmodifiers Urho3D::RefCounted::SetScriptObject "internal"
 %csmethodmodifiers Urho3D::RefCounted::GetScriptObject "internal"
 %include "Urho3D/Container/RefCounted.h"
@@ -328,6 +328,7 @@ namespace SDL
 %ignore Urho3D::Detail::CriticalSection;
 %ignore Urho3D::MutexLock;
 %ignore Urho3D::ObjectReflectionRegistry::GetReflection(StringHash typeNameHash) const;
+%ignore Urho3D::ObjectReflection::GetObjectPool;
 
 %include "Object.i"
 %director Urho3D::AttributeAccessor;
@@ -483,6 +484,7 @@ public:
 %ignore Urho3D::NodeReplicationState::dirtyVars_;		// Needs HashSet wrapped
 %ignore Urho3D::Animatable::animatedNetworkAttributes_; // Needs HashSet wrapped
 %ignore Urho3D::AsyncProgress::resources_;
+%ignore Urho3D::AsyncProgress::nodeTreeQueue_;
 %ignore Urho3D::ValueAnimation::GetKeyFrames;
 %ignore Urho3D::Serializable::networkState_;
 %ignore Urho3D::Serializable::instanceDefaultValues_;
@@ -496,6 +498,7 @@ public:
 %ignore Urho3D::Node::SetEntity;
 %ignore Urho3D::Scene::GetRegistry;
 %ignore Urho3D::Scene::GetComponentIndex;
+%ignore Urho3D::Scene::GetTransformHierarchy;
 %ignore Urho3D::Animatable::animationEnabled_;
 %ignore Urho3D::Animatable::objectAnimation_;
 %ignore Urho3D::Component::node_;
@@ -515,6 +518,7 @@ public:
 %include "Urho3D/Scene/ValueAnimation.h"
 %include "Urho3D/Scene/LogicComponent.h"
 %include "Urho3D/Scene/ObjectAnimation.h"
+%include "Urho3D/Scene/Prefab.h"
 %include "Urho3D/Scene/SceneResolver.h"
 %include "Urho3D/Scene/SmoothedTransform.h"
 %include "Urho3D/Scene/UnknownComponent.h"
@@ -552,6 +556,9 @@ public:
 %ignore Urho3D::PointOctreeQuery::TestDrawables;
 %ignore Urho3D::BoxOctreeQuery::TestDrawables;
 %ignore Urho3D::OctreeQuery::TestDrawables;
+%ignore Urho3D::Octree::GetAnimationPoseCache;
+%ignore Urho3D::AnimatedNodeTransforms;
+%ignore Urho3D::AnimationState::SampleNodeTracks;
 %ignore Urho3D::UpdateDrawablesWork;
 %ignore Urho3D::ProcessLightWork;
 %ignore Urho3D::CheckVisibilityWork;
@@ -0,0 +1,236 @@
+//
+// Copyright (c) 2021-2022 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "../Precompiled.h"
+
+#include "../Container/ObjectPool.h"
+#include "../Math/MathDefs.h"
+
+#include <EASTL/algorithm.h>
+#include <EASTL/unordered_map.h>
+
+#include <cstddef>
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+namespace
+{
+
+/// Registry of all pools. Pools are never destroyed.
+struct ObjectPoolRegistry
+{
+    /// Mutex for registration.
+    Mutex mutex_;
+    /// Pools by object type.
+    ea::unordered_map<StringHash, ObjectPool*> poolsByType_;
+};
+
+ObjectPoolRegistry& GetRegistry()
+{
+    // Intentionally leaked: pooled objects may be deleted during static destruction
+    static auto registry = new ObjectPoolRegistry;
+    return *registry;
+}
+
+}
+
+ObjectPool* ObjectPool::GetOrCreate(StringHash type, unsigned objectSize, unsigned objectAlignment, unsigned objectsPerSlab)
+{
+    // Free blocks should be able to store the link to the next free block
+    if (objectSize > MaxObjectSize || objectSize < sizeof(void*))
+        return nullptr;
+
+    ObjectPoolRegistry& registry = GetRegistry();
+    MutexLock lock(registry.mutex_);
+
+    ObjectPool*& pool = registry.poolsByType_[type];
+    if (pool)
+    {
+        assert(pool->objectSize_ == objectSize);
+        return pool;
+    }
+
+    pool = new ObjectPool(type, objectSize, objectAlignment, ea::max(1u, objectsPerSlab));
+    return pool;
+}
+
+ea::vector<ObjectPoolStats> ObjectPool::GetAllStats()
+{
+    ObjectPoolRegistry& registry = GetRegistry();
+    MutexLock lock(registry.mutex_);
+
+    ea::vector<ObjectPoolStats> result;
+    for (const auto& item : registry.poolsByType_)
+        result.push_back(item.second->GetStats());
+    return result;
+}
+
+unsigned ObjectPool::TrimAll()
+{
+    ObjectPoolRegistry& registry = GetRegistry();
+    MutexLock lock(registry.mutex_);
+
+    unsigned numReleasedSlabs = 0;
+    for (const auto& item : registry.poolsByType_)
+        numReleasedSlabs += item.second->Trim();
+    return numReleasedSlabs;
+}
+
+ObjectPool::ObjectPool(StringHash type, unsigned objectSize, unsigned objectAlignment, unsigned objectsPerSlab)
+    : type_(type)
+    , objectSize_(objectSize)
+    , objectAlignment_(ea::max<unsigned>(objectAlignment, alignof(std::max_align_t)))
+    , blockSize_((objectSize + objectAlignment_ - 1) / objectAlignment_ * objectAlignment_)
+    , objectsPerSlab_(objectsPerSlab)
+{
+}
+
+void* ObjectPool::Allocate()
+{
+    MutexLock lock(mutex_);
+
+    if (!freeList_)
+        AllocateSlab();
+
+    void* ptr = freeList_;
+    freeList_ = *static_cast<void**>(freeList_);
+
+    ++numObjects_;
+    ++numAllocations_;
+    peakNumObjects_ = ea::max(peakNumObjects_, numObjects_);
+    return ptr;
+}
+
+void ObjectPool::Free(void* ptr)
+{
+    MutexLock lock(mutex_);
+
+    assert(numObjects_ > 0);
+    *static_cast<void**>(ptr) = freeList_;
+    freeList_ = ptr;
+    --numObjects_;
+}
+
+unsigned ObjectPool::Trim()
+{
+    MutexLock lock(mutex_);
+
+    if (numObjects_ == slabs_.size() * objectsPerSlab_)
+        return 0;
+
+    ea::vector<unsigned> numFreeBlocks(slabs_.size());
+    for (void* block = freeList_; block; block = *static_cast<void**>(block))
+        ++numFreeBlocks[FindSlab(block)];
+
+    // Unlink blocks of empty slabs, keep the order of remaining free blocks
+    void** nextLink = &freeList_;
+    for (void* block = freeList_; block; )
+    {
+        void* nextBlock = *static_cast<void**>(block);
+        if (numFreeBlocks[FindSlab(block)] != objectsPerSlab_)
+        {
+            *nextLink = block;
+            nextLink = static_cast<void**>(block);
+        }
+        block = nextBlock;
+    }
+    *nextLink = nullptr;
+
+    unsigned numReleasedSlabs = 0;
+    for (unsigned i = 0; i < slabs_.size(); ++i)
+    {
+        if (numFreeBlocks[i] == objectsPerSlab_)
+        {
+            delete[] slabs_[i].memory_;
+            slabs_[i].memory_ = nullptr;
+            ++numReleasedSlabs;
+        }
+    }
+    ea::erase_if(slabs_, [](const Slab& slab) { return !slab.memory_; });
+    return numReleasedSlabs;
+}
+
+bool ObjectPool::IsOwned(const void* ptr) const
+{
+    MutexLock lock(mutex_);
+    return FindSlab(ptr) != M_MAX_UNSIGNED;
+}
+
+unsigned ObjectPool::FindSlab(const void* ptr) const
+{
+    const auto bytes = static_cast<const unsigned char*>(ptr);
+    const unsigned slabSize = blockSize_ * objectsPerSlab_;
+
+    // Find the last slab that begins not after the pointer
+    const auto iter = ea::upper_bound(slabs_.begin(), slabs_.end(), bytes,
+        [](const unsigned char* lhs, const Slab& rhs) { return lhs < rhs.begin_; });
+    if (iter == slabs_.begin())
+        return M_MAX_UNSIGNED;
+
+    const Slab& slab = *(iter - 1);
+    if (bytes >= slab.begin_ + slabSize)
+        return M_MAX_UNSIGNED;
+    return static_cast<unsigned>(iter - 1 - slabs_.begin());
+}
+
+ObjectPoolStats ObjectPool::GetStats() const
+{
+    MutexLock lock(mutex_);
+
+    ObjectPoolStats stats;
+    stats.type_ = type_;
+    stats.objectSize_ = objectSize_;
+    stats.numSlabs_ = slabs_.size();
+    stats.capacity_ = stats.numSlabs_ * objectsPerSlab_;
+    stats.numObjects_ = numObjects_;
+    stats.peakNumObjects_ = peakNumObjects_;
+    stats.numAllocations_ = numAllocations_;
+    stats.memoryUse_ = static_cast<unsigned long long>(stats.numSlabs_) * (blockSize_ * objectsPerSlab_ + objectAlignment_);
+    return stats;
+}
+
+void ObjectPool::AllocateSlab()
+{
+    // Memory is aligned manually
+    const unsigned slabSize = blockSize_ * objectsPerSlab_;
+    auto memory = new unsigned char[slabSize + objectAlignment_];
+    const auto address = reinterpret_cast<uintptr_t>(memory);
+    auto slab = memory + (objectAlignment_ - address % objectAlignment_) % objectAlignment_;
+
+    const auto iter = ea::upper_bound(slabs_.begin(), slabs_.end(), slab,
+        [](const unsigned char* lhs, const Slab& rhs) { return lhs < rhs.begin_; });
+    slabs_.insert(iter, Slab{ memory, slab });
+
+    // Chain blocks so that the first block of the slab is allocated first
+    for (unsigned i = objectsPerSlab_; i > 0; --i)
+    {
+        void* block = slab + (i - 1) * blockSize_;
+        *static_cast<void**>(block) = freeList_;
+        freeList_ = block;
+    }
+}
+
+}
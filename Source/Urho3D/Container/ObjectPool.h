@@ -0,0 +1,127 @@
+//
+// Copyright (c) 2021-2022 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#pragma once
+
+#include "../Core/Mutex.h"
+#include "../Math/StringHash.h"
+
+#include <EASTL/vector.h>
+
+namespace Urho3D
+{
+
+/// Memory statistics of object pool.
+struct ObjectPoolStats
+{
+    /// Type of pooled objects.
+    StringHash type_;
+    /// Size of pooled object in bytes.
+    unsigned objectSize_{};
+    /// Number of allocated slabs.
+    unsigned numSlabs_{};
+    /// Number of objects that fit into allocated slabs.
+    unsigned capacity_{};
+    /// Number of currently allocated objects.
+    unsigned numObjects_{};
+    /// Max number of simultaneously allocated objects.
+    unsigned peakNumObjects_{};
+    /// Total number of allocations.
+    unsigned long long numAllocations_{};
+    /// Memory reserved by slabs in bytes.
+    unsigned long long memoryUse_{};
+};
+
+/// Thread-safe pool of fixed-size memory blocks for objects of one type, allocated in slabs.
+/// Memory of deleted RefCounted objects is returned to the pool automatically if the object was marked as pooled.
+/// Pools are never destroyed, so pooled objects may safely outlive Context. Empty slabs are released by Trim.
+class URHO3D_API ObjectPool : private NonCopyable
+{
+public:
+    /// Default number of objects in one slab.
+    static const unsigned DefaultObjectsPerSlab = 64;
+    /// Max size of pooled object.
+    static const unsigned MaxObjectSize = 8192;
+
+    /// Return existing or create new pool for given type. Return null if objects of this size cannot be pooled.
+    static ObjectPool* GetOrCreate(StringHash type, unsigned objectSize, unsigned objectAlignment,
+        unsigned objectsPerSlab = DefaultObjectsPerSlab);
+    /// Return statistics of all pools.
+    static ea::vector<ObjectPoolStats> GetAllStats();
+    /// Release empty slabs of all pools. Return number of released slabs.
+    static unsigned TrimAll();
+
+    /// Allocate memory for one object.
+    void* Allocate();
+    /// Return memory of object to the pool.
+    void Free(void* ptr);
+    /// Release slabs that have no allocated objects. Return number of released slabs.
+    unsigned Trim();
+    /// Return whether the memory is owned by the pool.
+    bool IsOwned(const void* ptr) const;
+    /// Return memory statistics.
+    ObjectPoolStats GetStats() const;
+
+private:
+    /// Slab of memory blocks.
+    struct Slab
+    {
+        /// Allocated memory.
+        unsigned char* memory_{};
+        /// Aligned beginning of the first block.
+        unsigned char* begin_{};
+    };
+
+    /// Construct.
+    ObjectPool(StringHash type, unsigned objectSize, unsigned objectAlignment, unsigned objectsPerSlab);
+    /// Allocate new slab and add its blocks to the free list.
+    void AllocateSlab();
+    /// Return index of the slab that owns the memory, M_MAX_UNSIGNED if not found. Mutex should be locked.
+    unsigned FindSlab(const void* ptr) const;
+
+    /// Type of pooled objects.
+    const StringHash type_;
+    /// Size of pooled object in bytes.
+    const unsigned objectSize_{};
+    /// Alignment of pooled objects.
+    const unsigned objectAlignment_{};
+    /// Size of memory block in bytes.
+    const unsigned blockSize_{};
+    /// Number of objects in one slab.
+    const unsigned objectsPerSlab_{};
+
+    /// Mutex for pool state.
+    mutable SpinLockMutex mutex_;
+    /// Slabs sorted by address.
+    ea::vector<Slab> slabs_;
+    /// First free memory block. Free blocks are chained.
+    void* freeList_{};
+    /// Number of currently allocated objects.
+    unsigned numObjects_{};
+    /// Max number of simultaneously allocated objects.
+    unsigned peakNumObjects_{};
+    /// Total number of allocations.
+    unsigned long long numAllocations_{};
+};
+
+}
@@ -0,0 +1,178 @@
+//
+// Copyright (c) 2021-2022 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include "../Core/WorkQueue.h"
+
+#include <EASTL/algorithm.h>
+#include <EASTL/array.h>
+#include <EASTL/span.h>
+#include <EASTL/vector.h>
+
+namespace Urho3D
+{
+
+/// Histogram of key bytes for single pass of radix sort.
+using RadixSortHistogram = ea::array<unsigned, 256>;
+
+/// Count key bytes with given index in range of elements.
+/// Signature of getKeyByte: unsigned char(const T& element, unsigned byteIndex)
+template <class T, class GetKeyByte>
+void AccumulateRadixSortHistogram(const T* begin, const T* end, unsigned byteIndex,
+    const GetKeyByte& getKeyByte, RadixSortHistogram& histogram)
+{
+    for (const T* element = begin; element != end; ++element)
+        ++histogram[getKeyByte(*element, byteIndex)];
+}
+
+/// Move range of elements to destination according to offsets of buckets. Offsets are advanced.
+template <class T, class GetKeyByte>
+void ScatterRadixSortElements(T* begin, T* end, T* dest, unsigned byteIndex,
+    const GetKeyByte& getKeyByte, RadixSortHistogram& offsets)
+{
+    for (T* element = begin; element != end; ++element)
+        dest[offsets[getKeyByte(*element, byteIndex)]++] = ea::move(*element);
+}
+
+/// Return whether all elements have the same key byte, so the pass can be skipped.
+inline bool IsRadixSortPassTrivial(const RadixSortHistogram& histogram, unsigned numElements)
+{
+    return ea::any_of(histogram.begin(), histogram.end(),
+        [&](unsigned count) { return count == numElements; });
+}
+
+/// Sort elements in ascending order using stable LSD radix sort.
+/// Key consists of numKeyBytes bytes, byte 0 is the least significant one.
+/// Scratch buffer should have at least as many elements as the sorted range.
+/// Signature of getKeyByte: unsigned char(const T& element, unsigned byteIndex)
+template <class T, class GetKeyByte>
+void RadixSort(ea::span<T> elements, ea::span<T> scratch, unsigned numKeyBytes, const GetKeyByte& getKeyByte)
+{
+    const auto numElements = static_cast<unsigned>(elements.size());
+    if (numElements <= 1)
+        return;
+
+    assert(scratch.size() >= elements.size());
+
+    // Histograms don't depend on order of elements, so they are collected in one go
+    ea::vector<RadixSortHistogram> histograms(numKeyBytes);
+    for (unsigned byteIndex = 0; byteIndex < numKeyBytes; ++byteIndex)
+    {
+        histograms[byteIndex].fill(0);
+        AccumulateRadixSortHistogram(elements.data(), elements.data() + numElements, byteIndex, getKeyByte,
+            histograms[byteIndex]);
+    }
+
+    T* source = elements.data();
+    T* dest = scratch.data();
+    for (unsigned byteIndex = 0; byteIndex < numKeyBytes; ++byteIndex)
+    {
+        RadixSortHistogram& offsets = histograms[byteIndex];
+        if (IsRadixSortPassTrivial(offsets, numElements))
+            continue;
+
+        unsigned offset = 0;
+        for (unsigned& count : offsets)
+        {
+            const unsigned bucketSize = count;
+            count = offset;
+            offset += bucketSize;
+        }
+
+        ScatterRadixSortElements(source, source + numElements, dest, byteIndex, getKeyByte, offsets);
+        ea::swap(source, dest);
+    }
+
+    if (source != elements.data())
+        ea::move(source, source + numElements, elements.data());
+}
+
+/// Sort elements in ascending order using stable LSD radix sort in multiple threads.
+/// Each thread processes contiguous chunk of elements, so result doesn't depend on number of threads.
+/// Fallbacks to single-threaded sort if there are less than minElementsPerThread elements per thread.
+template <class T, class GetKeyByte>
+void RadixSortParallel(WorkQueue* workQueue, unsigned minElementsPerThread,
+    ea::span<T> elements, ea::span<T> scratch, unsigned numKeyBytes, const GetKeyByte& getKeyByte)
+{
+    const auto numElements = static_cast<unsigned>(elements.size());
+    const unsigned maxThreads = workQueue ? workQueue->GetNumThreads() + 1 : 1;
+    const unsigned maxChunks = ea::min(maxThreads, numElements / ea::max(1u, minElementsPerThread));
+    if (maxChunks <= 1)
+    {
+        RadixSort(elements, scratch, numKeyBytes, getKeyByte);
+        return;
+    }
+
+    assert(scratch.size() >= elements.size());
+
+    const unsigned chunkSize = (numElements + maxChunks - 1) / maxChunks;
+    const unsigned numChunks = (numElements + chunkSize - 1) / chunkSize;
+    ea::vector<RadixSortHistogram> histograms(numChunks);
+
+    T* source = elements.data();
+    T* dest = scratch.data();
+    for (unsigned byteIndex = 0; byteIndex < numKeyBytes; ++byteIndex)
+    {
+        ForEachParallel(workQueue, chunkSize, numElements, [&](unsigned beginIndex, unsigned endIndex)
+        {
+            RadixSortHistogram& histogram = histograms[beginIndex / chunkSize];
+            histogram.fill(0);
+            AccumulateRadixSortHistogram(source + beginIndex, source + endIndex, byteIndex, getKeyByte, histogram);
+        });
+
+        // Elements of each bucket are placed in order of chunks to keep the sort stable
+        unsigned offset = 0;
+        bool isTrivial = false;
+        for (unsigned bucket = 0; bucket < histograms[0].size(); ++bucket)
+        {
+            const unsigned bucketBegin = offset;
+            for (RadixSortHistogram& histogram : histograms)
+            {
+                const unsigned count = histogram[bucket];
+                histogram[bucket] = offset;
+                offset += count;
+            }
+
+            if (offset - bucketBegin == numElements)
+            {
+                isTrivial = true;
+                break;
+            }
+        }
+
+        if (isTrivial)
+            continue;
+
+        ForEachParallel(workQueue, chunkSize, numElements, [&](unsigned beginIndex, unsigned endIndex)
+        {
+            RadixSortHistogram& offsets = histograms[beginIndex / chunkSize];
+            ScatterRadixSortElements(source + beginIndex, source + endIndex, dest, byteIndex, getKeyByte, offsets);
+        });
+        ea::swap(source, dest);
+    }
+
+    if (source != elements.data())
+        ea::move(source, source + numElements, elements.data());
+}
+
+}
@@ -25,7 +25,9 @@
 #include <cassert>
 
 #include <EASTL/internal/thread_support.h>
+#include <EASTL/utility.h>
 
+#include "../Container/ObjectPool.h"
 #include "../Container/RefCounted.h"
 #include "../Core/Macros.h"
 #if URHO3D_CSHARP
@@ -35,6 +37,14 @@
 namespace Urho3D
 {
 
+namespace
+{
+
+/// Pool of the object destroyed last on this thread. Passed from destructor to operator delete.
+thread_local ObjectPool* destroyedObjectPool = nullptr;
+
+}
+
 RefCount* RefCount::Allocate()
 {
     void* const memory = EASTLAlloc(*ea::get_default_allocator((Allocator*)nullptr), sizeof(RefCount));
@@ -78,11 +88,33 @@ RefCounted::~RefCounted()
 
     // Mark object as expired, release the self weak ref and delete the refcount if no other weak refs exist
     refCount_->refs_ = -1;
+    ObjectPool* objectPool = refCount_->objectPool_;
 
     if (ea::Internal::atomic_decrement(&refCount_->weakRefs_) == 0)
         RefCount::Free(refCount_);
 
     refCount_ = nullptr;
+
+    // Operator delete, if any, is called right after the destructor on the same thread
+    destroyedObjectPool = objectPool;
+}
+
+void RefCounted::operator delete(void* ptr, std::size_t size)
+{
+    ObjectPool* objectPool = ea::exchange(destroyedObjectPool, nullptr);
+    if (objectPool)
+        objectPool->Free(ptr);
+    else
+        ::operator delete(ptr, size);
+}
+
+void RefCounted::operator delete(void* ptr, std::size_t size, std::align_val_t alignment)
+{
+    ObjectPool* objectPool = ea::exchange(destroyedObjectPool, nullptr);
+    if (objectPool)
+        objectPool->Free(ptr);
+    else
+        ::operator delete(ptr, size, alignment);
 }
 
 int RefCounted::AddRef()
@@ -24,11 +24,16 @@
 
 #include <EASTL/allocator.h>
 
+#include <cstddef>
+#include <new>
+
 #include <Urho3D/Urho3D.h>
 
 namespace Urho3D
 {
 
+class ObjectPool;
+
 /// Reference count structure.
 struct URHO3D_API RefCount
 {
@@ -56,6 +61,8 @@ public:
     int refs_ = 0;
     /// Weak reference count.
     int weakRefs_ = 0;
+    /// Pool that owns memory of the object. Null if the object was not allocated from ObjectPool.
+    ObjectPool* objectPool_{};
 };
 
 /// Base class for intrusively reference-counted objects. These are noncopyable and non-assignable.
@@ -72,6 +79,11 @@ public:
     /// Prevent assignment.
     RefCounted& operator =(const RefCounted& rhs) = delete;
 
+    /// Deallocate memory of the object. Memory of pooled object is returned to the pool without lookup.
+    static void operator delete(void* ptr, std::size_t size);
+    /// Deallocate memory of the over-aligned object. Memory of pooled object is returned to the pool without lookup.
+    static void operator delete(void* ptr, std::size_t size, std::align_val_t alignment);
+
     /// Increment reference count. Can also be called outside of a SharedPtr for traditional reference counting. Returns new reference count value. Operation is atomic.
     /// @manualbind
     int AddRef();
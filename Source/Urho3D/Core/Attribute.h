@@ -58,7 +58,9 @@ enum AttributeMode
 };
 URHO3D_FLAGSET(AttributeMode, AttributeModeFlags);
 
+class Deserializer;
 class Serializable;
+class Serializer;
 
 /// Abstract base class for invoking attribute accessors.
 class URHO3D_API AttributeAccessor : public RefCounted
@@ -70,6 +72,14 @@ public:
     virtual void Get(const Serializable* ptr, Variant& dest) const = 0;
     /// Set the attribute.
     virtual void Set(Serializable* ptr, const Variant& src) = 0;
+#ifndef SWIG
+    /// Return whether the attribute can be read and written directly as binary data without intermediate Variant.
+    virtual bool HasBinaryAccess() const { return false; }
+    /// Read the attribute from binary stream directly. Should be called only if HasBinaryAccess() is true.
+    virtual void ReadBinary(Serializable* ptr, Deserializer& source) { }
+    /// Write the attribute to binary stream directly. Should be called only if HasBinaryAccess() is true. Return true if successful.
+    virtual bool WriteBinary(const Serializable* ptr, Serializer& dest) const { return false; }
+#endif
 };
 
 /// Description of an automatically serializable variable.
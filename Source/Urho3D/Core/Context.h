@@ -101,6 +101,8 @@ public:
 
     /// Deprecated. Use RegisterObject instead.
     template <class T> void RegisterFactory(const char* category = "") { AddFactoryReflection<T>(category); }
+    /// Register factory that allocates objects from ObjectPool. Use for types that are created and destroyed often.
+    template <class T> void RegisterPooledFactory(const char* category = "", unsigned objectsPerSlab = ObjectPool::DefaultObjectsPerSlab);
     /// Template version of registering subsystem.
     template <class T> T* RegisterSubsystem();
     /// Template version of removing a subsystem.
@@ -207,6 +209,12 @@ private:
     VariantMap globalVars_;
 };
 
+template <class T> void Context::RegisterPooledFactory(const char* category, unsigned objectsPerSlab)
+{
+    if (ObjectReflection* reflection = AddFactoryReflection<T>(category))
+        reflection->SetPooledObjectFactory<T>(objectsPerSlab);
+}
+
 template <class T> T* Context::RegisterSubsystem()
 {
     auto* subsystem = new T(this);
@@ -59,8 +59,17 @@ ObjectReflection::ObjectReflection(Context* context, ea::unique_ptr<TypeInfo> ty
 {
 }
 
+void ObjectReflection::SetObjectFactory(ObjectFactoryCallback callback)
+{
+    createObject_ = callback;
+    objectPool_ = nullptr;
+    createPooledObject_ = nullptr;
+}
+
 SharedPtr<Object> ObjectReflection::CreateObject()
 {
+    if (createPooledObject_)
+        return createPooledObject_(objectPool_, context_);
     return createObject_ ? createObject_(typeInfo_, context_) : nullptr;
 }
 
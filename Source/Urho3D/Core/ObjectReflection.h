@@ -23,6 +23,7 @@
 #pragma once
 
 #include "../Core/Attribute.h"
+#include "../Container/ObjectPool.h"
 #include "../Container/Ptr.h"
 
 #include <EASTL/functional.h>
@@ -42,16 +43,20 @@ class URHO3D_API ObjectReflection : public RefCounted
 {
 public:
     using ObjectFactoryCallback = SharedPtr<Object>(*)(const TypeInfo* typeInfo, Context* context);
+    using PooledObjectFactoryCallback = SharedPtr<Object>(*)(ObjectPool* objectPool, Context* context);
 
     ObjectReflection(Context* context, const TypeInfo* typeInfo);
     ObjectReflection(Context* context, ea::unique_ptr<TypeInfo> typeInfo);
 
     /// @name Factory management
     /// @{
-    void SetObjectFactory(ObjectFactoryCallback callback) { createObject_ = callback; }
+    void SetObjectFactory(ObjectFactoryCallback callback);
     template <class T> void SetObjectFactory();
+    /// Create objects in memory of ObjectPool. Fallback to default factory if objects cannot be pooled.
+    template <class T> void SetPooledObjectFactory(unsigned objectsPerSlab = ObjectPool::DefaultObjectsPerSlab);
     SharedPtr<Object> CreateObject();
-    bool HasObjectFactory() const { return createObject_ != nullptr; }
+    bool HasObjectFactory() const { return createObject_ != nullptr || createPooledObject_ != nullptr; }
+    ObjectPool* GetObjectPool() const { return objectPool_; }
     /// @}
 
     /// @name Category management
@@ -95,6 +100,9 @@ private:
     const TypeInfo* typeInfo_{};
     ea::unique_ptr<TypeInfo> ownedTypeInfo_;
     ObjectFactoryCallback createObject_{};
+    /// Pool and factory of pooled objects.
+    ObjectPool* objectPool_{};
+    PooledObjectFactoryCallback createPooledObject_{};
     /// Category of the object.
     ea::string category_;
 
@@ -169,7 +177,33 @@ private:
 template <class T>
 void ObjectReflection::SetObjectFactory()
 {
-    createObject_ = +[](const TypeInfo* typeInfo, Context* context) { return StaticCast<Object>(MakeShared<T>(context)); };
+    SetObjectFactory(+[](const TypeInfo* typeInfo, Context* context) { return StaticCast<Object>(MakeShared<T>(context)); });
+}
+
+template <class T>
+void ObjectReflection::SetPooledObjectFactory(unsigned objectsPerSlab)
+{
+    SetObjectFactory<T>();
+
+    objectPool_ = ObjectPool::GetOrCreate(T::GetTypeStatic(), sizeof(T), alignof(T), objectsPerSlab);
+    if (!objectPool_)
+        return;
+
+    createPooledObject_ = +[](ObjectPool* objectPool, Context* context)
+    {
+        void* memory = objectPool->Allocate();
+        try
+        {
+            T* object = new (memory) T(context);
+            object->RefCountPtr()->objectPool_ = objectPool;
+            return StaticCast<Object>(SharedPtr<T>(object));
+        }
+        catch (...)
+        {
+            objectPool->Free(memory);
+            throw;
+        }
+    };
 }
 
 template <class T>
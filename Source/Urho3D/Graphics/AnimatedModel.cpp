@@ -102,6 +102,8 @@ void AnimatedModel::RegisterObject(Context* context)
     URHO3D_ACCESSOR_ATTRIBUTE("Shadow Distance", GetShadowDistance, SetShadowDistance, float, 0.0f, AM_DEFAULT);
     URHO3D_ACCESSOR_ATTRIBUTE("LOD Bias", GetLodBias, SetLodBias, float, 1.0f, AM_DEFAULT);
     URHO3D_ACCESSOR_ATTRIBUTE("Animation LOD Bias", GetAnimationLodBias, SetAnimationLodBias, float, 1.0f, AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("Nodeless Skeleton", IsNodelessSkeleton, SetNodelessSkeleton, bool, false, AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("Pose Cache Time Step", GetPoseCacheTimeStep, SetPoseCacheTimeStep, float, 0.0f, AM_DEFAULT);
     URHO3D_COPY_BASE_ATTRIBUTES(Drawable);
     URHO3D_MIXED_ACCESSOR_ATTRIBUTE("Bone Animation Enabled", GetBonesEnabledAttr, SetBonesEnabledAttr, VariantVector,
         Variant::emptyVariantVector, AM_FILE | AM_NOEDIT);
@@ -166,18 +168,24 @@ void AnimatedModel::ProcessCustomRayQuery(const RayOctreeQuery& query, const Bou
         return;
 
     const ea::vector<Bone>& bones = skeleton_.GetBones();
+    const bool hasBonePose = HasBonePose();
 
     for (unsigned i = 0; i < bones.size(); ++i)
     {
         const Bone& bone = bones[i];
-        if (!bone.node_)
+        if (!bone.node_ && !hasBonePose)
             continue;
 
         float distance;
 
         // Keep this check to reuse this function for normal raycast without dedicated array of matrices.
-        const Matrix3x4& transform =
-            i < boneWorldTransforms.size() ? boneWorldTransforms[i] : bone.node_->GetWorldTransform();
+        Matrix3x4 transform;
+        if (i < boneWorldTransforms.size())
+            transform = boneWorldTransforms[i];
+        else if (hasBonePose)
+            transform = worldTransform * boneModelTransforms_[i];
+        else
+            transform = bone.node_->GetWorldTransform();
 
         // Use hitbox if available
         if (bone.collisionMask_ & BONECOLLISION_BOX)
@@ -261,6 +269,15 @@ void AnimatedModel::Update(const FrameInfo& frame)
         UpdateBoneBoundingBox();
 }
 
+void AnimatedModel::CommitUpdate()
+{
+    if (bonePoseCommitPending_)
+    {
+        bonePoseCommitPending_ = false;
+        ApplyBonePose();
+    }
+}
+
 void AnimatedModel::UpdateBatches(const FrameInfo& frame)
 {
     const Matrix3x4& worldTransform = node_->GetWorldTransform();
@@ -454,6 +471,13 @@ void AnimatedModel::SetUpdateInvisible(bool enable)
     MarkNetworkUpdate();
 }
 
+void AnimatedModel::SetPoseCacheTimeStep(float timeStep)
+{
+    poseCacheTimeStep_ = Max(0.0f, timeStep);
+    MarkAnimationDirty();
+    MarkNetworkUpdate();
+}
+
 
 void AnimatedModel::SetMorphWeight(unsigned index, float weight)
 {
@@ -574,10 +598,13 @@ void AnimatedModel::SetSkeleton(const Skeleton& skeleton, bool createBones)
         return;
     }
 
+    // Bones of the master pose will be mapped again on the next pose commit
+    poseMasterBoneIndices_.clear();
+
     if (isMaster_)
     {
         // Check if bone structure has stayed compatible (reloading the model). In that case retain the old bones and animations
-        if (skeleton_.GetNumBones() == skeleton.GetNumBones())
+        if (!nodelessSkeleton_ && skeleton_.GetNumBones() == skeleton.GetNumBones())
         {
             ea::vector<Bone>& destBones = skeleton_.GetModifiableBones();
             const ea::vector<Bone>& srcBones = skeleton.GetBones();
@@ -617,10 +644,11 @@ void AnimatedModel::SetSkeleton(const Skeleton& skeleton, bool createBones)
 
         // Merge bounding boxes from non-master models
         FinalizeBoneBoundingBoxes();
+        InitializeBonePose();
 
         ea::vector<Bone>& bones = skeleton_.GetModifiableBones();
-        // Create scene nodes for the bones
-        if (createBones)
+        // Create scene nodes for the bones. Nodeless skeleton creates them on demand
+        if (createBones && !nodelessSkeleton_)
         {
             for (auto i = bones.begin(); i != bones.end(); ++i)
             {
@@ -651,6 +679,7 @@ void AnimatedModel::SetSkeleton(const Skeleton& skeleton, bool createBones)
     {
         // For non-master models: use the bone nodes of the master model
         skeleton_.Define(skeleton);
+        InitializeBonePose();
 
         // Instruct the master model to refresh (merge) its bone bounding boxes
         auto* master = node_->GetComponent<AnimatedModel>();
@@ -726,18 +755,33 @@ void AnimatedModel::UpdateBoneBoundingBox()
         Matrix3x4 inverseNodeTransform = node_->GetWorldTransform().Inverse();
 
         const ea::vector<Bone>& bones = skeleton_.GetBones();
-        for (auto i = bones.begin(); i != bones.end(); ++i)
+        if (HasBonePose())
         {
-            Node* boneNode = i->node_;
-            if (!boneNode)
-                continue;
+            // Pose buffer is already in model space
+            for (unsigned i = 0; i < bones.size(); ++i)
+            {
+                const Bone& bone = bones[i];
+                if (bone.collisionMask_ & BONECOLLISION_BOX)
+                    boneBoundingBox_.Merge(bone.boundingBox_.Transformed(boneModelTransforms_[i]));
+                else if (bone.collisionMask_ & BONECOLLISION_SPHERE)
+                    boneBoundingBox_.Merge(Sphere(boneModelTransforms_[i].Translation(), bone.radius_ * 0.5f));
+            }
+        }
+        else
+        {
+            for (auto i = bones.begin(); i != bones.end(); ++i)
+            {
+                Node* boneNode = i->node_;
+                if (!boneNode)
+                    continue;
 
-            // Use hitbox if available. If not, use only half of the sphere radius
-            /// \todo The sphere radius should be multiplied with bone scale
-            if (i->collisionMask_ & BONECOLLISION_BOX)
-                boneBoundingBox_.Merge(i->boundingBox_.Transformed(inverseNodeTransform * boneNode->GetWorldTransform()));
-            else if (i->collisionMask_ & BONECOLLISION_SPHERE)
-                boneBoundingBox_.Merge(Sphere(inverseNodeTransform * boneNode->GetWorldPosition(), i->radius_ * 0.5f));
+                // Use hitbox if available. If not, use only half of the sphere radius
+                /// \todo The sphere radius should be multiplied with bone scale
+                if (i->collisionMask_ & BONECOLLISION_BOX)
+                    boneBoundingBox_.Merge(i->boundingBox_.Transformed(inverseNodeTransform * boneNode->GetWorldTransform()));
+                else if (i->collisionMask_ & BONECOLLISION_SPHERE)
+                    boneBoundingBox_.Merge(Sphere(inverseNodeTransform * boneNode->GetWorldPosition(), i->radius_ * 0.5f));
+            }
         }
     }
 
@@ -797,6 +841,9 @@ void AnimatedModel::AssignBoneNodes()
     if (!node_)
         return;
 
+    // Pose buffer is not initialized yet if the skeleton mode was loaded after the model
+    InitializeBonePose();
+
     // Find the bone nodes from the node hierarchy and add listeners
     ea::vector<Bone>& bones = skeleton_.GetModifiableBones();
     bool boneFound = false;
@@ -806,14 +853,16 @@ void AnimatedModel::AssignBoneNodes()
         if (boneNode)
         {
             boneFound = true;
-            boneNode->AddListener(this);
+            // Bone nodes of nodeless skeleton are driven by the pose buffer and don't affect skinning
+            if (!nodelessSkeleton_)
+                boneNode->AddListener(this);
         }
         i->node_ = boneNode;
     }
 
     // If no bones found, this may be a prefab where the bone information was left out.
     // In that case reassign the skeleton now if possible
-    if (!boneFound && model_)
+    if (!boneFound && !nodelessSkeleton_ && model_)
         SetSkeleton(model_->GetSkeleton(), true);
 
     // Notify AnimationStateSource so it can reconnect to new bone nodes
@@ -888,6 +937,271 @@ void AnimatedModel::RemoveRootBone()
     Bone* rootBone = skeleton_.GetRootBone();
     if (rootBone && rootBone->node_)
         rootBone->node_->Remove();
+
+    // Bone nodes of nodeless skeleton are not necessarily parented to the root bone node
+    if (nodelessSkeleton_)
+    {
+        for (Bone& bone : skeleton_.GetModifiableBones())
+        {
+            if (bone.node_)
+                bone.node_->Remove();
+        }
+    }
+}
+
+void AnimatedModel::InitializeBonePose()
+{
+    boneLocalTransforms_.clear();
+    boneModelTransforms_.clear();
+    boneEvaluationOrder_.clear();
+
+    // Skeleton of the master may have changed, so bone mappings of non-master models are rebuilt
+    if (isMaster_ && node_)
+    {
+        for (Component* component : node_->GetComponents())
+        {
+            if (component != this && component->GetType() == GetTypeStatic())
+            {
+                auto* model = static_cast<AnimatedModel*>(component);
+                model->poseMasterBoneIndices_.clear();
+                model->skinningDirty_ = true;
+            }
+        }
+    }
+
+    if (!nodelessSkeleton_ || !isMaster_)
+        return;
+
+    const ea::vector<Bone>& bones = skeleton_.GetBones();
+    const auto numBones = static_cast<unsigned>(bones.size());
+
+    boneLocalTransforms_.resize(numBones);
+    boneModelTransforms_.resize(numBones);
+    for (unsigned i = 0; i < numBones; ++i)
+    {
+        const Bone& bone = bones[i];
+        boneLocalTransforms_[i] = Transform{ bone.initialPosition_, bone.initialRotation_, bone.initialScale_ };
+    }
+
+    // Sort bones by depth so that the pose can be evaluated in one pass
+    ea::vector<unsigned> boneDepths(numBones);
+    for (unsigned i = 0; i < numBones; ++i)
+    {
+        unsigned depth = 0;
+        unsigned index = i;
+        while (bones[index].parentIndex_ != index && bones[index].parentIndex_ < numBones && depth < numBones)
+        {
+            index = bones[index].parentIndex_;
+            ++depth;
+        }
+        boneDepths[i] = depth;
+    }
+
+    boneEvaluationOrder_.resize(numBones);
+    for (unsigned i = 0; i < numBones; ++i)
+        boneEvaluationOrder_[i] = i;
+    ea::stable_sort(boneEvaluationOrder_.begin(), boneEvaluationOrder_.end(),
+        [&](unsigned lhs, unsigned rhs) { return boneDepths[lhs] < boneDepths[rhs]; });
+
+    UpdateBoneModelTransforms();
+    ApplyBonePose();
+}
+
+void AnimatedModel::ResetBonePose()
+{
+    const ea::vector<Bone>& bones = skeleton_.GetBones();
+    for (unsigned i = 0; i < boneLocalTransforms_.size(); ++i)
+    {
+        const Bone& bone = bones[i];
+        if (bone.animated_)
+            boneLocalTransforms_[i] = Transform{ bone.initialPosition_, bone.initialRotation_, bone.initialScale_ };
+    }
+}
+
+void AnimatedModel::UpdateBoneModelTransforms()
+{
+    const ea::vector<Bone>& bones = skeleton_.GetBones();
+    const auto numBones = static_cast<unsigned>(boneModelTransforms_.size());
+
+    for (unsigned i : boneEvaluationOrder_)
+    {
+        const Transform& localTransform = boneLocalTransforms_[i];
+        const Matrix3x4 localMatrix{ localTransform.position_, localTransform.rotation_, localTransform.scale_ };
+
+        const unsigned parentIndex = bones[i].parentIndex_;
+        const bool hasParent = parentIndex != i && parentIndex < numBones;
+        boneModelTransforms_[i] = hasParent ? boneModelTransforms_[parentIndex] * localMatrix : localMatrix;
+    }
+}
+
+void AnimatedModel::ApplyBonePoseToNodes()
+{
+    const ea::vector<Bone>& bones = skeleton_.GetBones();
+    const auto numBones = static_cast<unsigned>(boneModelTransforms_.size());
+
+    bool hasBoneNodes = false;
+    for (unsigned i = 0; i < numBones; ++i)
+    {
+        Node* boneNode = bones[i].node_;
+        if (!boneNode)
+            continue;
+
+        // Bone node may be attached either to the parent bone node or to the model node
+        hasBoneNodes = true;
+        const Transform& localTransform = boneLocalTransforms_[i];
+        const unsigned parentIndex = bones[i].parentIndex_;
+        const bool hasParent = parentIndex != i && parentIndex < numBones;
+        if (hasParent && boneNode->GetParent() == bones[parentIndex].node_)
+            boneNode->SetTransformSilent(localTransform.position_, localTransform.rotation_, localTransform.scale_);
+        else
+            boneNode->SetTransformSilent(boneModelTransforms_[i]);
+    }
+
+    // Only bone nodes need to be dirtied, the pose buffer doesn't depend on them
+    if (hasBoneNodes)
+    {
+        for (const Bone& bone : bones)
+        {
+            if (bone.node_)
+                bone.node_->MarkDirty();
+        }
+    }
+}
+
+void AnimatedModel::CommitBonePose()
+{
+    const ea::vector<Bone>& bones = skeleton_.GetBones();
+    const bool hasBoneNodes = ea::any_of(bones.begin(), bones.end(), [](const Bone& bone) { return !!bone.node_; });
+    if (!hasBoneNodes && !HasNonMasterModels())
+        return;
+
+    // Scene nodes should not be modified from worker threads, so the pose buffer is evaluated in parallel
+    // and only written to nodes afterwards
+    Scene* scene = GetScene();
+    if (octant_ && scene && scene->IsThreadedUpdate())
+    {
+        if (!bonePoseCommitPending_)
+        {
+            bonePoseCommitPending_ = true;
+            octant_->GetOctree()->QueueCommit(this);
+        }
+    }
+    else
+    {
+        bonePoseCommitPending_ = false;
+        ApplyBonePose();
+    }
+}
+
+void AnimatedModel::ApplyBonePose()
+{
+    ApplyBonePoseToNodes();
+
+    if (!node_)
+        return;
+
+    for (Component* component : node_->GetComponents())
+    {
+        if (component != this && component->GetType() == GetTypeStatic())
+            static_cast<AnimatedModel*>(component)->SetPoseMaster(this);
+    }
+}
+
+bool AnimatedModel::HasNonMasterModels() const
+{
+    if (!node_)
+        return false;
+
+    for (Component* component : node_->GetComponents())
+    {
+        if (component != this && component->GetType() == GetTypeStatic())
+            return true;
+    }
+    return false;
+}
+
+void AnimatedModel::SetPoseMaster(AnimatedModel* master)
+{
+    const ea::vector<Bone>& bones = skeleton_.GetBones();
+    if (poseMaster_ != master || poseMasterBoneIndices_.size() != bones.size())
+    {
+        poseMaster_ = master;
+        poseMasterBoneIndices_.clear();
+        for (const Bone& bone : bones)
+        {
+            const unsigned masterIndex = master->skeleton_.GetBoneIndex(bone.nameHash_);
+            poseMasterBoneIndices_.push_back(masterIndex);
+        }
+    }
+
+    // Pose of the master is not tracked by node dirtying, so skinning and bounds are invalidated explicitly
+    if (skeleton_.GetNumBones())
+    {
+        skinningDirty_ = true;
+        worldBoundingBoxDirty_ = true;
+        MarkForUpdate();
+    }
+}
+
+Matrix3x4 AnimatedModel::GetBoneSkinTransform(unsigned index, const Matrix3x4& worldTransform, const AnimatedModel* poseMaster) const
+{
+    const Bone& bone = skeleton_.GetBones()[index];
+    if (HasBonePose())
+        return worldTransform * boneModelTransforms_[index] * bone.offsetMatrix_;
+
+    if (poseMaster)
+    {
+        const unsigned masterIndex = poseMasterBoneIndices_[index];
+        if (masterIndex < poseMaster->boneModelTransforms_.size())
+            return worldTransform * poseMaster->boneModelTransforms_[masterIndex] * bone.offsetMatrix_;
+    }
+
+    if (bone.node_)
+        return bone.node_->GetWorldTransform() * bone.offsetMatrix_;
+
+    return worldTransform;
+}
+
+void AnimatedModel::SetNodelessSkeleton(bool enable)
+{
+    if (nodelessSkeleton_ == enable)
+        return;
+
+    // Bone nodes will be assigned after loading
+    const bool recreateBones = !loading_ && isMaster_ && model_ && node_;
+    if (recreateBones)
+    {
+        RemoveRootBone();
+        skeleton_.ClearBones();
+    }
+
+    nodelessSkeleton_ = enable;
+
+    if (recreateBones)
+    {
+        SetSkeleton(model_->GetSkeleton(), true);
+        MarkAnimationDirty();
+        skinningDirty_ = true;
+    }
+}
+
+Node* AnimatedModel::CreateBoneNode(const ea::string& boneName)
+{
+    const unsigned index = skeleton_.GetBoneIndex(boneName);
+    if (index == M_MAX_UNSIGNED)
+        return nullptr;
+
+    Bone& bone = skeleton_.GetModifiableBones()[index];
+    if (bone.node_ || !nodelessSkeleton_ || !isMaster_ || !node_)
+        return bone.node_;
+
+    // Create bone node as local, as it's never to be directly synchronized over the network
+    Node* boneNode = node_->CreateChild(bone.name_, LOCAL);
+    boneNode->SetTransform(boneModelTransforms_[index]);
+    // Copy the model component's temporary status
+    boneNode->SetTemporary(IsTemporary());
+    bone.node_ = boneNode;
+    return boneNode;
 }
 
 void AnimatedModel::MarkAnimationDirty()
@@ -978,7 +1292,46 @@ void AnimatedModel::ApplyAnimation()
 {
     // Reset skeleton, apply all animations, calculate bones' bounding box. Make sure this is only done for the master model
     // (first AnimatedModel in a node)
-    if (isMaster_)
+    if (isMaster_ && HasBonePose())
+    {
+        // Reuse the pose if another model has already evaluated it on this frame
+        AnimationPoseCache* poseCache = PreparePoseCacheKey();
+        const auto cachedPose = poseCache ? poseCache->FindPose(poseCacheKey_) : nullptr;
+        if (cachedPose)
+        {
+            boneLocalTransforms_ = cachedPose->localTransforms_;
+            boneModelTransforms_ = cachedPose->modelTransforms_;
+        }
+        else
+        {
+            ResetBonePose();
+
+            if (AnimationStateSource* animationStateSource = animationStateSource_)
+            {
+                for (AnimationState* state : animationStateSource->GetAnimationStates())
+                    state->ApplyModelTracks(GetPoseSampleTime(state));
+            }
+
+            // Evaluate the pose in one pass
+            UpdateBoneModelTransforms();
+
+            if (poseCache)
+            {
+                auto pose = ea::make_shared<AnimationPoseCacheEntry>();
+                pose->localTransforms_ = boneLocalTransforms_;
+                pose->modelTransforms_ = boneModelTransforms_;
+                poseCache->StorePose(poseCacheKey_, ea::move(pose));
+            }
+        }
+
+        // The model node itself is not dirtied
+        CommitBonePose();
+        skinningDirty_ = true;
+        MarkForUpdate();
+
+        UpdateBoneBoundingBox();
+    }
+    else if (isMaster_)
     {
         skeleton_.ResetSilent();
 
@@ -999,6 +1352,46 @@ void AnimatedModel::ApplyAnimation()
     animationDirty_ = false;
 }
 
+float AnimatedModel::GetPoseSampleTime(const AnimationState* state) const
+{
+    const float time = state->GetTime();
+    return poseCacheTimeStep_ > 0.0f ? Floor(time / poseCacheTimeStep_) * poseCacheTimeStep_ : time;
+}
+
+AnimationPoseCache* AnimatedModel::PreparePoseCacheKey()
+{
+    if (poseCacheTimeStep_ <= 0.0f || !model_ || !octant_)
+        return nullptr;
+
+    // Pose of bones with disabled animation is controlled by the user and cannot be shared
+    for (const Bone& bone : skeleton_.GetBones())
+    {
+        if (!bone.animated_)
+            return nullptr;
+    }
+
+    poseCacheKey_.Reset(model_, poseCacheTimeStep_);
+    if (AnimationStateSource* animationStateSource = animationStateSource_)
+    {
+        for (AnimationState* state : animationStateSource->GetAnimationStates())
+        {
+            if (!state->GetAnimation() || !state->IsEnabled())
+                continue;
+
+            AnimationPoseCacheState keyState;
+            keyState.animation_ = state->GetAnimation();
+            keyState.timeIndex_ = static_cast<unsigned>(FloorToInt(state->GetTime() / poseCacheTimeStep_));
+            keyState.weight_ = state->GetWeight();
+            keyState.blendMode_ = static_cast<unsigned char>(state->GetBlendMode());
+            keyState.looped_ = state->IsLooped();
+            keyState.startBoneHash_ = StringHash(state->GetStartBone()).Value();
+            poseCacheKey_.AddState(keyState);
+        }
+    }
+
+    return &octant_->GetOctree()->GetAnimationPoseCache();
+}
+
 void AnimatedModel::ConnectToAnimationStateSource(AnimationStateSource* source)
 {
     animationStateSource_ = source;
@@ -1010,29 +1403,21 @@ void AnimatedModel::UpdateSkinning()
     const ea::vector<Bone>& bones = skeleton_.GetBones();
     // Use model's world transform in case a bone is missing
     const Matrix3x4& worldTransform = node_->GetWorldTransform();
+    // Non-master model may follow the pose buffer of nodeless master instead of bone nodes
+    const AnimatedModel* poseMaster = !isMaster_ && poseMasterBoneIndices_.size() == bones.size() ? poseMaster_.Get() : nullptr;
 
     // Skinning with global matrices only
     if (!geometrySkinMatrices_.size())
     {
         for (unsigned i = 0; i < bones.size(); ++i)
-        {
-            const Bone& bone = bones[i];
-            if (bone.node_)
-                skinMatrices_[i] = bone.node_->GetWorldTransform() * bone.offsetMatrix_;
-            else
-                skinMatrices_[i] = worldTransform;
-        }
+            skinMatrices_[i] = GetBoneSkinTransform(i, worldTransform, poseMaster);
     }
     // Skinning with per-geometry matrices
     else
     {
         for (unsigned i = 0; i < bones.size(); ++i)
         {
-            const Bone& bone = bones[i];
-            if (bone.node_)
-                skinMatrices_[i] = bone.node_->GetWorldTransform() * bone.offsetMatrix_;
-            else
-                skinMatrices_[i] = worldTransform;
+            skinMatrices_[i] = GetBoneSkinTransform(i, worldTransform, poseMaster);
 
             // Copy the skin matrix to per-geometry matrices as needed
             for (unsigned j = 0; j < geometrySkinMatrixPtrs_[i].size(); ++j)
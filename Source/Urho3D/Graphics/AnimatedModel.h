@@ -22,10 +22,12 @@
 
 #pragma once
 
+#include "../Graphics/AnimationPoseCache.h"
 #include "../Graphics/AnimationStateSource.h"
 #include "../Graphics/Model.h"
 #include "../Graphics/Skeleton.h"
 #include "../Graphics/StaticModel.h"
+#include "../Math/Transform.h"
 
 namespace Urho3D
 {
@@ -59,6 +61,10 @@ public:
     bool LoadXML(const XMLElement& source) override;
     /// Load from JSON data. Return true if successful.
     bool LoadJSON(const JSONValue& source) override;
+    /// Begin setting attributes from serialized data.
+    void OnBeginLoadAttributes() override { loading_ = true; }
+    /// End setting attributes from serialized data.
+    void OnEndLoadAttributes() override { loading_ = false; }
     /// Apply attribute changes that can not be applied immediately. Called after scene load or a network update.
     void ApplyAttributes() override;
 
@@ -70,6 +76,8 @@ public:
     void ProcessRayQuery(const RayOctreeQuery& query, ea::vector<RayQueryResult>& results) override;
     /// Update before octree reinsertion. Is called from a worker thread.
     void Update(const FrameInfo& frame) override;
+    /// Write pose evaluated in worker thread to bone nodes. Is called from the main thread.
+    void CommitUpdate() override;
     /// Calculate distance and prepare batches for rendering. May be called from worker thread(s), possibly re-entrantly.
     void UpdateBatches(const FrameInfo& frame) override;
     /// Prepare geometry for rendering. Called from a worker thread if possible (no GPU update).
@@ -102,6 +110,17 @@ public:
     void ApplyAnimation();
     /// Connect to AnimationStateSource that provides animation states.
     void ConnectToAnimationStateSource(AnimationStateSource* source);
+    /// Set whether the skeleton pose is kept in the pose buffer instead of bone nodes.
+    /// Bone nodes of nodeless skeleton are created only on demand via CreateBoneNode and are driven by the pose.
+    /// Affects only the master model. Changing the mode recreates bone nodes.
+    /// @property
+    void SetNodelessSkeleton(bool enable);
+    /// Return scene node of the bone. If skeleton is nodeless, the node is created on demand as a child of the model node.
+    Node* CreateBoneNode(const ea::string& boneName);
+    /// Set time step used to quantize animation time of nodeless skeleton. Zero disables quantization.
+    /// If enabled, models with the same skeleton and animations at the same quantized time share evaluated pose.
+    /// @property
+    void SetPoseCacheTimeStep(float timeStep);
 
     /// Return skeleton.
     /// @property
@@ -115,6 +134,17 @@ public:
     /// @property
     bool GetUpdateInvisible() const { return updateInvisible_; }
 
+    /// Return whether the skeleton pose is kept in the pose buffer instead of bone nodes.
+    /// @property
+    bool IsNodelessSkeleton() const { return nodelessSkeleton_; }
+
+    /// Return time step used to quantize animation time of nodeless skeleton.
+    /// @property
+    float GetPoseCacheTimeStep() const { return poseCacheTimeStep_; }
+
+    /// Return model-space bone transforms of nodeless skeleton. Empty if bone nodes are used or the model is not master.
+    const ea::vector<Matrix3x4>& GetBoneModelTransforms() const { return boneModelTransforms_; }
+
     /// Return all vertex morphs.
     const ea::vector<ModelMorph>& GetMorphs() const { return morphs_; }
 
@@ -152,6 +182,9 @@ public:
     /// Return per-geometry bone mappings.
     const ea::vector<ea::vector<unsigned> >& GetGeometryBoneMappings() const { return geometryBoneMappings_; }
 
+    /// Return global skin matrices.
+    const ea::vector<Matrix3x4>& GetSkinMatrices() const { return skinMatrices_; }
+
     /// Return per-geometry skin matrices. If empty, uses global skinning.
     const ea::vector<ea::vector<Matrix3x4> >& GetGeometrySkinMatrices() const { return geometrySkinMatrices_; }
 
@@ -171,8 +204,32 @@ private:
     void AssignBoneNodes();
     /// Finalize master model bone bounding boxes by merging from matching non-master bones.. Performed whenever any of the AnimatedModels in the same node changes its model.
     void FinalizeBoneBoundingBoxes();
-    /// Remove (old) skeleton root bone.
+    /// Remove (old) skeleton root bone. All bone nodes are removed if skeleton is nodeless.
     void RemoveRootBone();
+    /// Initialize pose buffer and evaluation order of nodeless master model. Clear them otherwise.
+    void InitializeBonePose();
+    /// Reset animated bones of the pose buffer to initial transforms.
+    void ResetBonePose();
+    /// Calculate model-space bone transforms from local transforms.
+    void UpdateBoneModelTransforms();
+    /// Write bone pose to bone nodes of nodeless skeleton if any.
+    void ApplyBonePoseToNodes();
+    /// Write bone pose to bone nodes now, or defer it to the main thread if called during threaded update.
+    void CommitBonePose();
+    /// Write bone pose to bone nodes and notify non-master models in the same node. Main thread only.
+    void ApplyBonePose();
+    /// Return whether the node has non-master models that follow the pose of this model.
+    bool HasNonMasterModels() const;
+    /// Follow the pose buffer of nodeless master model. Main thread only.
+    void SetPoseMaster(AnimatedModel* master);
+    /// Return skinning transform of bone.
+    Matrix3x4 GetBoneSkinTransform(unsigned index, const Matrix3x4& worldTransform, const AnimatedModel* poseMaster) const;
+    /// Return time at which animation state should be sampled.
+    float GetPoseSampleTime(const AnimationState* state) const;
+    /// Prepare key of current pose and return pose cache if the pose can be shared.
+    AnimationPoseCache* PreparePoseCacheKey();
+    /// Return whether the pose buffer of nodeless skeleton is used.
+    bool HasBonePose() const { return !boneModelTransforms_.empty(); }
     /// Mark animation and skinning to require an update.
     void MarkAnimationDirty();
     /// Mark morphs to require an update.
@@ -204,6 +261,18 @@ private:
     ea::vector<ModelMorph> morphs_;
     /// Skinning matrices.
     ea::vector<Matrix3x4> skinMatrices_;
+    /// Local bone transforms of nodeless skeleton.
+    ea::vector<Transform> boneLocalTransforms_;
+    /// Model-space bone transforms of nodeless skeleton.
+    ea::vector<Matrix3x4> boneModelTransforms_;
+    /// Bone indices ordered so that parents are evaluated before children.
+    ea::vector<unsigned> boneEvaluationOrder_;
+    /// Nodeless master model whose pose buffer is used by this non-master model.
+    WeakPtr<AnimatedModel> poseMaster_;
+    /// Indices of master bones matching the bones of this model, M_MAX_UNSIGNED if not found.
+    ea::vector<unsigned> poseMasterBoneIndices_;
+    /// Key of current pose in pose cache.
+    AnimationPoseCacheKey poseCacheKey_;
     /// Mapping of subgeometry bone indices, used if more bones than skinning shader can manage.
     ea::vector<ea::vector<unsigned> > geometryBoneMappings_;
     /// Subgeometry skinning matrices, used if more bones than skinning shader can manage.
@@ -244,6 +313,12 @@ private:
     bool assignBonesPending_;
     /// Force animation update after becoming visible flag.
     bool forceAnimationUpdate_;
+    /// Whether the skeleton pose is kept in the pose buffer instead of bone nodes.
+    bool nodelessSkeleton_{};
+    /// Time step used to quantize animation time of nodeless skeleton.
+    float poseCacheTimeStep_{};
+    /// Whether the pose is queued to be written to bone nodes from the main thread.
+    bool bonePoseCommitPending_{};
 };
 
 }
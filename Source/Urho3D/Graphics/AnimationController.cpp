@@ -35,6 +35,7 @@
 #include "../Scene/Scene.h"
 #include "../Scene/SceneEvents.h"
 
+#include <EASTL/algorithm.h>
 #include <EASTL/sort.h>
 
 #include "../DebugNew.h"
@@ -184,14 +185,36 @@ void AnimationController::Update(float timeStep)
             UpdateAnimationStateTracks(state);
     }
 
-    // Node hierarchy animations need to be applied manually
+    // Attribute animations may have arbitrary side effects and are applied immediately
     for (AnimationState* state : animationStates_)
-    {
-        state->ApplyNodeTracks();
         state->ApplyAttributeTracks();
+
+    // Node hierarchy animations are sampled in parallel with other controllers and applied afterwards
+    const bool hasNodeTracks = ea::any_of(animationStates_.begin(), animationStates_.end(),
+        [](const AnimationState* state) { return state->HasNodeTracks(); });
+    if (!hasNodeTracks)
+        return;
+
+    if (Scene* scene = GetScene())
+        scene->QueueParallelUpdate(this);
+    else
+    {
+        ParallelUpdate();
+        CommitParallelUpdate();
     }
 }
 
+void AnimationController::ParallelUpdate()
+{
+    for (AnimationState* state : animationStates_)
+        state->SampleNodeTracks(nodeTransforms_);
+}
+
+void AnimationController::CommitParallelUpdate()
+{
+    nodeTransforms_.Apply();
+}
+
 bool AnimationController::Play(const ea::string& name, unsigned char layer, bool looped, float fadeInTime)
 {
     // Get the animation resource first to be able to get the canonical resource name
@@ -1072,36 +1095,43 @@ void AnimationController::UpdateAnimationStateTracks(AnimationState* state)
     if (!startNode)
         startNode = node_;
 
-    Node* startBone = startNode == node_ && model ? model->GetSkeleton().GetRootBone()->node_ : startNode;
-    if (!startBone)
-    {
-        URHO3D_LOGWARNING("AnimatedModel skeleton is not initialized");
-        return;
-    }
-
-    // Setup model and node tracks
-    const auto& tracks = animation->GetTracks();
-    for (const auto& item : tracks)
+    // Nodeless skeleton is animated via pose buffer, bone tracks are resolved by bone names
+    if (model && model->IsNodelessSkeleton() && model->IsMaster())
+        AddNodelessModelTracks(state, model);
+    else
     {
-        const AnimationTrack& track = item.second;
-        Node* trackNode = GetTrackNodeByNameHash(track.nameHash_, startBone);
-        Bone* trackBone = trackNode && model ? model->GetSkeleton().GetBone(track.nameHash_) : nullptr;
-
-        // Add model track
-        if (trackBone && trackBone->node_)
+        Node* startBone = startNode == node_ && model ? model->GetSkeleton().GetRootBone()->node_ : startNode;
+        if (!startBone)
         {
-            ModelAnimationStateTrack stateTrack;
-            stateTrack.track_ = &track;
-            stateTrack.node_ = trackBone->node_;
-            stateTrack.bone_ = trackBone;
-            state->AddModelTrack(stateTrack);
+            URHO3D_LOGWARNING("AnimatedModel skeleton is not initialized");
+            return;
         }
-        else if (trackNode)
+
+        // Setup model and node tracks
+        const auto& tracks = animation->GetTracks();
+        for (const auto& item : tracks)
         {
-            NodeAnimationStateTrack stateTrack;
-            stateTrack.track_ = &track;
-            stateTrack.node_ = trackNode;
-            state->AddNodeTrack(stateTrack);
+            const AnimationTrack& track = item.second;
+            Node* trackNode = GetTrackNodeByNameHash(track.nameHash_, startBone);
+            Bone* trackBone = trackNode && model ? model->GetSkeleton().GetBone(track.nameHash_) : nullptr;
+
+            // Add model track
+            if (trackBone && trackBone->node_)
+            {
+                ModelAnimationStateTrack stateTrack;
+                stateTrack.track_ = &track;
+                stateTrack.node_ = trackBone->node_;
+                stateTrack.bone_ = trackBone;
+                stateTrack.boneIndex_ = model->GetSkeleton().GetBoneIndex(trackBone);
+                state->AddModelTrack(stateTrack);
+            }
+            else if (trackNode)
+            {
+                NodeAnimationStateTrack stateTrack;
+                stateTrack.track_ = &track;
+                stateTrack.node_ = trackNode;
+                state->AddNodeTrack(stateTrack);
+            }
         }
     }
 
@@ -1126,6 +1156,52 @@ void AnimationController::UpdateAnimationStateTracks(AnimationState* state)
     state->OnTracksReady();
 }
 
+void AnimationController::AddNodelessModelTracks(AnimationState* state, AnimatedModel* model)
+{
+    Skeleton& skeleton = model->GetSkeleton();
+    ea::vector<Bone>& bones = skeleton.GetModifiableBones();
+    const auto numBones = static_cast<unsigned>(bones.size());
+
+    const ea::string& startBoneName = state->GetStartBone();
+    const unsigned startBoneIndex = !startBoneName.empty()
+        ? skeleton.GetBoneIndex(startBoneName) : skeleton.GetBoneIndex(skeleton.GetRootBone());
+    if (startBoneIndex == M_MAX_UNSIGNED)
+    {
+        URHO3D_LOGWARNING("AnimatedModel skeleton is not initialized");
+        return;
+    }
+
+    const auto isInStartBoneSubtree = [&](unsigned boneIndex)
+    {
+        for (unsigned depth = 0; depth < numBones; ++depth)
+        {
+            if (boneIndex == startBoneIndex)
+                return true;
+
+            const unsigned parentIndex = bones[boneIndex].parentIndex_;
+            if (parentIndex == boneIndex || parentIndex >= numBones)
+                return false;
+            boneIndex = parentIndex;
+        }
+        return false;
+    };
+
+    const Animation* animation = state->GetAnimation();
+    for (const auto& item : animation->GetTracks())
+    {
+        const AnimationTrack& track = item.second;
+        const unsigned boneIndex = skeleton.GetBoneIndex(track.nameHash_);
+        if (boneIndex == M_MAX_UNSIGNED || !isInStartBoneSubtree(boneIndex))
+            continue;
+
+        ModelAnimationStateTrack stateTrack;
+        stateTrack.track_ = &track;
+        stateTrack.bone_ = &bones[boneIndex];
+        stateTrack.boneIndex_ = boneIndex;
+        state->AddModelTrack(stateTrack);
+    }
+}
+
 void AnimationController::ConnectToAnimatedModel()
 {
     auto model = GetComponent<AnimatedModel>();
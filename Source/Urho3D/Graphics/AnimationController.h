@@ -116,7 +116,12 @@ public:
     /// Should be called on every substantial change in animated structure.
     void MarkAnimationStateTracksDirty() override;
 
-    /// Update the animations. Is called from HandleScenePostUpdate().
+    /// Sample node hierarchy animations queued by Update.
+    void ParallelUpdate() override;
+    /// Apply sampled node hierarchy animations.
+    void CommitParallelUpdate() override;
+
+    /// Update the animations. Is called from HandleScenePostUpdate(). Node hierarchy animations are applied after scene post-update if the controller is in a scene.
     virtual void Update(float timeStep);
     /// Play an animation and set full target weight. Name must be the full resource name. Return true on success.
     bool Play(const ea::string& name, unsigned char layer, bool looped, float fadeInTime = 0.0f);
@@ -230,6 +235,8 @@ private:
     void HandleScenePostUpdate(StringHash eventType, VariantMap& eventData);
     /// Update animation state tracks so they are connected to correct animatable objects.
     void UpdateAnimationStateTracks(AnimationState* state);
+    /// Add model tracks that animate pose buffer of nodeless skeleton.
+    void AddNodelessModelTracks(AnimationState* state, AnimatedModel* model);
     /// Connect to AnimatedModel if possible.
     void ConnectToAnimatedModel();
     /// Parse animatable path from starting node.
@@ -242,6 +249,8 @@ private:
     ea::vector<AnimationControl> animations_;
     /// Attribute buffer for network replication.
     mutable VectorBuffer attrBuffer_;
+    /// Node transforms sampled from node hierarchy animations.
+    AnimatedNodeTransforms nodeTransforms_;
 
     /// Internal dirty flags cleaned on Update.
     /// @{
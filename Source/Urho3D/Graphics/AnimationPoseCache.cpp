@@ -0,0 +1,81 @@
+//
+// Copyright (c) 2021-2022 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "../Precompiled.h"
+
+#include "../Graphics/AnimationPoseCache.h"
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+void AnimationPoseCacheKey::Reset(const Model* model, float timeStep)
+{
+    model_ = model;
+    timeStep_ = timeStep;
+    states_.clear();
+}
+
+unsigned AnimationPoseCacheKey::ToHash() const
+{
+    unsigned hash = 0;
+    CombineHash(hash, MakeHash(model_));
+    CombineHash(hash, MakeHash(timeStep_));
+    for (const AnimationPoseCacheState& state : states_)
+    {
+        CombineHash(hash, MakeHash(state.animation_));
+        CombineHash(hash, state.timeIndex_);
+        CombineHash(hash, MakeHash(state.weight_));
+        CombineHash(hash, state.blendMode_);
+        CombineHash(hash, state.looped_);
+        CombineHash(hash, state.startBoneHash_);
+    }
+    return hash;
+}
+
+void AnimationPoseCache::BeginFrame()
+{
+    MutexLock lock(mutex_);
+    poses_.clear();
+    numHits_ = 0;
+}
+
+ea::shared_ptr<const AnimationPoseCacheEntry> AnimationPoseCache::FindPose(const AnimationPoseCacheKey& key)
+{
+    MutexLock lock(mutex_);
+    const auto iter = poses_.find(key);
+    if (iter == poses_.end())
+        return nullptr;
+
+    ++numHits_;
+    return iter->second;
+}
+
+void AnimationPoseCache::StorePose(const AnimationPoseCacheKey& key, ea::shared_ptr<const AnimationPoseCacheEntry> pose)
+{
+    MutexLock lock(mutex_);
+    poses_.emplace(key, ea::move(pose));
+}
+
+}
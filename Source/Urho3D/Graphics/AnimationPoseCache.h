@@ -0,0 +1,113 @@
+//
+// Copyright (c) 2021-2022 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#pragma once
+
+#include "../Container/Hash.h"
+#include "../Core/Mutex.h"
+#include "../Math/Matrix3x4.h"
+#include "../Math/Transform.h"
+
+#include <EASTL/shared_ptr.h>
+#include <EASTL/unordered_map.h>
+#include <EASTL/vector.h>
+
+namespace Urho3D
+{
+
+class Animation;
+class Model;
+
+/// Animation state that contributes to shared skeleton pose.
+struct AnimationPoseCacheState
+{
+    const Animation* animation_{};
+    unsigned timeIndex_{};
+    float weight_{};
+    unsigned char blendMode_{};
+    bool looped_{};
+    unsigned startBoneHash_{};
+
+    bool operator==(const AnimationPoseCacheState& rhs) const
+    {
+        return animation_ == rhs.animation_ && timeIndex_ == rhs.timeIndex_ && weight_ == rhs.weight_
+            && blendMode_ == rhs.blendMode_ && looped_ == rhs.looped_ && startBoneHash_ == rhs.startBoneHash_;
+    }
+    bool operator!=(const AnimationPoseCacheState& rhs) const { return !(*this == rhs); }
+};
+
+/// Identifies skeleton pose: skeleton of the model and ordered set of animation states sampled at quantized time.
+struct AnimationPoseCacheKey
+{
+    const Model* model_{};
+    float timeStep_{};
+    ea::vector<AnimationPoseCacheState> states_;
+
+    /// Reset key contents, capacity is preserved.
+    void Reset(const Model* model, float timeStep);
+    /// Append animation state.
+    void AddState(const AnimationPoseCacheState& state) { states_.push_back(state); }
+
+    bool operator==(const AnimationPoseCacheKey& rhs) const
+    {
+        return model_ == rhs.model_ && timeStep_ == rhs.timeStep_ && states_ == rhs.states_;
+    }
+    bool operator!=(const AnimationPoseCacheKey& rhs) const { return !(*this == rhs); }
+
+    unsigned ToHash() const;
+};
+
+/// Skeleton pose evaluated once per frame and shared between animated models.
+struct AnimationPoseCacheEntry
+{
+    ea::vector<Transform> localTransforms_;
+    ea::vector<Matrix3x4> modelTransforms_;
+};
+
+/// Cache of skeleton poses evaluated on current frame.
+/// Crowds playing the same animations at the same quantized time evaluate each unique pose only once.
+/// Safe to use from multiple threads during drawable update.
+class URHO3D_API AnimationPoseCache
+{
+public:
+    /// Begin new frame. Poses of previous frame are discarded.
+    void BeginFrame();
+
+    /// Return pose evaluated on current frame, or null if not found.
+    ea::shared_ptr<const AnimationPoseCacheEntry> FindPose(const AnimationPoseCacheKey& key);
+    /// Store evaluated pose. Existing pose is kept if the same pose was stored concurrently.
+    void StorePose(const AnimationPoseCacheKey& key, ea::shared_ptr<const AnimationPoseCacheEntry> pose);
+
+    /// Return statistics for current frame.
+    /// @{
+    unsigned GetNumPoses() const { return poses_.size(); }
+    unsigned GetNumHits() const { return numHits_; }
+    /// @}
+
+private:
+    Mutex mutex_;
+    ea::unordered_map<AnimationPoseCacheKey, ea::shared_ptr<const AnimationPoseCacheEntry>> poses_;
+    unsigned numHits_{};
+};
+
+}
@@ -81,6 +81,37 @@ Variant BlendAdditive(const Variant& oldValue, const Variant& newValue, const Va
 
 }
 
+Transform& AnimatedNodeTransforms::GetTransform(Node* node, AnimationChannelFlags channelMask)
+{
+    const auto iter = indices_.find(node);
+    if (iter != indices_.end())
+    {
+        Entry& entry = entries_[iter->second];
+        entry.channelMask_ |= channelMask;
+        return entry.transform_;
+    }
+
+    indices_.emplace(node, entries_.size());
+    entries_.push_back(Entry{ node, Transform{ node->GetPosition(), node->GetRotation(), node->GetScale() }, channelMask });
+    return entries_.back().transform_;
+}
+
+void AnimatedNodeTransforms::Apply()
+{
+    for (const Entry& entry : entries_)
+    {
+        if (entry.channelMask_ & CHANNEL_POSITION)
+            entry.node_->SetPosition(entry.transform_.position_);
+        if (entry.channelMask_ & CHANNEL_ROTATION)
+            entry.node_->SetRotation(entry.transform_.rotation_);
+        if (entry.channelMask_ & CHANNEL_SCALE)
+            entry.node_->SetScale(entry.transform_.scale_);
+    }
+
+    entries_.clear();
+    indices_.clear();
+}
+
 AnimationState::AnimationState(AnimationController* controller, AnimatedModel* model, Animation* animation) :
     controller_(controller),
     model_(model),
@@ -337,17 +368,32 @@ float AnimationState::GetLength() const
 }
 
 void AnimationState::ApplyModelTracks()
+{
+    ApplyModelTracks(time_);
+}
+
+void AnimationState::ApplyModelTracks(float time)
 {
     if (!animation_ || !IsEnabled())
         return;
 
+    ea::vector<Transform>* bonePose = model_ ? &model_->boneLocalTransforms_ : nullptr;
     for (ModelAnimationStateTrack& stateTrack : modelTracks_)
     {
         // Do not apply if the bone has animation disabled
         if (!stateTrack.bone_->animated_)
             continue;
 
-        ApplyTransformTrack(*stateTrack.track_, stateTrack.node_, stateTrack.bone_, stateTrack.keyFrame_, weight_, true);
+        if (stateTrack.node_)
+        {
+            ApplyTransformTrack(*stateTrack.track_, stateTrack.node_, stateTrack.bone_,
+                time, stateTrack.keyFrame_, weight_, true);
+        }
+        else if (bonePose && stateTrack.boneIndex_ < bonePose->size())
+        {
+            ApplyTransformTrack(*stateTrack.track_, (*bonePose)[stateTrack.boneIndex_],
+                time, stateTrack.keyFrame_, weight_);
+        }
     }
 }
 
@@ -358,7 +404,24 @@ void AnimationState::ApplyNodeTracks()
 
     for (NodeAnimationStateTrack& stateTrack : nodeTracks_)
     {
-        ApplyTransformTrack(*stateTrack.track_, stateTrack.node_, nullptr, stateTrack.keyFrame_, weight_, false);
+        ApplyTransformTrack(*stateTrack.track_, stateTrack.node_, nullptr, time_, stateTrack.keyFrame_, weight_, false);
+    }
+}
+
+void AnimationState::SampleNodeTracks(AnimatedNodeTransforms& transforms)
+{
+    if (!animation_ || !IsEnabled())
+        return;
+
+    for (NodeAnimationStateTrack& stateTrack : nodeTracks_)
+    {
+        const AnimationTrack& track = *stateTrack.track_;
+        Node* node = stateTrack.node_.Get();
+        if (track.keyFrames_.empty() || !node)
+            continue;
+
+        Transform& transform = transforms.GetTransform(node, track.channelMask_);
+        ApplyTransformTrack(track, transform, time_, stateTrack.keyFrame_, weight_);
     }
 }
 
@@ -373,36 +436,33 @@ void AnimationState::ApplyAttributeTracks()
     }
 }
 
-void AnimationState::ApplyTransformTrack(const AnimationTrack& track,
-    Node* node, Bone* bone, unsigned& frame, float weight, bool silent)
+Transform AnimationState::SampleTransformTrack(const AnimationTrack& track,
+    const Transform& currentTransform, float time, unsigned& frame, float weight) const
 {
-    if (track.keyFrames_.empty() || !node)
-        return;
-
     const AnimationKeyFrame& baseValue = track.keyFrames_.front();
     const AnimationChannelFlags channelMask = track.channelMask_;
 
     Transform newTransform;
-    track.Sample(time_, animation_->GetLength(), looped_, frame, newTransform);
+    track.Sample(time, animation_->GetLength(), looped_, frame, newTransform);
 
     if (blendingMode_ == ABM_ADDITIVE) // not ABM_LERP
     {
         if (channelMask & CHANNEL_POSITION)
         {
             const Vector3 delta = newTransform.position_ - baseValue.position_;
-            newTransform.position_ = node->GetPosition() + delta * weight;
+            newTransform.position_ = currentTransform.position_ + delta * weight;
         }
         if (channelMask & CHANNEL_ROTATION)
         {
             const Quaternion delta = newTransform.rotation_ * baseValue.rotation_.Inverse();
-            newTransform.rotation_ = (delta * node->GetRotation()).Normalized();
+            newTransform.rotation_ = (delta * currentTransform.rotation_).Normalized();
             if (!Equals(weight, 1.0f))
-                newTransform.rotation_ = node->GetRotation().Slerp(newTransform.rotation_, weight);
+                newTransform.rotation_ = currentTransform.rotation_.Slerp(newTransform.rotation_, weight);
         }
         if (channelMask & CHANNEL_SCALE)
         {
             const Vector3 delta = newTransform.scale_ - baseValue.scale_;
-            newTransform.scale_ = node->GetScale() + delta * weight;
+            newTransform.scale_ = currentTransform.scale_ + delta * weight;
         }
     }
     else
@@ -410,14 +470,27 @@ void AnimationState::ApplyTransformTrack(const AnimationTrack& track,
         if (!Equals(weight, 1.0f)) // not full weight
         {
             if (channelMask & CHANNEL_POSITION)
-                newTransform.position_ = node->GetPosition().Lerp(newTransform.position_, weight);
+                newTransform.position_ = currentTransform.position_.Lerp(newTransform.position_, weight);
             if (channelMask & CHANNEL_ROTATION)
-                newTransform.rotation_ = node->GetRotation().Slerp(newTransform.rotation_, weight);
+                newTransform.rotation_ = currentTransform.rotation_.Slerp(newTransform.rotation_, weight);
             if (channelMask & CHANNEL_SCALE)
-                newTransform.scale_ = node->GetScale().Lerp(newTransform.scale_, weight);
+                newTransform.scale_ = currentTransform.scale_.Lerp(newTransform.scale_, weight);
         }
     }
 
+    return newTransform;
+}
+
+void AnimationState::ApplyTransformTrack(const AnimationTrack& track,
+    Node* node, Bone* bone, float time, unsigned& frame, float weight, bool silent)
+{
+    if (track.keyFrames_.empty() || !node)
+        return;
+
+    const AnimationChannelFlags channelMask = track.channelMask_;
+    const Transform currentTransform{ node->GetPosition(), node->GetRotation(), node->GetScale() };
+    const Transform newTransform = SampleTransformTrack(track, currentTransform, time, frame, weight);
+
     if (silent)
     {
         if (channelMask & CHANNEL_POSITION)
@@ -438,6 +511,23 @@ void AnimationState::ApplyTransformTrack(const AnimationTrack& track,
     }
 }
 
+void AnimationState::ApplyTransformTrack(const AnimationTrack& track,
+    Transform& transform, float time, unsigned& frame, float weight)
+{
+    if (track.keyFrames_.empty())
+        return;
+
+    const AnimationChannelFlags channelMask = track.channelMask_;
+    const Transform newTransform = SampleTransformTrack(track, transform, time, frame, weight);
+
+    if (channelMask & CHANNEL_POSITION)
+        transform.position_ = newTransform.position_;
+    if (channelMask & CHANNEL_ROTATION)
+        transform.rotation_ = newTransform.rotation_;
+    if (channelMask & CHANNEL_SCALE)
+        transform.scale_ = newTransform.scale_;
+}
+
 void AnimationState::ApplyAttributeTrack(AttributeAnimationStateTrack& stateTrack, float weight)
 {
     const VariantAnimationTrack& track = *stateTrack.track_;
@@ -27,7 +27,9 @@
 #include <EASTL/unordered_map.h>
 
 #include "../Container/Ptr.h"
+#include "../Graphics/AnimationTrack.h"
 #include "../Math/StringHash.h"
+#include "../Math/Transform.h"
 
 namespace Urho3D
 {
@@ -59,6 +61,9 @@ struct URHO3D_API ModelAnimationStateTrack
 {
     const AnimationTrack* track_{};
     Bone* bone_{};
+    /// Index of the bone in the skeleton. Used to animate nodeless skeleton.
+    unsigned boneIndex_{};
+    /// Bone node. Null if the pose buffer of nodeless skeleton is animated instead.
     WeakPtr<Node> node_;
     unsigned keyFrame_{};
 };
@@ -71,6 +76,26 @@ struct URHO3D_API NodeAnimationStateTrack
     unsigned keyFrame_{};
 };
 
+/// Node transforms sampled from node tracks of animation states and applied to nodes afterwards.
+struct URHO3D_API AnimatedNodeTransforms
+{
+    /// Animated node transform.
+    struct Entry
+    {
+        Node* node_{};
+        Transform transform_;
+        AnimationChannelFlags channelMask_;
+    };
+
+    /// Return transform of the node for blending. Initialized from the node if not sampled yet.
+    Transform& GetTransform(Node* node, AnimationChannelFlags channelMask);
+    /// Apply sampled transforms to nodes and clear them.
+    void Apply();
+
+    ea::vector<Entry> entries_;
+    ea::unordered_map<Node*, unsigned> indices_;
+};
+
 /// Custom attribute type, used to support sub-attribute animation in special cases.
 enum class AnimatedAttributeType
 {
@@ -184,15 +209,27 @@ public:
 
     /// Apply animation to a skeleton. Transform changes are applied silently, so the model needs to dirty its root model afterward.
     void ApplyModelTracks();
+    /// Apply animation to a skeleton at given time instead of current time position.
+    void ApplyModelTracks(float time);
     /// Apply animation to a scene node hierarchy.
     void ApplyNodeTracks();
+    /// Sample animation of a scene node hierarchy without modifying nodes. Safe to call from worker threads.
+    void SampleNodeTracks(AnimatedNodeTransforms& transforms);
+    /// Return whether the state animates a scene node hierarchy.
+    bool HasNodeTracks() const { return !nodeTracks_.empty(); }
     /// Apply animation to attributes.
     void ApplyAttributeTracks();
 
 private:
+    /// Sample single transformation track and blend it with current transform. Key frame hint is updated on call.
+    Transform SampleTransformTrack(const AnimationTrack& track,
+        const Transform& currentTransform, float time, unsigned& frame, float weight) const;
     /// Apply single transformation track to target object. Key frame hint is updated on call.
     void ApplyTransformTrack(const AnimationTrack& track,
-        Node* node, Bone* bone, unsigned& frame, float weight, bool silent);
+        Node* node, Bone* bone, float time, unsigned& frame, float weight, bool silent);
+    /// Apply single transformation track to bone pose. Key frame hint is updated on call.
+    void ApplyTransformTrack(const AnimationTrack& track,
+        Transform& transform, float time, unsigned& frame, float weight);
     /// Apply single attribute track to target object. Key frame hint is updated on call.
     void ApplyAttributeTrack(AttributeAnimationStateTrack& stateTrack, float weight);
 
@@ -79,6 +79,29 @@ public:
         return {{ currentBufferIndex_, offset, size }, data };
     }
 
+    /// Copy all blocks from another collection with the same alignment.
+    /// Returns location of each buffer of other collection within this collection.
+    void Append(const ConstantBufferCollection& other, ea::vector<ConstantBufferCollectionRef>& bufferLocations)
+    {
+        assert(alignment_ == other.alignment_ && bufferSize_ == other.bufferSize_);
+
+        const unsigned numBuffers = other.GetNumBuffers();
+        bufferLocations.resize(numBuffers);
+        for (unsigned i = 0; i < numBuffers; ++i)
+        {
+            const unsigned size = other.GetBufferSize(i);
+            if (size == 0)
+            {
+                bufferLocations[i] = {};
+                continue;
+            }
+
+            const auto& refAndData = AddBlock(size);
+            memcpy(refAndData.second, other.GetBufferData(i), size);
+            bufferLocations[i] = refAndData.first;
+        }
+    }
+
     /// Return number of buffers.
     unsigned GetNumBuffers() const { return currentBufferIndex_ + 1; }
 
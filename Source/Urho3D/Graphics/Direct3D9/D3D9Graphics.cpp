@@ -2411,6 +2411,11 @@ void Graphics::CheckFeatureSupport()
     anisotropySupport_ = true;
     dxtTextureSupport_ = true;
 
+    // D3D9 has no signed normalized byte vertex type, half floats are optional
+    byteNormVertexSupport_ = false;
+    halfFloatVertexSupport_ = (impl_->deviceCaps_.DeclTypes & (D3DDTCAPS_FLOAT16_2 | D3DDTCAPS_FLOAT16_4))
+        == (D3DDTCAPS_FLOAT16_2 | D3DDTCAPS_FLOAT16_4);
+
     // Reset features first
     lightPrepassSupport_ = false;
     deferredSupport_ = false;
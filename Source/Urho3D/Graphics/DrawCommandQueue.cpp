@@ -38,9 +38,19 @@ DrawCommandQueue::DrawCommandQueue(Graphics* graphics)
 
 void DrawCommandQueue::Reset(bool preferConstantBuffers)
 {
-    useConstantBuffers_ = preferConstantBuffers
+    ResetInternal(preferConstantBuffers
         ? graphics_->GetCaps().constantBuffersSupported_
-        : !graphics_->GetCaps().globalUniformsSupported_;
+        : !graphics_->GetCaps().globalUniformsSupported_);
+}
+
+void DrawCommandQueue::Reset(const DrawCommandQueue& compatibleQueue)
+{
+    ResetInternal(compatibleQueue.useConstantBuffers_);
+}
+
+void DrawCommandQueue::ResetInternal(bool useConstantBuffers)
+{
+    useConstantBuffers_ = useConstantBuffers;
 
     // Reset state accumulators
     currentDrawCommand_ = {};
@@ -71,6 +81,72 @@ void DrawCommandQueue::Reset(bool preferConstantBuffers)
     scissorRects_.push_back(IntRect::ZERO);
 }
 
+void DrawCommandQueue::Append(const DrawCommandQueue& other)
+{
+    assert(useConstantBuffers_ == other.useConstantBuffers_);
+    if (other.drawCommands_.empty())
+        return;
+
+    const unsigned firstCommand = drawCommands_.size();
+    const unsigned shaderResourcesOffset = shaderResources_.size();
+    const unsigned scissorRectsOffset = scissorRects_.size() - 1;
+    const unsigned shaderParametersOffset = shaderParameters_.collection_.Size();
+
+    // Copy shader parameters
+    if (useConstantBuffers_)
+        constantBuffers_.collection_.Append(other.constantBuffers_.collection_, tempConstantBufferLocations_);
+    else
+    {
+        shaderParameters_.collection_.Append(other.shaderParameters_.collection_);
+        shaderParameters_.currentGroupRange_.first = shaderParameters_.collection_.Size();
+        shaderParameters_.currentGroupRange_.second = shaderParameters_.currentGroupRange_.first;
+    }
+
+    // Copy resources, scissor rects and commands. Scissor rect #0 is always present.
+    shaderResources_.insert(shaderResources_.end(), other.shaderResources_.begin(), other.shaderResources_.end());
+    currentShaderResourceGroup_.first = shaderResources_.size();
+    currentShaderResourceGroup_.second = currentShaderResourceGroup_.first;
+
+    scissorRects_.insert(scissorRects_.end(), other.scissorRects_.begin() + 1, other.scissorRects_.end());
+    drawCommands_.insert(drawCommands_.end(), other.drawCommands_.begin(), other.drawCommands_.end());
+
+    // Adjust references in copied commands
+    for (unsigned commandIndex = firstCommand; commandIndex < drawCommands_.size(); ++commandIndex)
+    {
+        DrawCommandDescription& cmd = drawCommands_[commandIndex];
+
+        if (useConstantBuffers_)
+        {
+            for (ConstantBufferCollectionRef& ref : cmd.constantBuffers_)
+            {
+                if (ref.size_ == 0)
+                    continue;
+
+                const ConstantBufferCollectionRef& bufferLocation = tempConstantBufferLocations_[ref.index_];
+                ref.index_ = bufferLocation.index_;
+                ref.offset_ += bufferLocation.offset_;
+            }
+        }
+        else
+        {
+            for (ShaderParameterRange& range : cmd.shaderParameters_)
+            {
+                if (range.first == range.second)
+                    continue;
+
+                range.first += shaderParametersOffset;
+                range.second += shaderParametersOffset;
+            }
+        }
+
+        cmd.shaderResources_.first += shaderResourcesOffset;
+        cmd.shaderResources_.second += shaderResourcesOffset;
+
+        if (cmd.scissorRect_ != 0)
+            cmd.scissorRect_ += scissorRectsOffset;
+    }
+}
+
 void DrawCommandQueue::Execute()
 {
     if (drawCommands_.empty())
@@ -101,6 +101,12 @@ public:
 
     /// Reset queue.
     void Reset(bool preferConstantBuffers = true);
+    /// Reset queue and use the same shader parameter storage as in another queue, so they can be merged.
+    void Reset(const DrawCommandQueue& compatibleQueue);
+
+    /// Append all draw commands from another compatible queue.
+    /// Shall not be called while shader parameter group is being filled.
+    void Append(const DrawCommandQueue& other);
 
     /// Set pipeline state. Must be called first.
     void SetPipelineState(PipelineState* pipelineState)
@@ -369,7 +375,13 @@ public:
     /// Execute commands in the queue.
     void Execute();
 
+    /// Return whether the queue uses constant buffers.
+    bool IsUsingConstantBuffers() const { return useConstantBuffers_; }
+
 private:
+    /// Reset queue with given shader parameter storage.
+    void ResetInternal(bool useConstantBuffers);
+
     /// Cached pointer to Graphics.
     Graphics* graphics_{};
     /// Whether to use constant buffers.
@@ -412,6 +424,9 @@ private:
     DrawCommandDescription currentDrawCommand_;
     /// Current shader resource group.
     ShaderResourceRange currentShaderResourceGroup_;
+
+    /// Temporary buffer for merging queues.
+    ea::vector<ConstantBufferCollectionRef> tempConstantBufferLocations_;
 };
 
 }
@@ -193,6 +193,9 @@ public:
     virtual void ProcessRayQuery(const RayOctreeQuery& query, ea::vector<RayQueryResult>& results);
     /// Update before octree reinsertion. Is called from a worker thread.
     virtual void Update(const FrameInfo& frame) { }
+    /// Apply results of threaded update that cannot be applied from a worker thread, e.g. write to scene nodes.
+    /// Is called from the main thread after all drawables are updated, if queued via Octree::QueueCommit.
+    virtual void CommitUpdate() { }
     /// Calculate distance and prepare batches for rendering. May be called from worker thread(s), possibly re-entrantly.
     virtual void UpdateBatches(const FrameInfo& frame);
     /// Prepare geometry for rendering.
@@ -260,6 +263,9 @@ public:
 
     /// Return drawable flags.
     DrawableFlags GetDrawableFlags() const { return drawableFlags_; }
+    /// Return revision of drawable in Octree. Changed every time the drawable is added to, removed from or reinserted
+    /// into Octree. Revisions are unique across all drawables and never reused.
+    unsigned long long GetOctreeUpdateRevision() const { return octreeUpdateRevision_; }
 
     /// Return draw distance.
     /// @property
@@ -465,6 +471,8 @@ protected:
     bool occludee_;
     /// Octree update queued flag.
     bool updateQueued_;
+    /// Octree update revision.
+    unsigned long long octreeUpdateRevision_{};
     /// Zone inconclusive or dirtied flag.
     bool zoneDirty_;
     /// Octree octant.
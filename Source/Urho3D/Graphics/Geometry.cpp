@@ -38,6 +38,23 @@
 namespace Urho3D
 {
 
+namespace
+{
+
+/// Return first element with given semantic regardless of type.
+const VertexElement* FindVertexElement(const ea::vector<VertexElement>& elements, VertexElementSemantic semantic)
+{
+    const auto iter = ea::find_if(elements.begin(), elements.end(),
+        [&](const VertexElement& element) { return element.semantic_ == semantic && element.index_ == 0; });
+    return iter != elements.end() ? &*iter : nullptr;
+}
+
+/// Stride and UV offset of unpacked ray test vertices.
+const unsigned rayTestVertexSize = 2 * sizeof(Vector4);
+const unsigned rayTestUVOffset = sizeof(Vector4);
+
+}
+
 extern const char* GEOMETRY_CATEGORY;
 
 Geometry::Geometry(Context* context) :
@@ -85,6 +102,7 @@ bool Geometry::SetVertexBuffer(unsigned index, VertexBuffer* buffer)
 
     vertexBuffersDependencies_[index] = CreateDependency(buffer);
     vertexBuffers_[index] = buffer;
+    rayTestVertexData_ = nullptr;
     return true;
 }
 
@@ -94,6 +112,7 @@ void Geometry::SetVertexBuffers(const ea::vector<SharedPtr<VertexBuffer>>& verte
     for (unsigned i = 0; i < vertexBuffers.size(); ++i)
         vertexBuffersDependencies_[i] = CreateDependency(vertexBuffers[i]);
     vertexBuffers_ = vertexBuffers;
+    rayTestVertexData_ = nullptr;
 }
 
 void Geometry::SetIndexBuffer(IndexBuffer* buffer)
@@ -181,6 +200,7 @@ void Geometry::SetRawVertexData(const ea::shared_array<unsigned char>& data, con
     rawVertexData_ = data;
     rawVertexSize_ = VertexBuffer::GetVertexSize(elements);
     rawElements_ = elements;
+    rayTestVertexData_ = nullptr;
 }
 
 void Geometry::SetRawVertexData(const ea::shared_array<unsigned char>& data, unsigned elementMask)
@@ -188,6 +208,7 @@ void Geometry::SetRawVertexData(const ea::shared_array<unsigned char>& data, uns
     rawVertexData_ = data;
     rawVertexSize_ = VertexBuffer::GetVertexSize(elementMask);
     rawElements_ = VertexBuffer::GetElements(elementMask);
+    rayTestVertexData_ = nullptr;
 }
 
 void Geometry::SetRawIndexData(const ea::shared_array<unsigned char>& data, unsigned indexSize)
@@ -353,12 +374,11 @@ float Geometry::GetHitDistance(const Ray& ray, Vector3* outNormal, Vector2* outU
 
     GetRawData(vertexData, vertexSize, indexData, indexSize, elements);
 
-    if (!vertexData || !elements || VertexBuffer::GetElementOffset(*elements, TYPE_VECTOR3, SEM_POSITION) != 0)
+    if (!vertexData || !elements)
         return M_INFINITY;
 
-    unsigned uvOffset = VertexBuffer::GetElementOffset(*elements, TYPE_VECTOR2, SEM_TEXCOORD);
-
-    if (outUV && uvOffset == M_MAX_UNSIGNED)
+    const bool hasUV = FindVertexElement(*elements, SEM_TEXCOORD) != nullptr;
+    if (outUV && !hasUV)
     {
         // requested UV output, but no texture data in vertex buffer
         URHO3D_LOGWARNING("Illegal GetHitDistance call: UV return requested on vertex buffer without UV coords");
@@ -366,6 +386,20 @@ float Geometry::GetHitDistance(const Ray& ray, Vector3* outNormal, Vector2* outU
         outUV = nullptr;
     }
 
+    const bool isPositionPacked = VertexBuffer::GetElementOffset(*elements, TYPE_VECTOR3, SEM_POSITION) != 0;
+    const bool isUVPacked = outUV && VertexBuffer::GetElementOffset(*elements, TYPE_VECTOR2, SEM_TEXCOORD) == M_MAX_UNSIGNED;
+    if (isPositionPacked || isUVPacked)
+    {
+        const ea::vector<Vector4>& unpackedVertices = GetRayTestVertices(vertexData, vertexSize, *elements);
+        if (unpackedVertices.empty())
+            return M_INFINITY;
+
+        return indexData ? ray.HitDistance(unpackedVertices.data(), rayTestVertexSize, indexData, indexSize, indexStart_, indexCount_,
+            outNormal, outUV, rayTestUVOffset) : ray.HitDistance(unpackedVertices.data(), rayTestVertexSize, vertexStart_, vertexCount_,
+            outNormal, outUV, rayTestUVOffset);
+    }
+
+    const unsigned uvOffset = VertexBuffer::GetElementOffset(*elements, TYPE_VECTOR2, SEM_TEXCOORD);
     return indexData ? ray.HitDistance(vertexData, vertexSize, indexData, indexSize, indexStart_, indexCount_, outNormal, outUV,
         uvOffset) : ray.HitDistance(vertexData, vertexSize, vertexStart_, vertexCount_, outNormal, outUV, uvOffset);
 }
@@ -380,10 +414,44 @@ bool Geometry::IsInside(const Ray& ray) const
 
     GetRawData(vertexData, vertexSize, indexData, indexSize, elements);
 
+    if (vertexData && elements && VertexBuffer::GetElementOffset(*elements, TYPE_VECTOR3, SEM_POSITION) != 0)
+    {
+        const ea::vector<Vector4>& unpackedVertices = GetRayTestVertices(vertexData, vertexSize, *elements);
+        if (unpackedVertices.empty())
+            return false;
+
+        return indexData ? ray.InsideGeometry(unpackedVertices.data(), rayTestVertexSize, indexData, indexSize, indexStart_, indexCount_)
+            : ray.InsideGeometry(unpackedVertices.data(), rayTestVertexSize, vertexStart_, vertexCount_);
+    }
+
     return vertexData ? (indexData ? ray.InsideGeometry(vertexData, vertexSize, indexData, indexSize, indexStart_, indexCount_) :
                          ray.InsideGeometry(vertexData, vertexSize, vertexStart_, vertexCount_)) : false;
 }
 
+const ea::vector<Vector4>& Geometry::GetRayTestVertices(const unsigned char* vertexData, unsigned vertexSize,
+    const ea::vector<VertexElement>& elements) const
+{
+    // Unpack whole vertex range used by the geometry once, vertex data is not expected to change
+    const unsigned vertexEnd = vertexStart_ + vertexCount_;
+    if (rayTestVertexData_ == vertexData && rayTestVertices_.size() == 2 * vertexEnd)
+        return rayTestVertices_;
+
+    rayTestVertices_.clear();
+    rayTestVertexData_ = nullptr;
+
+    const VertexElement* positionElement = FindVertexElement(elements, SEM_POSITION);
+    if (!positionElement)
+        return rayTestVertices_;
+
+    rayTestVertices_.resize(2 * vertexEnd);
+    VertexBuffer::UnpackVertexData(vertexData, vertexSize, *positionElement, 0, vertexEnd, &rayTestVertices_[0], rayTestVertexSize);
+    if (const VertexElement* uvElement = FindVertexElement(elements, SEM_TEXCOORD))
+        VertexBuffer::UnpackVertexData(vertexData, vertexSize, *uvElement, 0, vertexEnd, &rayTestVertices_[1], rayTestVertexSize);
+
+    rayTestVertexData_ = vertexData;
+    return rayTestVertices_;
+}
+
 unsigned Geometry::RecalculatePipelineStateHash() const
 {
     unsigned hash = 0;
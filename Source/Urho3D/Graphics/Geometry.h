@@ -149,6 +149,9 @@ public:
 private:
     /// Recalculate hash. Shall be save to call from multiple threads as long as the object is not changing.
     unsigned RecalculatePipelineStateHash() const override;
+    /// Return positions and UVs unpacked from packed vertex data for ray tests. Each vertex is a pair of Vector4.
+    const ea::vector<Vector4>& GetRayTestVertices(const unsigned char* vertexData, unsigned vertexSize,
+        const ea::vector<VertexElement>& elements) const;
 
     /// Vertex buffers.
     ea::vector<SharedPtr<VertexBuffer> > vertexBuffers_;
@@ -180,6 +183,10 @@ private:
     unsigned rawVertexSize_;
     /// Raw index data override size.
     unsigned rawIndexSize_;
+    /// Unpacked vertices for ray tests of packed vertex data.
+    mutable ea::vector<Vector4> rayTestVertices_;
+    /// Vertex data from which ray test vertices were unpacked.
+    mutable const unsigned char* rayTestVertexData_{};
 };
 
 }
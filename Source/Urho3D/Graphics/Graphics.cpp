@@ -340,6 +340,20 @@ bool Graphics::GetMaximized() const
     return window_? static_cast<bool>(SDL_GetWindowFlags(window_) & SDL_WINDOW_MAXIMIZED) : false;
 }
 
+bool Graphics::GetVertexElementTypeSupport(VertexElementType type) const
+{
+    switch (type)
+    {
+    case TYPE_BYTE4_NORM:
+        return byteNormVertexSupport_;
+    case TYPE_HALF2:
+    case TYPE_HALF4:
+        return halfFloatVertexSupport_;
+    default:
+        return true;
+    }
+}
+
 Vector3 Graphics::GetDisplayDPI(int monitor) const
 {
     Vector3 result;
@@ -533,6 +533,9 @@ public:
     /// @property
     bool GetSRGBWriteSupport() const { return sRGBWriteSupport_; }
 
+    /// Return whether vertex element type can be used in vertex buffers.
+    bool GetVertexElementTypeSupport(VertexElementType type) const;
+
     /// Return supported fullscreen resolutions (third component is refreshRate). Will be empty if listing the resolutions is not supported on the platform (e.g. Web).
     /// @property
     ea::vector<IntVector3> GetResolutions(int monitor) const;
@@ -883,6 +886,10 @@ private:
     bool sRGBSupport_{};
     /// sRGB conversion on write support flag.
     bool sRGBWriteSupport_{};
+    /// Signed normalized byte vertex element support flag.
+    bool byteNormVertexSupport_{true};
+    /// Half float vertex element support flag.
+    bool halfFloatVertexSupport_{true};
     /// Number of primitives this frame.
     unsigned numPrimitives_{};
     /// Number of batches this frame.
@@ -128,7 +128,11 @@ extern URHO3D_API const unsigned ELEMENT_TYPESIZES[] =
     3 * sizeof(float),
     4 * sizeof(float),
     sizeof(unsigned),
-    sizeof(unsigned)
+    sizeof(unsigned),
+    sizeof(unsigned),
+    2 * sizeof(unsigned short),
+    2 * sizeof(unsigned short),
+    4 * sizeof(unsigned short)
 };
 
 
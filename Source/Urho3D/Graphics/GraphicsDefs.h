@@ -162,6 +162,14 @@ enum VertexElementType : unsigned char
     TYPE_VECTOR4,
     TYPE_UBYTE4,
     TYPE_UBYTE4_NORM,
+    /// 4 signed bytes normalized to [-1, 1]. Not supported on D3D9.
+    TYPE_BYTE4_NORM,
+    /// 2 unsigned shorts normalized to [0, 1].
+    TYPE_USHORT2_NORM,
+    /// 2 half-precision floats.
+    TYPE_HALF2,
+    /// 4 half-precision floats.
+    TYPE_HALF4,
     MAX_VERTEX_ELEMENT_TYPES
 };
 
@@ -133,8 +133,22 @@ bool Model::BeginLoad(Deserializer& source)
         unsigned vertexSize = VertexBuffer::GetVertexSize(desc.vertexElements_);
         desc.dataSize_ = desc.vertexCount_ * vertexSize;
 
+        // Convert vertex elements not supported by the graphics backend, e.g. quantized normals on D3D9
+        ea::vector<VertexElement> loadedElements = desc.vertexElements_;
+        VertexBuffer::UpdateOffsets(loadedElements);
+        if (VertexBuffer::ReplaceUnsupportedElements(GetSubsystem<Graphics>(), desc.vertexElements_))
+        {
+            ByteVector loadedData(desc.dataSize_);
+            source.Read(loadedData.data(), loadedData.size());
+
+            vertexSize = VertexBuffer::GetVertexSize(desc.vertexElements_);
+            desc.dataSize_ = desc.vertexCount_ * vertexSize;
+            desc.data_ = new unsigned char[desc.dataSize_];
+            VertexBuffer::ConvertVertexData(desc.vertexCount_, loadedData.data(), loadedElements,
+                desc.data_.get(), desc.vertexElements_);
+        }
         // Prepare vertex buffer data to be uploaded during EndLoad()
-        if (async)
+        else if (async)
         {
             desc.data_ = new unsigned char[desc.dataSize_];
             source.Read(desc.data_.get(), desc.dataSize_);
@@ -23,6 +23,7 @@
 #include "../Graphics/ModelView.h"
 
 #include "../Graphics/Geometry.h"
+#include "../Graphics/Graphics.h"
 #include "../Graphics/IndexBuffer.h"
 #include "../Graphics/Model.h"
 #include "../Graphics/Tangent.h"
@@ -672,6 +673,14 @@ Vector3 GeometryLODView::CalculateCenter() const
     return vertices_.empty() ? Vector3::ZERO : center / static_cast<float>(vertices_.size());
 }
 
+BoundingBox GeometryLODView::CalculateBoundingBox() const
+{
+    BoundingBox boundingBox;
+    for (const ModelVertex& vertex : vertices_)
+        boundingBox.Merge(static_cast<Vector3>(vertex.position_));
+    return boundingBox;
+}
+
 unsigned GeometryLODView::CalculateNumMorphs() const
 {
     unsigned numMorphs = 0;
@@ -817,6 +826,57 @@ void GeometryLODView::RecalculateTangents()
         offsetof(ModelVertex, normal_), offsetof(ModelVertex, uv_), offsetof(ModelVertex, tangent_));
 }
 
+void GeometryLODView::QuantizeVertexFormat(const ModelVertexQuantization& quantization)
+{
+    const auto isDefined = [](VertexElementType type) { return type != ModelVertexFormat::Undefined; };
+
+    if (quantization.packNormals_)
+    {
+        if (isDefined(vertexFormat_.normal_))
+            vertexFormat_.normal_ = TYPE_BYTE4_NORM;
+        if (isDefined(vertexFormat_.tangent_))
+            vertexFormat_.tangent_ = TYPE_BYTE4_NORM;
+        if (isDefined(vertexFormat_.binormal_))
+            vertexFormat_.binormal_ = TYPE_BYTE4_NORM;
+    }
+
+    if (quantization.packColors_)
+    {
+        for (VertexElementType& colorType : vertexFormat_.color_)
+        {
+            if (isDefined(colorType))
+                colorType = TYPE_UBYTE4_NORM;
+        }
+    }
+
+    if (quantization.packUVs_)
+    {
+        for (unsigned i = 0; i < ModelVertex::MaxUVs; ++i)
+        {
+            VertexElementType& uvType = vertexFormat_.uv_[i];
+            // Don't pack 3D and 4D texture coordinates
+            if (uvType != TYPE_VECTOR2)
+                continue;
+
+            const bool isNormalized = ea::all_of(vertices_.begin(), vertices_.end(), [&](const ModelVertex& vertex)
+            {
+                const Vector4& uv = vertex.uv_[i];
+                return uv.x_ >= 0.0f && uv.x_ <= 1.0f && uv.y_ >= 0.0f && uv.y_ <= 1.0f;
+            });
+            uvType = isNormalized ? TYPE_USHORT2_NORM : TYPE_HALF2;
+        }
+    }
+
+    if (quantization.packPositions_ && isDefined(vertexFormat_.position_))
+    {
+        const BoundingBox boundingBox = CalculateBoundingBox();
+        const Vector3 extent = VectorMax(boundingBox.min_.Abs(), boundingBox.max_.Abs());
+        const float maxExtent = Max(extent.x_, Max(extent.y_, extent.z_));
+        if (boundingBox.Defined() && maxExtent <= quantization.maxPackedPositionExtent_)
+            vertexFormat_.position_ = TYPE_HALF4;
+    }
+}
+
 unsigned GeometryView::CalculateNumMorphs() const
 {
     unsigned numMorphs = 0;
@@ -1084,10 +1144,13 @@ void ModelView::ExportModel(Model* model) const
     // Create vertex buffers
     for (auto& [vertexFormat, vertexBufferData] : vertexBuffersData)
     {
-        const auto vertexElements = CollectVertexElements(vertexFormat);
+        auto vertexElements = CollectVertexElements(vertexFormat);
         if (vertexElements.empty())
             URHO3D_LOGERROR("No vertex elements in vertex buffer");
 
+        // Quantized formats may be not supported by the graphics backend, fall back to float formats
+        VertexBuffer::ReplaceUnsupportedElements(GetSubsystem<Graphics>(), vertexElements);
+
         auto vertexBuffer = MakeShared<VertexBuffer>(context_);
         vertexBuffer->SetShadowed(true);
         vertexBuffer->SetSize(vertexBufferData.vertices_.size(), vertexElements);
@@ -1379,6 +1442,15 @@ void ModelView::CalculateMissingTangents()
     }
 }
 
+void ModelView::QuantizeVertexFormats(const ModelVertexQuantization& quantization)
+{
+    for (GeometryView& geometryView : geometries_)
+    {
+        for (GeometryLODView& lodView : geometryView.lods_)
+            lodView.QuantizeVertexFormat(quantization);
+    }
+}
+
 void ModelView::RepairBoneWeights()
 {
     if (bones_.empty())
@@ -60,6 +60,22 @@ struct URHO3D_API ModelVertexFormat
     bool operator !=(const ModelVertexFormat& rhs) const { return !(*this == rhs); }
 };
 
+/// Settings of vertex format quantization. Quantized formats are decoded by GPU and by VertexBuffer unpacking.
+struct URHO3D_API ModelVertexQuantization
+{
+    /// Whether to pack normals, tangents and binormals into signed normalized bytes.
+    bool packNormals_{ true };
+    /// Whether to pack colors into unsigned normalized bytes.
+    bool packColors_{ true };
+    /// Whether to pack UVs into unsigned normalized shorts if they are in [0, 1] range, or into half floats otherwise.
+    bool packUVs_{ true };
+    /// Whether to pack positions into half floats.
+    bool packPositions_{ false };
+    /// Max absolute coordinate of geometry bounding box for positions to be packed.
+    /// Half float has 11 significant bits, so default value gives precision of at least 1/128 units.
+    float maxPackedPositionExtent_{ 8.0f };
+};
+
 /// Model vertex, unpacked for easy editing.
 /// Warning: ModelVertex must be equivalent to an array of Vector4.
 struct URHO3D_API ModelVertex
@@ -163,6 +179,8 @@ struct URHO3D_API GeometryLODView
 
     /// Calculate center of vertices' bounding box.
     Vector3 CalculateCenter() const;
+    /// Calculate bounding box of vertices.
+    BoundingBox CalculateBoundingBox() const;
     /// Calculate number of morphs in the model.
     unsigned CalculateNumMorphs() const;
     /// All equivalent views should be literally equal after normalization.
@@ -172,6 +190,8 @@ struct URHO3D_API GeometryLODView
     void RecalculateFlatNormals();
     void RecalculateSmoothNormals();
     void RecalculateTangents();
+    /// Replace vertex element formats with compact ones if possible.
+    void QuantizeVertexFormat(const ModelVertexQuantization& quantization);
 
     /// Iterate all triangles in primitive. Callback is called with three vertex indices.
     template <class T>
@@ -312,6 +332,8 @@ public:
     void RepairBoneWeights();
     /// Recalculate bounding boxes for bones.
     void RecalculateBoneBoundingBoxes();
+    /// Replace vertex element formats with compact ones for all geometries. Applied on export.
+    void QuantizeVertexFormats(const ModelVertexQuantization& quantization = {});
 
     /// Set contents
     /// @{
@@ -24,6 +24,8 @@
 
 #include <EASTL/sort.h>
 
+#include <atomic>
+
 #include "../Core/Context.h"
 #include "../Core/CoreEvents.h"
 #include "../Core/Profiler.h"
@@ -53,6 +55,15 @@ namespace
 /// Unused vector of drawables.
 static ea::vector<Drawable*> unusedDrawablesVector;
 
+/// Last Octree update revision. Shared by all octrees so revisions are never reused,
+/// even if drawable is moved to another Octree or its memory is reused by another drawable.
+std::atomic<unsigned long long> lastOctreeUpdateRevision{};
+
+unsigned long long AllocateOctreeUpdateRevision()
+{
+    return lastOctreeUpdateRevision.fetch_add(1, std::memory_order_relaxed) + 1;
+}
+
 }
 
 static const float DEFAULT_OCTREE_SIZE = 1000.0f;
@@ -487,6 +498,13 @@ void Octree::Update(const FrameInfo& frame)
         return;
     }
 
+    // Shared animation poses are valid only within one frame
+    animationPoseCache_.BeginFrame();
+
+    // Drawables moved since last sync point should be queued for update
+    if (Scene* scene = GetScene())
+        scene->NotifyDirtyComponents();
+
     // Let drawables update themselves before reinsertion. This can be used for animation
     if (!drawableUpdates_.empty())
     {
@@ -544,6 +562,19 @@ void Octree::Update(const FrameInfo& frame)
         threadedDrawableUpdates_.clear();
     }
 
+    // Commit results of threaded update before anyone can observe them.
+    // Sort drawables so the order doesn't depend on scheduling of worker threads
+    if (!drawableCommits_.empty())
+    {
+        URHO3D_PROFILE("CommitDrawableUpdates");
+
+        ea::sort(drawableCommits_.begin(), drawableCommits_.end(),
+            [](const Drawable* lhs, const Drawable* rhs) { return lhs->GetID() < rhs->GetID(); });
+        for (Drawable* drawable : drawableCommits_)
+            drawable->CommitUpdate();
+        drawableCommits_.clear();
+    }
+
     // Notify drawable update being finished. Custom animation (eg. IK) can be done at this point
     Scene* scene = GetScene();
     if (scene)
@@ -566,6 +597,7 @@ void Octree::Update(const FrameInfo& frame)
         {
             Drawable* drawable = *i;
             drawable->updateQueued_ = false;
+            drawable->octreeUpdateRevision_ = AllocateOctreeUpdateRevision();
             Octant* octant = drawable->GetOctant();
             const BoundingBox& box = drawable->GetWorldBoundingBox();
 
@@ -625,6 +657,7 @@ void Octree::AddDrawable(Drawable* drawable)
     const unsigned index = drawables_.size();
     drawables_.push_back(drawable);
     drawable->SetDrawableIndex(index);
+    drawable->octreeUpdateRevision_ = AllocateOctreeUpdateRevision();
 
     // Insert drawable to common Octree
     rootOctant_.InsertDrawable(drawable);
@@ -674,6 +707,7 @@ void Octree::RemoveDrawable(Drawable* drawable, Octant* octant)
     drawables_.pop_back();
     drawable->SetDrawableIndex(M_MAX_UNSIGNED);
     drawable->updateQueued_ = false;
+    drawable->octreeUpdateRevision_ = AllocateOctreeUpdateRevision();
 }
 
 void Octree::MarkZoneDirty(Zone* zone)
@@ -765,11 +799,18 @@ void Octree::QueueUpdate(Drawable* drawable)
     drawable->updateQueued_ = true;
 }
 
+void Octree::QueueCommit(Drawable* drawable)
+{
+    MutexLock lock(octreeMutex_);
+    drawableCommits_.push_back(drawable);
+}
+
 void Octree::CancelUpdate(Drawable* drawable)
 {
     // This doesn't have to take into account scene being in threaded update, because it is called only
     // when removing a drawable from octree, which should only ever happen from the main thread.
     drawableUpdates_.erase_first(drawable);
+    drawableCommits_.erase_first(drawable);
     drawable->updateQueued_ = false;
 }
 
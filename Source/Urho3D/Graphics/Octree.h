@@ -23,6 +23,7 @@
 #pragma once
 
 #include "../Core/Mutex.h"
+#include "../Graphics/AnimationPoseCache.h"
 #include "../Graphics/Drawable.h"
 #include "../Graphics/OctreeQuery.h"
 
@@ -267,10 +268,15 @@ public:
     /// Return all drawables in all octants.
     const ea::vector<Drawable*>& GetAllDrawables() const { return drawables_; }
 
+    /// Return cache of skeleton poses shared between animated models on current frame.
+    AnimationPoseCache& GetAnimationPoseCache() { return animationPoseCache_; }
+
     /// Mark drawable object as requiring an update and a reinsertion.
     void QueueUpdate(Drawable* drawable);
     /// Cancel drawable object's update.
     void CancelUpdate(Drawable* drawable);
+    /// Queue drawable object to commit results of threaded update from the main thread. May be called from a worker thread.
+    void QueueCommit(Drawable* drawable);
     /// Visualize the component as debug geometry.
     void DrawDebugGeometry(bool depthTest);
 
@@ -286,6 +292,8 @@ private:
     ea::vector<Drawable*> drawableUpdates_;
     /// Drawable objects that were inserted during threaded update phase.
     ea::vector<Drawable*> threadedDrawableUpdates_;
+    /// Drawable objects that should commit results of threaded update.
+    ea::vector<Drawable*> drawableCommits_;
     /// All Drawable objects.
     ea::vector<Drawable*> drawables_;
     /// Mutex for octree reinsertions.
@@ -298,6 +306,8 @@ private:
     BoundingBox worldBoundingBox_;
     /// Zones.
     ZoneLookupIndex zones_;
+    /// Skeleton poses evaluated on current frame.
+    AnimationPoseCache animationPoseCache_;
 };
 
 }
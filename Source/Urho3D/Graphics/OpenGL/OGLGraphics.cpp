@@ -257,7 +257,11 @@ static const unsigned glElementTypes[] =
     GL_FLOAT,
     GL_FLOAT,
     GL_UNSIGNED_BYTE,
-    GL_UNSIGNED_BYTE
+    GL_UNSIGNED_BYTE,
+    GL_BYTE,
+    GL_UNSIGNED_SHORT,
+    GL_VERTEX_HALF_FLOAT,
+    GL_VERTEX_HALF_FLOAT
 };
 
 static const unsigned glElementComponents[] =
@@ -268,9 +272,28 @@ static const unsigned glElementComponents[] =
     3,
     4,
     4,
+    4,
+    4,
+    2,
+    2,
     4
 };
 
+static const bool glElementNormalize[] =
+{
+    false,
+    false,
+    false,
+    false,
+    false,
+    false,
+    true,
+    true,
+    true,
+    false,
+    false
+};
+
 #ifdef GL_ES_VERSION_2_0
 static unsigned glesDepthStencilFormat = GL_DEPTH_COMPONENT16;
 static unsigned glesReadableDepthFormat = GL_DEPTH_COMPONENT;
@@ -2817,6 +2840,7 @@ void Graphics::CheckFeatureSupport()
     else
     {
         instancingSupport_ = GLEW_ARB_instanced_arrays != 0;
+        halfFloatVertexSupport_ = GLEW_ARB_half_float_vertex != 0;
         dxtTextureSupport_ = GLEW_EXT_texture_compression_s3tc != 0;
         anisotropySupport_ = GLEW_EXT_texture_filter_anisotropic != 0;
         sRGBSupport_ = GLEW_EXT_texture_sRGB != 0;
@@ -2859,6 +2883,7 @@ void Graphics::CheckFeatureSupport()
     etc2TextureSupport_ = gl3Support || CheckExtension("OES_compressed_ETC2_RGBA8_texture");
     pvrtcTextureSupport_ = CheckExtension("IMG_texture_compression_pvrtc");
 #endif
+    halfFloatVertexSupport_ = gl3Support || CheckExtension("GL_OES_vertex_half_float");
 
     // Check for best supported depth renderbuffer format for GLES2
     if (CheckExtension("GL_OES_depth24"))
@@ -3195,7 +3220,7 @@ void Graphics::PrepareDraw()
 #endif
                     {
                         glVertexAttribPointer(location, glElementComponents[element.type_], glElementTypes[element.type_],
-                            element.type_ == TYPE_UBYTE4_NORM ? GL_TRUE : GL_FALSE, (unsigned)buffer->GetVertexSize(),
+                            glElementNormalize[element.type_] ? GL_TRUE : GL_FALSE, (unsigned)buffer->GetVertexSize(),
                             (const void *)(size_t)dataStart);
                     }
                 }
@@ -68,6 +68,16 @@
 #ifndef GL_ETC2_RGBA8_OES
 #define GL_ETC2_RGBA8_OES 0x9278
 #endif
+#ifndef GL_HALF_FLOAT_OES
+#define GL_HALF_FLOAT_OES 0x8d61
+#endif
+#if defined(GL_ES_VERSION_3_0)
+#define GL_VERTEX_HALF_FLOAT GL_HALF_FLOAT
+#elif defined(GL_ES_VERSION_2_0)
+#define GL_VERTEX_HALF_FLOAT GL_HALF_FLOAT_OES
+#else
+#define GL_VERTEX_HALF_FLOAT GL_HALF_FLOAT_ARB
+#endif
 #ifndef COMPRESSED_RGB_PVRTC_4BPPV1_IMG
 #define COMPRESSED_RGB_PVRTC_4BPPV1_IMG 0x8c00
 #endif
@@ -173,6 +173,41 @@ public:
     /// Return size.
     unsigned Size() const { return count_; }
 
+    /// Append all parameters from another collection. Parameter indices are shifted by the current size.
+    void Append(const ShaderParameterCollection& other)
+    {
+        // Resize data buffer
+        const unsigned dataSize = data_.size();
+        if (offset_ + other.offset_ > dataSize)
+            data_.resize(ea::max(dataSize * 2, offset_ + other.offset_));
+
+        // Resize metadata buffers
+        const unsigned metadataSize = names_.size();
+        if (count_ + other.count_ > metadataSize)
+        {
+            const unsigned newMetadataSize = ea::max(metadataSize * 2, count_ + other.count_);
+            names_.resize(newMetadataSize);
+            dataOffsets_.resize(newMetadataSize);
+            dataSizes_.resize(newMetadataSize);
+            dataTypes_.resize(newMetadataSize);
+        }
+
+        // Copy metadata
+        for (unsigned i = 0; i < other.count_; ++i)
+        {
+            names_[count_ + i] = other.names_[i];
+            dataOffsets_[count_ + i] = offset_ + other.dataOffsets_[i];
+            dataSizes_[count_ + i] = other.dataSizes_[i];
+            dataTypes_[count_ + i] = other.dataTypes_[i];
+        }
+
+        if (other.offset_ > 0)
+            memcpy(&data_[offset_], other.data_.data(), other.offset_);
+
+        offset_ += other.offset_;
+        count_ += other.count_;
+    }
+
     /// Iterate subset.
     template <class T>
     void ForEach(unsigned from, unsigned to, const T& callback) const
@@ -23,6 +23,8 @@
 #include "../Precompiled.h"
 
 #include "../Core/Context.h"
+#include "../Core/Thread.h"
+#include "../Core/WorkQueue.h"
 #include "../IO/Log.h"
 #include "../Graphics/Geometry.h"
 #include "../Graphics/IndexBuffer.h"
@@ -31,6 +33,10 @@
 
 #include <EASTL/sort.h>
 
+#ifdef URHO3D_SSE
+#include <emmintrin.h>
+#endif
+
 #include "../DebugNew.h"
 
 namespace Urho3D
@@ -39,6 +45,33 @@ namespace Urho3D
 namespace
 {
 
+/// Return mask of position, normal and tangent elements regardless of their types.
+VertexMaskFlags GetAnimatedElementMask(const VertexBuffer* vertexBuffer)
+{
+    VertexMaskFlags mask = MASK_NONE;
+    if (vertexBuffer->HasElement(SEM_POSITION))
+        mask |= MASK_POSITION;
+    if (vertexBuffer->HasElement(SEM_NORMAL))
+        mask |= MASK_NORMAL;
+    if (vertexBuffer->HasElement(SEM_TANGENT))
+        mask |= MASK_TANGENT;
+    return mask;
+}
+
+/// Copy first N components of vertex element into floats, decoding packed formats if needed.
+template <unsigned N>
+void CopyVertexElement(float* dest, const unsigned char* vertexData, const VertexElement& element)
+{
+    if (element.type_ == TYPE_VECTOR3 || element.type_ == TYPE_VECTOR4)
+        memcpy(dest, vertexData + element.offset_, sizeof(float) * N);
+    else
+    {
+        Vector4 value;
+        VertexBuffer::UnpackVertexData(vertexData, 0, element, 0, 1, &value, 0);
+        memcpy(dest, value.Data(), sizeof(float) * N);
+    }
+}
+
 Vector3 TransformNormal(const Matrix3x4& m, const Vector3& v)
 {
     return {
@@ -48,6 +81,249 @@ Vector3 TransformNormal(const Matrix3x4& m, const Vector3& v)
     };
 }
 
+/// Return size of single vertex in morph data.
+unsigned GetMorphVertexSize(VertexMaskFlags morphElementMask)
+{
+    unsigned vertexSize = sizeof(unsigned);
+    if (morphElementMask & MASK_POSITION)
+        vertexSize += sizeof(Vector3);
+    if (morphElementMask & MASK_NORMAL)
+        vertexSize += sizeof(Vector3);
+    if (morphElementMask & MASK_TANGENT)
+        vertexSize += sizeof(Vector3);
+    return vertexSize;
+}
+
+template <bool SkinNormals, bool SkinTangents>
+void SkinVerticesScalarImpl(const SoftwareSkinningBatch& batch, unsigned beginVertex, unsigned endVertex)
+{
+    const unsigned numBones = batch.numBones_;
+    const Matrix3x4* boneTransforms = batch.boneTransforms_.data();
+    const unsigned char* indicesData = batch.blendIndices_ + beginVertex * numBones;
+    const float* weightsData = batch.blendWeights_ + beginVertex * numBones;
+    unsigned char* vertexData = batch.vertexData_ + beginVertex * batch.vertexSize_;
+
+    Matrix3x4 matrix;
+    for (unsigned vertexIndex = beginVertex; vertexIndex < endVertex; ++vertexIndex)
+    {
+        matrix = boneTransforms[indicesData[0]] * weightsData[0];
+        for (unsigned boneIndex = 1; boneIndex < numBones; ++boneIndex)
+            matrix = matrix + boneTransforms[indicesData[boneIndex]] * weightsData[boneIndex];
+
+        Vector3& position = *reinterpret_cast<Vector3*>(vertexData);
+        position = matrix * position;
+
+        if constexpr (SkinNormals)
+        {
+            Vector3& normal = *reinterpret_cast<Vector3*>(vertexData + batch.normalOffset_);
+            normal = TransformNormal(matrix, normal);
+        }
+
+        if constexpr (SkinTangents)
+        {
+            Vector3& tangent = *reinterpret_cast<Vector3*>(vertexData + batch.tangentOffset_);
+            tangent = TransformNormal(matrix, tangent);
+        }
+
+        // Advance
+        indicesData += numBones;
+        weightsData += numBones;
+        vertexData += batch.vertexSize_;
+    }
+}
+
+/// Add scaled morph delta to vertex element.
+void AccumulateMorphDelta(unsigned char* dest, const unsigned char* src, float weight)
+{
+    auto destVector = reinterpret_cast<float*>(dest);
+    auto srcVector = reinterpret_cast<const float*>(src);
+    destVector[0] += srcVector[0] * weight;
+    destVector[1] += srcVector[1] * weight;
+    destVector[2] += srcVector[2] * weight;
+}
+
+#ifdef URHO3D_SSE
+/// Load Vector3 without reading past its end.
+inline __m128 LoadVector3(const void* data)
+{
+    const auto floats = reinterpret_cast<const float*>(data);
+    const __m128 xy = _mm_castpd_ps(_mm_load_sd(reinterpret_cast<const double*>(floats)));
+    return _mm_movelh_ps(xy, _mm_load_ss(floats + 2));
+}
+
+/// Store Vector3 without writing past its end.
+inline void StoreVector3(void* data, __m128 value)
+{
+    const auto floats = reinterpret_cast<float*>(data);
+    _mm_store_sd(reinterpret_cast<double*>(floats), _mm_castps_pd(value));
+    _mm_store_ss(floats + 2, _mm_movehl_ps(value, value));
+}
+
+/// Transform direction by matrix stored as columns.
+inline __m128 TransformDirection(__m128 column0, __m128 column1, __m128 column2, const void* data)
+{
+    const auto floats = reinterpret_cast<const float*>(data);
+    const __m128 x = _mm_mul_ps(column0, _mm_set1_ps(floats[0]));
+    const __m128 y = _mm_mul_ps(column1, _mm_set1_ps(floats[1]));
+    const __m128 z = _mm_mul_ps(column2, _mm_set1_ps(floats[2]));
+    return _mm_add_ps(_mm_add_ps(x, y), z);
+}
+
+template <bool SkinNormals, bool SkinTangents>
+void SkinVerticesSIMDImpl(const SoftwareSkinningBatch& batch, unsigned beginVertex, unsigned endVertex)
+{
+    const unsigned numBones = batch.numBones_;
+    const Matrix3x4* boneTransforms = batch.boneTransforms_.data();
+    const unsigned char* indicesData = batch.blendIndices_ + beginVertex * numBones;
+    const float* weightsData = batch.blendWeights_ + beginVertex * numBones;
+    unsigned char* vertexData = batch.vertexData_ + beginVertex * batch.vertexSize_;
+
+    for (unsigned vertexIndex = beginVertex; vertexIndex < endVertex; ++vertexIndex)
+    {
+        // Blend matrix rows of all bones
+        const Matrix3x4& firstBone = boneTransforms[indicesData[0]];
+        const __m128 firstWeight = _mm_set1_ps(weightsData[0]);
+        __m128 row0 = _mm_mul_ps(_mm_loadu_ps(&firstBone.m00_), firstWeight);
+        __m128 row1 = _mm_mul_ps(_mm_loadu_ps(&firstBone.m10_), firstWeight);
+        __m128 row2 = _mm_mul_ps(_mm_loadu_ps(&firstBone.m20_), firstWeight);
+        for (unsigned boneIndex = 1; boneIndex < numBones; ++boneIndex)
+        {
+            const Matrix3x4& bone = boneTransforms[indicesData[boneIndex]];
+            const __m128 weight = _mm_set1_ps(weightsData[boneIndex]);
+            row0 = _mm_add_ps(row0, _mm_mul_ps(_mm_loadu_ps(&bone.m00_), weight));
+            row1 = _mm_add_ps(row1, _mm_mul_ps(_mm_loadu_ps(&bone.m10_), weight));
+            row2 = _mm_add_ps(row2, _mm_mul_ps(_mm_loadu_ps(&bone.m20_), weight));
+        }
+
+        // Rows become columns, the last one is translation
+        __m128 row3 = _mm_setzero_ps();
+        _MM_TRANSPOSE4_PS(row0, row1, row2, row3);
+
+        StoreVector3(vertexData, _mm_add_ps(TransformDirection(row0, row1, row2, vertexData), row3));
+
+        if constexpr (SkinNormals)
+        {
+            unsigned char* normalData = vertexData + batch.normalOffset_;
+            StoreVector3(normalData, TransformDirection(row0, row1, row2, normalData));
+        }
+
+        if constexpr (SkinTangents)
+        {
+            unsigned char* tangentData = vertexData + batch.tangentOffset_;
+            StoreVector3(tangentData, TransformDirection(row0, row1, row2, tangentData));
+        }
+
+        // Advance
+        indicesData += numBones;
+        weightsData += numBones;
+        vertexData += batch.vertexSize_;
+    }
+}
+
+/// Add scaled morph delta to vertex element.
+inline void AccumulateMorphDeltaSIMD(unsigned char* dest, const unsigned char* src, __m128 weight)
+{
+    StoreVector3(dest, _mm_add_ps(LoadVector3(dest), _mm_mul_ps(LoadVector3(src), weight)));
+}
+#endif
+
+}
+
+void SkinVertices(const SoftwareSkinningBatch& batch, unsigned beginVertex, unsigned endVertex)
+{
+#ifdef URHO3D_SSE
+    const bool skinNormals = batch.normalOffset_ != M_MAX_UNSIGNED;
+    const bool skinTangents = batch.tangentOffset_ != M_MAX_UNSIGNED;
+    if (!skinNormals && !skinTangents)
+        SkinVerticesSIMDImpl<false, false>(batch, beginVertex, endVertex);
+    else if (skinNormals && !skinTangents)
+        SkinVerticesSIMDImpl<true, false>(batch, beginVertex, endVertex);
+    else if (skinNormals && skinTangents)
+        SkinVerticesSIMDImpl<true, true>(batch, beginVertex, endVertex);
+    else
+        SkinVerticesSIMDImpl<false, true>(batch, beginVertex, endVertex);
+#else
+    SkinVerticesScalar(batch, beginVertex, endVertex);
+#endif
+}
+
+void SkinVerticesScalar(const SoftwareSkinningBatch& batch, unsigned beginVertex, unsigned endVertex)
+{
+    const bool skinNormals = batch.normalOffset_ != M_MAX_UNSIGNED;
+    const bool skinTangents = batch.tangentOffset_ != M_MAX_UNSIGNED;
+    if (!skinNormals && !skinTangents)
+        SkinVerticesScalarImpl<false, false>(batch, beginVertex, endVertex);
+    else if (skinNormals && !skinTangents)
+        SkinVerticesScalarImpl<true, false>(batch, beginVertex, endVertex);
+    else if (skinNormals && skinTangents)
+        SkinVerticesScalarImpl<true, true>(batch, beginVertex, endVertex);
+    else
+        SkinVerticesScalarImpl<false, true>(batch, beginVertex, endVertex);
+}
+
+void MorphVertices(const SoftwareMorphBatch& batch, unsigned beginVertex, unsigned endVertex)
+{
+#ifdef URHO3D_SSE
+    const unsigned morphVertexSize = GetMorphVertexSize(batch.morphElementMask_);
+    const unsigned char* srcData = batch.morphData_ + beginVertex * morphVertexSize;
+    const __m128 weight = _mm_set1_ps(batch.weight_);
+
+    for (unsigned i = beginVertex; i < endVertex; ++i)
+    {
+        const unsigned vertexIndex = *reinterpret_cast<const unsigned*>(srcData);
+        const unsigned char* src = srcData + sizeof(unsigned);
+        unsigned char* dest = batch.vertexData_ + vertexIndex * batch.vertexSize_;
+
+        if (batch.morphElementMask_ & MASK_POSITION)
+        {
+            if (batch.elementMask_ & MASK_POSITION)
+                AccumulateMorphDeltaSIMD(dest, src, weight);
+            src += sizeof(Vector3);
+        }
+        if (batch.morphElementMask_ & MASK_NORMAL)
+        {
+            if (batch.elementMask_ & MASK_NORMAL)
+                AccumulateMorphDeltaSIMD(dest + batch.normalOffset_, src, weight);
+            src += sizeof(Vector3);
+        }
+        if ((batch.morphElementMask_ & MASK_TANGENT) && (batch.elementMask_ & MASK_TANGENT))
+            AccumulateMorphDeltaSIMD(dest + batch.tangentOffset_, src, weight);
+
+        srcData += morphVertexSize;
+    }
+#else
+    MorphVerticesScalar(batch, beginVertex, endVertex);
+#endif
+}
+
+void MorphVerticesScalar(const SoftwareMorphBatch& batch, unsigned beginVertex, unsigned endVertex)
+{
+    const unsigned morphVertexSize = GetMorphVertexSize(batch.morphElementMask_);
+    const unsigned char* srcData = batch.morphData_ + beginVertex * morphVertexSize;
+
+    for (unsigned i = beginVertex; i < endVertex; ++i)
+    {
+        const unsigned vertexIndex = *reinterpret_cast<const unsigned*>(srcData);
+        const unsigned char* src = srcData + sizeof(unsigned);
+        unsigned char* dest = batch.vertexData_ + vertexIndex * batch.vertexSize_;
+
+        if (batch.morphElementMask_ & MASK_POSITION)
+        {
+            if (batch.elementMask_ & MASK_POSITION)
+                AccumulateMorphDelta(dest, src, batch.weight_);
+            src += sizeof(Vector3);
+        }
+        if (batch.morphElementMask_ & MASK_NORMAL)
+        {
+            if (batch.elementMask_ & MASK_NORMAL)
+                AccumulateMorphDelta(dest + batch.normalOffset_, src, batch.weight_);
+            src += sizeof(Vector3);
+        }
+        if ((batch.morphElementMask_ & MASK_TANGENT) && (batch.elementMask_ & MASK_TANGENT))
+            AccumulateMorphDelta(dest + batch.tangentOffset_, src, batch.weight_);
+
+        srcData += morphVertexSize;
+    }
 }
 
 SoftwareModelAnimator::SoftwareModelAnimator(Context* context) : Object(context) {}
@@ -117,68 +393,42 @@ void SoftwareModelAnimator::ApplySkinning(ea::span<const Matrix3x4> worldTransfo
         if (!clonedBuffer || !animationData.hasSkeletalAnimation_)
             continue;
 
-        if (!animationData.skinNormals_ && !animationData.skinTangents_)
-            ApplyVertexBufferSkinning<false, false>(clonedBuffer, animationData, worldTransforms);
-        else if (animationData.skinNormals_ && !animationData.skinTangents_)
-            ApplyVertexBufferSkinning<true, false>(clonedBuffer, animationData, worldTransforms);
-        else if (animationData.skinNormals_ && animationData.skinTangents_)
-            ApplyVertexBufferSkinning<true, true>(clonedBuffer, animationData, worldTransforms);
-        else
-            ApplyVertexBufferSkinning<false, true>(clonedBuffer, animationData, worldTransforms); // this is really weird case
+        ApplyVertexBufferSkinning(clonedBuffer, animationData, worldTransforms);
     }
 }
 
-template <bool SkinNormals, bool SkinTangents>
 void SoftwareModelAnimator::ApplyVertexBufferSkinning(VertexBuffer* clonedBuffer, const VertexBufferAnimationData& animationData,
     ea::span<const Matrix3x4> worldTransforms) const
 {
-    const unsigned clonedVertexSize = clonedBuffer->GetVertexSize();
-    const unsigned normalOffset = clonedBuffer->GetElementOffset(TYPE_VECTOR3, SEM_NORMAL);
-    const unsigned tangentOffset = clonedBuffer->GetElementOffset(TYPE_VECTOR4, SEM_TANGENT);
-
-    unsigned char* clonedBufferData = clonedBuffer->GetShadowData();
-
-    unsigned char* positionsData = clonedBufferData;
-    unsigned char* normalsData = SkinNormals ? clonedBufferData + normalOffset : nullptr;
-    unsigned char* tangentsData = SkinTangents ? clonedBufferData + tangentOffset : nullptr;
-
-    const unsigned char* indicesData = animationData.blendIndices_.data();
-    const float* weightsData = animationData.blendWeights_.data();
+    SoftwareSkinningBatch batch;
+    batch.vertexData_ = clonedBuffer->GetShadowData();
+    batch.vertexSize_ = clonedBuffer->GetVertexSize();
+    if (animationData.skinNormals_)
+        batch.normalOffset_ = clonedBuffer->GetElementOffset(TYPE_VECTOR3, SEM_NORMAL);
+    if (animationData.skinTangents_)
+        batch.tangentOffset_ = clonedBuffer->GetElementOffset(TYPE_VECTOR4, SEM_TANGENT);
+    batch.numBones_ = numBones_;
+    batch.blendIndices_ = animationData.blendIndices_.data();
+    batch.blendWeights_ = animationData.blendWeights_.data();
+    batch.boneTransforms_ = worldTransforms;
 
     const unsigned numVertices = clonedBuffer->GetVertexCount();
-    Matrix3x4 matrix;
-    for (unsigned vertexIndex = 0; vertexIndex < numVertices; ++vertexIndex)
+    if (WorkQueue* workQueue = GetWorkQueueForVertices(numVertices))
     {
-        matrix = worldTransforms[indicesData[0]] * weightsData[0];
-        for (unsigned boneIndex = 1; boneIndex < numBones_; ++boneIndex)
-            matrix = matrix + worldTransforms[indicesData[boneIndex]] * weightsData[boneIndex];
-
-        Vector3& position = *reinterpret_cast<Vector3*>(positionsData);
-        position = matrix * position;
-
-        if constexpr (SkinNormals)
-        {
-            Vector3& normal = *reinterpret_cast<Vector3*>(normalsData);
-            normal = TransformNormal(matrix, normal);
-        }
-
-        if constexpr (SkinTangents)
-        {
-            Vector3& tangent = *reinterpret_cast<Vector3*>(tangentsData);
-            tangent = TransformNormal(matrix, tangent);
-        }
-
-        // Advance
-        indicesData += numBones_;
-        weightsData += numBones_;
-
-        positionsData += clonedVertexSize;
-        if constexpr (SkinNormals)
-            normalsData += clonedVertexSize;
-        if constexpr (SkinTangents)
-            tangentsData += clonedVertexSize;
+        ForEachParallel(workQueue, MinVerticesPerThread, numVertices,
+            [&](unsigned beginVertex, unsigned endVertex) { SkinVertices(batch, beginVertex, endVertex); });
     }
+    else
+        SkinVertices(batch, 0, numVertices);
+}
+
+WorkQueue* SoftwareModelAnimator::GetWorkQueueForVertices(unsigned numVertices) const
+{
+    if (numVertices < 2 * MinVerticesPerThread || !Thread::IsMainThread())
+        return nullptr;
 
+    auto workQueue = GetSubsystem<WorkQueue>();
+    return workQueue && workQueue->GetNumThreads() > 0 ? workQueue : nullptr;
 }
 
 void SoftwareModelAnimator::Commit()
@@ -221,30 +471,35 @@ void SoftwareModelAnimator::CloneModelGeometries()
 
         // Validate formats
         VertexBuffer* originalVertexBuffer = originalVertexBuffers[i];
-        const VertexMaskFlags clonedBufferMask = morphElementMask & originalVertexBuffer->GetElementMask();
+        const VertexMaskFlags clonedBufferMask = morphElementMask & GetAnimatedElementMask(originalVertexBuffer);
 
         const bool needPosition = clonedBufferMask & MASK_POSITION;
         const bool needNormal = clonedBufferMask & MASK_NORMAL;
         const bool needTangent = clonedBufferMask & MASK_TANGENT;
 
-        const bool hasPositionVector3 = originalVertexBuffer->HasElement(TYPE_VECTOR3, SEM_POSITION);
-        const bool hasPositionVector4 = originalVertexBuffer->HasElement(TYPE_VECTOR4, SEM_POSITION);
-        const bool hasNormalVector3 = originalVertexBuffer->HasElement(TYPE_VECTOR3, SEM_NORMAL);
-        const bool hasTangentVector4 = originalVertexBuffer->HasElement(TYPE_VECTOR4, SEM_TANGENT);
-
-        if (needPosition && !(hasPositionVector3 || hasPositionVector4))
+        const bool hasPosition = originalVertexBuffer->HasElement(TYPE_VECTOR3, SEM_POSITION)
+            || originalVertexBuffer->HasElement(TYPE_VECTOR4, SEM_POSITION)
+            || originalVertexBuffer->HasElement(TYPE_HALF4, SEM_POSITION);
+        const bool hasNormal = originalVertexBuffer->HasElement(TYPE_VECTOR3, SEM_NORMAL)
+            || originalVertexBuffer->HasElement(TYPE_BYTE4_NORM, SEM_NORMAL)
+            || originalVertexBuffer->HasElement(TYPE_HALF4, SEM_NORMAL);
+        const bool hasTangent = originalVertexBuffer->HasElement(TYPE_VECTOR4, SEM_TANGENT)
+            || originalVertexBuffer->HasElement(TYPE_BYTE4_NORM, SEM_TANGENT)
+            || originalVertexBuffer->HasElement(TYPE_HALF4, SEM_TANGENT);
+
+        if (needPosition && !hasPosition)
         {
-            URHO3D_LOGERROR("Position must be Vector3 or Vector4 for software skinning and morphing");
+            URHO3D_LOGERROR("Position must be Vector3, Vector4 or Half4 for software skinning and morphing");
             continue;
         }
-        if (needNormal && !hasNormalVector3)
+        if (needNormal && !hasNormal)
         {
-            URHO3D_LOGERROR("Normal must be Vector3 for software skinning and morphing");
+            URHO3D_LOGERROR("Normal must be Vector3, Byte4Norm or Half4 for software skinning and morphing");
             continue;
         }
-        if (needTangent && !hasTangentVector4)
+        if (needTangent && !hasTangent)
         {
-            URHO3D_LOGERROR("Tangent must be Vector4 for software skinning and morphing");
+            URHO3D_LOGERROR("Tangent must be Vector4, Byte4Norm or Half4 for software skinning and morphing");
             continue;
         }
 
@@ -410,10 +665,11 @@ void SoftwareModelAnimator::InitializeAnimationData()
 void SoftwareModelAnimator::CopyMorphVertices(void* destVertexData, const void* srcVertexData, unsigned vertexCount,
     VertexBuffer* destBuffer, VertexBuffer* srcBuffer) const
 {
-    unsigned mask = destBuffer->GetElementMask() & srcBuffer->GetElementMask();
-    unsigned normalOffset = srcBuffer->GetElementOffset(SEM_NORMAL);
-    unsigned tangentOffset = srcBuffer->GetElementOffset(SEM_TANGENT);
-    unsigned vertexSize = srcBuffer->GetVertexSize();
+    const unsigned mask = destBuffer->GetElementMask() & GetAnimatedElementMask(srcBuffer);
+    const VertexElement* positionElement = srcBuffer->GetElement(SEM_POSITION);
+    const VertexElement* normalElement = srcBuffer->GetElement(SEM_NORMAL);
+    const VertexElement* tangentElement = srcBuffer->GetElement(SEM_TANGENT);
+    const unsigned vertexSize = srcBuffer->GetVertexSize();
     auto dest = reinterpret_cast<float*>(destVertexData);
     auto src = reinterpret_cast<const unsigned char*>(srcVertexData);
 
@@ -421,17 +677,17 @@ void SoftwareModelAnimator::CopyMorphVertices(void* destVertexData, const void*
     {
         if (mask & MASK_POSITION)
         {
-            memcpy(dest, src, sizeof(float) * 3);
+            CopyVertexElement<3>(dest, src, *positionElement);
             dest += 3;
         }
         if (mask & MASK_NORMAL)
         {
-            memcpy(dest, src + normalOffset, sizeof(float) * 3);
+            CopyVertexElement<3>(dest, src, *normalElement);
             dest += 3;
         }
         if (mask & MASK_TANGENT)
         {
-            memcpy(dest, src + tangentOffset, sizeof(float) * 4);
+            CopyVertexElement<4>(dest, src, *tangentElement);
             dest += 4;
         }
 
@@ -441,48 +697,25 @@ void SoftwareModelAnimator::CopyMorphVertices(void* destVertexData, const void*
 
 void SoftwareModelAnimator::ApplyMorph(VertexBuffer* buffer, const VertexBufferMorph& morph, float weight)
 {
-    const VertexMaskFlags elementMask = morph.elementMask_ & buffer->GetElementMask();
-    unsigned vertexCount = morph.vertexCount_;
-    unsigned normalOffset = buffer->GetElementOffset(SEM_NORMAL);
-    unsigned tangentOffset = buffer->GetElementOffset(SEM_TANGENT);
-    unsigned vertexSize = buffer->GetVertexSize();
-
-    unsigned char* srcData = morph.morphData_.get();
-    unsigned char* destData = buffer->GetShadowData();
-
-    while (vertexCount--)
+    SoftwareMorphBatch batch;
+    batch.vertexData_ = buffer->GetShadowData();
+    batch.vertexSize_ = buffer->GetVertexSize();
+    batch.normalOffset_ = buffer->GetElementOffset(SEM_NORMAL);
+    batch.tangentOffset_ = buffer->GetElementOffset(SEM_TANGENT);
+    batch.elementMask_ = morph.elementMask_ & buffer->GetElementMask();
+    batch.morphElementMask_ = morph.elementMask_;
+    batch.morphData_ = morph.morphData_.get();
+    batch.weight_ = weight;
+
+    // Morphed vertices are unique, so they can be processed in any order
+    const unsigned numVertices = morph.vertexCount_;
+    if (WorkQueue* workQueue = GetWorkQueueForVertices(numVertices))
     {
-        const unsigned vertexIndex = *reinterpret_cast<const unsigned*>(srcData);
-        srcData += sizeof(unsigned);
-
-        if (elementMask & MASK_POSITION)
-        {
-            auto dest = reinterpret_cast<float*>(destData + vertexIndex * vertexSize);
-            auto src = reinterpret_cast<const float*>(srcData);
-            dest[0] += src[0] * weight;
-            dest[1] += src[1] * weight;
-            dest[2] += src[2] * weight;
-            srcData += 3 * sizeof(float);
-        }
-        if (elementMask & MASK_NORMAL)
-        {
-            auto dest = reinterpret_cast<float*>(destData + vertexIndex * vertexSize + normalOffset);
-            auto src = reinterpret_cast<const float*>(srcData);
-            dest[0] += src[0] * weight;
-            dest[1] += src[1] * weight;
-            dest[2] += src[2] * weight;
-            srcData += 3 * sizeof(float);
-        }
-        if (elementMask & MASK_TANGENT)
-        {
-            auto dest = reinterpret_cast<float*>(destData + vertexIndex * vertexSize + tangentOffset);
-            auto src = reinterpret_cast<const float*>(srcData);
-            dest[0] += src[0] * weight;
-            dest[1] += src[1] * weight;
-            dest[2] += src[2] * weight;
-            srcData += 3 * sizeof(float);
-        }
+        ForEachParallel(workQueue, MinVerticesPerThread, numVertices,
+            [&](unsigned beginVertex, unsigned endVertex) { MorphVertices(batch, beginVertex, endVertex); });
     }
+    else
+        MorphVertices(batch, 0, numVertices);
 }
 
 }
@@ -30,6 +30,8 @@
 namespace Urho3D
 {
 
+class WorkQueue;
+
 /// Container for vertex buffer animation data.
 struct VertexBufferAnimationData
 {
@@ -45,6 +47,56 @@ struct VertexBufferAnimationData
     ea::vector<unsigned char> blendIndices_;
 };
 
+/// Vertex range processed by software skinning kernel.
+struct SoftwareSkinningBatch
+{
+    /// Vertex data. Position is expected to be Vector3 at offset 0.
+    unsigned char* vertexData_{};
+    /// Vertex size in bytes.
+    unsigned vertexSize_{};
+    /// Offset of Vector3 normal, M_MAX_UNSIGNED if normals are not skinned.
+    unsigned normalOffset_{M_MAX_UNSIGNED};
+    /// Offset of Vector4 tangent, M_MAX_UNSIGNED if tangents are not skinned.
+    unsigned tangentOffset_{M_MAX_UNSIGNED};
+    /// Number of bones per vertex, up to 4.
+    unsigned numBones_{};
+    /// Blend indices, numBones_ per vertex.
+    const unsigned char* blendIndices_{};
+    /// Normalized blend weights, numBones_ per vertex.
+    const float* blendWeights_{};
+    /// Bone transforms.
+    ea::span<const Matrix3x4> boneTransforms_;
+};
+
+/// Vertex range processed by software morphing kernel.
+struct SoftwareMorphBatch
+{
+    /// Vertex data. Position is expected to be Vector3 at offset 0, normal and tangent are expected to be floats.
+    unsigned char* vertexData_{};
+    /// Vertex size in bytes.
+    unsigned vertexSize_{};
+    /// Offset of normal.
+    unsigned normalOffset_{};
+    /// Offset of tangent.
+    unsigned tangentOffset_{};
+    /// Elements to be morphed.
+    VertexMaskFlags elementMask_;
+    /// Elements stored in morph data.
+    VertexMaskFlags morphElementMask_;
+    /// Morph data stored as <index, data> pairs.
+    const unsigned char* morphData_{};
+    /// Morph weight.
+    float weight_{};
+};
+
+/// Software animation kernels. Scalar versions are reference implementations.
+/// @{
+URHO3D_API void SkinVertices(const SoftwareSkinningBatch& batch, unsigned beginVertex, unsigned endVertex);
+URHO3D_API void SkinVerticesScalar(const SoftwareSkinningBatch& batch, unsigned beginVertex, unsigned endVertex);
+URHO3D_API void MorphVertices(const SoftwareMorphBatch& batch, unsigned beginVertex, unsigned endVertex);
+URHO3D_API void MorphVerticesScalar(const SoftwareMorphBatch& batch, unsigned beginVertex, unsigned endVertex);
+/// @}
+
 /// Class for software model animation (morphing and skinning).
 class URHO3D_API SoftwareModelAnimator : public Object
 {
@@ -53,6 +105,8 @@ class URHO3D_API SoftwareModelAnimator : public Object
 public:
     /// Max number of bones.
     static const unsigned MaxBones = 4;
+    /// Min number of vertices processed by one thread. Smaller buffers are processed in calling thread.
+    static const unsigned MinVerticesPerThread = 4096;
 
     /// Construct.
     explicit SoftwareModelAnimator(Context* context);
@@ -66,9 +120,9 @@ public:
 
     /// Reset morph and/or skeletal animation. Safe to call from worker thread.
     void ResetAnimation();
-    /// Apply morphs. Safe to call from worker thread.
+    /// Apply morphs. Safe to call from worker thread. Large morphs are processed in multiple threads if called from main thread.
     void ApplyMorphs(ea::span<const ModelMorph> morphs);
-    /// Apply skinning.
+    /// Apply skinning. Large buffers are processed in multiple threads if called from main thread.
     void ApplySkinning(ea::span<const Matrix3x4> worldTransforms);
     /// Commit data to GPU.
     void Commit();
@@ -92,9 +146,10 @@ private:
     /// Apply a vertex buffer morph.
     void ApplyMorph(VertexBuffer* buffer, const VertexBufferMorph& morph, float weight);
     /// Apply skinning for given vertex buffer.
-    template <bool SkinNormals, bool SkinTangents>
     void ApplyVertexBufferSkinning(VertexBuffer* clonedBuffer, const VertexBufferAnimationData& animationData,
         ea::span<const Matrix3x4> worldTransforms) const;
+    /// Return work queue if vertices should be processed in multiple threads.
+    WorkQueue* GetWorkQueueForVertices(unsigned numVertices) const;
 
     /// Original model.
     SharedPtr<Model> originalModel_;
@@ -103,6 +103,32 @@ Ubyte4 Vector4WeightsToUbyte4Norm(const Vector4& value)
     return result;
 }
 
+/// Helper types for packed vertex elements.
+/// @{
+using Byte4 = ea::array<signed char, 4>;
+using Ushort2 = ea::array<unsigned short, 2>;
+using Half2 = ea::array<unsigned short, 2>;
+using Half4 = ea::array<unsigned short, 4>;
+/// @}
+
+/// Convert float in range [-1, 1] to signed normalized byte (with clamping).
+signed char FloatToSNormByte(float value)
+{
+    return static_cast<signed char>(Clamp(RoundToInt(value * 127.0f), -127, 127));
+}
+
+/// Convert float in range [0, 1] to unsigned normalized short (with clamping).
+unsigned short FloatToUNormShort(float value)
+{
+    return static_cast<unsigned short>(Clamp(RoundToInt(value * 65535.0f), 0, 65535));
+}
+
+/// Convert signed normalized byte to float. Both -128 and -127 are mapped to -1.
+float SNormByteToFloat(signed char value)
+{
+    return ea::max(static_cast<float>(value) / 127.0f, -1.0f);
+}
+
 /// No-op converter from float vector to float vector.
 Vector4 Vector4ToVector4(const Vector4& value) { return { value.x_, value.y_, value.z_, value.w_ }; }
 
@@ -123,6 +149,31 @@ Vector3 Vector4ToVector3(const Vector4& value) { return { value.x_, value.y_, va
 Ubyte4 Vector4ToUbyte4Norm(const Vector4& value) { return Vector4ToUbyte4(value * 255.0f); }
 /// @}
 
+/// Converters for packed vertex elements.
+/// @{
+Vector4 Byte4NormToVector4(const Byte4& value)
+{
+    return { SNormByteToFloat(value[0]), SNormByteToFloat(value[1]), SNormByteToFloat(value[2]), SNormByteToFloat(value[3]) };
+}
+Vector4 Ushort2NormToVector4(const Ushort2& value) { return { value[0] / 65535.0f, value[1] / 65535.0f, 0.0f, 0.0f }; }
+Vector4 Half2ToVector4(const Half2& value) { return { HalfToFloat(value[0]), HalfToFloat(value[1]), 0.0f, 0.0f }; }
+Vector4 Half4ToVector4(const Half4& value)
+{
+    return { HalfToFloat(value[0]), HalfToFloat(value[1]), HalfToFloat(value[2]), HalfToFloat(value[3]) };
+}
+
+Byte4 Vector4ToByte4Norm(const Vector4& value)
+{
+    return { FloatToSNormByte(value.x_), FloatToSNormByte(value.y_), FloatToSNormByte(value.z_), FloatToSNormByte(value.w_) };
+}
+Ushort2 Vector4ToUshort2Norm(const Vector4& value) { return { FloatToUNormShort(value.x_), FloatToUNormShort(value.y_) }; }
+Half2 Vector4ToHalf2(const Vector4& value) { return { FloatToHalf(value.x_), FloatToHalf(value.y_) }; }
+Half4 Vector4ToHalf4(const Vector4& value)
+{
+    return { FloatToHalf(value.x_), FloatToHalf(value.y_), FloatToHalf(value.z_), FloatToHalf(value.w_) };
+}
+/// @}
+
 }
 
 extern const char* GEOMETRY_CATEGORY;
@@ -376,6 +427,18 @@ void VertexBuffer::UnpackVertexData(const void* source, unsigned sourceStride,
     case TYPE_UBYTE4_NORM:
         ConvertArray<Vector4, Ubyte4>(destBytes, sourceBytes, destStride, sourceStride, count, Ubyte4NormToVector4);
         break;
+    case TYPE_BYTE4_NORM:
+        ConvertArray<Vector4, Byte4>(destBytes, sourceBytes, destStride, sourceStride, count, Byte4NormToVector4);
+        break;
+    case TYPE_USHORT2_NORM:
+        ConvertArray<Vector4, Ushort2>(destBytes, sourceBytes, destStride, sourceStride, count, Ushort2NormToVector4);
+        break;
+    case TYPE_HALF2:
+        ConvertArray<Vector4, Half2>(destBytes, sourceBytes, destStride, sourceStride, count, Half2ToVector4);
+        break;
+    case TYPE_HALF4:
+        ConvertArray<Vector4, Half4>(destBytes, sourceBytes, destStride, sourceStride, count, Half4ToVector4);
+        break;
     default:
         assert(0);
         break;
@@ -414,6 +477,18 @@ void VertexBuffer::PackVertexData(const Vector4 source[], unsigned sourceStride,
         else
             ConvertArray<Ubyte4, Vector4>(destBytes, sourceBytes, destStride, sourceStride, count, Vector4ToUbyte4Norm);
         break;
+    case TYPE_BYTE4_NORM:
+        ConvertArray<Byte4, Vector4>(destBytes, sourceBytes, destStride, sourceStride, count, Vector4ToByte4Norm);
+        break;
+    case TYPE_USHORT2_NORM:
+        ConvertArray<Ushort2, Vector4>(destBytes, sourceBytes, destStride, sourceStride, count, Vector4ToUshort2Norm);
+        break;
+    case TYPE_HALF2:
+        ConvertArray<Half2, Vector4>(destBytes, sourceBytes, destStride, sourceStride, count, Vector4ToHalf2);
+        break;
+    case TYPE_HALF4:
+        ConvertArray<Half4, Vector4>(destBytes, sourceBytes, destStride, sourceStride, count, Vector4ToHalf4);
+        break;
     default:
         assert(0);
         break;
@@ -454,6 +529,59 @@ void VertexBuffer::ShuffleUnpackedVertexData(unsigned vertexCount,
     }
 }
 
+bool VertexBuffer::ReplaceUnsupportedElements(const Graphics* graphics, ea::vector<VertexElement>& elements)
+{
+    if (!graphics)
+        return false;
+
+    bool replaced = false;
+    for (VertexElement& element : elements)
+    {
+        if (graphics->GetVertexElementTypeSupport(element.type_))
+            continue;
+
+        switch (element.type_)
+        {
+        case TYPE_HALF2:
+            element.type_ = TYPE_VECTOR2;
+            break;
+        case TYPE_BYTE4_NORM:
+        case TYPE_HALF4:
+            // Tangents and other 4D data need all components
+            element.type_ = element.semantic_ == SEM_POSITION || element.semantic_ == SEM_NORMAL
+                || element.semantic_ == SEM_BINORMAL ? TYPE_VECTOR3 : TYPE_VECTOR4;
+            break;
+        default:
+            element.type_ = TYPE_VECTOR4;
+            break;
+        }
+        replaced = true;
+    }
+
+    if (replaced)
+        UpdateOffsets(elements);
+    return replaced;
+}
+
+void VertexBuffer::ConvertVertexData(unsigned vertexCount, const void* source, const ea::vector<VertexElement>& sourceElements,
+    void* dest, const ea::vector<VertexElement>& destElements)
+{
+    const unsigned sourceStride = GetVertexSize(sourceElements);
+    const unsigned destStride = GetVertexSize(destElements);
+
+    ea::vector<Vector4> buffer(vertexCount);
+    for (const VertexElement& sourceElement : sourceElements)
+    {
+        const auto iter = ea::find_if(destElements.begin(), destElements.end(), [&](const VertexElement& destElement)
+            { return destElement.semantic_ == sourceElement.semantic_ && destElement.index_ == sourceElement.index_; });
+        if (iter == destElements.end())
+            continue;
+
+        UnpackVertexData(source, sourceStride, sourceElement, 0, vertexCount, buffer.data(), sizeof(Vector4));
+        PackVertexData(buffer.data(), sizeof(Vector4), dest, destStride, *iter, 0, vertexCount);
+    }
+}
+
 unsigned VertexBuffer::RecalculatePipelineStateHash() const
 {
     unsigned hash = 0;
@@ -163,6 +163,12 @@ public:
     /// Shuffle unpacked vertex data according to another vertex format. Element types are ignored. Source array should have `vertexCount * sourceElements.size()` elements. Destination array should have `vertexCount * destElements.size()` elements.
     static void ShuffleUnpackedVertexData(unsigned vertexCount, const Vector4 source[], const ea::vector<VertexElement>& sourceElements, Vector4 dest[], const ea::vector<VertexElement>& destElements, bool setMissingElementsToZero = true);
 
+    /// Replace element types not supported by Graphics with float types and update offsets. Return whether any element was replaced.
+    static bool ReplaceUnsupportedElements(const Graphics* graphics, ea::vector<VertexElement>& elements);
+
+    /// Convert vertex data to another vertex format with the same elements of possibly different types.
+    static void ConvertVertexData(unsigned vertexCount, const void* source, const ea::vector<VertexElement>& sourceElements, void* dest, const ea::vector<VertexElement>& destElements);
+
 private:
     /// Update offsets of vertex elements.
     void UpdateOffsets();
@@ -224,7 +230,7 @@ public:
     ea::pair<unsigned, unsigned char*> AddVertices(unsigned count)
     {
         const unsigned startVertex = numVertices_;
-        if (startVertex + count > maxNumVertices_)
+        while (startVertex + count > maxNumVertices_)
             GrowBuffer();
 
         numVertices_ += count;
@@ -56,6 +56,15 @@ unsigned DecompressData(void* dest, const void* src, unsigned destSize)
         return (unsigned)LZ4_decompress_fast((const char*)src, (char*)dest, destSize);
 }
 
+unsigned DecompressData(void* dest, const void* src, unsigned destSize, unsigned srcSize)
+{
+    if (!dest || !src || !destSize || !srcSize)
+        return 0;
+
+    const int result = LZ4_decompress_safe((const char*)src, (char*)dest, srcSize, destSize);
+    return result > 0 ? (unsigned)result : 0;
+}
+
 bool CompressStream(Serializer& dest, Deserializer& src)
 {
     unsigned srcSize = src.GetSize() - src.GetPosition();
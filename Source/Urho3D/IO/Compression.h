@@ -37,6 +37,8 @@ URHO3D_API unsigned EstimateCompressBound(unsigned srcSize);
 URHO3D_API unsigned CompressData(void* dest, const void* src, unsigned srcSize);
 /// Uncompress data using the LZ4 algorithm. The uncompressed data size must be known. Return the number of compressed data bytes consumed.
 URHO3D_API unsigned DecompressData(void* dest, const void* src, unsigned destSize);
+/// Uncompress untrusted data using the LZ4 algorithm without reading more than srcSize or writing more than destSize bytes. Return the number of uncompressed bytes or 0 if data is corrupt.
+URHO3D_API unsigned DecompressData(void* dest, const void* src, unsigned destSize, unsigned srcSize);
 /// Compress a source stream (from current position to the end) to the destination stream using the LZ4 algorithm. Return true on success.
 URHO3D_API bool CompressStream(Serializer& dest, Deserializer& src);
 /// Decompress a compressed source stream produced using CompressStream() to the destination stream. Return true on success.
@@ -0,0 +1,419 @@
+//
+// Copyright (c) 2021-2022 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "../Precompiled.h"
+
+#include "../Container/ByteVector.h"
+#include "../Core/StringUtils.h"
+#include "../IO/File.h"
+#include "../IO/Log.h"
+#include "../IO/PackageDelta.h"
+#include "../IO/PackageFile.h"
+
+#include <EASTL/sort.h>
+#include <EASTL/unordered_map.h>
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+namespace
+{
+
+/// File ID of package delta.
+const char* PACKAGE_DELTA_ID = "UDLT";
+
+/// Size of buffer used to copy data when applying delta.
+const unsigned COPY_BUFFER_SIZE = 65536;
+
+/// Delta operations.
+enum DeltaOperation : unsigned char
+{
+    /// End of delta.
+    OP_END = 0,
+    /// Copy range of old file: offset and size.
+    OP_COPY = 1,
+    /// Insert data stored in delta: size and data.
+    OP_LITERAL = 2
+};
+
+/// Range of package file that belongs to one entry. Unnamed region is the package header.
+struct PackageRegion
+{
+    /// Entry name.
+    ea::string name_;
+    /// Offset in file.
+    unsigned offset_{};
+    /// Size in file, including compression headers and whatever follows the entry data up to the next entry.
+    unsigned size_{};
+};
+
+/// Split package file into regions of entries.
+ea::vector<PackageRegion> GetPackageRegions(const PackageFile* package, unsigned fileSize)
+{
+    ea::vector<PackageRegion> regions;
+    regions.push_back(PackageRegion{});
+    for (const auto& [name, entry] : package->GetEntries())
+        regions.push_back(PackageRegion{name, ea::min(entry.offset_, fileSize)});
+
+    // Entries are sorted by name too so empty entries at the same offset are always in the same order
+    ea::sort(regions.begin(), regions.end(), [](const PackageRegion& lhs, const PackageRegion& rhs)
+    {
+        return lhs.offset_ != rhs.offset_ ? lhs.offset_ < rhs.offset_ : lhs.name_ < rhs.name_;
+    });
+
+    for (unsigned i = 0; i < regions.size(); ++i)
+    {
+        const unsigned nextOffset = i + 1 < regions.size() ? regions[i + 1].offset_ : fileSize;
+        regions[i].size_ = nextOffset - regions[i].offset_;
+    }
+    return regions;
+}
+
+/// Weak checksum of a block that can be updated when the block moves by one byte.
+class RollingChecksum
+{
+public:
+    /// Calculate checksum of the block.
+    void Reset(const unsigned char* data, unsigned size)
+    {
+        a_ = 0;
+        b_ = 0;
+        for (unsigned i = 0; i < size; ++i)
+        {
+            a_ += data[i];
+            b_ += (size - i) * data[i];
+        }
+    }
+
+    /// Move block of given size by one byte.
+    void Roll(unsigned char removed, unsigned char added, unsigned size)
+    {
+        a_ += added - removed;
+        b_ += a_ - size * removed;
+    }
+
+    /// Return checksum value.
+    unsigned Get() const { return (a_ & 0xffff) | (b_ << 16); }
+
+private:
+    unsigned a_{};
+    unsigned b_{};
+};
+
+/// Writes delta operations, adjacent copies are merged.
+class DeltaWriter
+{
+public:
+    explicit DeltaWriter(Serializer& dest) : dest_(dest) {}
+
+    /// Copy range of old file.
+    void WriteCopy(unsigned offset, unsigned size)
+    {
+        if (!size)
+            return;
+
+        if (copySize_ && copyOffset_ + copySize_ == offset)
+        {
+            copySize_ += size;
+            return;
+        }
+
+        FlushCopy();
+        copyOffset_ = offset;
+        copySize_ = size;
+    }
+
+    /// Insert data.
+    void WriteLiteral(const unsigned char* data, unsigned size)
+    {
+        if (!size)
+            return;
+
+        FlushCopy();
+        success_ &= dest_.WriteUByte(OP_LITERAL);
+        success_ &= dest_.WriteUInt(size);
+        success_ &= dest_.Write(data, size) == size;
+    }
+
+    /// Finish delta. Return whether everything was written.
+    bool Finish()
+    {
+        FlushCopy();
+        success_ &= dest_.WriteUByte(OP_END);
+        return success_;
+    }
+
+private:
+    void FlushCopy()
+    {
+        if (!copySize_)
+            return;
+
+        success_ &= dest_.WriteUByte(OP_COPY);
+        success_ &= dest_.WriteUInt(copyOffset_);
+        success_ &= dest_.WriteUInt(copySize_);
+        copySize_ = 0;
+    }
+
+    Serializer& dest_;
+    unsigned copyOffset_{};
+    unsigned copySize_{};
+    bool success_{true};
+};
+
+/// Write operations that rebuild new region from old region.
+void WriteRegionDelta(DeltaWriter& writer, const ByteVector& oldData, unsigned oldOffset, const ByteVector& newData,
+    unsigned blockSize)
+{
+    const unsigned oldSize = oldData.size();
+    const unsigned newSize = newData.size();
+
+    // Most entries are usually unchanged
+    if (oldSize == newSize && ea::equal(oldData.begin(), oldData.end(), newData.begin()))
+    {
+        writer.WriteCopy(oldOffset, oldSize);
+        return;
+    }
+
+    // Index aligned blocks of old data
+    ea::unordered_map<unsigned, unsigned> oldBlocks;
+    RollingChecksum checksum;
+    for (unsigned offset = 0; offset + blockSize <= oldSize; offset += blockSize)
+    {
+        checksum.Reset(&oldData[offset], blockSize);
+        oldBlocks.emplace(checksum.Get(), offset);
+    }
+
+    // Look for old blocks at every offset of new data
+    unsigned literalBegin = 0;
+    unsigned position = 0;
+    bool isChecksumValid = false;
+    while (!oldBlocks.empty() && position + blockSize <= newSize)
+    {
+        if (!isChecksumValid)
+        {
+            checksum.Reset(&newData[position], blockSize);
+            isChecksumValid = true;
+        }
+
+        const auto iter = oldBlocks.find(checksum.Get());
+        if (iter != oldBlocks.end() && !memcmp(&oldData[iter->second], &newData[position], blockSize))
+        {
+            // Extend the match as far as possible
+            const unsigned matchOffset = iter->second;
+            unsigned matchSize = blockSize;
+            while (position + matchSize < newSize && matchOffset + matchSize < oldSize
+                && oldData[matchOffset + matchSize] == newData[position + matchSize])
+                ++matchSize;
+
+            writer.WriteLiteral(&newData[literalBegin], position - literalBegin);
+            writer.WriteCopy(oldOffset + matchOffset, matchSize);
+
+            position += matchSize;
+            literalBegin = position;
+            isChecksumValid = false;
+        }
+        else
+        {
+            if (position + blockSize < newSize)
+                checksum.Roll(newData[position], newData[position + blockSize], blockSize);
+            ++position;
+        }
+    }
+
+    writer.WriteLiteral(&newData[literalBegin], newSize - literalBegin);
+}
+
+/// Read region of file.
+bool ReadRegion(File& file, const PackageRegion& region, ByteVector& data)
+{
+    data.resize(region.size_);
+    return file.Seek(region.offset_) == region.offset_ && file.Read(data.data(), region.size_) == region.size_;
+}
+
+}
+
+bool CreatePackageDelta(PackageFile* oldPackage, PackageFile* newPackage, Serializer& dest, unsigned blockSize)
+{
+    if (!oldPackage || !newPackage)
+        return false;
+
+    Context* context = newPackage->GetContext();
+    File oldFile(context, oldPackage->GetName());
+    File newFile(context, newPackage->GetName());
+    if (!oldFile.IsOpen() || !newFile.IsOpen())
+    {
+        URHO3D_LOGERROR("Failed to open package files to create delta");
+        return false;
+    }
+
+    PackageDeltaHeader header;
+    header.oldSize_ = oldFile.GetSize();
+    header.oldChecksum_ = oldPackage->GetChecksum();
+    header.oldFileChecksum_ = oldFile.GetChecksum();
+    header.newSize_ = newFile.GetSize();
+    header.newChecksum_ = newPackage->GetChecksum();
+    header.newFileChecksum_ = newFile.GetChecksum();
+
+    dest.WriteFileID(PACKAGE_DELTA_ID);
+    dest.WriteUInt(header.oldSize_);
+    dest.WriteUInt(header.oldChecksum_);
+    dest.WriteUInt(header.oldFileChecksum_);
+    dest.WriteUInt(header.newSize_);
+    dest.WriteUInt(header.newChecksum_);
+    dest.WriteUInt(header.newFileChecksum_);
+
+    ea::unordered_map<ea::string, PackageRegion> oldRegions;
+    for (const PackageRegion& region : GetPackageRegions(oldPackage, header.oldSize_))
+        oldRegions.emplace(region.name_, region);
+
+    blockSize = ea::max(blockSize, 1u);
+    DeltaWriter writer(dest);
+    ByteVector oldData;
+    ByteVector newData;
+    for (const PackageRegion& region : GetPackageRegions(newPackage, header.newSize_))
+    {
+        if (!ReadRegion(newFile, region, newData))
+        {
+            URHO3D_LOGERROR("Failed to read package file " + newPackage->GetName());
+            return false;
+        }
+
+        const auto iter = oldRegions.find(region.name_);
+        if (iter == oldRegions.end())
+        {
+            writer.WriteLiteral(newData.data(), newData.size());
+            continue;
+        }
+
+        const PackageRegion& oldRegion = iter->second;
+        if (!ReadRegion(oldFile, oldRegion, oldData))
+        {
+            URHO3D_LOGERROR("Failed to read package file " + oldPackage->GetName());
+            return false;
+        }
+
+        WriteRegionDelta(writer, oldData, oldRegion.offset_, newData, blockSize);
+    }
+
+    return writer.Finish();
+}
+
+bool ReadPackageDeltaHeader(Deserializer& source, PackageDeltaHeader& header)
+{
+    if (source.ReadFileID() != PACKAGE_DELTA_ID)
+        return false;
+
+    header.oldSize_ = source.ReadUInt();
+    header.oldChecksum_ = source.ReadUInt();
+    header.oldFileChecksum_ = source.ReadUInt();
+    header.newSize_ = source.ReadUInt();
+    header.newChecksum_ = source.ReadUInt();
+    header.newFileChecksum_ = source.ReadUInt();
+    return !source.IsEof();
+}
+
+bool ApplyPackageDelta(File& oldFile, Deserializer& delta, Serializer& dest)
+{
+    PackageDeltaHeader header;
+    if (!ReadPackageDeltaHeader(delta, header))
+    {
+        URHO3D_LOGERROR("Invalid package delta");
+        return false;
+    }
+
+    if (oldFile.GetSize() != header.oldSize_ || oldFile.GetChecksum() != header.oldFileChecksum_)
+    {
+        URHO3D_LOGERROR("Package delta does not match package file " + oldFile.GetName());
+        return false;
+    }
+
+    ByteVector buffer(COPY_BUFFER_SIZE);
+    unsigned size = 0;
+    unsigned checksum = 0;
+    const auto copyData = [&](Deserializer& source, unsigned count)
+    {
+        while (count > 0)
+        {
+            const unsigned chunkSize = ea::min(count, COPY_BUFFER_SIZE);
+            if (source.Read(buffer.data(), chunkSize) != chunkSize || dest.Write(buffer.data(), chunkSize) != chunkSize)
+                return false;
+
+            for (unsigned i = 0; i < chunkSize; ++i)
+                checksum = SDBMHash(checksum, buffer[i]);
+            size += chunkSize;
+            count -= chunkSize;
+        }
+        return true;
+    };
+
+    while (true)
+    {
+        if (delta.IsEof())
+        {
+            URHO3D_LOGERROR("Package delta is truncated");
+            return false;
+        }
+
+        const unsigned char operation = delta.ReadUByte();
+        if (operation == OP_END)
+            break;
+
+        bool success = false;
+        if (operation == OP_COPY)
+        {
+            const unsigned offset = delta.ReadUInt();
+            const unsigned count = delta.ReadUInt();
+            success = offset <= header.oldSize_ && count <= header.oldSize_ - offset && count <= header.newSize_ - size
+                && oldFile.Seek(offset) == offset && copyData(oldFile, count);
+        }
+        else if (operation == OP_LITERAL)
+        {
+            const unsigned count = delta.ReadUInt();
+            success = count <= header.newSize_ - size && copyData(delta, count);
+        }
+
+        if (!success)
+        {
+            URHO3D_LOGERROR("Package delta is corrupted");
+            return false;
+        }
+    }
+
+    if (size != header.newSize_ || checksum != header.newFileChecksum_)
+    {
+        URHO3D_LOGERROR("Package file rebuilt from delta does not match expected checksum");
+        return false;
+    }
+
+    return true;
+}
+
+ea::string GetPackageDeltaFileName(const ea::string& packageFileName, unsigned oldChecksum)
+{
+    return packageFileName + "." + ToStringHex(oldChecksum) + ".delta";
+}
+
+}
@@ -0,0 +1,71 @@
+//
+// Copyright (c) 2021-2022 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#pragma once
+
+#include "../Urho3D.h"
+
+#include <EASTL/string.h>
+
+namespace Urho3D
+{
+
+class Deserializer;
+class File;
+class PackageFile;
+class Serializer;
+
+/// Default size of blocks matched between package versions.
+static const unsigned DEFAULT_PACKAGE_DELTA_BLOCK_SIZE = 1024;
+
+/// Header of binary delta between two versions of package file.
+struct PackageDeltaHeader
+{
+    /// Size of old package file.
+    unsigned oldSize_{};
+    /// Checksum of old package as stored in package header.
+    unsigned oldChecksum_{};
+    /// Checksum of old package file contents.
+    unsigned oldFileChecksum_{};
+    /// Size of new package file.
+    unsigned newSize_{};
+    /// Checksum of new package as stored in package header.
+    unsigned newChecksum_{};
+    /// Checksum of new package file contents.
+    unsigned newFileChecksum_{};
+};
+
+/// Write binary delta that rebuilds new package file from old one.
+/// Each entry of new package is matched block by block against the entry with the same name in old package,
+/// data that cannot be found is stored in the delta as is. Return false if package files could not be read.
+URHO3D_API bool CreatePackageDelta(PackageFile* oldPackage, PackageFile* newPackage, Serializer& dest,
+    unsigned blockSize = DEFAULT_PACKAGE_DELTA_BLOCK_SIZE);
+/// Read header of package delta. Return false if the data is not a package delta.
+URHO3D_API bool ReadPackageDeltaHeader(Deserializer& source, PackageDeltaHeader& header);
+/// Rebuild new package file from old package file and delta.
+/// Return false if old file doesn't match the delta, delta is corrupted or the result doesn't match the delta.
+URHO3D_API bool ApplyPackageDelta(File& oldFile, Deserializer& delta, Serializer& dest);
+/// Return conventional name of delta file that updates package from the version with given checksum.
+URHO3D_API ea::string GetPackageDeltaFileName(const ea::string& packageFileName, unsigned oldChecksum);
+
+}
@@ -0,0 +1,178 @@
+//
+// Copyright (c) 2021-2022 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "../Precompiled.h"
+
+#include "../Core/Thread.h"
+#include "../Core/WorkQueue.h"
+#include "../IO/Deserializer.h"
+#include "../IO/PackageEntryWriter.h"
+#include "../IO/Serializer.h"
+
+#include <LZ4/lz4.h>
+#include <LZ4/lz4hc.h>
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+namespace
+{
+
+/// Maximum size of uncompressed block, so that size of compressed block always fits 16 bits.
+const unsigned MAX_BLOCK_SIZE = 65024;
+
+/// SDBMHash(hash, c) is equal to c + hash * SDBM_MULTIPLIER.
+const unsigned SDBM_MULTIPLIER = 65599;
+
+/// Return checksum of the data.
+unsigned CalculateChecksum(const unsigned char* data, unsigned size)
+{
+    unsigned checksum = 0;
+    for (unsigned i = 0; i < size; ++i)
+        checksum = SDBMHash(checksum, data[i]);
+    return checksum;
+}
+
+/// Return checksum of concatenated data given checksums of both parts.
+unsigned CombineChecksums(unsigned checksum, unsigned nextChecksum, unsigned nextSize)
+{
+    // Raise multiplier to the power of nextSize modulo 2^32
+    unsigned multiplier = 1;
+    unsigned base = SDBM_MULTIPLIER;
+    for (unsigned exponent = nextSize; exponent != 0; exponent >>= 1)
+    {
+        if (exponent & 1)
+            multiplier *= base;
+        base *= base;
+    }
+    return checksum * multiplier + nextChecksum;
+}
+
+bool CanWriteInParallel(WorkQueue* workQueue)
+{
+    // ForEachParallel can be used only from main thread
+    return workQueue && workQueue->GetNumThreads() > 0 && Thread::IsMainThread() && !workQueue->IsCompleting();
+}
+
+}
+
+PackageEntryWriter::PackageEntryWriter(WorkQueue* workQueue, unsigned blockSize, unsigned batchSize)
+    : workQueue_(workQueue)
+    , blockSize_(Clamp(blockSize, 1u, MAX_BLOCK_SIZE))
+{
+    const unsigned numThreads = workQueue_ ? workQueue_->GetNumThreads() + 1 : 1;
+    batchSize_ = batchSize ? batchSize : numThreads * 4;
+
+    buffer_.resize(batchSize_ * blockSize_);
+    blocks_.resize(batchSize_);
+    for (Block& block : blocks_)
+        block.data_.resize(LZ4_compressBound(blockSize_));
+}
+
+bool PackageEntryWriter::Write(Serializer& dest, Deserializer& source, unsigned size, PackageCompression compression,
+    unsigned& entryChecksum, unsigned& packageChecksum)
+{
+    const bool isParallel = CanWriteInParallel(workQueue_);
+
+    entryChecksum = 0;
+    for (unsigned offset = 0; offset < size;)
+    {
+        const unsigned batchBytes = ea::min(size - offset, batchSize_ * blockSize_);
+        if (source.Read(buffer_.data(), batchBytes) != batchBytes)
+            return false;
+
+        const unsigned numBlocks = (batchBytes + blockSize_ - 1) / blockSize_;
+        for (unsigned i = 0; i < numBlocks; ++i)
+            blocks_[i].size_ = ea::min(blockSize_, batchBytes - i * blockSize_);
+
+        if (isParallel)
+        {
+            ForEachParallel(workQueue_, 1u, numBlocks,
+                [&](unsigned beginIndex, unsigned endIndex) { ProcessBlocks(beginIndex, endIndex, compression); });
+        }
+        else
+            ProcessBlocks(0, numBlocks, compression);
+
+        // Blocks are written in order, so output is the same as if they were processed sequentially
+        for (unsigned i = 0; i < numBlocks; ++i)
+        {
+            const Block& block = blocks_[i];
+            entryChecksum = CombineChecksums(entryChecksum, block.checksum_, block.size_);
+            packageChecksum = CombineChecksums(packageChecksum, block.checksum_, block.size_);
+
+            if (compression == PackageCompression::None)
+            {
+                if (dest.Write(&buffer_[i * blockSize_], block.size_) != block.size_)
+                    return false;
+            }
+            else
+            {
+                if (!block.compressedSize_)
+                    return false;
+
+                dest.WriteUShort(static_cast<unsigned short>(block.size_));
+                dest.WriteUShort(static_cast<unsigned short>(block.compressedSize_));
+                if (dest.Write(block.data_.data(), block.compressedSize_) != block.compressedSize_)
+                    return false;
+            }
+        }
+
+        offset += batchBytes;
+    }
+
+    return true;
+}
+
+void PackageEntryWriter::ProcessBlocks(unsigned beginIndex, unsigned endIndex, PackageCompression compression)
+{
+    for (unsigned i = beginIndex; i < endIndex; ++i)
+    {
+        Block& block = blocks_[i];
+        const auto source = reinterpret_cast<const char*>(&buffer_[i * blockSize_]);
+        const auto dest = reinterpret_cast<char*>(block.data_.data());
+        const auto size = static_cast<int>(block.size_);
+        const auto capacity = static_cast<int>(block.data_.size());
+
+        block.checksum_ = CalculateChecksum(&buffer_[i * blockSize_], block.size_);
+
+        switch (compression)
+        {
+        case PackageCompression::LZ4:
+            block.compressedSize_ = static_cast<unsigned>(LZ4_compress_default(source, dest, size, capacity));
+            break;
+
+        case PackageCompression::LZ4HC:
+            block.compressedSize_ = static_cast<unsigned>(LZ4_compress_HC(source, dest, size, capacity, 0));
+            break;
+
+        case PackageCompression::None:
+        default:
+            block.compressedSize_ = 0;
+            break;
+        }
+    }
+}
+
+}
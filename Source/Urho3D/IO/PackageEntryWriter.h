@@ -0,0 +1,102 @@
+//
+// Copyright (c) 2021-2022 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#pragma once
+
+#include "../Urho3D.h"
+#include "../Container/ByteVector.h"
+
+#include <EASTL/vector.h>
+
+namespace Urho3D
+{
+
+class Deserializer;
+class Serializer;
+class WorkQueue;
+
+/// Compression of package entry data.
+enum class PackageCompression
+{
+    /// Data is stored as is.
+    None,
+    /// Fast LZ4 compression.
+    LZ4,
+    /// Slower LZ4 compression with higher ratio. Data is decompressed as fast as LZ4.
+    LZ4HC
+};
+
+/// Writes data of package entries in the format expected by PackageFile.
+/// Source data is streamed in batches of blocks, so memory usage doesn't depend on entry size.
+/// Blocks of each batch are checksummed and compressed by WorkQueue threads and written in order,
+/// so the output doesn't depend on the number of threads.
+class URHO3D_API PackageEntryWriter
+{
+public:
+    /// Default size of uncompressed LZ4 block.
+    static const unsigned DEFAULT_BLOCK_SIZE = 32768;
+
+    /// Construct. Work queue is optional and is used only when writing from main thread.
+    /// Batch size is the number of blocks buffered at once, zero means a few blocks per thread.
+    explicit PackageEntryWriter(WorkQueue* workQueue, unsigned blockSize = DEFAULT_BLOCK_SIZE, unsigned batchSize = 0);
+
+    /// Write entry data of given size from source. Entry checksum is returned, package checksum is updated.
+    /// Return false if source could not be read or compression failed.
+    bool Write(Serializer& dest, Deserializer& source, unsigned size, PackageCompression compression,
+        unsigned& entryChecksum, unsigned& packageChecksum);
+
+    /// Return size of uncompressed block.
+    unsigned GetBlockSize() const { return blockSize_; }
+    /// Return number of blocks buffered at once.
+    unsigned GetBatchSize() const { return batchSize_; }
+
+private:
+    /// Compressed block.
+    struct Block
+    {
+        /// Size of uncompressed data.
+        unsigned size_{};
+        /// Checksum of uncompressed data, not combined with previous blocks.
+        unsigned checksum_{};
+        /// Compressed data.
+        ByteVector data_;
+        /// Size of compressed data.
+        unsigned compressedSize_{};
+    };
+
+    /// Process blocks of the batch.
+    void ProcessBlocks(unsigned beginIndex, unsigned endIndex, PackageCompression compression);
+
+    /// Work queue.
+    WorkQueue* workQueue_{};
+    /// Size of uncompressed block.
+    unsigned blockSize_{};
+    /// Number of blocks buffered at once.
+    unsigned batchSize_{};
+    /// Uncompressed data of the batch.
+    ByteVector buffer_;
+    /// Blocks of the batch.
+    ea::vector<Block> blocks_;
+};
+
+}
@@ -26,8 +26,10 @@
 #include "../Core/Profiler.h"
 #include "../IO/File.h"
 #include "../IO/FileSystem.h"
+#include "../IO/Compression.h"
 #include "../IO/Log.h"
 #include "../IO/MemoryBuffer.h"
+#include "../IO/PackageDelta.h"
 #include "../IO/PackageFile.h"
 #include "../Network/ClockSynchronizer.h"
 #include "../Network/Connection.h"
@@ -60,16 +62,48 @@ namespace Urho3D
 
 static const int STATS_INTERVAL_MSEC = 2000;
 
+/// Return file name of downloaded package in package cache. Prepend the checksum to the filename to allow multiple versions.
+static ea::string GetDownloadedPackageFileName(const ea::string& packageCacheDir, const PackageDownload& download)
+{
+    return packageCacheDir + ToStringHex(download.checksum_) + "_" + download.name_;
+}
+
+/// Return file name of partially downloaded file.
+static ea::string GetPartialFileName(const ea::string& fileName)
+{
+    return fileName + ".part";
+}
+
+/// Return offset to resume download of partially downloaded file from.
+static unsigned GetResumeOffset(Context* context, const ea::string& partialFileName)
+{
+    if (!context->GetSubsystem<FileSystem>()->FileExists(partialFileName))
+        return 0;
+
+    File file(context, partialFileName);
+    return file.GetSize();
+}
+
 PackageDownload::PackageDownload() :
-    totalFragments_(0),
+    totalSize_(0),
+    receivedSize_(0),
+    receivedFragments_(0),
+    fragmentSize_(0),
+    fileSize_(0),
     checksum_(0),
-    initiated_(false)
+    baseChecksum_(0),
+    initiated_(false),
+    delta_(false),
+    compressed_(false)
 {
 }
 
 PackageUpload::PackageUpload() :
     fragment_(0),
-    totalFragments_(0)
+    totalFragments_(0),
+    ackedFragments_(0),
+    fragmentSize_(0),
+    compressed_(false)
 {
 }
 
@@ -196,7 +230,8 @@ void Connection::SetScene(Scene* newScene)
     {
         // Remove replication states and owner references from the previous scene
         scene_->CleanupConnection(this);
-        if (replicationManager_)
+        // Server adds the connection to replication only when the client has loaded the scene
+        if (replicationManager_ && (sceneLoaded_ || !replicationManager_->IsServer()))
             replicationManager_->DropConnection(this);
         replicationManager_ = nullptr;
     }
@@ -372,28 +407,45 @@ void Connection::SendRemoteEvents()
 
 void Connection::SendPackages()
 {
-    while (!uploads_.empty())
+    const unsigned windowSize = GetSubsystem<Network>()->GetPackageWindowSize();
+
+    for (auto i = uploads_.begin(); i != uploads_.end();)
     {
-        unsigned char buffer[PACKAGE_FRAGMENT_SIZE];
+        auto current = i++;
+        PackageUpload& upload = current->second;
 
-        for (auto i = uploads_.begin(); i != uploads_.end();)
+        // Send fragments only as fast as the client acknowledges them
+        while (upload.fragment_ < upload.totalFragments_ && upload.fragment_ - upload.ackedFragments_ < windowSize)
         {
-            auto current = i++;
-            PackageUpload& upload = current->second;
-            auto fragmentSize =
-                (unsigned)Min((int)(upload.file_->GetSize() - upload.file_->GetPosition()), (int)PACKAGE_FRAGMENT_SIZE);
-            upload.file_->Read(buffer, fragmentSize);
+            const unsigned fragmentSize = Min(upload.file_->GetSize() - upload.file_->GetPosition(), upload.fragmentSize_);
+            packageBuffer_.resize(fragmentSize);
+            upload.file_->Read(packageBuffer_.data(), fragmentSize);
 
             msg_.Clear();
             msg_.WriteStringHash(current->first);
             msg_.WriteUInt(upload.fragment_++);
-            msg_.Write(buffer, fragmentSize);
-            SendMessage(MSG_PACKAGEDATA, true, false, msg_);
+            if (upload.compressed_)
+            {
+                // Fragments that don't compress well are sent as is
+                packageCompressBuffer_.resize(EstimateCompressBound(fragmentSize));
+                const unsigned packedSize = CompressData(packageCompressBuffer_.data(), packageBuffer_.data(), fragmentSize);
+                const bool isPacked = packedSize && packedSize < fragmentSize;
+                msg_.WriteBool(isPacked);
+                if (isPacked)
+                    msg_.Write(packageCompressBuffer_.data(), packedSize);
+                else
+                    msg_.Write(packageBuffer_.data(), fragmentSize);
+            }
+            else
+                msg_.Write(packageBuffer_.data(), fragmentSize);
 
-            // Check if upload finished
-            if (upload.fragment_ == upload.totalFragments_)
-                uploads_.erase(current);
+            // Fragments are sent in order, so partially downloaded file never has gaps and can be resumed
+            SendMessage(MSG_PACKAGEDATA, true, true, msg_);
         }
+
+        // Check if upload finished
+        if (upload.fragment_ == upload.totalFragments_)
+            uploads_.erase(current);
     }
 }
 
@@ -515,7 +567,9 @@ bool Connection::ProcessMessage(int msgID, MemoryBuffer& buffer)
                 break;
 
             case MSG_REQUESTPACKAGE:
+            case MSG_PACKAGESTART:
             case MSG_PACKAGEDATA:
+            case MSG_PACKAGEACK:
                 ProcessPackageDownload(msgID, msg);
                 break;
 
@@ -856,6 +910,18 @@ void Connection::ProcessPackageDownload(int msgID, MemoryBuffer& msg)
         else
         {
             ea::string name = msg.ReadString();
+            const unsigned requestedFragmentSize = msg.ReadUInt();
+            const unsigned resumeOffset = msg.ReadUInt();
+
+            // Client may have other versions of the package and partially received deltas for them
+            ea::vector<ea::pair<unsigned, unsigned>> baseVersions;
+            const unsigned numBaseVersions = msg.ReadVLE();
+            for (unsigned i = 0; i < numBaseVersions && !msg.IsEof(); ++i)
+            {
+                const unsigned baseChecksum = msg.ReadUInt();
+                const unsigned deltaResumeOffset = msg.ReadUInt();
+                baseVersions.emplace_back(baseChecksum, deltaResumeOffset);
+            }
 
             if (!scene_)
             {
@@ -880,20 +946,72 @@ void Connection::ProcessPackageDownload(int msgID, MemoryBuffer& msg)
                         return;
                     }
 
-                    // Try to open the file now
-                    SharedPtr<File> file(new File(context_, packageFullName));
-                    if (!file->IsOpen())
+                    // Send delta instead of the whole package if there is one for the version the client has
+                    SharedPtr<File> file;
+                    unsigned offset = resumeOffset;
+                    unsigned baseChecksum = 0;
+                    for (const auto& [checksum, deltaResumeOffset] : baseVersions)
                     {
-                        URHO3D_LOGERROR("Failed to transmit package file " + name);
-                        SendPackageError(name);
-                        return;
+                        const ea::string deltaFileName = GetPackageDeltaFileName(packageFullName, checksum);
+                        if (!GetSubsystem<FileSystem>()->FileExists(deltaFileName))
+                            continue;
+
+                        SharedPtr<File> deltaFile(new File(context_, deltaFileName));
+                        PackageDeltaHeader header;
+                        if (deltaFile->IsOpen() && ReadPackageDeltaHeader(*deltaFile, header) && header.oldChecksum_ == checksum
+                            && header.newChecksum_ == package->GetChecksum() && header.newSize_ == package->GetTotalSize())
+                        {
+                            file = deltaFile;
+                            offset = deltaResumeOffset;
+                            baseChecksum = checksum;
+                            break;
+                        }
+                    }
+
+                    const bool isDelta = file != nullptr;
+                    if (!isDelta)
+                    {
+                        // Try to open the file now
+                        file = new File(context_, packageFullName);
+                        if (!file->IsOpen())
+                        {
+                            URHO3D_LOGERROR("Failed to transmit package file " + name);
+                            SendPackageError(name);
+                            return;
+                        }
                     }
 
-                    URHO3D_LOGINFO("Transmitting package file " + name + " to client " + ToString());
+                    offset = Min(offset, file->GetSize());
+                    file->Seek(offset);
+
+                    // Use the smaller of client and server fragment sizes. Compressed packages are not compressed again
+                    auto* network = GetSubsystem<Network>();
+                    const unsigned fragmentSize = Clamp(Min(requestedFragmentSize, network->GetPackageFragmentSize()),
+                        PACKAGE_FRAGMENT_SIZE, MAX_PACKAGE_FRAGMENT_SIZE);
+                    const bool compressed = network->GetPackageCompression() && !package->IsCompressed();
 
-                    uploads_[nameHash].file_ = file;
-                    uploads_[nameHash].fragment_ = 0;
-                    uploads_[nameHash].totalFragments_ = (file->GetSize() + PACKAGE_FRAGMENT_SIZE - 1) / PACKAGE_FRAGMENT_SIZE;
+                    URHO3D_LOGINFO("Transmitting package " + ea::string(isDelta ? "delta " : "file ") + name + " to client "
+                        + ToString() + (offset ? " from offset " + ea::to_string(offset) : EMPTY_STRING));
+
+                    msg_.Clear();
+                    msg_.WriteStringHash(nameHash);
+                    msg_.WriteBool(isDelta);
+                    msg_.WriteUInt(baseChecksum);
+                    msg_.WriteUInt(file->GetSize());
+                    msg_.WriteUInt(offset);
+                    msg_.WriteUInt(fragmentSize);
+                    msg_.WriteBool(compressed);
+                    SendMessage(MSG_PACKAGESTART, true, true, msg_);
+
+                    const unsigned totalFragments = (file->GetSize() - offset + fragmentSize - 1) / fragmentSize;
+                    if (totalFragments > 0)
+                    {
+                        PackageUpload& upload = uploads_[nameHash];
+                        upload.file_ = file;
+                        upload.totalFragments_ = totalFragments;
+                        upload.fragmentSize_ = fragmentSize;
+                        upload.compressed_ = compressed;
+                    }
                     return;
                 }
             }
@@ -905,6 +1023,63 @@ void Connection::ProcessPackageDownload(int msgID, MemoryBuffer& msg)
         }
         break;
 
+    case MSG_PACKAGESTART:
+        if (IsClient())
+        {
+            URHO3D_LOGWARNING("Received unexpected PackageStart message from client");
+            return;
+        }
+        else
+        {
+            StringHash nameHash = msg.ReadStringHash();
+
+            auto i = downloads_.find(nameHash);
+            if (i == downloads_.end())
+                return;
+
+            PackageDownload& download = i->second;
+            download.delta_ = msg.ReadBool();
+            download.baseChecksum_ = msg.ReadUInt();
+            const unsigned size = msg.ReadUInt();
+            const unsigned offset = msg.ReadUInt();
+            download.fragmentSize_ = msg.ReadUInt();
+            download.compressed_ = msg.ReadBool();
+
+            if ((download.delta_ && !download.baseFiles_.contains(download.baseChecksum_))
+                || download.fragmentSize_ < PACKAGE_FRAGMENT_SIZE || download.fragmentSize_ > MAX_PACKAGE_FRAGMENT_SIZE)
+            {
+                OnPackageDownloadFailed(download.name_);
+                return;
+            }
+
+            // Data is received into temporary file, which is kept if the transfer is interrupted
+            const ea::string fileName = GetDownloadedPackageFileName(GetSubsystem<Network>()->GetPackageCacheDir(), download);
+            const ea::string partialFileName =
+                GetPartialFileName(download.delta_ ? GetPackageDeltaFileName(fileName, download.baseChecksum_) : fileName);
+
+            download.file_ = new File(context_, partialFileName, offset ? FILE_READWRITE : FILE_WRITE);
+            if (!download.file_->IsOpen() || download.file_->GetSize() < offset)
+            {
+                OnPackageDownloadFailed(download.name_);
+                return;
+            }
+
+            if (download.delta_)
+                URHO3D_LOGINFO("Receiving delta for package " + download.name_);
+            if (offset)
+                URHO3D_LOGINFO("Resuming download of package " + download.name_ + " from offset " + ea::to_string(offset));
+
+            download.file_->Seek(offset);
+            download.totalSize_ = size;
+            download.receivedSize_ = offset;
+            download.receivedFragments_ = 0;
+
+            // Nothing to receive if the transfer was interrupted right before completion
+            if (download.receivedSize_ >= download.totalSize_)
+                OnPackageDownloadReceived(nameHash);
+        }
+        break;
+
     case MSG_PACKAGEDATA:
         if (IsClient())
         {
@@ -930,53 +1105,79 @@ void Connection::ProcessPackageDownload(int msgID, MemoryBuffer& msg)
                 return;
             }
 
-            // If file has not yet been opened, try to open now. Prepend the checksum to the filename to allow multiple versions
+            // File is opened when transfer starts
             if (!download.file_)
             {
-                download.file_ = new File(context_,
-                    GetSubsystem<Network>()->GetPackageCacheDir() + ToStringHex(download.checksum_) + "_" + download.name_,
-                    FILE_WRITE);
-                if (!download.file_->IsOpen())
+                OnPackageDownloadFailed(download.name_);
+                return;
+            }
+
+            // Fragments are received in order
+            const unsigned index = msg.ReadUInt();
+            if (index != download.receivedFragments_)
+            {
+                URHO3D_LOGWARNING("Received unexpected fragment of package " + download.name_);
+                return;
+            }
+
+            const unsigned fragmentSize = Min(download.fragmentSize_, download.totalSize_ - download.receivedSize_);
+            const bool isPacked = download.compressed_ && msg.ReadBool();
+            const unsigned dataSize = msg.GetSize() - msg.GetPosition();
+            const unsigned char* data = msg.GetData() + msg.GetPosition();
+            if (isPacked)
+            {
+                // Fragment is received from the network, so it is decompressed with bounds checking
+                packageBuffer_.resize(fragmentSize);
+                if (DecompressData(packageBuffer_.data(), data, fragmentSize, dataSize) != fragmentSize)
                 {
+                    URHO3D_LOGWARNING("Received corrupt fragment of package " + download.name_);
                     OnPackageDownloadFailed(download.name_);
                     return;
                 }
+                data = packageBuffer_.data();
+            }
+            else if (dataSize != fragmentSize)
+            {
+                OnPackageDownloadFailed(download.name_);
+                return;
+            }
+
+            if (download.file_->Write(data, fragmentSize) != fragmentSize)
+            {
+                OnPackageDownloadFailed(download.name_);
+                return;
             }
 
-            // Write the fragment data to the proper index
-            unsigned char buffer[PACKAGE_FRAGMENT_SIZE];
-            unsigned index = msg.ReadUInt();
-            unsigned fragmentSize = msg.GetSize() - msg.GetPosition();
+            download.receivedSize_ += fragmentSize;
+            ++download.receivedFragments_;
 
-            msg.Read(buffer, fragmentSize);
-            download.file_->Seek(index * PACKAGE_FRAGMENT_SIZE);
-            download.file_->Write(buffer, fragmentSize);
-            download.receivedFragments_.insert(index);
+            // Let the server send more fragments
+            msg_.Clear();
+            msg_.WriteStringHash(nameHash);
+            msg_.WriteUInt(download.receivedFragments_);
+            SendMessage(MSG_PACKAGEACK, true, false, msg_);
 
             // Check if all fragments received
-            if (download.receivedFragments_.size() == download.totalFragments_)
-            {
-                URHO3D_LOGINFO("Package " + download.name_ + " downloaded successfully");
-
-                // Instantiate the package and add to the resource system, as we will need it to load the scene
-                download.file_->Close();
-                GetSubsystem<ResourceCache>()->AddPackageFile(download.file_->GetName(), 0);
+            if (download.receivedSize_ >= download.totalSize_)
+                OnPackageDownloadReceived(nameHash);
+        }
+        break;
 
-                // Then start the next download if there are more
-                downloads_.erase(i);
-                if (downloads_.empty())
-                    OnPackagesReady();
-                else
-                {
-                    PackageDownload& nextDownload = downloads_.begin()->second;
+    case MSG_PACKAGEACK:
+        if (!IsClient())
+        {
+            URHO3D_LOGWARNING("Received unexpected PackageAck message from server");
+            return;
+        }
+        else
+        {
+            StringHash nameHash = msg.ReadStringHash();
+            const unsigned ackedFragments = msg.ReadUInt();
 
-                    URHO3D_LOGINFO("Requesting package " + nextDownload.name_ + " from server");
-                    msg_.Clear();
-                    msg_.WriteString(nextDownload.name_);
-                    SendMessage(MSG_REQUESTPACKAGE, true, true, msg_);
-                    nextDownload.initiated_ = true;
-                }
-            }
+            // Upload may be already finished
+            auto i = uploads_.find(nameHash);
+            if (i != uploads_.end())
+                i->second.ackedFragments_ = Max(i->second.ackedFragments_, Min(ackedFragments, i->second.fragment_));
         }
         break;
 
@@ -1225,8 +1426,9 @@ float Connection::GetDownloadProgress() const
     for (auto i = downloads_.begin(); i !=
         downloads_.end(); ++i)
     {
-        if (i->second.initiated_)
-            return (float)i->second.receivedFragments_.size() / (float)i->second.totalFragments_;
+        const PackageDownload& download = i->second;
+        if (download.initiated_ && download.totalSize_)
+            return (float)download.receivedSize_ / (float)download.totalSize_;
     }
     return 1.0f;
 }
@@ -1636,18 +1838,135 @@ void Connection::RequestPackage(const ea::string& name, unsigned fileSize, unsig
 
     PackageDownload& download = downloads_[nameHash];
     download.name_ = name;
-    download.totalFragments_ = (fileSize + PACKAGE_FRAGMENT_SIZE - 1) / PACKAGE_FRAGMENT_SIZE;
+    download.totalSize_ = fileSize;
+    download.fileSize_ = fileSize;
     download.checksum_ = checksum;
 
+    // Other versions of the package may be updated with delta if the server has one
+    for (PackageFile* package : GetSubsystem<ResourceCache>()->GetPackageFiles())
+    {
+        if (!GetFileNameAndExtension(package->GetName()).comparei(name) && package->GetChecksum() != checksum)
+            download.baseFiles_[package->GetChecksum()] = package->GetName();
+    }
+
+    const ea::string& packageCacheDir = GetSubsystem<Network>()->GetPackageCacheDir();
+    ea::vector<ea::string> downloadedPackages;
+    if (!packageCacheDir.empty())
+        GetSubsystem<FileSystem>()->ScanDir(downloadedPackages, packageCacheDir, "*.*", SCAN_FILES, false);
+    for (const ea::string& fileName : downloadedPackages)
+    {
+        // In download cache, package file name format is checksum_packagename
+        if (fileName.length() == name.length() + 9 && fileName[8] == '_' && !fileName.substr(9).comparei(name))
+        {
+            const unsigned baseChecksum = ToUInt(fileName.substr(0, 8), 16);
+            if (baseChecksum != checksum)
+                download.baseFiles_[baseChecksum] = packageCacheDir + fileName;
+        }
+    }
+
     // Start download now only if no existing downloads, else wait for the existing ones to finish
     if (downloads_.size() == 1)
+        SendPackageRequest(download);
+}
+
+void Connection::SendPackageRequest(PackageDownload& download)
+{
+    const ea::string fileName = GetDownloadedPackageFileName(GetSubsystem<Network>()->GetPackageCacheDir(), download);
+
+    URHO3D_LOGINFO("Requesting package " + download.name_ + " from server");
+    msg_.Clear();
+    msg_.WriteString(download.name_);
+    msg_.WriteUInt(GetSubsystem<Network>()->GetPackageFragmentSize());
+    msg_.WriteUInt(GetResumeOffset(context_, GetPartialFileName(fileName)));
+    msg_.WriteVLE(download.baseFiles_.size());
+    for (const auto& [baseChecksum, baseFileName] : download.baseFiles_)
     {
-        URHO3D_LOGINFO("Requesting package " + name + " from server");
-        msg_.Clear();
-        msg_.WriteString(name);
-        SendMessage(MSG_REQUESTPACKAGE, true, true, msg_);
-        download.initiated_ = true;
+        msg_.WriteUInt(baseChecksum);
+        msg_.WriteUInt(GetResumeOffset(context_, GetPartialFileName(GetPackageDeltaFileName(fileName, baseChecksum))));
     }
+    SendMessage(MSG_REQUESTPACKAGE, true, true, msg_);
+    download.initiated_ = true;
+}
+
+void Connection::OnPackageDownloadReceived(StringHash nameHash)
+{
+    auto i = downloads_.find(nameHash);
+    if (i == downloads_.end())
+        return;
+
+    PackageDownload& download = i->second;
+    download.file_->Close();
+    if (!FinishPackageDownload(download))
+    {
+        if (!download.delta_)
+        {
+            OnPackageDownloadFailed(download.name_);
+            return;
+        }
+
+        // Delta could not be applied, download the whole package instead
+        URHO3D_LOGWARNING("Failed to apply delta for package " + download.name_ + ", requesting whole package");
+        download.file_ = nullptr;
+        download.baseFiles_.clear();
+        download.delta_ = false;
+        SendPackageRequest(download);
+        return;
+    }
+
+    URHO3D_LOGINFO("Package " + download.name_ + " downloaded successfully");
+
+    // Then start the next download if there are more
+    downloads_.erase(i);
+    if (downloads_.empty())
+        OnPackagesReady();
+    else
+        SendPackageRequest(downloads_.begin()->second);
+}
+
+bool Connection::FinishPackageDownload(PackageDownload& download)
+{
+    auto* fileSystem = GetSubsystem<FileSystem>();
+    const ea::string fileName = GetDownloadedPackageFileName(GetSubsystem<Network>()->GetPackageCacheDir(), download);
+    const ea::string partialFileName = download.file_->GetName();
+
+    if (download.delta_)
+    {
+        bool success = false;
+        {
+            File baseFile(context_, download.baseFiles_[download.baseChecksum_]);
+            File deltaFile(context_, partialFileName);
+            File packageFile(context_, fileName, FILE_WRITE);
+            if (baseFile.IsOpen() && deltaFile.IsOpen() && packageFile.IsOpen())
+                success = ApplyPackageDelta(baseFile, deltaFile, packageFile);
+        }
+
+        fileSystem->Delete(partialFileName);
+        if (!success)
+        {
+            fileSystem->Delete(fileName);
+            return false;
+        }
+    }
+    else
+    {
+        if (fileSystem->FileExists(fileName))
+            fileSystem->Delete(fileName);
+        if (!fileSystem->Rename(partialFileName, fileName))
+            return false;
+    }
+
+    // Instantiate the package and add to the resource system, as we will need it to load the scene
+    SharedPtr<PackageFile> package(new PackageFile(context_, fileName));
+    if (package->GetTotalSize() != download.fileSize_ || package->GetChecksum() != download.checksum_)
+    {
+        URHO3D_LOGERROR("Downloaded package " + download.name_ + " does not match expected checksum");
+        package = nullptr;
+        fileSystem->Delete(fileName);
+        return false;
+    }
+
+    GetSubsystem<ResourceCache>()->AddPackageFile(package, 0);
+    return true;
 }
 
 void Connection::SendPackageError(const ea::string& name)
@@ -76,16 +76,30 @@ struct PackageDownload
 
     /// Destination file.
     SharedPtr<File> file_;
-    /// Already received fragments.
-    ea::hash_set<unsigned> receivedFragments_;
     /// Package name.
     ea::string name_;
-    /// Total number of fragments.
-    unsigned totalFragments_;
+    /// Local versions of the package that can be updated with delta, by package checksum.
+    ea::unordered_map<unsigned, ea::string> baseFiles_;
+    /// Size of transferred data.
+    unsigned totalSize_;
+    /// Size of received data, including data received before transfer was interrupted.
+    unsigned receivedSize_;
+    /// Number of fragments received in this transfer.
+    unsigned receivedFragments_;
+    /// Fragment size.
+    unsigned fragmentSize_;
+    /// Package file size.
+    unsigned fileSize_;
     /// Checksum.
     unsigned checksum_;
+    /// Checksum of local version of the package that received delta is applied to.
+    unsigned baseChecksum_;
     /// Download initiated flag.
     bool initiated_;
+    /// Package delta is received instead of package file.
+    bool delta_;
+    /// Fragments may be compressed.
+    bool compressed_;
 };
 
 /// Package file send transfer.
@@ -100,6 +114,12 @@ struct PackageUpload
     unsigned fragment_;
     /// Total number of fragments.
     unsigned totalFragments_;
+    /// Number of fragments acknowledged by client.
+    unsigned ackedFragments_;
+    /// Fragment size.
+    unsigned fragmentSize_;
+    /// Compress fragments.
+    bool compressed_;
 };
 
 /// Send modes for observer position/rotation. Activated by the client setting either position or rotation.
@@ -318,6 +338,12 @@ private:
     bool RequestNeededPackages(unsigned numPackages, MemoryBuffer& msg);
     /// Initiate a package download.
     void RequestPackage(const ea::string& name, unsigned fileSize, unsigned checksum);
+    /// Request package from server. Partially downloaded files are resumed.
+    void SendPackageRequest(PackageDownload& download);
+    /// Handle all fragments of a package download received on the client.
+    void OnPackageDownloadReceived(StringHash nameHash);
+    /// Apply received delta if needed, verify downloaded package and add it to the resource cache. Return false if failed.
+    bool FinishPackageDownload(PackageDownload& download);
     /// Send an error reply for a package download.
     void SendPackageError(const ea::string& name);
     /// Handle scene load failure on the server or client.
@@ -384,6 +410,10 @@ private:
     ea::unordered_map<int, VectorBuffer> outgoingBuffer_;
     /// Outgoing packet size limit
     int packedMessageLimit_;
+    /// Package file fragment buffer.
+    ByteVector packageBuffer_;
+    /// Compressed package file fragment buffer.
+    ByteVector packageCompressBuffer_;
 };
 
 }
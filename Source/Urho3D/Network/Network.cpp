@@ -661,6 +661,16 @@ void Network::SetPackageCacheDir(const ea::string& path)
     packageCacheDir_ = AddTrailingSlash(path);
 }
 
+void Network::SetPackageFragmentSize(unsigned size)
+{
+    packageFragmentSize_ = Clamp(size, PACKAGE_FRAGMENT_SIZE, MAX_PACKAGE_FRAGMENT_SIZE);
+}
+
+void Network::SetPackageWindowSize(unsigned size)
+{
+    packageWindowSize_ = Max(size, 1u);
+}
+
 void Network::SendPackageToClients(Scene* scene, PackageFile* package)
 {
     if (!scene)
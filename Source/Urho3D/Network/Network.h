@@ -116,6 +116,15 @@ public:
     /// Set the package download cache directory.
     /// @property
     void SetPackageCacheDir(const ea::string& path);
+    /// Set max size of package file fragments. Smaller of client and server sizes is used.
+    /// @property
+    void SetPackageFragmentSize(unsigned size);
+    /// Set max number of package file fragments sent by server and not acknowledged by client yet.
+    /// @property
+    void SetPackageWindowSize(unsigned size);
+    /// Set whether server compresses fragments of uncompressed package files.
+    /// @property
+    void SetPackageCompression(bool enable) { packageCompression_ = enable; }
     /// Trigger all client connections in the specified scene to download a package file from the server. Can be used to download additional resource packages when clients are already joined in the scene. The package must have been added as a requirement to the scene, or else the eventual download will fail.
     void SendPackageToClients(Scene* scene, PackageFile* package);
     /// Perform an HTTP request to the specified URL. Empty verb defaults to a GET request. Return a request object which can be used to read the response data.
@@ -167,6 +176,15 @@ public:
     /// Return the package download cache directory.
     /// @property
     const ea::string& GetPackageCacheDir() const { return packageCacheDir_; }
+    /// Return max size of package file fragments.
+    /// @property
+    unsigned GetPackageFragmentSize() const { return packageFragmentSize_; }
+    /// Return max number of package file fragments sent by server and not acknowledged by client yet.
+    /// @property
+    unsigned GetPackageWindowSize() const { return packageWindowSize_; }
+    /// Return whether server compresses fragments of uncompressed package files.
+    /// @property
+    bool GetPackageCompression() const { return packageCompression_; }
 
     /// Process incoming messages from connections. Called by HandleBeginFrame.
     void Update(float timeStep);
@@ -232,6 +250,12 @@ private:
     bool updateNow_{};
     /// Package cache directory.
     ea::string packageCacheDir_;
+    /// Max size of package file fragments.
+    unsigned packageFragmentSize_{DEFAULT_PACKAGE_FRAGMENT_SIZE};
+    /// Max number of package file fragments in transfer.
+    unsigned packageWindowSize_{DEFAULT_PACKAGE_WINDOW_SIZE};
+    /// Whether to compress fragments of uncompressed package files.
+    bool packageCompression_{true};
     /// Whether we started as server or not.
     bool isServer_;
     /// Server/Client password used for connecting.
@@ -35,7 +35,7 @@ enum NetworkMessageId
     MSG_CONTROLS = 0x88,
     /// Client->server: scene has been loaded and client is ready to proceed.
     MSG_SCENELOADED = 0x89,
-    /// Client->server: request a package file.
+    /// Client->server: request a package file. Contains max fragment size, offsets to resume from and versions of the package available to the client.
     MSG_REQUESTPACKAGE = 0x8A,
 
     /// Server->client: package file data fragment.
@@ -74,6 +74,11 @@ enum NetworkMessageId
     /// Message used to synchronize clock between client and server.
     MSG_CLOCK_SYNC = 0x9A,
 
+    /// Server->client: start of package file transfer. Specifies whether package delta or whole package is sent, its size, offset to resume from, fragment size and whether fragments are compressed.
+    MSG_PACKAGESTART = 0x9B,
+    /// Client->server: number of package file fragments received.
+    MSG_PACKAGEACK = 0x9C,
+
     /// Server->Client. ReplicationManager message. Deliver networking settings.
     MSG_CONFIGURE = 200,
     /// Server->Client. ReplicationManager message. Send server time and dynamic properties of the client connection.
@@ -95,7 +100,13 @@ enum NetworkMessageId
     MSG_USER = 512
 };
 
-/// Package file fragment size.
+/// Minimum package file fragment size.
 static const unsigned PACKAGE_FRAGMENT_SIZE = 1024;
+/// Maximum package file fragment size.
+static const unsigned MAX_PACKAGE_FRAGMENT_SIZE = 65536;
+/// Default max package file fragment size.
+static const unsigned DEFAULT_PACKAGE_FRAGMENT_SIZE = 16384;
+/// Default max number of package file fragments sent and not acknowledged yet.
+static const unsigned DEFAULT_PACKAGE_WINDOW_SIZE = 16;
 
 }
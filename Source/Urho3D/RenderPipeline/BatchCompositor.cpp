@@ -23,9 +23,13 @@
 #include "../Precompiled.h"
 
 #include "../IO/Log.h"
+#include "../Graphics/Geometry.h"
+#include "../Graphics/Material.h"
 #include "../Graphics/Renderer.h"
+#include "../Graphics/Technique.h"
 #include "../RenderPipeline/BatchCompositor.h"
 #include "../RenderPipeline/LightProcessor.h"
+#include "../RenderPipeline/RenderPipelineDebugger.h"
 #include "../RenderPipeline/RenderPipelineDefs.h"
 #include "../Scene/Node.h"
 
@@ -37,23 +41,64 @@ namespace Urho3D
 namespace
 {
 
-/// Add batch or delayed batch.
-void AddPipelineBatch(const PipelineBatchDesc& desc, BatchStateCache& cache,
-    WorkQueueVector<PipelineBatch>& batches, WorkQueueVector<PipelineBatchDesc>& delayedBatches)
+/// Number of frames after which unused cached batches are discarded.
+const unsigned maxBatchCacheUnusedFrames = 60;
+
+unsigned GetPassPipelineStateHash(Pass* pass)
 {
-    PipelineState* pipelineState = cache.GetPipelineState(desc.GetKey());
-    if (pipelineState)
+    return pass ? pass->GetPipelineStateHash() : 0;
+}
+
+}
+
+bool CachedGeometryBatch::IsValid(const GeometryBatch& geometryBatch, const SourceBatch& sourceBatch,
+    Material* material, unsigned lightingHash) const
+{
+    // Compare cheap inputs first
+    if (!isComplete_
+        || drawable_ != geometryBatch.drawable_
+        || geometry_ != sourceBatch.geometry_
+        || material_ != material
+        || deferredPass_ != geometryBatch.deferredPass_
+        || unlitBasePass_ != geometryBatch.unlitBasePass_
+        || litBasePass_ != geometryBatch.litBasePass_
+        || lightPass_ != geometryBatch.lightPass_
+        || geometryType_ != sourceBatch.geometryType_
+        || lightingHash_ != lightingHash)
     {
-        if (pipelineState->IsValid())
-        {
-            PipelineBatch& pipelineBatch = batches.Emplace(desc);
-            pipelineBatch.pipelineState_ = pipelineState;
-        }
+        return false;
     }
-    else
-        delayedBatches.Insert(desc);
+
+    return drawableHash_ == drawable_->GetPipelineStateHash()
+        && geometryHash_ == geometry_->GetPipelineStateHash()
+        && materialHash_ == material_->GetPipelineStateHash()
+        && deferredPassHash_ == GetPassPipelineStateHash(deferredPass_)
+        && unlitBasePassHash_ == GetPassPipelineStateHash(unlitBasePass_)
+        && litBasePassHash_ == GetPassPipelineStateHash(litBasePass_)
+        && lightPassHash_ == GetPassPipelineStateHash(lightPass_);
 }
 
+void CachedGeometryBatch::Reset(const GeometryBatch& geometryBatch, const SourceBatch& sourceBatch,
+    Material* material, unsigned lightingHash)
+{
+    drawable_ = geometryBatch.drawable_;
+    geometry_ = sourceBatch.geometry_;
+    material_ = material;
+    deferredPass_ = geometryBatch.deferredPass_;
+    unlitBasePass_ = geometryBatch.unlitBasePass_;
+    litBasePass_ = geometryBatch.litBasePass_;
+    lightPass_ = geometryBatch.lightPass_;
+    geometryType_ = sourceBatch.geometryType_;
+    drawableHash_ = drawable_->GetPipelineStateHash();
+    geometryHash_ = geometry_->GetPipelineStateHash();
+    materialHash_ = material_->GetPipelineStateHash();
+    deferredPassHash_ = GetPassPipelineStateHash(deferredPass_);
+    unlitBasePassHash_ = GetPassPipelineStateHash(unlitBasePass_);
+    litBasePassHash_ = GetPassPipelineStateHash(litBasePass_);
+    lightPassHash_ = GetPassPipelineStateHash(lightPass_);
+    lightingHash_ = lightingHash;
+    isComplete_ = true;
+    batches_.clear();
 }
 
 BatchCompositorPass::BatchCompositorPass(RenderPipelineInterface* renderPipeline,
@@ -64,12 +109,15 @@ BatchCompositorPass::BatchCompositorPass(RenderPipelineInterface* renderPipeline
     , defaultMaterial_(GetSubsystem<Renderer>()->GetDefaultMaterial())
     , drawableProcessor_(drawableProcessor)
     , batchStateCacheCallback_(callback)
+    , debugger_(renderPipeline->GetDebugger())
 {
     renderPipeline->OnPipelineStatesInvalidated.Subscribe(this, &BatchCompositorPass::OnPipelineStatesInvalidated);
 }
 
 void BatchCompositorPass::ComposeBatches()
 {
+    PrepareBatchCache();
+
     // Try to process batches in worker threads
     ForEachParallel(workQueue_, geometryBatches_,
         [&](unsigned /*index*/, const GeometryBatch& geometryBatch)
@@ -84,6 +132,9 @@ void BatchCompositorPass::ComposeBatches()
     ResolveDelayedBatches(BatchCompositorSubpass::Light, delayedLightBatches_, lightCache_, lightBatches_);
     ResolveDelayedBatches(BatchCompositorSubpass::Light, delayedNegativeLightBatches_, lightCache_, negativeLightBatches_);
 
+    if (RenderPipelineDebugger::IsSnapshotInProgress(debugger_))
+        debugger_->ReportBatchCacheStatistics(GetNumBatchCacheHits(), GetNumBatchCacheMisses());
+
     OnBatchesReady();
 }
 
@@ -101,6 +152,13 @@ void BatchCompositorPass::OnUpdateBegin(const CommonFrameInfo& frameInfo)
     delayedLitBaseBatches_.Clear();
     delayedLightBatches_.Clear();
     delayedNegativeLightBatches_.Clear();
+
+    numBatchCacheHits_.store(0, std::memory_order_relaxed);
+    numBatchCacheMisses_.store(0, std::memory_order_relaxed);
+
+    currentFrame_ = frameInfo.frameNumber_;
+    if (currentFrame_ % maxBatchCacheUnusedFrames == 0)
+        EvictUnusedCachedBatches();
 }
 
 void BatchCompositorPass::OnPipelineStatesInvalidated()
@@ -109,22 +167,143 @@ void BatchCompositorPass::OnPipelineStatesInvalidated()
     unlitBaseCache_.Invalidate();
     litBaseCache_.Invalidate();
     lightCache_.Invalidate();
+
+    // Cached batches reference pipeline states that may be destroyed
+    batchCache_.clear();
+}
+
+void BatchCompositorPass::PrepareBatchCache()
+{
+    // Allocate cache entries from main thread so worker threads never resize cache
+    for (const GeometryBatch& geometryBatch : geometryBatches_)
+    {
+        const unsigned drawableIndex = geometryBatch.drawable_->GetDrawableIndex();
+        if (drawableIndex >= batchCache_.size())
+            batchCache_.resize(drawableIndex + 1);
+
+        ea::vector<CachedGeometryBatch>& drawableBatches = batchCache_[drawableIndex];
+        if (geometryBatch.sourceBatchIndex_ >= drawableBatches.size())
+            drawableBatches.resize(geometryBatch.sourceBatchIndex_ + 1);
+    }
+}
+
+void BatchCompositorPass::EvictUnusedCachedBatches()
+{
+    for (ea::vector<CachedGeometryBatch>& drawableBatches : batchCache_)
+    {
+        bool isDrawableUsed = false;
+        for (CachedGeometryBatch& cachedBatch : drawableBatches)
+        {
+            if (currentFrame_ - cachedBatch.lastUsedFrame_ > maxBatchCacheUnusedFrames)
+                cachedBatch = CachedGeometryBatch{};
+            else
+                isDrawableUsed = true;
+        }
+
+        if (!isDrawableUsed)
+        {
+            drawableBatches.clear();
+            drawableBatches.shrink_to_fit();
+        }
+    }
+
+    while (!batchCache_.empty() && batchCache_.back().empty())
+        batchCache_.pop_back();
+    if (batchCache_.capacity() > 2 * batchCache_.size())
+        batchCache_.shrink_to_fit();
+}
+
+unsigned BatchCompositorPass::CalculateLightingHash(unsigned drawableIndex) const
+{
+    const LightAccumulator& lightAccumulator = drawableProcessor_->GetGeometryLighting(drawableIndex);
+
+    unsigned hash = 0;
+    for (const auto& [penalty, lightIndex] : lightAccumulator.GetPixelLights())
+    {
+        LightProcessor* lightProcessor = drawableProcessor_->GetLightProcessor(lightIndex);
+        const Light* light = lightProcessor->GetLight();
+        CombineHash(hash, MakeHash(lightIndex));
+        CombineHash(hash, MakeHash(lightProcessor));
+        CombineHash(hash, lightProcessor->GetForwardLitHash());
+        CombineHash(hash, MakeHash(light->GetLightType()));
+        CombineHash(hash, MakeHash(light->IsNegative()));
+    }
+    CombineHash(hash, lightAccumulator.GetVertexLightsHash());
+    return hash;
+}
+
+void BatchCompositorPass::AddPipelineBatch(PipelineBatchTarget target, const PipelineBatchDesc& desc,
+    BatchStateCache& cache, WorkQueueVector<PipelineBatchDesc>& delayedBatches, CachedGeometryBatch& cachedBatch)
+{
+    PipelineState* pipelineState = cache.GetPipelineState(desc.GetKey());
+    if (pipelineState)
+    {
+        if (pipelineState->IsValid())
+        {
+            PipelineBatch& pipelineBatch = GetBatches(target).Emplace(desc);
+            pipelineBatch.pipelineState_ = pipelineState;
+            cachedBatch.batches_.emplace_back(target, pipelineBatch);
+        }
+    }
+    else
+    {
+        delayedBatches.Insert(desc);
+        cachedBatch.isComplete_ = false;
+    }
+}
+
+WorkQueueVector<PipelineBatch>& BatchCompositorPass::GetBatches(PipelineBatchTarget target)
+{
+    switch (target)
+    {
+    case PipelineBatchTarget::Deferred:
+        return deferredBatches_;
+    case PipelineBatchTarget::Base:
+        return baseBatches_;
+    case PipelineBatchTarget::Light:
+        return lightBatches_;
+    case PipelineBatchTarget::NegativeLight:
+    default:
+        return negativeLightBatches_;
+    }
 }
 
 void BatchCompositorPass::ProcessGeometryBatch(const GeometryBatch& geometryBatch)
 {
     // Skip invalid batches. It may happen if UpdateGeometry removed some source batches.
-    PipelineBatchDesc desc(geometryBatch.drawable_, geometryBatch.sourceBatchIndex_, geometryBatch.deferredPass_);
-    if (!desc.geometry_)
+    const SourceBatch& sourceBatch = geometryBatch.drawable_->GetBatches()[geometryBatch.sourceBatchIndex_];
+    if (!sourceBatch.geometry_)
         return;
 
-    if (!desc.material_)
-        desc.material_ = defaultMaterial_;
+    Material* material = sourceBatch.material_ ? sourceBatch.material_.Get() : defaultMaterial_;
+    const unsigned drawableIndex = geometryBatch.drawable_->GetDrawableIndex();
+    const unsigned lightingHash = geometryBatch.lightPass_ ? CalculateLightingHash(drawableIndex) : 0;
+
+    // Reuse batches from previous frame if nothing changed.
+    // Distance and lightmap are not a part of the key and may change every frame.
+    CachedGeometryBatch& cachedBatch = batchCache_[drawableIndex][geometryBatch.sourceBatchIndex_];
+    cachedBatch.lastUsedFrame_ = currentFrame_;
+    if (cachedBatch.IsValid(geometryBatch, sourceBatch, material, lightingHash))
+    {
+        for (const auto& [target, cachedPipelineBatch] : cachedBatch.batches_)
+        {
+            PipelineBatch& pipelineBatch = GetBatches(target).Emplace(cachedPipelineBatch);
+            pipelineBatch.distance_ = sourceBatch.distance_;
+            pipelineBatch.lightmapIndex_ = sourceBatch.lightmapIndex_;
+        }
+        numBatchCacheHits_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    numBatchCacheMisses_.fetch_add(1, std::memory_order_relaxed);
+    cachedBatch.Reset(geometryBatch, sourceBatch, material, lightingHash);
+
+    PipelineBatchDesc desc(geometryBatch.drawable_, geometryBatch.sourceBatchIndex_, geometryBatch.deferredPass_);
+    desc.material_ = material;
 
     // Always add deferred batch if possible.
     if (desc.pass_)
     {
-        AddPipelineBatch(desc, deferredCache_, deferredBatches_, delayedDeferredBatches_);
+        AddPipelineBatch(PipelineBatchTarget::Deferred, desc, deferredCache_, delayedDeferredBatches_, cachedBatch);
         return;
     }
 
@@ -132,7 +311,6 @@ void BatchCompositorPass::ProcessGeometryBatch(const GeometryBatch& geometryBatc
     unsigned litBaseLightIndex = M_MAX_UNSIGNED;
     if (geometryBatch.lightPass_)
     {
-        const unsigned drawableIndex = desc.drawable_->GetDrawableIndex();
         const LightAccumulator& lightAccumulator = drawableProcessor_->GetGeometryLighting(drawableIndex);
         const auto pixelLights = lightAccumulator.GetPixelLights();
 
@@ -155,9 +333,12 @@ void BatchCompositorPass::ProcessGeometryBatch(const GeometryBatch& geometryBatc
             desc.InitializeLitBatch(lightProcessor, lightIndex, lightProcessor->GetForwardLitHash());
 
             if (lightProcessor->GetLight()->IsNegative())
-                AddPipelineBatch(desc, lightCache_, negativeLightBatches_, delayedNegativeLightBatches_);
+            {
+                AddPipelineBatch(PipelineBatchTarget::NegativeLight, desc, lightCache_,
+                    delayedNegativeLightBatches_, cachedBatch);
+            }
             else
-                AddPipelineBatch(desc, lightCache_, lightBatches_, delayedLightBatches_);
+                AddPipelineBatch(PipelineBatchTarget::Light, desc, lightCache_, delayedLightBatches_, cachedBatch);
         }
 
         // Initialize vertex lights after all light batches
@@ -170,13 +351,13 @@ void BatchCompositorPass::ProcessGeometryBatch(const GeometryBatch& geometryBatc
         LightProcessor* light = drawableProcessor_->GetLightProcessor(litBaseLightIndex);
         desc.InitializeLitBatch(light, litBaseLightIndex, light->GetForwardLitHash());
         desc.pass_ = geometryBatch.litBasePass_;
-        AddPipelineBatch(desc, litBaseCache_, baseBatches_, delayedLitBaseBatches_);
+        AddPipelineBatch(PipelineBatchTarget::Base, desc, litBaseCache_, delayedLitBaseBatches_, cachedBatch);
     }
     else
     {
         desc.InitializeLitBatch(nullptr, M_MAX_UNSIGNED, 0);
         desc.pass_ = geometryBatch.unlitBasePass_;
-        AddPipelineBatch(desc, unlitBaseCache_, baseBatches_, delayedUnlitBaseBatches_);
+        AddPipelineBatch(PipelineBatchTarget::Base, desc, unlitBaseCache_, delayedUnlitBaseBatches_, cachedBatch);
     }
 }
 
@@ -38,6 +38,7 @@ class LightProcessor;
 class Material;
 class Pass;
 class PipelineState;
+class RenderPipelineDebugger;
 class ShadowSplitProcessor;
 class WorkQueue;
 struct PipelineBatchByState;
@@ -132,6 +133,54 @@ struct PipelineBatchDesc : public PipelineBatch
     }
 };
 
+/// Destination list of PipelineBatch within BatchCompositorPass.
+enum class PipelineBatchTarget
+{
+    Deferred,
+    Base,
+    Light,
+    NegativeLight
+};
+
+/// Pipeline batches composed from single GeometryBatch.
+/// Batches are reused on the next frames as long as all inputs of batch composition are the same.
+struct URHO3D_API CachedGeometryBatch
+{
+    /// Inputs of batch composition
+    /// @{
+    Drawable* drawable_{};
+    Geometry* geometry_{};
+    Material* material_{};
+    Pass* deferredPass_{};
+    Pass* unlitBasePass_{};
+    Pass* litBasePass_{};
+    Pass* lightPass_{};
+    GeometryType geometryType_{};
+    unsigned drawableHash_{};
+    unsigned geometryHash_{};
+    unsigned materialHash_{};
+    unsigned deferredPassHash_{};
+    unsigned unlitBasePassHash_{};
+    unsigned litBasePassHash_{};
+    unsigned lightPassHash_{};
+    unsigned lightingHash_{};
+    /// @}
+
+    /// Whether all pipeline batches were resolved. Incomplete entries are never reused.
+    bool isComplete_{};
+    /// Frame number when entry was used last time.
+    unsigned lastUsedFrame_{};
+    /// Composed batches.
+    ea::vector<ea::pair<PipelineBatchTarget, PipelineBatch>> batches_;
+
+    /// Return whether the batches were composed from the same inputs.
+    bool IsValid(const GeometryBatch& geometryBatch, const SourceBatch& sourceBatch,
+        Material* material, unsigned lightingHash) const;
+    /// Remember new inputs and discard composed batches.
+    void Reset(const GeometryBatch& geometryBatch, const SourceBatch& sourceBatch,
+        Material* material, unsigned lightingHash);
+};
+
 /// Batch compositor for single scene pass.
 class URHO3D_API BatchCompositorPass : public DrawableProcessorPass
 {
@@ -151,6 +200,11 @@ public:
             || lightBatches_.Size() > 0;
         }
 
+    /// Return number of geometry batches reused from cache in current frame.
+    unsigned GetNumBatchCacheHits() const { return numBatchCacheHits_.load(std::memory_order_relaxed); }
+    /// Return number of geometry batches composed from scratch in current frame.
+    unsigned GetNumBatchCacheMisses() const { return numBatchCacheMisses_.load(std::memory_order_relaxed); }
+
 protected:
     /// Callbacks from RenderPipeline
     /// @{
@@ -167,6 +221,7 @@ protected:
     Material* defaultMaterial_{};
     DrawableProcessor* drawableProcessor_{};
     BatchStateCacheCallback* batchStateCacheCallback_{};
+    RenderPipelineDebugger* debugger_{};
     /// @}
 
     WorkQueueVector<PipelineBatch> deferredBatches_;
@@ -177,6 +232,13 @@ protected:
 private:
     bool PreparePipelineBatch(PipelineBatchDesc& key, const GeometryBatch& geometryBatch) const;
 
+    void PrepareBatchCache();
+    unsigned CalculateLightingHash(unsigned drawableIndex) const;
+    void EvictUnusedCachedBatches();
+    void AddPipelineBatch(PipelineBatchTarget target, const PipelineBatchDesc& desc, BatchStateCache& cache,
+        WorkQueueVector<PipelineBatchDesc>& delayedBatches, CachedGeometryBatch& cachedBatch);
+    WorkQueueVector<PipelineBatch>& GetBatches(PipelineBatchTarget target);
+
     void ProcessGeometryBatch(const GeometryBatch& geometryBatch);
     void ResolveDelayedBatches(BatchCompositorSubpass subpass, const WorkQueueVector<PipelineBatchDesc>& delayedBatches,
         BatchStateCache& cache, WorkQueueVector<PipelineBatch>& batches);
@@ -197,6 +259,16 @@ private:
     WorkQueueVector<PipelineBatchDesc> delayedLightBatches_;
     WorkQueueVector<PipelineBatchDesc> delayedNegativeLightBatches_;
     /// @}
+
+    /// Cached batches indexed by drawable index and source batch index.
+    ea::vector<ea::vector<CachedGeometryBatch>> batchCache_;
+    /// Current frame number.
+    unsigned currentFrame_{};
+    /// Batch cache statistics for current frame
+    /// @{
+    std::atomic<unsigned> numBatchCacheHits_{};
+    std::atomic<unsigned> numBatchCacheMisses_{};
+    /// @}
 };
 
 /// Batch composition manager.
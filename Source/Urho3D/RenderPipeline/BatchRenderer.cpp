@@ -23,6 +23,7 @@
 #include "../Precompiled.h"
 
 #include "../Core/Context.h"
+#include "../Core/WorkQueue.h"
 #include "../Graphics/Camera.h"
 #include "../Graphics/DrawCommandQueue.h"
 #include "../Graphics/Graphics.h"
@@ -134,8 +135,13 @@ public:
     /// Whether the batch should be processed using instancing.
     bool IsBatchInstanced(const PipelineBatch& pipelineBatch) const
     {
-        return instancingEnabled_
-            && pipelineBatch.geometry_->IsInstanced(pipelineBatch.geometryType_);
+        return BatchRenderer::IsBatchInstanced(pipelineBatch, instancingEnabled_);
+    }
+
+    /// Return number of instances used by the batch in instancing buffer.
+    unsigned GetNumInstancesInBuffer(const PipelineBatch& pipelineBatch) const
+    {
+        return BatchRenderer::GetNumInstancesInBuffer(pipelineBatch, instancingEnabled_);
     }
 
     /// Set batch ambient lighting.
@@ -155,18 +161,16 @@ public:
         }
     }
 
-    /// Add uniforms to instancing buffer for instanced batches.
-    void AddBatchesToInstancingBuffer(InstancingBuffer& instancingBuffer,
-        const SourceBatch& sourceBatch, unsigned instanceIndex)
+    /// Store uniforms of instanced batch in instancing buffer.
+    void StoreInstanceData(unsigned char* instanceData, const SourceBatch& sourceBatch, unsigned instanceIndex) const
     {
-        instancingBuffer.AddInstance();
-        instancingBuffer.SetElements(&sourceBatch.worldTransform_[instanceIndex], 0, 3);
+        InstancingBuffer::SetElements(instanceData, &sourceBatch.worldTransform_[instanceIndex], 0, 3);
         if (ambientEnabled_)
         {
             if (ambientMode_ == DrawableAmbientMode::Flat)
-                instancingBuffer.SetElements(&ambientValueFlat_, 3, 1);
+                InstancingBuffer::SetElements(instanceData, &ambientValueFlat_, 3, 1);
             else if (ambientMode_ == DrawableAmbientMode::Directional)
-                instancingBuffer.SetElements(ambientValueSH_, 3, 7);
+                InstancingBuffer::SetElements(instanceData, ambientValueSH_, 3, 7);
         }
     }
 
@@ -647,8 +651,7 @@ private:
             CheckDirtyLightmap(sourceBatch);
         }
 
-        const unsigned numBatchInstances = pipelineBatch.geometryType_ == GEOM_STATIC
-            ? sourceBatch.numWorldTransforms_ : 1u;
+        const unsigned numBatchInstances = BatchRenderer::GetNumBatchInstances(pipelineBatch);
 
         const bool resetInstancingGroup = instancingGroup_.count_ == 0 || dirty_.IsAnythingDirty();
         if constexpr (DebuggerEnabled)
@@ -820,9 +823,21 @@ BatchRenderingContext::BatchRenderingContext(DrawCommandQueue& drawQueue, const
 {
 }
 
+BatchRenderingContext::BatchRenderingContext(DrawCommandQueue& drawQueue, const BatchRenderingContext& other)
+    : drawQueue_(drawQueue)
+    , camera_(other.camera_)
+    , outputShadowSplit_(other.outputShadowSplit_)
+    , globalResources_(other.globalResources_)
+    , frameParameters_(other.frameParameters_)
+    , cameraParameters_(other.cameraParameters_)
+{
+}
+
 BatchRenderer::BatchRenderer(RenderPipelineInterface* renderPipeline, const DrawableProcessor* drawableProcessor,
     InstancingBuffer* instancingBuffer)
     : Object(renderPipeline->GetContext())
+    , workQueue_(context_->GetSubsystem<WorkQueue>())
+    , graphics_(context_->GetSubsystem<Graphics>())
     , renderer_(context_->GetSubsystem<Renderer>())
     , debugger_(renderPipeline->GetDebugger())
     , drawableProcessor_(drawableProcessor)
@@ -837,46 +852,12 @@ void BatchRenderer::SetSettings(const BatchRendererSettings& settings)
 
 void BatchRenderer::RenderBatches(const BatchRenderingContext& ctx, PipelineBatchGroup<PipelineBatchByState> batchGroup)
 {
-    batchGroup.flags_ = AdjustRenderFlags(batchGroup.flags_);
-
-    if (RenderPipelineDebugger::IsSnapshotInProgress(debugger_))
-    {
-        DrawCommandCompositor<true> compositor(ctx, settings_, debugger_,
-            *drawableProcessor_, *instancingBuffer_, batchGroup.flags_, batchGroup.startInstance_);
-        for (const auto& sortedBatch : batchGroup.batches_)
-            compositor.ProcessSceneBatch(*sortedBatch.pipelineBatch_);
-        compositor.FlushDrawCommands(batchGroup.startInstance_ + batchGroup.numInstances_);
-    }
-    else
-    {
-        DrawCommandCompositor<false> compositor(ctx, settings_, nullptr,
-            *drawableProcessor_, *instancingBuffer_, batchGroup.flags_, batchGroup.startInstance_);
-        for (const auto& sortedBatch : batchGroup.batches_)
-            compositor.ProcessSceneBatch(*sortedBatch.pipelineBatch_);
-        compositor.FlushDrawCommands(batchGroup.startInstance_ + batchGroup.numInstances_);
-    }
+    RenderBatchesImpl(ctx, batchGroup);
 }
 
 void BatchRenderer::RenderBatches(const BatchRenderingContext& ctx, PipelineBatchGroup<PipelineBatchBackToFront> batchGroup)
 {
-    batchGroup.flags_ = AdjustRenderFlags(batchGroup.flags_);
-
-    if (RenderPipelineDebugger::IsSnapshotInProgress(debugger_))
-    {
-        DrawCommandCompositor<true> compositor(ctx, settings_, debugger_,
-            *drawableProcessor_, *instancingBuffer_, batchGroup.flags_, batchGroup.startInstance_);
-        for (const auto& sortedBatch : batchGroup.batches_)
-            compositor.ProcessSceneBatch(*sortedBatch.pipelineBatch_);
-        compositor.FlushDrawCommands(batchGroup.startInstance_ + batchGroup.numInstances_);
-    }
-    else
-    {
-        DrawCommandCompositor<false> compositor(ctx, settings_, nullptr,
-            *drawableProcessor_, *instancingBuffer_, batchGroup.flags_, batchGroup.startInstance_);
-        for (const auto& sortedBatch : batchGroup.batches_)
-            compositor.ProcessSceneBatch(*sortedBatch.pipelineBatch_);
-        compositor.FlushDrawCommands(batchGroup.startInstance_ + batchGroup.numInstances_);
-    }
+    RenderBatchesImpl(ctx, batchGroup);
 }
 
 void BatchRenderer::RenderLightVolumeBatches(const BatchRenderingContext& ctx,
@@ -910,6 +891,66 @@ void BatchRenderer::PrepareInstancingBuffer(PipelineBatchGroup<PipelineBatchBack
     PrepareInstancingBufferImpl(batches);
 }
 
+template <class T>
+void BatchRenderer::RenderBatchesImpl(const BatchRenderingContext& ctx, PipelineBatchGroup<T> batchGroup)
+{
+    batchGroup.flags_ = AdjustRenderFlags(batchGroup.flags_);
+
+    if (RenderPipelineDebugger::IsSnapshotInProgress(debugger_))
+    {
+        DrawCommandCompositor<true> compositor(ctx, settings_, debugger_,
+            *drawableProcessor_, *instancingBuffer_, batchGroup.flags_, batchGroup.startInstance_);
+        for (const auto& sortedBatch : batchGroup.batches_)
+            compositor.ProcessSceneBatch(*sortedBatch.pipelineBatch_);
+        compositor.FlushDrawCommands(batchGroup.startInstance_ + batchGroup.numInstances_);
+        return;
+    }
+
+    const unsigned numTasks = GetNumRecordingTasks(batchGroup.batches_.size());
+    if (numTasks <= 1)
+    {
+        DrawCommandCompositor<false> compositor(ctx, settings_, nullptr,
+            *drawableProcessor_, *instancingBuffer_, batchGroup.flags_, batchGroup.startInstance_);
+        for (const auto& sortedBatch : batchGroup.batches_)
+            compositor.ProcessSceneBatch(*sortedBatch.pipelineBatch_);
+        compositor.FlushDrawCommands(batchGroup.startInstance_ + batchGroup.numInstances_);
+        return;
+    }
+
+    // Find instances used by each task
+    const ObjectParameterBuilder objectParameterBuilder(settings_, batchGroup.flags_);
+    CalculateTaskInstanceOffsets(batchGroup.batches_, numTasks, [&](const PipelineBatch& pipelineBatch)
+    {
+        return objectParameterBuilder.GetNumInstancesInBuffer(pipelineBatch);
+    });
+
+    // Record draw commands into intermediate queues
+    while (taskDrawQueues_.size() < numTasks)
+        taskDrawQueues_.push_back(MakeShared<DrawCommandQueue>(graphics_));
+    for (unsigned taskIndex = 0; taskIndex < numTasks; ++taskIndex)
+        taskDrawQueues_[taskIndex]->Reset(ctx.drawQueue_);
+
+    ForEachParallel(workQueue_, 1u, numTasks, [&](unsigned beginTask, unsigned endTask)
+    {
+        for (unsigned taskIndex = beginTask; taskIndex < endTask; ++taskIndex)
+        {
+            const BatchRenderingContext taskCtx{ *taskDrawQueues_[taskIndex], ctx };
+            const unsigned startInstance = batchGroup.startInstance_ + taskInstanceOffsets_[taskIndex];
+            const unsigned endInstance = batchGroup.startInstance_ + taskInstanceOffsets_[taskIndex + 1];
+
+            DrawCommandCompositor<false> compositor(taskCtx, settings_, nullptr,
+                *drawableProcessor_, *instancingBuffer_, batchGroup.flags_, startInstance);
+            for (const auto& sortedBatch : GetTaskBatches(batchGroup.batches_, numTasks, taskIndex))
+                compositor.ProcessSceneBatch(*sortedBatch.pipelineBatch_);
+            compositor.FlushDrawCommands(endInstance);
+        }
+    });
+
+    // Merge queues in order
+    for (unsigned taskIndex = 0; taskIndex < numTasks; ++taskIndex)
+        ctx.drawQueue_.Append(*taskDrawQueues_[taskIndex]);
+}
+
 template <class T>
 void BatchRenderer::PrepareInstancingBufferImpl(PipelineBatchGroup<T>& batches)
 {
@@ -917,28 +958,110 @@ void BatchRenderer::PrepareInstancingBufferImpl(PipelineBatchGroup<T>& batches)
     batches.startInstance_ = 0;
     batches.numInstances_ = 0;
 
-    ObjectParameterBuilder objectParameterBuilder(settings_, batches.flags_);
+    const ObjectParameterBuilder objectParameterBuilder(settings_, batches.flags_);
     if (!objectParameterBuilder.IsInstancingSupported())
         return;
 
-    batches.startInstance_ = instancingBuffer_->GetNextInstanceIndex();
-    for (const T& sortedBatch : batches.batches_)
+    // Allocate continuous region of instancing buffer for each task
+    const unsigned numTasks = GetNumRecordingTasks(batches.batches_.size());
+    const unsigned numInstances = CalculateTaskInstanceOffsets(batches.batches_, numTasks,
+        [&](const PipelineBatch& pipelineBatch)
+    {
+        return objectParameterBuilder.GetNumInstancesInBuffer(pipelineBatch);
+    });
+
+    const auto indexAndData = instancingBuffer_->AddInstances(numInstances);
+    const unsigned instanceStride = instancingBuffer_->GetInstanceStride();
+    batches.startInstance_ = indexAndData.first;
+    batches.numInstances_ = numInstances;
+
+    ForEachParallel(workQueue_, 1u, numTasks, [&](unsigned beginTask, unsigned endTask)
     {
-        const PipelineBatch& pipelineBatch = *sortedBatch.pipelineBatch_;
-        if (!objectParameterBuilder.IsBatchInstanced(pipelineBatch))
-            continue;
+        ObjectParameterBuilder taskParameterBuilder(settings_, batches.flags_);
+        for (unsigned taskIndex = beginTask; taskIndex < endTask; ++taskIndex)
+        {
+            unsigned char* instanceData = indexAndData.second + taskInstanceOffsets_[taskIndex] * instanceStride;
+            for (const T& sortedBatch : GetTaskBatches(batches.batches_, numTasks, taskIndex))
+            {
+                const PipelineBatch& pipelineBatch = *sortedBatch.pipelineBatch_;
+                if (!taskParameterBuilder.IsBatchInstanced(pipelineBatch))
+                    continue;
+
+                const SourceBatch& sourceBatch = pipelineBatch.GetSourceBatch();
+                if (taskParameterBuilder.IsAmbientEnabled())
+                {
+                    const LightAccumulator& lightAccumulator = drawableProcessor_->GetGeometryLighting(pipelineBatch.drawableIndex_);
+                    taskParameterBuilder.SetBatchAmbient(lightAccumulator);
+                }
+
+                const unsigned numBatchInstances = GetNumBatchInstances(pipelineBatch);
+                for (unsigned i = 0; i < numBatchInstances; ++i)
+                {
+                    taskParameterBuilder.StoreInstanceData(instanceData, sourceBatch, i);
+                    instanceData += instanceStride;
+                }
+            }
+        }
+    });
+}
+
+bool BatchRenderer::IsBatchInstanced(const PipelineBatch& pipelineBatch, bool instancingEnabled)
+{
+    return instancingEnabled && pipelineBatch.geometry_->IsInstanced(pipelineBatch.geometryType_);
+}
+
+unsigned BatchRenderer::GetNumBatchInstances(const PipelineBatch& pipelineBatch)
+{
+    // Only static geometry is drawn once per world transform
+    return pipelineBatch.geometryType_ == GEOM_STATIC ? pipelineBatch.GetSourceBatch().numWorldTransforms_ : 1u;
+}
+
+unsigned BatchRenderer::GetNumInstancesInBuffer(const PipelineBatch& pipelineBatch, bool instancingEnabled)
+{
+    return IsBatchInstanced(pipelineBatch, instancingEnabled) ? GetNumBatchInstances(pipelineBatch) : 0u;
+}
+
+template <class T, class Callback>
+unsigned BatchRenderer::CalculateTaskInstanceOffsets(ea::span<const T> batches, unsigned numTasks,
+    const Callback& getNumInstances)
+{
+    taskInstanceOffsets_.resize(numTasks + 1);
+    taskInstanceOffsets_[0] = 0;
 
-        const SourceBatch& sourceBatch = pipelineBatch.GetSourceBatch();
-        if (objectParameterBuilder.IsAmbientEnabled())
+    ForEachParallel(workQueue_, 1u, numTasks, [&](unsigned beginTask, unsigned endTask)
+    {
+        for (unsigned taskIndex = beginTask; taskIndex < endTask; ++taskIndex)
         {
-            const LightAccumulator& lightAccumulator = drawableProcessor_->GetGeometryLighting(pipelineBatch.drawableIndex_);
-            objectParameterBuilder.SetBatchAmbient(lightAccumulator);
+            unsigned numInstances = 0;
+            for (const T& sortedBatch : GetTaskBatches(batches, numTasks, taskIndex))
+                numInstances += getNumInstances(*sortedBatch.pipelineBatch_);
+            taskInstanceOffsets_[taskIndex + 1] = numInstances;
         }
+    });
 
-        for (unsigned i = 0; i < sourceBatch.numWorldTransforms_; ++i)
-            objectParameterBuilder.AddBatchesToInstancingBuffer(*instancingBuffer_, sourceBatch, i);
-        batches.numInstances_ += sourceBatch.numWorldTransforms_;
-    }
+    for (unsigned taskIndex = 1; taskIndex <= numTasks; ++taskIndex)
+        taskInstanceOffsets_[taskIndex] += taskInstanceOffsets_[taskIndex - 1];
+    return taskInstanceOffsets_[numTasks];
+}
+
+template <class T>
+ea::span<const T> BatchRenderer::GetTaskBatches(ea::span<const T> batches, unsigned numTasks, unsigned taskIndex) const
+{
+    if (numTasks <= 1)
+        return batches;
+
+    const unsigned batchesPerTask = settings_.numBatchesPerRecordingTask_;
+    const unsigned beginIndex = taskIndex * batchesPerTask;
+    const unsigned endIndex = ea::min<unsigned>(beginIndex + batchesPerTask, batches.size());
+    return batches.subspan(beginIndex, endIndex - beginIndex);
+}
+
+unsigned BatchRenderer::GetNumRecordingTasks(unsigned numBatches) const
+{
+    const unsigned batchesPerTask = settings_.numBatchesPerRecordingTask_;
+    if (batchesPerTask == 0 || numBatches <= batchesPerTask || RenderPipelineDebugger::IsSnapshotInProgress(debugger_))
+        return 1;
+    return (numBatches + batchesPerTask - 1) / batchesPerTask;
 }
 
 BatchRenderFlags BatchRenderer::AdjustRenderFlags(BatchRenderFlags flags) const
@@ -35,8 +35,10 @@ namespace Urho3D
 
 class Camera;
 class DrawableProcessor;
+class Graphics;
 class InstancingBuffer;
 class ShadowSplitProcessor;
+class WorkQueue;
 
 /// Common parameters of batch rendering
 struct BatchRenderingContext
@@ -51,6 +53,8 @@ struct BatchRenderingContext
 
     BatchRenderingContext(DrawCommandQueue& drawQueue, const Camera& camera);
     BatchRenderingContext(DrawCommandQueue& drawQueue, const ShadowSplitProcessor& outputShadowSplit);
+    /// Construct with the same parameters as other context but different draw queue.
+    BatchRenderingContext(DrawCommandQueue& drawQueue, const BatchRenderingContext& other);
 };
 
 /// Utility class to convert pipeline batches into sequence of draw commands.
@@ -77,13 +81,33 @@ public:
     void PrepareInstancingBuffer(PipelineBatchGroup<PipelineBatchBackToFront>& batches);
     /// @}
 
+    /// Instance accounting shared by instancing buffer preparation and draw command recording.
+    /// @{
+    static bool IsBatchInstanced(const PipelineBatch& pipelineBatch, bool instancingEnabled);
+    static unsigned GetNumBatchInstances(const PipelineBatch& pipelineBatch);
+    static unsigned GetNumInstancesInBuffer(const PipelineBatch& pipelineBatch, bool instancingEnabled);
+    /// @}
+
 private:
+    template <class T>
+    void RenderBatchesImpl(const BatchRenderingContext& ctx, PipelineBatchGroup<T> batchGroup);
     template <class T>
     void PrepareInstancingBufferImpl(PipelineBatchGroup<T>& batches);
     BatchRenderFlags AdjustRenderFlags(BatchRenderFlags flags) const;
 
+    /// Draw commands and instancing data are prepared in multiple tasks, each for continuous range of batches.
+    /// @{
+    unsigned GetNumRecordingTasks(unsigned numBatches) const;
+    template <class T>
+    ea::span<const T> GetTaskBatches(ea::span<const T> batches, unsigned numTasks, unsigned taskIndex) const;
+    template <class T, class Callback>
+    unsigned CalculateTaskInstanceOffsets(ea::span<const T> batches, unsigned numTasks, const Callback& getNumInstances);
+    /// @}
+
     /// External dependencies
     /// @{
+    WorkQueue* workQueue_{};
+    Graphics* graphics_{};
     Renderer* renderer_{};
     RenderPipelineDebugger* debugger_{};
     const DrawableProcessor* drawableProcessor_{};
@@ -91,6 +115,11 @@ private:
     /// @}
 
     BatchRendererSettings settings_;
+
+    /// Per-task draw queues merged into output queue after recording.
+    ea::vector<SharedPtr<DrawCommandQueue>> taskDrawQueues_;
+    /// Index of the first instance used by each task, relative to batch group.
+    ea::vector<unsigned> taskInstanceOffsets_;
 };
 
 }
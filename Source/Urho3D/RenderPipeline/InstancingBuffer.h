@@ -58,15 +58,26 @@ public:
         return indexAndData.first;
     }
 
+    /// Add multiple instances to buffer.
+    /// Returns index of the first instance and writeable data that may be filled from any thread.
+    ea::pair<unsigned, unsigned char*> AddInstances(unsigned count) { return vertexBuffer_->AddVertices(count); }
+
     /// Set one or more 4-float elements in current instance.
     void SetElements(const void* data, unsigned index, unsigned count)
     {
-        memcpy(currentInstanceData_ + index * ElementStride, data, count * ElementStride);
+        SetElements(currentInstanceData_, data, index, count);
+    }
+
+    /// Set one or more 4-float elements in specified instance.
+    static void SetElements(unsigned char* instanceData, const void* data, unsigned index, unsigned count)
+    {
+        memcpy(instanceData + index * ElementStride, data, count * ElementStride);
     }
 
     /// Getters
     /// @{
     const InstancingBufferSettings& GetSettings() const { return settings_; }
+    unsigned GetInstanceStride() const { return settings_.numInstancingTexCoords_ * ElementStride; }
     VertexBuffer* GetVertexBuffer() const { return vertexBuffer_->GetVertexBuffer(); }
     bool IsEnabled() const { return settings_.enableInstancing_; }
     /// @}
@@ -286,7 +286,7 @@ void LightProcessor::EndUpdate(DrawableProcessor* drawableProcessor,
     // Allocate shadow map
     if (numActiveSplits_ > 0)
     {
-        shadowMap_ = callback->AllocateTransientShadowMap(shadowMapSize_);
+        shadowMap_ = callback->AllocatePersistentShadowMap(this, shadowMapSize_);
         if (!shadowMap_)
             numActiveSplits_ = 0;
         else
@@ -127,6 +127,17 @@ struct PipelineBatchByState
             return primaryKey_ < rhs.primaryKey_;
         return secondaryKey_ < rhs.secondaryKey_;
     }
+
+    /// Number of bytes in combined sorting key.
+    static constexpr unsigned NumSortKeyBytes = 16;
+
+    /// Return byte of combined sorting key for radix sort, starting from the least significant byte.
+    static unsigned char GetSortKeyByte(const PipelineBatchByState& batch, unsigned byteIndex)
+    {
+        return byteIndex < 8
+            ? static_cast<unsigned char>(batch.secondaryKey_ >> (byteIndex * 8))
+            : static_cast<unsigned char>(batch.primaryKey_ >> ((byteIndex - 8) * 8));
+    }
 };
 
 /// Pipeline batch sorted by render order and back to front.
@@ -157,6 +168,24 @@ struct PipelineBatchBackToFront
             return renderOrder_ < rhs.renderOrder_;
         return distance_ > rhs.distance_;
     }
+
+    /// Number of bytes in combined sorting key.
+    static constexpr unsigned NumSortKeyBytes = 5;
+
+    /// Return combined sorting key. Distance is mapped to unsigned integer with reversed order.
+    unsigned long long GetSortKey() const
+    {
+        // Flip all bits of negative numbers and sign bit of positive numbers to get monotonic mapping
+        const unsigned distanceBits = FloatToRawIntBits(distance_);
+        const unsigned distanceKey = distanceBits & 0x80000000u ? ~distanceBits : distanceBits | 0x80000000u;
+        return (static_cast<unsigned long long>(renderOrder_) << 32) | ~distanceKey;
+    }
+
+    /// Return byte of combined sorting key for radix sort, starting from the least significant byte.
+    static unsigned char GetSortKeyByte(const PipelineBatchBackToFront& batch, unsigned byteIndex)
+    {
+        return static_cast<unsigned char>(batch.GetSortKey() >> (byteIndex * 8));
+    }
 };
 
 /// Group of batches to be rendered.
@@ -145,6 +145,7 @@ ea::string DebugFrameSnapshot::ToString() const
     result += Format("Pipeline states in scene ({}): \n\n{}\n", scenePipelineStates_.size(), ScenePipelineStatesToString());
     result += Format("Materials in scene ({}): \n\n{}\n", sceneMaterials_.size(), SceneMaterialsToString());
     result += Format("Shaders in scene ({}): \n\n{}\n", sceneShaders_.size(), SceneShadersToString());
+    result += Format("Batch cache: {} hits, {} misses\n", numBatchCacheHits_, numBatchCacheMisses_);
     return result;
 }
 
@@ -224,6 +225,12 @@ void RenderPipelineDebugger::ReportQuad(ea::string_view debugComment, const IntV
     snapshot_.passes_.back().quads_.push_back(DebugFrameSnapshotQuad{ ea::string(debugComment), size });
 }
 
+void RenderPipelineDebugger::ReportBatchCacheStatistics(unsigned numHits, unsigned numMisses)
+{
+    snapshot_.numBatchCacheHits_ += numHits;
+    snapshot_.numBatchCacheMisses_ += numMisses;
+}
+
 void RenderPipelineDebugger::EndPass()
 {
     passInProgress_ = false;
@@ -82,6 +82,10 @@ struct URHO3D_API DebugFrameSnapshot
     ea::unordered_set<PipelineState*> scenePipelineStates_{};
     ea::unordered_set<Material*> sceneMaterials_{};
     ea::unordered_set<ShaderVariation*> sceneShaders_{};
+    /// Number of scene geometry batches reused from batch cache.
+    unsigned numBatchCacheHits_{};
+    /// Number of scene geometry batches composed from scratch.
+    unsigned numBatchCacheMisses_{};
 
     ea::string ToString() const;
     ea::string ScenePipelineStatesToString() const;
@@ -106,6 +110,7 @@ public:
     void BeginPass(ea::string_view name);
     void ReportSceneBatch(const DebugFrameSnapshotBatch& sceneBatch);
     void ReportQuad(ea::string_view debugComment, const IntVector2& size = IntVector2::ZERO);
+    void ReportBatchCacheStatistics(unsigned numHits, unsigned numMisses);
     void EndPass();
     /// @}
 
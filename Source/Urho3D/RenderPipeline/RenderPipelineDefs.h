@@ -263,6 +263,10 @@ struct ShadowMapRegion
     unsigned pageIndex_{};
     Texture2D* texture_;
     IntRect rect_;
+    /// Whether the region is kept allocated across frames.
+    bool isPersistent_{};
+    /// Whether the region contains shadow map rendered on previous frame.
+    bool isContentPreserved_{};
 
     /// Return whether the shadow map region is not empty.
     operator bool() const { return !!texture_; }
@@ -281,6 +285,9 @@ public:
     virtual unsigned GetShadowMapSize(Light* light, unsigned numActiveSplits) const = 0;
     /// Allocate shadow map for one frame.
     virtual ShadowMapRegion AllocateTransientShadowMap(const IntVector2& size) = 0;
+    /// Allocate shadow map that is kept across frames while it's requested by the owner on every frame.
+    /// May return transient shadow map if shadow map caching is disabled or not possible.
+    virtual ShadowMapRegion AllocatePersistentShadowMap(const void* owner, const IntVector2& size) = 0;
 };
 
 struct LightProcessorCacheSettings
@@ -391,6 +398,10 @@ struct BatchRendererSettings
     bool linearSpaceLighting_{};
     DrawableAmbientMode ambientMode_{ DrawableAmbientMode::Directional };
     Vector2 varianceShadowMapParams_{ 0.0000001f, 0.9f };
+    /// Draw commands for large batch groups are recorded in multiple threads, in chunks of this size.
+    /// Chunk size doesn't depend on number of threads, so recorded commands are the same on any machine.
+    /// Set to 0 to always record draw commands in main thread.
+    unsigned numBatchesPerRecordingTask_{ 2048 };
 
     /// Utility operators
     /// @{
@@ -410,7 +421,8 @@ struct BatchRendererSettings
     {
         return linearSpaceLighting_ == rhs.linearSpaceLighting_
             && ambientMode_ == rhs.ambientMode_
-            && varianceShadowMapParams_ == rhs.varianceShadowMapParams_;
+            && varianceShadowMapParams_ == rhs.varianceShadowMapParams_
+            && numBatchesPerRecordingTask_ == rhs.numBatchesPerRecordingTask_;
     }
 
     bool operator!=(const BatchRendererSettings& rhs) const { return !(*this == rhs); }
@@ -423,6 +435,8 @@ struct ShadowMapAllocatorSettings
     int varianceShadowMapMultiSample_{ 1 };
     bool use16bitShadowMaps_{};
     unsigned shadowAtlasPageSize_{ 2048 };
+    /// Whether to keep shadow maps of lights across frames and re-render them only when shadow casters change.
+    bool cacheShadowMaps_{};
 
     /// Utility operators
     /// @{
@@ -445,7 +459,8 @@ struct ShadowMapAllocatorSettings
         return enableVarianceShadowMaps_ == rhs.enableVarianceShadowMaps_
             && varianceShadowMapMultiSample_ == rhs.varianceShadowMapMultiSample_
             && use16bitShadowMaps_ == rhs.use16bitShadowMaps_
-            && shadowAtlasPageSize_ == rhs.shadowAtlasPageSize_;
+            && shadowAtlasPageSize_ == rhs.shadowAtlasPageSize_
+            && cacheShadowMaps_ == rhs.cacheShadowMaps_;
     }
 
     bool operator!=(const ShadowMapAllocatorSettings& rhs) const { return !(*this == rhs); }
@@ -22,6 +22,7 @@
 
 #include "../Precompiled.h"
 
+#include "../Container/RadixSort.h"
 #include "../Core/Context.h"
 #include "../Core/StringUtils.h"
 #include "../Graphics/Renderer.h"
@@ -36,6 +37,32 @@
 namespace Urho3D
 {
 
+namespace
+{
+
+/// Batches are sorted by comparison if there are too few of them for radix sort to pay off.
+const unsigned MinBatchesForRadixSort = 128;
+/// Batches are sorted in multiple threads only if each thread gets enough work.
+const unsigned MinBatchesPerSortThread = 2048;
+
+/// Sort range of batches. Order of batches with equal sort keys is preserved.
+template <class T>
+void SortBatches(WorkQueue* workQueue, ea::span<T> batches, ea::vector<T>& scratchBuffer)
+{
+    if (batches.size() < MinBatchesForRadixSort)
+    {
+        ea::stable_sort(batches.begin(), batches.end());
+        return;
+    }
+
+    if (scratchBuffer.size() < batches.size())
+        scratchBuffer.resize(batches.size());
+    RadixSortParallel(workQueue, MinBatchesPerSortThread, batches, ea::span<T>(scratchBuffer),
+        T::NumSortKeyBytes, &T::GetSortKeyByte);
+}
+
+}
+
 ScenePass::ScenePass(RenderPipelineInterface* renderPipeline, DrawableProcessor* drawableProcessor,
     BatchStateCacheCallback* callback, DrawableProcessorPassFlags flags, const ea::string& deferredPass,
     const ea::string& unlitBasePass, const ea::string& litBasePass, const ea::string& lightPass)
@@ -57,12 +84,14 @@ void UnorderedScenePass::OnBatchesReady()
     BatchCompositor::FillSortKeys(sortedBaseBatches_, baseBatches_);
     BatchCompositor::FillSortKeys(sortedLightBatches_, lightBatches_, negativeLightBatches_);
 
-    ea::sort(sortedDeferredBatches_.begin(), sortedDeferredBatches_.end());
-    ea::sort(sortedBaseBatches_.begin(), sortedBaseBatches_.end());
+    SortBatches<PipelineBatchByState>(workQueue_, sortedDeferredBatches_, sortScratchBuffer_);
+    SortBatches<PipelineBatchByState>(workQueue_, sortedBaseBatches_, sortScratchBuffer_);
 
     const unsigned numNegativeLightBatches = negativeLightBatches_.Size();
-    ea::sort(sortedLightBatches_.begin(), sortedLightBatches_.end() - numNegativeLightBatches);
-    ea::sort(sortedLightBatches_.end() - numNegativeLightBatches, sortedLightBatches_.end());
+    const unsigned numPositiveLightBatches = sortedLightBatches_.size() - numNegativeLightBatches;
+    const ea::span<PipelineBatchByState> lightBatches{sortedLightBatches_};
+    SortBatches(workQueue_, lightBatches.subspan(0, numPositiveLightBatches), sortScratchBuffer_);
+    SortBatches(workQueue_, lightBatches.subspan(numPositiveLightBatches), sortScratchBuffer_);
 
     deferredBatchGroup_ = { sortedDeferredBatches_ };
     baseBatchGroup_ = { sortedBaseBatches_ };
@@ -125,7 +154,7 @@ void BackToFrontScenePass::OnBatchesReady()
     for (unsigned i = substractiveLightBatchesBegin; i < substractiveLightBatchesEnd; ++i)
         sortedBatches_[i].distance_ *= substractiveDistanceFactor;
 
-    ea::sort(sortedBatches_.begin(), sortedBatches_.end());
+    SortBatches<PipelineBatchBackToFront>(workQueue_, sortedBatches_, sortScratchBuffer_);
 
     if (GetFlags().Test(DrawableProcessorPassFlag::RefractionPass))
     {
@@ -355,6 +355,10 @@ void SceneProcessor::RenderShadowMaps()
     {
         for (const ShadowSplitProcessor& split : sceneLight->GetSplits())
         {
+            // Shadow map from previous frame is still valid
+            if (split.IsShadowMapCached())
+                continue;
+
             if (RenderPipelineDebugger::IsSnapshotInProgress(debugger_))
             {
                 const ea::string passName = Format("ShadowMap.[{}].{}",
@@ -501,6 +505,11 @@ ShadowMapRegion SceneProcessor::AllocateTransientShadowMap(const IntVector2& siz
     return shadowMapAllocator_->AllocateShadowMap(size);
 }
 
+ShadowMapRegion SceneProcessor::AllocatePersistentShadowMap(const void* owner, const IntVector2& size)
+{
+    return shadowMapAllocator_->AllocatePersistentShadowMap(owner, size);
+}
+
 void SceneProcessor::DrawOccluders()
 {
     const auto& activeOccluders = drawableProcessor_->GetOccluders();
@@ -63,6 +63,10 @@ void ShadowMapAllocator::SetSettings(const ShadowMapAllocatorSettings& settings)
 
         dummyColorTexture_ = nullptr;
         pages_.clear();
+
+        persistentShadowMaps_.clear();
+        hasReleasedPersistentRegions_ = false;
+        resetPersistentPages_ = false;
     }
 }
 
@@ -82,29 +86,113 @@ void ShadowMapAllocator::CacheSettings()
 
 void ShadowMapAllocator::ResetAllShadowMaps()
 {
-    for (AtlasPage& element : pages_)
+    if (resetPersistentPages_)
     {
-        element.areaAllocator_.Reset(shadowAtlasPageSize_.x_, shadowAtlasPageSize_.y_, shadowAtlasPageSize_.x_, shadowAtlasPageSize_.y_);
-        element.clearBeforeRendering_ = false;
+        resetPersistentPages_ = false;
+        hasReleasedPersistentRegions_ = false;
+        persistentShadowMaps_.clear();
+        for (AtlasPage& page : pages_)
+        {
+            if (page.isPersistent_)
+                ResetPage(page);
+        }
+    }
+    else
+    {
+        // Release persistent shadow maps that were not used on previous frame.
+        // Released regions cannot be reused until persistent pages are reset.
+        for (auto iter = persistentShadowMaps_.begin(); iter != persistentShadowMaps_.end();)
+        {
+            if (!iter->second.isUsed_)
+            {
+                iter = persistentShadowMaps_.erase(iter);
+                hasReleasedPersistentRegions_ = true;
+            }
+            else
+            {
+                iter->second.isUsed_ = false;
+                ++iter;
+            }
+        }
+    }
+
+    for (AtlasPage& page : pages_)
+    {
+        if (!page.isPersistent_)
+            ResetPage(page);
     }
 }
 
 ShadowMapRegion ShadowMapAllocator::AllocateShadowMap(const IntVector2& size)
 {
-    if (!settings_.shadowAtlasPageSize_ || !shadowMapFormat_)
-        return {};
+    return AllocateRegion(size, false);
+}
+
+ShadowMapRegion ShadowMapAllocator::AllocatePersistentShadowMap(const void* owner, const IntVector2& size)
+{
+    if (!settings_.cacheShadowMaps_ || !settings_.shadowAtlasPageSize_ || !shadowMapFormat_)
+        return AllocateShadowMap(size);
 
     const IntVector2 clampedSize = VectorMin(size, shadowAtlasPageSize_);
 
-    for (AtlasPage& element : pages_)
+    // Reuse region from previous frame if possible
+    const auto iter = persistentShadowMaps_.find(owner);
+    if (iter != persistentShadowMaps_.end())
     {
-        const ShadowMapRegion shadowMap = element.AllocateRegion(clampedSize);
-        if (shadowMap)
-            return shadowMap;
+        PersistentShadowMap& shadowMap = iter->second;
+        if (shadowMap.isUsed_)
+            return AllocateShadowMap(size);
+
+        if (shadowMap.region_.rect_.Size() == clampedSize)
+        {
+            shadowMap.isUsed_ = true;
+
+            ShadowMapRegion region = shadowMap.region_;
+            region.isContentPreserved_ = true;
+            return region;
+        }
+
+        persistentShadowMaps_.erase(iter);
+        hasReleasedPersistentRegions_ = true;
     }
 
-    AllocatePage();
-    return pages_.back().AllocateRegion(clampedSize);
+    // Don't allocate new regions if persistent pages are going to be reset anyway
+    if (resetPersistentPages_)
+        return AllocateShadowMap(size);
+
+    // Try to allocate in existing pages first
+    ShadowMapRegion region;
+    for (AtlasPage& page : pages_)
+    {
+        if (page.isPersistent_)
+        {
+            region = page.AllocateRegion(clampedSize);
+            if (region)
+                break;
+        }
+    }
+
+    if (!region)
+    {
+        // Defragment persistent pages on the next frame if there are released regions
+        if (hasReleasedPersistentRegions_)
+        {
+            resetPersistentPages_ = true;
+            return AllocateShadowMap(size);
+        }
+
+        AllocatePage(true);
+        region = pages_.back().AllocateRegion(clampedSize);
+        if (!region)
+            return {};
+    }
+
+    region.isPersistent_ = true;
+
+    PersistentShadowMap& shadowMap = persistentShadowMaps_[owner];
+    shadowMap.region_ = region;
+    shadowMap.isUsed_ = true;
+    return region;
 }
 
 bool ShadowMapAllocator::BeginShadowMapRendering(const ShadowMapRegion& shadowMap)
@@ -135,8 +223,17 @@ bool ShadowMapAllocator::BeginShadowMapRendering(const ShadowMapRegion& shadowMa
     for (unsigned i = 1; i < MAX_RENDERTARGETS; ++i)
         graphics_->SetRenderTarget(i, (RenderSurface*) nullptr);
 
+    // Clear only rendered region of persistent page, other regions are kept
+    if (shadowMap.isPersistent_)
+    {
+        graphics_->SetViewport(shadowMap.rect_);
+        ClearTargetFlags clearFlags = CLEAR_DEPTH;
+        if (settings_.enableVarianceShadowMaps_ || dummyColorTexture_)
+            clearFlags |= CLEAR_COLOR;
+        graphics_->Clear(clearFlags, Color::WHITE);
+    }
     // Clear whole texture if needed
-    if (poolElement.clearBeforeRendering_)
+    else if (poolElement.clearBeforeRendering_)
     {
         poolElement.clearBeforeRendering_ = false;
 
@@ -170,7 +267,34 @@ ShadowMapRegion ShadowMapAllocator::AtlasPage::AllocateRegion(const IntVector2&
     return {};
 }
 
-void ShadowMapAllocator::AllocatePage()
+ShadowMapRegion ShadowMapAllocator::AllocateRegion(const IntVector2& size, bool isPersistent)
+{
+    if (!settings_.shadowAtlasPageSize_ || !shadowMapFormat_)
+        return {};
+
+    const IntVector2 clampedSize = VectorMin(size, shadowAtlasPageSize_);
+
+    for (AtlasPage& element : pages_)
+    {
+        if (element.isPersistent_ != isPersistent)
+            continue;
+
+        const ShadowMapRegion shadowMap = element.AllocateRegion(clampedSize);
+        if (shadowMap)
+            return shadowMap;
+    }
+
+    AllocatePage(isPersistent);
+    return pages_.back().AllocateRegion(clampedSize);
+}
+
+void ShadowMapAllocator::ResetPage(AtlasPage& page)
+{
+    page.areaAllocator_.Reset(shadowAtlasPageSize_.x_, shadowAtlasPageSize_.y_, shadowAtlasPageSize_.x_, shadowAtlasPageSize_.y_);
+    page.clearBeforeRendering_ = false;
+}
+
+void ShadowMapAllocator::AllocatePage(bool isPersistent)
 {
     const bool isDepthTexture = !settings_.enableVarianceShadowMaps_;
     const TextureUsage textureUsage = isDepthTexture ? TEXTURE_DEPTHSTENCIL : TEXTURE_RENDERTARGET;
@@ -213,6 +337,7 @@ void ShadowMapAllocator::AllocatePage()
     AtlasPage& element = pages_.emplace_back();
     element.index_ = pages_.size() - 1;
     element.texture_ = newShadowMap;
+    element.isPersistent_ = isPersistent;
     element.areaAllocator_.Reset(shadowAtlasPageSize_.x_, shadowAtlasPageSize_.y_, shadowAtlasPageSize_.x_, shadowAtlasPageSize_.y_);
 }
 
@@ -29,6 +29,7 @@
 #include "../Graphics/Light.h"
 #include "../RenderPipeline/RenderPipelineDefs.h"
 
+#include <EASTL/unordered_map.h>
 #include <EASTL/vector.h>
 
 namespace Urho3D
@@ -49,6 +50,9 @@ public:
     void ResetAllShadowMaps();
     /// Allocate shadow map of given size. It is better to allocate from bigger to smaller sizes.
     ShadowMapRegion AllocateShadowMap(const IntVector2& size);
+    /// Allocate shadow map of given size that is kept across frames while it's requested by the owner on every frame.
+    /// Returns transient shadow map if there's no space left in persistent pages.
+    ShadowMapRegion AllocatePersistentShadowMap(const void* owner, const IntVector2& size);
     /// Begin shadow map rendering. Clears shadow map if necessary.
     bool BeginShadowMapRendering(const ShadowMapRegion& shadowMap);
 
@@ -61,13 +65,22 @@ private:
         SharedPtr<Texture2D> texture_;
         AreaAllocator areaAllocator_;
         bool clearBeforeRendering_{};
+        bool isPersistent_{};
 
         /// Allocate shadow map.
         ShadowMapRegion AllocateRegion(const IntVector2& size);
     };
 
+    struct PersistentShadowMap
+    {
+        ShadowMapRegion region_;
+        bool isUsed_{};
+    };
+
     void CacheSettings();
-    void AllocatePage();
+    void AllocatePage(bool isPersistent);
+    void ResetPage(AtlasPage& page);
+    ShadowMapRegion AllocateRegion(const IntVector2& size, bool isPersistent);
 
     /// External dependencies
     /// @{
@@ -85,6 +98,15 @@ private:
     /// Dummy color map for workaround, if needed.
     SharedPtr<Texture2D> dummyColorTexture_;
     ea::vector<AtlasPage> pages_;
+
+    /// Shadow maps kept across frames
+    /// @{
+    ea::unordered_map<const void*, PersistentShadowMap> persistentShadowMaps_;
+    /// Whether some of persistent pages have unused regions.
+    bool hasReleasedPersistentRegions_{};
+    /// Whether persistent pages should be reset on next frame.
+    bool resetPersistentPages_{};
+    /// @}
 };
 
 }
@@ -0,0 +1,92 @@
+//
+// Copyright (c) 2021-2022 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "../Precompiled.h"
+
+#include "../RenderPipeline/ShadowSplitCache.h"
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+void ShadowSplitCache::BeginFrame(const IntRect& region, bool isContentPreserved,
+    const Matrix3x4& view, const Matrix4& projection)
+{
+    ea::swap(previousState_, currentState_);
+
+    currentState_.hasData_ = true;
+    currentState_.region_ = region;
+    currentState_.view_ = view;
+    currentState_.projection_ = projection;
+    currentState_.casters_.clear();
+    currentState_.numDynamicCasters_ = 0;
+    currentState_.batchesHash_ = 0;
+    currentState_.numBatches_ = 0;
+
+    isContentPreserved_ = isContentPreserved;
+    isValid_ = false;
+}
+
+void ShadowSplitCache::AddCaster(const Drawable* drawable, unsigned long long revision, bool isDynamic)
+{
+    if (isDynamic)
+        ++currentState_.numDynamicCasters_;
+    else
+        currentState_.casters_.push_back({ drawable, revision });
+}
+
+void ShadowSplitCache::AddBatch(unsigned batchHash)
+{
+    // Batches may be sorted differently on every frame, so combine hashes in order-independent way
+    currentState_.batchesHash_ += batchHash;
+    ++currentState_.numBatches_;
+}
+
+void ShadowSplitCache::EndFrame()
+{
+    isValid_ = isContentPreserved_ && IsEquivalent(previousState_, currentState_);
+}
+
+void ShadowSplitCache::Invalidate()
+{
+    previousState_ = {};
+    currentState_ = {};
+    isContentPreserved_ = false;
+    isValid_ = false;
+}
+
+bool ShadowSplitCache::IsEquivalent(const SplitState& lhs, const SplitState& rhs) const
+{
+    // Dynamic casters are rendered on every frame, so previous content is never valid if there were any
+    return lhs.hasData_ && rhs.hasData_
+        && lhs.numDynamicCasters_ == 0 && rhs.numDynamicCasters_ == 0
+        && lhs.region_ == rhs.region_
+        && lhs.view_ == rhs.view_
+        && lhs.projection_ == rhs.projection_
+        && lhs.numBatches_ == rhs.numBatches_
+        && lhs.batchesHash_ == rhs.batchesHash_
+        && lhs.casters_ == rhs.casters_;
+}
+
+}
@@ -0,0 +1,97 @@
+//
+// Copyright (c) 2021-2022 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#pragma once
+
+#include "../Math/Matrix3x4.h"
+#include "../Math/Matrix4.h"
+#include "../Math/Rect.h"
+
+#include <EASTL/vector.h>
+
+namespace Urho3D
+{
+
+class Drawable;
+
+/// Shadow caster state used to validate cached shadow split.
+struct ShadowSplitCacheCaster
+{
+    const Drawable* drawable_{};
+    unsigned long long revision_{};
+
+    bool operator==(const ShadowSplitCacheCaster& rhs) const
+    {
+        return drawable_ == rhs.drawable_ && revision_ == rhs.revision_;
+    }
+    bool operator!=(const ShadowSplitCacheCaster& rhs) const { return !(*this == rhs); }
+};
+
+/// Tracks whether shadow split rendered on previous frame is still valid.
+/// Shadow casters are split into two layers:
+/// static casters are kept in cached shadow map until they are moved, added or removed;
+/// dynamic casters (e.g. geometries updated every frame) are never cached, and split is rendered on every frame.
+class URHO3D_API ShadowSplitCache
+{
+public:
+    /// Begin new frame of shadow split.
+    void BeginFrame(const IntRect& region, bool isContentPreserved, const Matrix3x4& view, const Matrix4& projection);
+    /// Add shadow caster.
+    void AddCaster(const Drawable* drawable, unsigned long long revision, bool isDynamic);
+    /// Add shadow batch hash. Order of batches doesn't matter.
+    void AddBatch(unsigned batchHash);
+    /// End frame and check if shadow split can be reused.
+    void EndFrame();
+    /// Invalidate cached state.
+    void Invalidate();
+
+    /// Return whether shadow split from previous frame is still valid and doesn't need rendering.
+    bool IsValid() const { return isValid_; }
+    /// Return number of casters on current frame.
+    /// @{
+    unsigned GetNumStaticCasters() const { return currentState_.casters_.size(); }
+    unsigned GetNumDynamicCasters() const { return currentState_.numDynamicCasters_; }
+    /// @}
+
+private:
+    struct SplitState
+    {
+        bool hasData_{};
+        IntRect region_;
+        Matrix3x4 view_;
+        Matrix4 projection_;
+        ea::vector<ShadowSplitCacheCaster> casters_;
+        unsigned numDynamicCasters_{};
+        unsigned batchesHash_{};
+        unsigned numBatches_{};
+    };
+
+    bool IsEquivalent(const SplitState& lhs, const SplitState& rhs) const;
+
+    SplitState previousState_;
+    SplitState currentState_;
+    bool isContentPreserved_{};
+    bool isValid_{};
+};
+
+}
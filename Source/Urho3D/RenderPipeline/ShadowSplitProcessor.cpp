@@ -366,6 +366,39 @@ void ShadowSplitProcessor::FinalizeShadowBatches()
     ea::sort(sortedShadowBatches_.begin(), sortedShadowBatches_.end());
     shadowBatches_ = { sortedShadowBatches_,
         BatchRenderFlag::EnableInstancingForStaticGeometry | BatchRenderFlag::DisableColorOutput };
+
+    UpdateShadowMapCache();
+}
+
+void ShadowSplitProcessor::UpdateShadowMapCache()
+{
+    if (!shadowMap_.isPersistent_)
+    {
+        shadowMapCache_.Invalidate();
+        return;
+    }
+
+    shadowMapCache_.BeginFrame(shadowMap_.rect_, shadowMap_.isContentPreserved_,
+        shadowCamera_->GetView(), shadowCamera_->GetProjection());
+
+    for (Drawable* drawable : shadowCasters_)
+    {
+        const bool isDynamic = drawable->GetUpdateGeometryType() != UPDATE_NONE;
+        shadowMapCache_.AddCaster(drawable, drawable->GetOctreeUpdateRevision(), isDynamic);
+    }
+
+    for (const PipelineBatch& batch : unsortedShadowBatches_)
+    {
+        unsigned hash = 0;
+        CombineHash(hash, MakeHash(batch.drawable_));
+        CombineHash(hash, MakeHash(batch.geometry_));
+        CombineHash(hash, MakeHash(batch.material_));
+        CombineHash(hash, MakeHash(batch.pipelineState_));
+        CombineHash(hash, batch.sourceBatchIndex_);
+        shadowMapCache_.AddBatch(hash);
+    }
+
+    shadowMapCache_.EndFrame();
 }
 
 }
@@ -26,6 +26,7 @@
 #include "../Math/NumericRange.h"
 #include "../RenderPipeline/RenderPipelineDefs.h"
 #include "../RenderPipeline/PipelineBatchSortKey.h"
+#include "../RenderPipeline/ShadowSplitCache.h"
 #include "../Scene/Node.h"
 
 #include <EASTL/vector.h>
@@ -85,6 +86,8 @@ public:
     Matrix4 GetWorldToShadowSpaceMatrix(float subPixelOffset) const;
     const ShadowMapRegion& GetShadowMap() const { return shadowMap_; }
     float GetShadowMapTexelSizeInWorldSpace() const { return shadowMapWorldSpaceTexelSize_; }
+    /// Return whether shadow map rendered on previous frame is still valid and split doesn't need rendering.
+    bool IsShadowMapCached() const { return shadowMapCache_.IsValid(); }
     const FloatRange& GetCascadeZRange() const { return cascadeZRange_; }
     Camera* GetShadowCamera() const { return shadowCamera_; }
     /// @}
@@ -100,6 +103,7 @@ private:
     BoundingBox GetSplitShadowBoundingBoxInLightSpace(
         DrawableProcessor* drawableProcessor, const ea::vector<Drawable*>& litGeometries) const;
     void AdjustDirectionalLightCamera(const BoundingBox& lightSpaceBoundingBox, float shadowMapSize);
+    void UpdateShadowMapCache();
 
     /// Immutable
     /// @{
@@ -130,6 +134,9 @@ private:
     ea::vector<PipelineBatchByState> sortedShadowBatches_;
     PipelineBatchGroup<PipelineBatchByState> shadowBatches_;
     /// @}
+
+    /// Validation of shadow map kept across frames.
+    ShadowSplitCache shadowMapCache_;
 };
 
 }
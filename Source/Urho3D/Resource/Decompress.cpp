@@ -22,10 +22,16 @@
 
 #include "../Precompiled.h"
 
+#include "../Core/Thread.h"
+#include "../Core/WorkQueue.h"
 #include "../Resource/Decompress.h"
 
 #include <cstdint>
 
+#ifdef URHO3D_SSE
+#include <emmintrin.h>
+#endif
+
 // ETC2 decompress
 typedef unsigned char uint8;
 typedef unsigned short uint16;
@@ -86,13 +92,9 @@ static int Unpack565(unsigned char const* packed, unsigned char* colour)
     return value;
 }
 
-static void DecompressColourDXT(unsigned char* rgba, void const* block, bool isDxt1)
+static void UnpackColourCodesDXT(unsigned char* codes, unsigned char const* bytes, bool isDxt1)
 {
-    // get the block bytes
-    auto const* bytes = reinterpret_cast< unsigned char const* >( block );
-
     // unpack the endpoints
-    unsigned char codes[16];
     int a = Unpack565(bytes, codes);
     int b = Unpack565(bytes + 2, codes + 4);
 
@@ -117,6 +119,16 @@ static void DecompressColourDXT(unsigned char* rgba, void const* block, bool isD
     // fill in alpha for the intermediate values
     codes[8 + 3] = 255;
     codes[12 + 3] = (unsigned char)((isDxt1 && a <= b) ? 0 : 255);
+}
+
+static void DecompressColourDXT(unsigned char* rgba, void const* block, bool isDxt1)
+{
+    // get the block bytes
+    auto const* bytes = reinterpret_cast< unsigned char const* >( block );
+
+    // unpack the palette
+    unsigned char codes[16];
+    UnpackColourCodesDXT(codes, bytes, isDxt1);
 
     // unpack the indices
     unsigned char indices[16];
@@ -160,15 +172,13 @@ static void DecompressAlphaDXT3(unsigned char* rgba, void const* block)
     }
 }
 
-static void DecompressAlphaDXT5(unsigned char* rgba, void const* block)
+static void UnpackAlphaCodesDXT5(unsigned char* codes, unsigned char const* bytes)
 {
     // get the two alpha values
-    auto const* bytes = reinterpret_cast< unsigned char const* >( block );
     int alpha0 = bytes[0];
     int alpha1 = bytes[1];
 
     // compare the values to build the codebook
-    unsigned char codes[8];
     codes[0] = (unsigned char)alpha0;
     codes[1] = (unsigned char)alpha1;
     if (alpha0 <= alpha1)
@@ -185,6 +195,15 @@ static void DecompressAlphaDXT5(unsigned char* rgba, void const* block)
         for (int i = 1; i < 7; ++i)
             codes[1 + i] = (unsigned char)(((7 - i) * alpha0 + i * alpha1) / 7);
     }
+}
+
+static void DecompressAlphaDXT5(unsigned char* rgba, void const* block)
+{
+    auto const* bytes = reinterpret_cast< unsigned char const* >( block );
+
+    // build the codebook
+    unsigned char codes[8];
+    UnpackAlphaCodesDXT5(codes, bytes);
 
     // decode the indices
     unsigned char indices[16];
@@ -281,6 +300,89 @@ void DecompressImageDXT(unsigned char* rgba, const void* blocks, int width, int
     }
 }
 
+/// Decompress DXT block to 4x4 RGBA pixels. Unlike DecompressDXT, colours are selected from the palette 4 pixels at once.
+static void DecompressBlockDXTFast(unsigned char* rgba, const unsigned char* block, CompressedFormat format)
+{
+    const unsigned char* colourBlock = format == CF_DXT1 ? block : block + 8;
+
+    alignas(16) unsigned char palette[16];
+    UnpackColourCodesDXT(palette, colourBlock, format == CF_DXT1);
+
+#ifdef URHO3D_SSE
+    // Each lane holds 2-bit index of its pixel in the row shifted to pixel position
+    const __m128i indexMask = _mm_setr_epi32(0x3, 0xc, 0x30, 0xc0);
+    const __m128i index1 = _mm_setr_epi32(0x1, 0x4, 0x10, 0x40);
+    const __m128i index2 = _mm_slli_epi32(index1, 1);
+    const __m128i index3 = _mm_or_si128(index1, index2);
+
+    const __m128i colours = _mm_load_si128(reinterpret_cast<const __m128i*>(palette));
+    const __m128i colour0 = _mm_shuffle_epi32(colours, _MM_SHUFFLE(0, 0, 0, 0));
+    const __m128i colour1 = _mm_shuffle_epi32(colours, _MM_SHUFFLE(1, 1, 1, 1));
+    const __m128i colour2 = _mm_shuffle_epi32(colours, _MM_SHUFFLE(2, 2, 2, 2));
+    const __m128i colour3 = _mm_shuffle_epi32(colours, _MM_SHUFFLE(3, 3, 3, 3));
+
+    for (int row = 0; row < 4; ++row)
+    {
+        const __m128i indices = _mm_and_si128(_mm_set1_epi32(colourBlock[4 + row]), indexMask);
+        __m128i result = _mm_and_si128(_mm_cmpeq_epi32(indices, _mm_setzero_si128()), colour0);
+        result = _mm_or_si128(result, _mm_and_si128(_mm_cmpeq_epi32(indices, index1), colour1));
+        result = _mm_or_si128(result, _mm_and_si128(_mm_cmpeq_epi32(indices, index2), colour2));
+        result = _mm_or_si128(result, _mm_and_si128(_mm_cmpeq_epi32(indices, index3), colour3));
+        _mm_store_si128(reinterpret_cast<__m128i*>(rgba + 16 * row), result);
+    }
+#else
+    for (int i = 0; i < 16; ++i)
+    {
+        const unsigned index = (colourBlock[4 + i / 4] >> (2 * (i % 4))) & 0x3;
+        memcpy(rgba + 4 * i, palette + 4 * index, 4);
+    }
+#endif
+
+    if (format == CF_DXT3)
+        DecompressAlphaDXT3(rgba, block);
+    else if (format == CF_DXT5)
+    {
+        unsigned char codes[8];
+        UnpackAlphaCodesDXT5(codes, block);
+
+        unsigned long long indices = 0;
+        for (int i = 0; i < 6; ++i)
+            indices |= static_cast<unsigned long long>(block[2 + i]) << (8 * i);
+
+        for (int i = 0; i < 16; ++i)
+            rgba[4 * i + 3] = codes[(indices >> (3 * i)) & 0x7];
+    }
+}
+
+void DecompressImageDXTRows(unsigned char* rgba, const void* blocks, int width, int height, CompressedFormat format,
+    unsigned beginBlockRow, unsigned endBlockRow)
+{
+    const unsigned bytesPerBlock = format == CF_DXT1 ? 8 : 16;
+    const unsigned numBlocksX = (width + 3) / 4;
+    const unsigned numBlocksY = (height + 3) / 4;
+
+    const auto* sourceBlock = reinterpret_cast<const unsigned char*>(blocks) + beginBlockRow * numBlocksX * bytesPerBlock;
+    for (unsigned blockRow = beginBlockRow; blockRow < endBlockRow; ++blockRow)
+    {
+        const unsigned z = blockRow / numBlocksY;
+        const int y = (blockRow % numBlocksY) * 4;
+        const int numRows = Min(height - y, 4);
+        unsigned char* targetRow = rgba + 4 * (width * height * z + width * y);
+
+        for (int x = 0; x < width; x += 4)
+        {
+            alignas(16) unsigned char targetRgba[4 * 16];
+            DecompressBlockDXTFast(targetRgba, sourceBlock, format);
+
+            const int numColumns = Min(width - x, 4);
+            for (int py = 0; py < numRows; ++py)
+                memcpy(targetRow + 4 * (width * py + x), targetRgba + 16 * py, 4 * numColumns);
+
+            sourceBlock += bytesPerBlock;
+        }
+    }
+}
+
 // PVRTC decompression based on the Oolong Engine, modified for Urho3D
 
 #define PT_INDEX    (2) /*The Punch-through index*/
@@ -908,23 +1010,34 @@ static void ReadBigEndian4byteWord(uint32_t* pBlock, const unsigned char *s)
     *pBlock = (s[0] << 24) | (s[1] << 16) | (s[2] << 8) | s[3];
 }
 
+// ETCPACK tables are read-only after initialization, so blocks may be decompressed in multiple threads.
+static void InitializeETCPACK()
+{
+    static const bool placeholder = []() { setupAlphaTable(); return true; }();
+    (void)placeholder;
+}
+
 // Use ETCPACK to decompress ETC texture.
 void DecompressImageETC(unsigned char* dstImage, const void* blocks, int width, int height, bool hasAlpha)
 {
-    // ETCPACK initialization.
-    static const bool placeholder = []() { setupAlphaTable(); return true; }();
+    DecompressImageETCRows(dstImage, blocks, width, height, hasAlpha, 0, (height + 3) / 4);
+}
+
+void DecompressImageETCRows(unsigned char* dstImage, const void* blocks, int width, int height, bool hasAlpha,
+    unsigned beginBlockRow, unsigned endBlockRow)
+{
+    InitializeETCPACK();
 
     const int channelCount = hasAlpha ? 4 : 3;
-    unsigned char* src = (unsigned char*)blocks;
     unsigned int blockPart1, blockPart2;
 
     // ETCPACK write 4x4 blocks, so it needs padding.
     int w4 = ((width + 3) / 4);
-    int h4 = ((height + 3) / 4);
+    unsigned char* src = (unsigned char*)blocks + beginBlockRow * w4 * (hasAlpha ? 16 : 8);
 
     unsigned char buffer4x4[4 * 4 * 4];
 
-    for (int y = 0; y < h4; ++y)
+    for (int y = static_cast<int>(beginBlockRow); y < static_cast<int>(endBlockRow); ++y)
     {
         for (int x = 0; x < w4; ++x)
         {
@@ -959,4 +1072,67 @@ void DecompressImageETC(unsigned char* dstImage, const void* blocks, int width,
     }
 }
 
+static bool CanDecompressInParallel(WorkQueue* workQueue)
+{
+    // Nested Complete() is not supported, and worker threads should not wait for each other
+    return workQueue && workQueue->GetNumThreads() > 0 && Thread::IsMainThread() && !workQueue->IsCompleting();
+}
+
+bool DecompressImage(WorkQueue* workQueue, unsigned char* rgba, const void* blocks, int width, int height, int depth,
+    CompressedFormat format)
+{
+    static const unsigned blockRowsPerTask = 16;
+
+    if (!CanDecompressInParallel(workQueue))
+        workQueue = nullptr;
+
+    const unsigned numBlockRows = (height + 3) / 4;
+    switch (format)
+    {
+    case CF_DXT1:
+    case CF_DXT3:
+    case CF_DXT5:
+    {
+        const unsigned numAllBlockRows = numBlockRows * Max(depth, 1);
+        const auto decompressRows = [&](unsigned beginBlockRow, unsigned endBlockRow)
+        { DecompressImageDXTRows(rgba, blocks, width, height, format, beginBlockRow, endBlockRow); };
+
+        if (workQueue)
+            ForEachParallel(workQueue, blockRowsPerTask, numAllBlockRows, decompressRows);
+        else
+            decompressRows(0, numAllBlockRows);
+        return true;
+    }
+
+    // ETC2 format is compatible with ETC1, so we just use the same function.
+    case CF_ETC1:
+    case CF_ETC2_RGB:
+    case CF_ETC2_RGBA:
+    {
+        const bool hasAlpha = format == CF_ETC2_RGBA;
+        const auto decompressRows = [&](unsigned beginBlockRow, unsigned endBlockRow)
+        { DecompressImageETCRows(rgba, blocks, width, height, hasAlpha, beginBlockRow, endBlockRow); };
+
+        InitializeETCPACK();
+        if (workQueue)
+            ForEachParallel(workQueue, blockRowsPerTask, numBlockRows, decompressRows);
+        else
+            decompressRows(0, numBlockRows);
+        return true;
+    }
+
+    case CF_PVRTC_RGB_2BPP:
+    case CF_PVRTC_RGBA_2BPP:
+    case CF_PVRTC_RGB_4BPP:
+    case CF_PVRTC_RGBA_4BPP:
+        // Blocks are shared by neighbouring pixels, keep it simple
+        DecompressImagePVRTC(rgba, blocks, width, height, format);
+        return true;
+
+    default:
+        // Unknown format
+        return false;
+    }
+}
+
 }
@@ -22,18 +22,53 @@
 
 #pragma once
 
+#include "../Container/ByteVector.h"
 #include "../Resource/Image.h"
 
 namespace Urho3D
 {
 
+class WorkQueue;
+
+/// Block compressed image transcoded from supercompressed format.
+struct TranscodedImage
+{
+    /// Compression format of blocks.
+    CompressedFormat format_{CF_NONE};
+    /// Number of color components.
+    unsigned components_{};
+    /// Width.
+    int width_{};
+    /// Height.
+    int height_{};
+    /// Number of mip levels.
+    unsigned numLevels_{};
+    /// Blocks of all mip levels, one array per cube map face.
+    ea::vector<ByteVector> faces_;
+};
+
 /// Decompress a DXT compressed image to RGBA.
 URHO3D_API void
     DecompressImageDXT(unsigned char* rgba, const void* blocks, int width, int height, int depth, CompressedFormat format);
+/// Decompress range of 4-pixel rows of a DXT compressed image to RGBA. Rows of all depth slices are numbered sequentially.
+URHO3D_API void DecompressImageDXTRows(unsigned char* rgba, const void* blocks, int width, int height,
+    CompressedFormat format, unsigned beginBlockRow, unsigned endBlockRow);
 /// Decompress an ETC1/ETC2 compressed image to RGBA.
 URHO3D_API void DecompressImageETC(unsigned char* dstImage, const void* blocks, int width, int height, bool hasAlpha);
+/// Decompress range of 4-pixel rows of an ETC1/ETC2 compressed image to RGBA.
+URHO3D_API void DecompressImageETCRows(unsigned char* dstImage, const void* blocks, int width, int height, bool hasAlpha,
+    unsigned beginBlockRow, unsigned endBlockRow);
+/// Decompress a DXT, ETC or PVRTC compressed image to RGBA. Return true if successful.
+/// DXT and ETC images are decompressed in multiple threads if work queue is provided and called from the main thread.
+URHO3D_API bool DecompressImage(WorkQueue* workQueue, unsigned char* rgba, const void* blocks, int width, int height,
+    int depth, CompressedFormat format);
 /// Decompress a PVRTC compressed image to RGBA.
 URHO3D_API void DecompressImagePVRTC(unsigned char* rgba, const void* blocks, int width, int height, CompressedFormat format);
+/// Return whether the data is a CRN supercompressed image.
+URHO3D_API bool IsImageCRN(const void* data, unsigned size);
+/// Transcode a CRN supercompressed image to DXT or ETC blocks of all mip levels. Return true if successful.
+/// Mip levels are transcoded in multiple threads if work queue is provided and called from the main thread.
+URHO3D_API bool TranscodeImageCRN(TranscodedImage& result, const void* data, unsigned size, WorkQueue* workQueue);
 /// Flip a compressed block vertically.
 URHO3D_API void FlipBlockVertical(unsigned char* dest, const unsigned char* src, CompressedFormat format);
 /// Flip a compressed block horizontally.
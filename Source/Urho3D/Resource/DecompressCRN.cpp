@@ -0,0 +1,169 @@
+//
+// Copyright (c) 2021-2022 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "../Precompiled.h"
+
+#include "../Core/Thread.h"
+#include "../Core/WorkQueue.h"
+#include "../IO/Log.h"
+#include "../Resource/Decompress.h"
+
+// Header-only decoder is compiled only in this translation unit because it requires disabled strict aliasing
+#include <crunch/crn_decomp.h>
+
+#include <atomic>
+
+namespace Urho3D
+{
+
+static const char* GetFormatNameCRN(crn_format format)
+{
+    switch (format)
+    {
+    case cCRNFmtDXT5_CCxY: return "DXT5_CCxY";
+    case cCRNFmtDXT5_xGxR: return "DXT5_xGxR";
+    case cCRNFmtDXT5_xGBR: return "DXT5_xGBR";
+    case cCRNFmtDXT5_AGBR: return "DXT5_AGBR";
+    case cCRNFmtDXN_XY: return "DXN_XY";
+    case cCRNFmtDXN_YX: return "DXN_YX";
+    case cCRNFmtDXT5A: return "DXT5A";
+    default: return "Unknown";
+    }
+}
+
+static CompressedFormat GetCompressedFormatCRN(crn_format format)
+{
+    switch (format)
+    {
+    case cCRNFmtDXT1:
+        return CF_DXT1;
+
+    case cCRNFmtDXT3:
+        return CF_DXT3;
+
+    case cCRNFmtDXT5:
+        return CF_DXT5;
+
+    case cCRNFmtETC1:
+        return CF_ETC1;
+
+    case cCRNFmtETC2:
+        return CF_ETC2_RGB;
+
+    case cCRNFmtETC2A:
+        return CF_ETC2_RGBA;
+
+    default:
+        // Swizzled DXT5 would need unswizzling in shaders, DXN and DXT5A have no matching format
+        return CF_NONE;
+    }
+}
+
+bool IsImageCRN(const void* data, unsigned size)
+{
+    const auto* bytes = reinterpret_cast<const unsigned char*>(data);
+    return size >= 2 && bytes[0] == 'H' && bytes[1] == 'x';
+}
+
+static bool CanTranscodeInParallel(WorkQueue* workQueue)
+{
+    // Same restrictions as for parallel decompression
+    return workQueue && workQueue->GetNumThreads() > 0 && Thread::IsMainThread() && !workQueue->IsCompleting();
+}
+
+bool TranscodeImageCRN(TranscodedImage& result, const void* data, unsigned size, WorkQueue* workQueue)
+{
+    crnd::crn_texture_info textureInfo;
+    if (!IsImageCRN(data, size) || !crnd::crnd_get_texture_info(data, size, &textureInfo))
+        return false;
+
+    result.format_ = GetCompressedFormatCRN(textureInfo.m_format);
+    if (result.format_ == CF_NONE)
+    {
+        URHO3D_LOGERROR("Unsupported CRN format {}", GetFormatNameCRN(textureInfo.m_format));
+        return false;
+    }
+
+    const bool isRGB = result.format_ == CF_DXT1 || result.format_ == CF_ETC1 || result.format_ == CF_ETC2_RGB;
+    result.components_ = isRGB ? 3 : 4;
+    result.width_ = textureInfo.m_width;
+    result.height_ = textureInfo.m_height;
+    result.numLevels_ = textureInfo.m_levels;
+
+    // Levels are stored one after another like in DDS files
+    const unsigned bytesPerBlock = textureInfo.m_bytes_per_block;
+    ea::vector<unsigned> levelOffsets(result.numLevels_ + 1);
+    for (unsigned level = 0; level < result.numLevels_; ++level)
+    {
+        const unsigned numBlocksX = (Max(result.width_ >> level, 1) + 3) / 4;
+        const unsigned numBlocksY = (Max(result.height_ >> level, 1) + 3) / 4;
+        levelOffsets[level + 1] = levelOffsets[level] + numBlocksX * numBlocksY * bytesPerBlock;
+    }
+
+    result.faces_.resize(textureInfo.m_faces);
+    for (ByteVector& face : result.faces_)
+        face.resize(levelOffsets.back());
+
+    // Each unpack context decodes shared palettes, so contexts are not created per level
+    std::atomic<bool> success{true};
+    const auto transcodeLevels = [&](unsigned beginLevel, unsigned endLevel)
+    {
+        crnd::crnd_unpack_context context = crnd::crnd_unpack_begin(data, size);
+        if (!context)
+        {
+            success = false;
+            return;
+        }
+
+        for (unsigned level = beginLevel; level < endLevel; ++level)
+        {
+            void* faces[cCRNMaxFaces]{};
+            for (unsigned face = 0; face < textureInfo.m_faces; ++face)
+                faces[face] = result.faces_[face].data() + levelOffsets[level];
+
+            const unsigned levelSize = levelOffsets[level + 1] - levelOffsets[level];
+            const unsigned rowPitch = (Max(result.width_ >> level, 1) + 3) / 4 * bytesPerBlock;
+            if (!crnd::crnd_unpack_level(context, faces, levelSize, rowPitch, level))
+                success = false;
+        }
+
+        crnd::crnd_unpack_end(context);
+    };
+
+    // Top level takes about 3/4 of the time, so it is transcoded in parallel with all other levels
+    if (CanTranscodeInParallel(workQueue) && result.numLevels_ > 1)
+    {
+        ForEachParallel(workQueue, 1u, 2u, [&](unsigned index, unsigned /*endIndex*/)
+        {
+            if (index == 0)
+                transcodeLevels(0, 1);
+            else
+                transcodeLevels(1, result.numLevels_);
+        });
+    }
+    else
+        transcodeLevels(0, result.numLevels_);
+
+    return success;
+}
+
+}
@@ -24,6 +24,8 @@
 
 #include "../Core/Context.h"
 #include "../Core/Profiler.h"
+#include "../Core/Thread.h"
+#include "../Core/WorkQueue.h"
 #include "../IO/File.h"
 #include "../IO/FileSystem.h"
 #include "../IO/Log.h"
@@ -36,6 +38,10 @@
 #include <webp/decode.h>
 #include <webp/encode.h>
 #include <webp/mux.h>
+
+#ifdef URHO3D_SSE
+#include <emmintrin.h>
+#endif
 #endif
 
 #include "../DebugNew.h"
@@ -217,41 +223,127 @@ struct DDSurfaceDesc2
     unsigned dwTextureStage_;
 };
 
-bool CompressedLevel::Decompress(unsigned char* dest) const
+namespace
 {
-    if (!data_)
-        return false;
 
-    switch (format_)
+/// Return whether the work queue can be used to process image in multiple threads.
+bool CanProcessInParallel(WorkQueue* workQueue)
+{
+    // Nested Complete() is not supported, and worker threads should not wait for each other
+    return workQueue && workQueue->GetNumThreads() > 0 && Thread::IsMainThread() && !workQueue->IsCompleting();
+}
+
+/// Calculate row of mip level with box filter, one output pixel at once.
+template <unsigned N>
+void BoxFilterRowScalar(unsigned char* out, const unsigned char* inUpper, const unsigned char* inLower, int widthOut)
+{
+    for (int x = 0; x < widthOut * static_cast<int>(N); x += N)
     {
-    case CF_DXT1:
-    case CF_DXT3:
-    case CF_DXT5:
-        DecompressImageDXT(dest, data_, width_, height_, depth_, format_);
-        return true;
+        for (unsigned c = 0; c < N; ++c)
+        {
+            out[x + c] = (unsigned char)(((unsigned)inUpper[x * 2 + c] + inUpper[x * 2 + N + c] +
+                                          inLower[x * 2 + c] + inLower[x * 2 + N + c]) >> 2);
+        }
+    }
+}
 
-    // ETC2 format is compatible with ETC1, so we just use the same function.
-    case CF_ETC1:
-    case CF_ETC2_RGB:
-        DecompressImageETC(dest, data_, width_, height_, false);
-        return true;
-    case CF_ETC2_RGBA:
-        DecompressImageETC(dest, data_, width_, height_, true);
-        return true;
+/// Calculate row of mip level with box filter.
+template <unsigned N>
+void BoxFilterRow(unsigned char* out, const unsigned char* inUpper, const unsigned char* inLower, int widthOut)
+{
+    BoxFilterRowScalar<N>(out, inUpper, inLower, widthOut);
+}
 
-    case CF_PVRTC_RGB_2BPP:
-    case CF_PVRTC_RGBA_2BPP:
-    case CF_PVRTC_RGB_4BPP:
-    case CF_PVRTC_RGBA_4BPP:
-        DecompressImagePVRTC(dest, data_, width_, height_, format_);
-        return true;
+#ifdef URHO3D_SSE
+/// Calculate row of RGBA mip level with box filter, 2 output pixels at once.
+template <>
+void BoxFilterRow<4>(unsigned char* out, const unsigned char* inUpper, const unsigned char* inLower, int widthOut)
+{
+    const __m128i zero = _mm_setzero_si128();
 
-    default:
-        // Unknown format
-        return false;
+    int x = 0;
+    for (; x + 2 <= widthOut; x += 2)
+    {
+        const __m128i upper = _mm_loadu_si128(reinterpret_cast<const __m128i*>(inUpper + x * 8));
+        const __m128i lower = _mm_loadu_si128(reinterpret_cast<const __m128i*>(inLower + x * 8));
+
+        // Sum vertically: 2 source pixels in each register
+        const __m128i sumFirst = _mm_add_epi16(_mm_unpacklo_epi8(upper, zero), _mm_unpacklo_epi8(lower, zero));
+        const __m128i sumSecond = _mm_add_epi16(_mm_unpackhi_epi8(upper, zero), _mm_unpackhi_epi8(lower, zero));
+
+        // Sum horizontally: 1 output pixel in lower half of each register
+        const __m128i first = _mm_add_epi16(sumFirst, _mm_srli_si128(sumFirst, 8));
+        const __m128i second = _mm_add_epi16(sumSecond, _mm_srli_si128(sumSecond, 8));
+
+        const __m128i result = _mm_srli_epi16(_mm_unpacklo_epi64(first, second), 2);
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(out + x * 4), _mm_packus_epi16(result, zero));
+    }
+
+    if (x < widthOut)
+        BoxFilterRowScalar<4>(out + x * 4, inUpper + x * 8, inLower + x * 8, 1);
+}
+#endif
+
+/// Calculate row of mip level with 4x4 tent filter. Source rows and columns are clamped to image.
+template <unsigned N>
+void TentFilterRow(unsigned char* out, const unsigned char* const (&inRows)[4], int width, int widthOut)
+{
+    static const unsigned weights[4] = {1, 3, 3, 1};
+
+    for (int x = 0; x < widthOut; ++x)
+    {
+        int columns[4];
+        for (int i = 0; i < 4; ++i)
+            columns[i] = Clamp(x * 2 - 1 + i, 0, width - 1) * N;
+
+        for (unsigned c = 0; c < N; ++c)
+        {
+            unsigned sum = 0;
+            for (int j = 0; j < 4; ++j)
+            {
+                const unsigned char* row = inRows[j];
+                const unsigned rowSum = row[columns[0] + c] + 3 * (row[columns[1] + c] + row[columns[2] + c]) +
+                    row[columns[3] + c];
+                sum += weights[j] * rowSum;
+            }
+            out[x * N + c] = (unsigned char)((sum + 32) >> 6);
+        }
     }
 }
 
+template <unsigned N>
+void CalculateMipRows(MipFilter filter, unsigned char* pixelDataOut, const unsigned char* pixelDataIn,
+    int width, int height, int widthOut, unsigned beginRow, unsigned endRow)
+{
+    for (int y = static_cast<int>(beginRow); y < static_cast<int>(endRow); ++y)
+    {
+        unsigned char* out = &pixelDataOut[y * widthOut * N];
+        if (filter == MipFilter::Box)
+        {
+            const unsigned char* inUpper = &pixelDataIn[(y * 2) * width * N];
+            const unsigned char* inLower = &pixelDataIn[(y * 2 + 1) * width * N];
+            BoxFilterRow<N>(out, inUpper, inLower, widthOut);
+        }
+        else
+        {
+            const unsigned char* inRows[4];
+            for (int i = 0; i < 4; ++i)
+                inRows[i] = &pixelDataIn[Clamp(y * 2 - 1 + i, 0, height - 1) * width * N];
+            TentFilterRow<N>(out, inRows, width, widthOut);
+        }
+    }
+}
+
+}
+
+bool CompressedLevel::Decompress(unsigned char* dest, WorkQueue* workQueue) const
+{
+    if (!data_)
+        return false;
+
+    return DecompressImage(workQueue, dest, data_, width_, height_, depth_, format_);
+}
+
 Image::Image(Context* context) :
     Resource(context)
 {
@@ -805,6 +897,48 @@ bool Image::BeginLoad(Deserializer& source)
         source.Read(data_.get(), dataSize);
         SetMemoryUse(dataSize);
     }
+    else if (IsImageCRN(fileID.data(), fileID.size()))
+    {
+        // CRN supercompressed format, transcoded to the block format it was encoded with.
+        // Texture classes decompress it to RGBA if the format is not supported by GPU.
+        source.Seek(0);
+        ByteVector fileData(source.GetSize());
+        source.Read(fileData.data(), fileData.size());
+
+        TranscodedImage transcodedImage;
+        if (!TranscodeImageCRN(transcodedImage, fileData.data(), fileData.size(), GetSubsystem<WorkQueue>()))
+        {
+            URHO3D_LOGERROR("Could not transcode CRN image " + source.GetName());
+            return false;
+        }
+
+        const unsigned numFaces = transcodedImage.faces_.size();
+        cubemap_ = numFaces == 6;
+
+        // Do not use a shared ptr here, in case nothing is refcounting the image outside this function.
+        Image* currentImage = this;
+        for (unsigned faceIndex = 0; faceIndex < numFaces; ++faceIndex)
+        {
+            const ByteVector& faceData = transcodedImage.faces_[faceIndex];
+            currentImage->data_ = new unsigned char[faceData.size()];
+            memcpy(currentImage->data_.get(), faceData.data(), faceData.size());
+            currentImage->cubemap_ = cubemap_;
+            currentImage->components_ = transcodedImage.components_;
+            currentImage->compressedFormat_ = transcodedImage.format_;
+            currentImage->width_ = transcodedImage.width_;
+            currentImage->height_ = transcodedImage.height_;
+            currentImage->depth_ = 1;
+            currentImage->numCompressedLevels_ = transcodedImage.numLevels_;
+            currentImage->SetMemoryUse(faceData.size());
+
+            if (faceIndex < numFaces - 1)
+            {
+                SharedPtr<Image> nextImage(context_->CreateObject<Image>());
+                currentImage->nextSibling_ = nextImage;
+                currentImage = nextImage;
+            }
+        }
+    }
 #ifdef URHO3D_WEBP
     else if (fileID == "RIFF")
     {
@@ -1034,7 +1168,7 @@ bool Image::LoadColorLUT(Deserializer& source)
 {
     ea::string fileID = source.ReadFileID();
 
-    if (fileID == "DDS " || fileID == "\253KTX" || fileID == "PVR\3")
+    if (fileID == "DDS " || fileID == "\253KTX" || fileID == "PVR\3" || IsImageCRN(fileID.data(), fileID.size()))
     {
         URHO3D_LOGERROR("Invalid image format, can not load image");
         return false;
@@ -1946,6 +2080,66 @@ SharedPtr<Image> Image::GetNextLevel() const
     return mipImage;
 }
 
+SharedPtr<Image> Image::CalculateNextLevel(MipFilter filter, WorkQueue* workQueue) const
+{
+    // Box filter for 1D and 3D images is not optimized, and there's no tent filter for 3D images
+    const bool isValid = !IsCompressed() && components_ >= 1 && components_ <= 4;
+    const bool isBox2D = depth_ == 1 && width_ > 1 && height_ > 1;
+    if (!isValid || depth_ > 1 || (filter == MipFilter::Box && !isBox2D))
+        return GetNextLevel();
+
+    URHO3D_PROFILE("CalculateImageMipLevel");
+
+    const int widthOut = Max(width_ / 2, 1);
+    const int heightOut = Max(height_ / 2, 1);
+
+    auto mipImage = MakeShared<Image>(context_);
+    mipImage->SetSize(widthOut, heightOut, components_);
+
+    const unsigned char* pixelDataIn = data_.get();
+    unsigned char* pixelDataOut = mipImage->data_.get();
+    const auto calculateRows = [&](unsigned beginRow, unsigned endRow)
+    {
+        switch (components_)
+        {
+        case 1: CalculateMipRows<1>(filter, pixelDataOut, pixelDataIn, width_, height_, widthOut, beginRow, endRow); break;
+        case 2: CalculateMipRows<2>(filter, pixelDataOut, pixelDataIn, width_, height_, widthOut, beginRow, endRow); break;
+        case 3: CalculateMipRows<3>(filter, pixelDataOut, pixelDataIn, width_, height_, widthOut, beginRow, endRow); break;
+        case 4: CalculateMipRows<4>(filter, pixelDataOut, pixelDataIn, width_, height_, widthOut, beginRow, endRow); break;
+        default: assert(false); break;
+        }
+    };
+
+    if (CanProcessInParallel(workQueue))
+    {
+        static const unsigned pixelsPerTask = 16 * 1024;
+        const unsigned rowsPerTask = Max(pixelsPerTask / widthOut, 1u);
+        ForEachParallel(workQueue, rowsPerTask, static_cast<unsigned>(heightOut), calculateRows);
+    }
+    else
+        calculateRows(0, heightOut);
+
+    return mipImage;
+}
+
+ea::vector<SharedPtr<Image>> Image::CalculateMipChain(MipFilter filter, WorkQueue* workQueue) const
+{
+    ea::vector<SharedPtr<Image>> levels;
+
+    const Image* current = this;
+    while (current->width_ > 1 || current->height_ > 1)
+    {
+        SharedPtr<Image> level = current->CalculateNextLevel(filter, workQueue);
+        if (!level)
+            break;
+
+        levels.push_back(level);
+        current = level;
+    }
+
+    return levels;
+}
+
 SharedPtr<Image> Image::ConvertToRGBA() const
 {
     if (IsCompressed())
@@ -2166,7 +2360,7 @@ SharedPtr<Image> Image::GetDecompressedImageLevel(unsigned index) const
 
         auto decompressedImage = MakeShared<Image>(context_);
         decompressedImage->SetSize(compressedLevel.width_, compressedLevel.height_, 4);
-        compressedLevel.Decompress(decompressedImage->GetData());
+        compressedLevel.Decompress(decompressedImage->GetData(), GetSubsystem<WorkQueue>());
 
         return decompressedImage;
     }
@@ -2360,15 +2554,11 @@ void Image::PrecalculateLevels()
 
     nextLevel_.Reset();
 
-    if (width_ > 1 || height_ > 1)
+    Image* current = this;
+    for (Image* level : CalculateMipChain(MipFilter::Box, GetSubsystem<WorkQueue>()))
     {
-        SharedPtr<Image> current = GetNextLevel();
-        nextLevel_ = current;
-        while (current && (current->width_ > 1 || current->height_ > 1))
-        {
-            current->nextLevel_ = current->GetNextLevel();
-            current = current->nextLevel_;
-        }
+        current->nextLevel_ = level;
+        current = level;
     }
 }
 
@@ -33,6 +33,8 @@ struct SDL_Surface;
 namespace Urho3D
 {
 
+class WorkQueue;
+
 static const int COLOR_LUT_SIZE = 16;
 
 /// Supported compressed image formats.
@@ -52,11 +54,21 @@ enum CompressedFormat
     CF_PVRTC_RGBA_4BPP,
 };
 
+/// Filter used to calculate image mip levels.
+enum class MipFilter
+{
+    /// Average of 2x2 pixels. Last row and column of odd-sized images are ignored.
+    Box,
+    /// Separable 4x4 filter with 1-3-3-1 weights, smoother than box. 3D images use box filter instead.
+    Tent,
+};
+
 /// Compressed image mip level.
 struct URHO3D_API CompressedLevel
 {
     /// Decompress to RGBA. The destination buffer required is width * height * 4 bytes. Return true if successful.
-    bool Decompress(unsigned char* dest) const;
+    /// Blocks are decompressed in multiple threads if work queue is provided.
+    bool Decompress(unsigned char* dest, WorkQueue* workQueue = nullptr) const;
 
     /// Compressed image data.
     unsigned char* data_{};
@@ -196,6 +208,11 @@ public:
 
     /// Return next mip level by bilinear filtering. Note that if the image is already 1x1x1, will keep returning an image of that size.
     SharedPtr<Image> GetNextLevel() const;
+    /// Calculate next mip level with given filter. Rows are processed in multiple threads if work queue is provided.
+    /// Box filter gives the same result as GetNextLevel.
+    SharedPtr<Image> CalculateNextLevel(MipFilter filter, WorkQueue* workQueue = nullptr) const;
+    /// Calculate all mip levels after this one until both width and height are 1.
+    ea::vector<SharedPtr<Image>> CalculateMipChain(MipFilter filter, WorkQueue* workQueue = nullptr) const;
     /// Return the next sibling image of an array or cubemap.
     SharedPtr<Image> GetNextSibling() const { return nextSibling_;  }
     /// Return image converted to 4-component (RGBA) to circumvent modern rendering API's not supporting e.g. the luminance-alpha format.
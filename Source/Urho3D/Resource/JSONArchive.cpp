@@ -22,8 +22,13 @@
 
 #include "../Core/StringUtils.h"
 #include "../IO/ArchiveSerialization.h"
+#include "../IO/Serializer.h"
 #include "../Resource/JSONArchive.h"
 
+#include <rapidjson/prettywriter.h>
+
+#include <EASTL/array.h>
+
 namespace Urho3D
 {
 
@@ -40,24 +45,117 @@ inline bool IsArchiveBlockJSONObject(ArchiveBlockType type)
     return type == ArchiveBlockType::Unordered;
 }
 
-inline bool IsJSONValueCompatibleWithArray(const JSONValue& value)
+template <class T>
+bool IsJSONValueCompatibleWithArray(const T& value)
 {
-    return value.IsArray() || value.IsNull() || (value.IsObject() && value.GetObject().empty());
+    return value.IsArray() || value.IsNull() || (value.IsObject() && value.Size() == 0);
 }
 
-inline bool IsJSONValueCompatibleWithObject(const JSONValue& value)
+template <class T>
+bool IsJSONValueCompatibleWithObject(const T& value)
 {
-    return value.IsObject() || value.IsNull() || (value.IsArray() && value.GetArray().empty());
+    return value.IsObject() || value.IsNull() || (value.IsArray() && value.Size() == 0);
 }
 
-inline bool IsArchiveBlockTypeMatching(const JSONValue& value, ArchiveBlockType type)
+template <class T>
+bool IsArchiveBlockTypeMatching(const T& value, ArchiveBlockType type)
 {
     return (IsArchiveBlockJSONArray(type) && IsJSONValueCompatibleWithArray(value))
         || (IsArchiveBlockJSONObject(type) && IsJSONValueCompatibleWithObject(value));
 }
 
+inline const JSONValue* FindJSONMember(const JSONValue& value, const char* name)
+{
+    return value.Contains(name) ? &value.Get(name) : nullptr;
+}
+
+inline const JSONDocumentValue* FindJSONMember(const JSONDocumentValue& value, const char* name)
+{
+    return value.Find(name);
 }
 
+/// Read element of input archive block. Shared between JSONValue and JSONDocumentValue blocks.
+template <class T>
+const T& ReadJSONBlockElement(ArchiveBase& archive, ea::string_view blockName, ArchiveBlockType blockType,
+    const T& blockValue, unsigned& nextElementIndex, const char* elementName, const ArchiveBlockType* elementBlockType)
+{
+    // Find appropriate value
+    const T* elementValue = nullptr;
+    if (IsArchiveBlockJSONArray(blockType))
+    {
+        if (nextElementIndex >= blockValue.Size())
+            throw archive.ElementNotFoundException(elementName, nextElementIndex);
+
+        elementValue = &blockValue.Get(nextElementIndex);
+        ++nextElementIndex;
+    }
+    else if (IsArchiveBlockJSONObject(blockType))
+    {
+        elementValue = FindJSONMember(blockValue, elementName);
+        if (!elementValue)
+            throw archive.ElementNotFoundException(elementName);
+    }
+    else
+    {
+        URHO3D_ASSERT(0);
+        return blockValue;
+    }
+
+    // Check if reading block
+    if (elementBlockType && !IsArchiveBlockTypeMatching(*elementValue, *elementBlockType))
+        throw archive.UnexpectedElementValueException(blockName);
+
+    return *elementValue;
+}
+
+}
+
+/// Writer of JSON text used by JSONStreamOutputArchive.
+class JSONStreamWriter
+{
+public:
+    /// Output stream for rapidjson that writes to Serializer in chunks.
+    class OutputStream
+    {
+    public:
+        using Ch = char;
+
+        explicit OutputStream(Serializer& dest) : dest_(dest) {}
+
+        void Put(char ch)
+        {
+            if (size_ == buffer_.size())
+                Flush();
+            buffer_[size_++] = ch;
+        }
+
+        void Flush()
+        {
+            if (size_ != 0 && dest_.Write(buffer_.data(), size_) != size_)
+                failed_ = true;
+            size_ = 0;
+        }
+
+        bool IsFailed() const { return failed_; }
+
+    private:
+        Serializer& dest_;
+        ea::array<char, 4096> buffer_;
+        unsigned size_{};
+        bool failed_{};
+    };
+
+    JSONStreamWriter(Serializer& dest, const ea::string& indentation)
+        : stream_(dest)
+        , writer_(stream_)
+    {
+        writer_.SetIndent(!indentation.empty() ? indentation.front() : ' ', indentation.length());
+    }
+
+    OutputStream stream_;
+    rapidjson::PrettyWriter<OutputStream> writer_;
+};
+
 JSONOutputArchiveBlock::JSONOutputArchiveBlock(const char* name, ArchiveBlockType type, JSONValue* blockValue, unsigned sizeHint)
     : ArchiveBlockBase(name, type)
     , blockValue_(blockValue)
@@ -172,42 +270,156 @@ URHO3D_JSON_OUT_IMPL(ea::string, SetString);
 
 #undef URHO3D_JSON_OUT_IMPL
 
-JSONInputArchiveBlock::JSONInputArchiveBlock(const char* name, ArchiveBlockType type, const JSONValue* value)
+JSONStreamOutputArchiveBlock::JSONStreamOutputArchiveBlock(const char* name, ArchiveBlockType type, JSONStreamWriter* writer, unsigned sizeHint)
     : ArchiveBlockBase(name, type)
-    , value_(value)
+    , writer_(writer)
 {
+    if (type_ == ArchiveBlockType::Array)
+        expectedElementCount_ = sizeHint;
+
+    if (IsArchiveBlockJSONArray(type_))
+        writer_->writer_.StartArray();
+    else if (IsArchiveBlockJSONObject(type_))
+        writer_->writer_.StartObject();
+    else
+        assert(0);
 }
 
-const JSONValue& JSONInputArchiveBlock::ReadElement(ArchiveBase& archive, const char* elementName, const ArchiveBlockType* elementBlockType)
+void JSONStreamOutputArchiveBlock::CreateElement(ArchiveBase& archive, const char* elementName)
 {
-    // Find appropriate value
-    const JSONValue* elementValue = nullptr;
-    if (IsArchiveBlockJSONArray(type_))
+    URHO3D_ASSERT(numElements_ < expectedElementCount_);
+
+    if (IsArchiveBlockJSONObject(type_))
     {
-        if (nextElementIndex_ >= value_->Size())
-            throw archive.ElementNotFoundException(elementName, nextElementIndex_);
+        const StringHash nameHash{ elementName };
+        if (ea::find(elementNames_.begin(), elementNames_.end(), nameHash) != elementNames_.end())
+            throw archive.DuplicateElementException(elementName);
 
-        elementValue = &value_->Get(nextElementIndex_);
-        ++nextElementIndex_;
+        elementNames_.push_back(nameHash);
+        writer_->writer_.Key(elementName);
     }
+
+    ++numElements_;
+}
+
+void JSONStreamOutputArchiveBlock::Close(ArchiveBase& archive)
+{
+    if (IsArchiveBlockJSONArray(type_))
+        writer_->writer_.EndArray();
     else if (IsArchiveBlockJSONObject(type_))
-    {
-        if (!value_->Contains(elementName))
-            throw archive.ElementNotFoundException(elementName);
+        writer_->writer_.EndObject();
 
-        elementValue = &value_->Get(elementName);
-    }
-    else
+    // Flush when the root block is closed
+    if (writer_->writer_.IsComplete())
     {
-        URHO3D_ASSERT(0);
-        return *value_;
+        writer_->stream_.Flush();
+        if (writer_->stream_.IsFailed())
+            throw archive.IOFailureException(name_);
     }
+}
 
-    // Check if reading block
-    if (elementBlockType && !IsArchiveBlockTypeMatching(*elementValue, *elementBlockType))
-        throw archive.UnexpectedElementValueException(name_);
+JSONStreamOutputArchive::JSONStreamOutputArchive(Context* context, Serializer& dest, const ea::string& indentation)
+    : JSONArchiveBase(context, ea::string_view{})
+    , writer_(ea::make_unique<JSONStreamWriter>(dest, indentation))
+{
+}
 
-    return *elementValue;
+JSONStreamOutputArchive::~JSONStreamOutputArchive() = default;
+
+void JSONStreamOutputArchive::BeginBlock(const char* name, unsigned& sizeHint, bool safe, ArchiveBlockType type)
+{
+    CheckBeforeBlock(name);
+    CheckBlockOrElementName(name);
+
+    if (!stack_.empty())
+        GetCurrentBlock().CreateElement(*this, name);
+
+    stack_.push_back(Block{ name, type, writer_.get(), sizeHint });
+    CheckResult(name);
+}
+
+void JSONStreamOutputArchive::Serialize(const char* name, long long& value)
+{
+    CreateElement(name);
+    tempString_ = eastl::to_string(value);
+    writer_->writer_.String(tempString_.c_str(), tempString_.length());
+    CheckResult(name);
+}
+
+void JSONStreamOutputArchive::Serialize(const char* name, unsigned long long& value)
+{
+    CreateElement(name);
+    tempString_ = eastl::to_string(value);
+    writer_->writer_.String(tempString_.c_str(), tempString_.length());
+    CheckResult(name);
+}
+
+void JSONStreamOutputArchive::Serialize(const char* name, ea::string& value)
+{
+    CreateElement(name);
+    writer_->writer_.String(value.c_str(), value.length());
+    CheckResult(name);
+}
+
+void JSONStreamOutputArchive::SerializeBytes(const char* name, void* bytes, unsigned size)
+{
+    CreateElement(name);
+    BufferToHexString(tempString_, bytes, size);
+    writer_->writer_.String(tempString_.c_str(), tempString_.length());
+    CheckResult(name);
+}
+
+void JSONStreamOutputArchive::SerializeVLE(const char* name, unsigned& value)
+{
+    CreateElement(name);
+    writer_->writer_.Uint(value);
+    CheckResult(name);
+}
+
+void JSONStreamOutputArchive::CreateElement(const char* name)
+{
+    CheckBeforeElement(name);
+    CheckBlockOrElementName(name);
+    GetCurrentBlock().CreateElement(*this, name);
+}
+
+void JSONStreamOutputArchive::CheckResult(const char* name) const
+{
+    if (writer_->stream_.IsFailed())
+        throw IOFailureException(name);
+}
+
+// Generate serialization implementation (JSON stream output)
+#define URHO3D_JSON_STREAM_OUT_IMPL(type, function, valueType) \
+    void JSONStreamOutputArchive::Serialize(const char* name, type& value) \
+    { \
+        CreateElement(name); \
+        if (!writer_->writer_.function(static_cast<valueType>(value))) \
+            throw UnexpectedElementValueException(name); \
+        CheckResult(name); \
+    }
+
+URHO3D_JSON_STREAM_OUT_IMPL(bool, Bool, bool);
+URHO3D_JSON_STREAM_OUT_IMPL(signed char, Int, int);
+URHO3D_JSON_STREAM_OUT_IMPL(short, Int, int);
+URHO3D_JSON_STREAM_OUT_IMPL(int, Int, int);
+URHO3D_JSON_STREAM_OUT_IMPL(unsigned char, Uint, unsigned);
+URHO3D_JSON_STREAM_OUT_IMPL(unsigned short, Uint, unsigned);
+URHO3D_JSON_STREAM_OUT_IMPL(unsigned int, Uint, unsigned);
+URHO3D_JSON_STREAM_OUT_IMPL(float, Double, double);
+URHO3D_JSON_STREAM_OUT_IMPL(double, Double, double);
+
+#undef URHO3D_JSON_STREAM_OUT_IMPL
+
+JSONInputArchiveBlock::JSONInputArchiveBlock(const char* name, ArchiveBlockType type, const JSONValue* value)
+    : ArchiveBlockBase(name, type)
+    , value_(value)
+{
+}
+
+const JSONValue& JSONInputArchiveBlock::ReadElement(ArchiveBase& archive, const char* elementName, const ArchiveBlockType* elementBlockType)
+{
+    return ReadJSONBlockElement(archive, name_, type_, *value_, nextElementIndex_, elementName, elementBlockType);
 }
 
 void JSONInputArchive::BeginBlock(const char* name, unsigned& sizeHint, bool safe, ArchiveBlockType type)
@@ -283,25 +495,129 @@ void JSONInputArchive::CheckType(const char* name, const JSONValue& value, JSONV
 }
 
 // Generate serialization implementation (JSON input)
-#define URHO3D_JSON_IN_IMPL(type, function, jsonType) \
-    void JSONInputArchive::Serialize(const char* name, type& value) \
+#define URHO3D_JSON_IN_IMPL(archiveType, valueType, type, function, jsonType) \
+    void archiveType::Serialize(const char* name, type& value) \
     { \
-        const JSONValue& jsonValue = ReadElement(name); \
+        const valueType& jsonValue = ReadElement(name); \
         CheckType(name, jsonValue, jsonType); \
         value = jsonValue.function(); \
     }
 
-URHO3D_JSON_IN_IMPL(bool, GetBool, JSON_BOOL);
-URHO3D_JSON_IN_IMPL(signed char, GetInt, JSON_NUMBER);
-URHO3D_JSON_IN_IMPL(short, GetInt, JSON_NUMBER);
-URHO3D_JSON_IN_IMPL(int, GetInt, JSON_NUMBER);
-URHO3D_JSON_IN_IMPL(unsigned char, GetUInt, JSON_NUMBER);
-URHO3D_JSON_IN_IMPL(unsigned short, GetUInt, JSON_NUMBER);
-URHO3D_JSON_IN_IMPL(unsigned int, GetUInt, JSON_NUMBER);
-URHO3D_JSON_IN_IMPL(float, GetFloat, JSON_NUMBER);
-URHO3D_JSON_IN_IMPL(double, GetDouble, JSON_NUMBER);
-URHO3D_JSON_IN_IMPL(ea::string, GetString, JSON_STRING);
+URHO3D_JSON_IN_IMPL(JSONInputArchive, JSONValue, bool, GetBool, JSON_BOOL);
+URHO3D_JSON_IN_IMPL(JSONInputArchive, JSONValue, signed char, GetInt, JSON_NUMBER);
+URHO3D_JSON_IN_IMPL(JSONInputArchive, JSONValue, short, GetInt, JSON_NUMBER);
+URHO3D_JSON_IN_IMPL(JSONInputArchive, JSONValue, int, GetInt, JSON_NUMBER);
+URHO3D_JSON_IN_IMPL(JSONInputArchive, JSONValue, unsigned char, GetUInt, JSON_NUMBER);
+URHO3D_JSON_IN_IMPL(JSONInputArchive, JSONValue, unsigned short, GetUInt, JSON_NUMBER);
+URHO3D_JSON_IN_IMPL(JSONInputArchive, JSONValue, unsigned int, GetUInt, JSON_NUMBER);
+URHO3D_JSON_IN_IMPL(JSONInputArchive, JSONValue, float, GetFloat, JSON_NUMBER);
+URHO3D_JSON_IN_IMPL(JSONInputArchive, JSONValue, double, GetDouble, JSON_NUMBER);
+URHO3D_JSON_IN_IMPL(JSONInputArchive, JSONValue, ea::string, GetString, JSON_STRING);
+
+URHO3D_JSON_IN_IMPL(JSONDocumentInputArchive, JSONDocumentValue, bool, GetBool, JSON_BOOL);
+URHO3D_JSON_IN_IMPL(JSONDocumentInputArchive, JSONDocumentValue, signed char, GetInt, JSON_NUMBER);
+URHO3D_JSON_IN_IMPL(JSONDocumentInputArchive, JSONDocumentValue, short, GetInt, JSON_NUMBER);
+URHO3D_JSON_IN_IMPL(JSONDocumentInputArchive, JSONDocumentValue, int, GetInt, JSON_NUMBER);
+URHO3D_JSON_IN_IMPL(JSONDocumentInputArchive, JSONDocumentValue, unsigned char, GetUInt, JSON_NUMBER);
+URHO3D_JSON_IN_IMPL(JSONDocumentInputArchive, JSONDocumentValue, unsigned short, GetUInt, JSON_NUMBER);
+URHO3D_JSON_IN_IMPL(JSONDocumentInputArchive, JSONDocumentValue, unsigned int, GetUInt, JSON_NUMBER);
+URHO3D_JSON_IN_IMPL(JSONDocumentInputArchive, JSONDocumentValue, float, GetFloat, JSON_NUMBER);
+URHO3D_JSON_IN_IMPL(JSONDocumentInputArchive, JSONDocumentValue, double, GetDouble, JSON_NUMBER);
+URHO3D_JSON_IN_IMPL(JSONDocumentInputArchive, JSONDocumentValue, ea::string, GetString, JSON_STRING);
 
 #undef URHO3D_JSON_IN_IMPL
 
+JSONDocumentInputArchiveBlock::JSONDocumentInputArchiveBlock(const char* name, ArchiveBlockType type, const JSONDocumentValue* value)
+    : ArchiveBlockBase(name, type)
+    , value_(value)
+{
+}
+
+const JSONDocumentValue& JSONDocumentInputArchiveBlock::ReadElement(ArchiveBase& archive, const char* elementName, const ArchiveBlockType* elementBlockType)
+{
+    return ReadJSONBlockElement(archive, name_, type_, *value_, nextElementIndex_, elementName, elementBlockType);
+}
+
+void JSONDocumentInputArchive::BeginBlock(const char* name, unsigned& sizeHint, bool safe, ArchiveBlockType type)
+{
+    CheckBeforeBlock(name);
+    CheckBlockOrElementName(name);
+
+    // Open root block
+    if (stack_.empty())
+    {
+        if (!IsArchiveBlockTypeMatching(rootValue_, type))
+            throw UnexpectedElementValueException(name);
+
+        Block frame{ name, type, &rootValue_ };
+        sizeHint = frame.GetSizeHint();
+        stack_.push_back(frame);
+        return;
+    }
+
+    // Open block
+    const JSONDocumentValue& blockValue = GetCurrentBlock().ReadElement(*this, name, &type);
+
+    Block blockFrame{ name, type, &blockValue };
+    sizeHint = blockFrame.GetSizeHint();
+    stack_.push_back(blockFrame);
+}
+
+void JSONDocumentInputArchive::Serialize(const char* name, long long& value)
+{
+    // Output archives write 64-bit integers as strings, hand-written numbers are stored exactly too
+    const JSONDocumentValue& jsonValue = ReadElement(name);
+    if (jsonValue.IsNumber())
+    {
+        value = jsonValue.GetInt64();
+        return;
+    }
+    CheckType(name, jsonValue, JSON_STRING);
+
+    // Strings of document are null-terminated
+    value = ToInt64(jsonValue.GetString().data());
+}
+
+void JSONDocumentInputArchive::Serialize(const char* name, unsigned long long& value)
+{
+    const JSONDocumentValue& jsonValue = ReadElement(name);
+    if (jsonValue.IsNumber())
+    {
+        value = jsonValue.GetUInt64();
+        return;
+    }
+    CheckType(name, jsonValue, JSON_STRING);
+
+    value = ToUInt64(jsonValue.GetString().data());
+}
+
+void JSONDocumentInputArchive::SerializeBytes(const char* name, void* bytes, unsigned size)
+{
+    const JSONDocumentValue& jsonValue = ReadElement(name);
+    CheckType(name, jsonValue, JSON_STRING);
+
+    ReadBytesFromHexString(name, ea::string{ jsonValue.GetString() }, bytes, size);
+}
+
+void JSONDocumentInputArchive::SerializeVLE(const char* name, unsigned& value)
+{
+    const JSONDocumentValue& jsonValue = ReadElement(name);
+    CheckType(name, jsonValue, JSON_NUMBER);
+
+    value = jsonValue.GetUInt();
+}
+
+const JSONDocumentValue& JSONDocumentInputArchive::ReadElement(const char* name)
+{
+    CheckBeforeElement(name);
+    CheckBlockOrElementName(name);
+    return GetCurrentBlock().ReadElement(*this, name, nullptr);
+}
+
+void JSONDocumentInputArchive::CheckType(const char* name, const JSONDocumentValue& value, JSONValueType type) const
+{
+    if (value.GetValueType() != type)
+        throw UnexpectedElementValueException(name);
+}
+
 }
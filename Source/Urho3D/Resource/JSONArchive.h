@@ -23,9 +23,12 @@
 #pragma once
 
 #include "../IO/ArchiveBase.h"
+#include "../Resource/JSONDocument.h"
 #include "../Resource/JSONFile.h"
 #include "../Resource/JSONValue.h"
 
+#include <EASTL/unique_ptr.h>
+
 namespace Urho3D
 {
 
@@ -36,7 +39,7 @@ class JSONArchiveBase : public ArchiveBaseT<BlockType, IsInputBool, true>
 public:
     /// @name Archive implementation
     /// @{
-    ea::string_view GetName() const { return jsonFile_ ? jsonFile_->GetName() : ""; }
+    ea::string_view GetName() const { return jsonFile_ ? ea::string_view{ jsonFile_->GetName() } : name_; }
     /// @}
 
 protected:
@@ -46,8 +49,15 @@ protected:
     {
     }
 
+    JSONArchiveBase(Context* context, ea::string_view name)
+        : ArchiveBaseT<BlockType, IsInputBool, true>(context)
+        , name_(name)
+    {
+    }
+
 private:
     const JSONFile* jsonFile_{};
+    ea::string_view name_;
 };
 
 /// JSON output archive block.
@@ -115,6 +125,72 @@ private:
     ea::string tempString_;
 };
 
+/// Writer of JSON text used by JSONStreamOutputArchive.
+class JSONStreamWriter;
+
+/// JSON stream output archive block.
+class URHO3D_API JSONStreamOutputArchiveBlock : public ArchiveBlockBase
+{
+public:
+    JSONStreamOutputArchiveBlock(const char* name, ArchiveBlockType type, JSONStreamWriter* writer, unsigned sizeHint);
+    /// Write name of the element if needed.
+    void CreateElement(ArchiveBase& archive, const char* elementName);
+
+    bool IsUnorderedAccessSupported() const { return type_ == ArchiveBlockType::Unordered; }
+    bool HasElementOrBlock(const char* name) const { return false; }
+    void Close(ArchiveBase& archive);
+
+private:
+    /// Writer.
+    JSONStreamWriter* writer_{};
+
+    /// Expected block size (for arrays).
+    unsigned expectedElementCount_{ M_MAX_UNSIGNED };
+    /// Number of elements in block.
+    unsigned numElements_{};
+    /// Hashes of element names (for unordered blocks).
+    ea::vector<StringHash> elementNames_;
+};
+
+/// JSON output archive that writes text directly to the stream without building JSONValue tree.
+/// Members of objects are written in order of serialization.
+class URHO3D_API JSONStreamOutputArchive : public JSONArchiveBase<JSONStreamOutputArchiveBlock, false>
+{
+public:
+    /// Construct from stream. Only the first character (if any) of indentation string is used, and the length of the string defines the character count.
+    JSONStreamOutputArchive(Context* context, Serializer& dest, const ea::string& indentation = "\t");
+    /// Destruct.
+    ~JSONStreamOutputArchive() override;
+
+    /// @name Archive implementation
+    /// @{
+    void BeginBlock(const char* name, unsigned& sizeHint, bool safe, ArchiveBlockType type) final;
+
+    void Serialize(const char* name, bool& value) final;
+    void Serialize(const char* name, signed char& value) final;
+    void Serialize(const char* name, unsigned char& value) final;
+    void Serialize(const char* name, short& value) final;
+    void Serialize(const char* name, unsigned short& value) final;
+    void Serialize(const char* name, int& value) final;
+    void Serialize(const char* name, unsigned int& value) final;
+    void Serialize(const char* name, long long& value) final;
+    void Serialize(const char* name, unsigned long long& value) final;
+    void Serialize(const char* name, float& value) final;
+    void Serialize(const char* name, double& value) final;
+    void Serialize(const char* name, ea::string& value) final;
+
+    void SerializeBytes(const char* name, void* bytes, unsigned size) final;
+    void SerializeVLE(const char* name, unsigned& value) final;
+    /// @}
+
+private:
+    void CreateElement(const char* name);
+    void CheckResult(const char* name) const;
+
+    ea::unique_ptr<JSONStreamWriter> writer_;
+    ea::string tempString_;
+};
+
 /// JSON input archive block.
 class URHO3D_API JSONInputArchiveBlock : public ArchiveBlockBase
 {
@@ -180,4 +256,70 @@ private:
     const JSONValue& rootValue_;
 };
 
+/// JSON document input archive block.
+class URHO3D_API JSONDocumentInputArchiveBlock : public ArchiveBlockBase
+{
+public:
+    JSONDocumentInputArchiveBlock(const char* name, ArchiveBlockType type, const JSONDocumentValue* value);
+    /// Return size hint.
+    unsigned GetSizeHint() const { return value_->Size(); }
+    /// Read current child and move to the next one.
+    const JSONDocumentValue& ReadElement(ArchiveBase& archive, const char* elementName, const ArchiveBlockType* elementBlockType);
+
+    bool IsUnorderedAccessSupported() const { return type_ == ArchiveBlockType::Unordered; }
+    bool HasElementOrBlock(const char* name) const { return value_ && value_->Contains(name); }
+    void Close(ArchiveBase& archive) {}
+
+private:
+    const JSONDocumentValue* value_{};
+
+    /// Next array index (for sequential and array blocks).
+    unsigned nextElementIndex_{};
+};
+
+/// JSON input archive that reads from read-only JSONDocument.
+class URHO3D_API JSONDocumentInputArchive : public JSONArchiveBase<JSONDocumentInputArchiveBlock, true>
+{
+public:
+    /// Construct from value.
+    JSONDocumentInputArchive(Context* context, const JSONDocumentValue& value, ea::string_view name = {})
+        : JSONArchiveBase(context, name)
+        , rootValue_(value)
+    {
+    }
+    /// Construct from document.
+    JSONDocumentInputArchive(Context* context, const JSONDocument& document)
+        : JSONArchiveBase(context, document.GetName())
+        , rootValue_(document.GetRoot())
+    {
+    }
+
+    /// @name Archive implementation
+    /// @{
+    void BeginBlock(const char* name, unsigned& sizeHint, bool safe, ArchiveBlockType type) final;
+
+    void Serialize(const char* name, bool& value) final;
+    void Serialize(const char* name, signed char& value) final;
+    void Serialize(const char* name, unsigned char& value) final;
+    void Serialize(const char* name, short& value) final;
+    void Serialize(const char* name, unsigned short& value) final;
+    void Serialize(const char* name, int& value) final;
+    void Serialize(const char* name, unsigned int& value) final;
+    void Serialize(const char* name, long long& value) final;
+    void Serialize(const char* name, unsigned long long& value) final;
+    void Serialize(const char* name, float& value) final;
+    void Serialize(const char* name, double& value) final;
+    void Serialize(const char* name, ea::string& value) final;
+
+    void SerializeBytes(const char* name, void* bytes, unsigned size) final;
+    void SerializeVLE(const char* name, unsigned& value) final;
+    /// @}
+
+private:
+    const JSONDocumentValue& ReadElement(const char* name);
+    void CheckType(const char* name, const JSONDocumentValue& value, JSONValueType type) const;
+
+    const JSONDocumentValue& rootValue_;
+};
+
 }
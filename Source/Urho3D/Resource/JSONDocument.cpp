@@ -0,0 +1,347 @@
+//
+// Copyright (c) 2021-2022 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "../Precompiled.h"
+
+#include "../Core/Profiler.h"
+#include "../IO/Deserializer.h"
+#include "../IO/Log.h"
+#include "../Math/MathDefs.h"
+#include "../Resource/JSONDocument.h"
+
+#include <EASTL/sort.h>
+
+#include <rapidjson/error/en.h>
+#include <rapidjson/reader.h>
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+/// SAX handler that appends parsed values to JSONDocument.
+class JSONDocumentBuilder
+{
+public:
+    explicit JSONDocumentBuilder(JSONDocument& document)
+        : document_(document)
+    {
+    }
+
+    /// @name SAX handler implementation
+    /// @{
+    bool Null()
+    {
+        AddValue(JSON_NULL);
+        return true;
+    }
+
+    bool Bool(bool value)
+    {
+        AddValue(JSON_BOOL).bool_ = value;
+        return true;
+    }
+
+    bool Int(int value) { return Int64(value); }
+    bool Uint(unsigned value) { return Uint64(value); }
+
+    bool Int64(int64_t value)
+    {
+        AddNumber(JSONNT_INT).int_ = value;
+        return true;
+    }
+
+    bool Uint64(uint64_t value)
+    {
+        AddNumber(JSONNT_UINT).uint_ = value;
+        return true;
+    }
+
+    bool Double(double value)
+    {
+        AddNumber(JSONNT_FLOAT_DOUBLE).number_ = value;
+        return true;
+    }
+
+    bool RawNumber(const char* str, rapidjson::SizeType length, bool copy) { return false; }
+
+    bool String(const char* str, rapidjson::SizeType length, bool copy)
+    {
+        // Strings are never copied when parsing in place
+        assert(!copy);
+        JSONDocumentValue& value = AddValue(JSON_STRING);
+        value.string_ = str;
+        value.size_ = length;
+        return true;
+    }
+
+    bool Key(const char* str, rapidjson::SizeType length, bool copy)
+    {
+        assert(!copy);
+        key_ = str;
+        keySize_ = length;
+        return true;
+    }
+
+    bool StartObject() { return BeginContainer(JSON_OBJECT); }
+    bool EndObject(rapidjson::SizeType memberCount) { return EndContainer(memberCount); }
+    bool StartArray() { return BeginContainer(JSON_ARRAY); }
+    bool EndArray(rapidjson::SizeType elementCount) { return EndContainer(elementCount); }
+    /// @}
+
+    /// Resolve children of arrays and objects when parsing is finished.
+    void Finalize()
+    {
+        auto& values = document_.values_;
+        auto& children = document_.children_;
+
+        children.resize(childIndices_.size());
+        for (unsigned i = 0; i < childIndices_.size(); ++i)
+            children[i] = &values[childIndices_[i]];
+
+        for (JSONDocumentValue& value : values)
+        {
+            if (value.IsArray() || value.IsObject())
+            {
+                const unsigned offset = value.childrenOffset_;
+                value.children_ = children.data() + offset;
+            }
+        }
+    }
+
+private:
+    JSONDocumentValue& AddValue(JSONValueType type)
+    {
+        auto& values = document_.values_;
+        if (!openContainers_.empty())
+            pendingChildren_.push_back(values.size());
+
+        JSONDocumentValue& value = values.emplace_back();
+        value.type_ = type;
+        value.key_ = key_;
+        value.keySize_ = keySize_;
+
+        key_ = nullptr;
+        keySize_ = 0;
+        return value;
+    }
+
+    JSONDocumentValue& AddNumber(JSONNumberType numberType)
+    {
+        JSONDocumentValue& value = AddValue(JSON_NUMBER);
+        value.numberType_ = numberType;
+        return value;
+    }
+
+    bool BeginContainer(JSONValueType type)
+    {
+        const unsigned index = document_.values_.size();
+        AddValue(type);
+        openContainers_.push_back(index);
+        return true;
+    }
+
+    bool EndContainer(unsigned size)
+    {
+        JSONDocumentValue& value = document_.values_[openContainers_.back()];
+        openContainers_.pop_back();
+
+        // Children of nested containers are already removed from the stack, so last elements belong to this container
+        value.size_ = size;
+        value.childrenOffset_ = childIndices_.size();
+        childIndices_.insert(childIndices_.end(), pendingChildren_.end() - size, pendingChildren_.end());
+
+        // Large objects also get members sorted by name, stable sort keeps duplicates in document order
+        if (value.IsObject() && size >= JSONDocumentValue::MinIndexedObjectSize)
+        {
+            const auto& values = document_.values_;
+            const unsigned sortedOffset = childIndices_.size();
+            childIndices_.insert(childIndices_.end(), pendingChildren_.end() - size, pendingChildren_.end());
+            ea::stable_sort(childIndices_.begin() + sortedOffset, childIndices_.end(),
+                [&](unsigned lhs, unsigned rhs) { return values[lhs].GetKey() < values[rhs].GetKey(); });
+        }
+
+        pendingChildren_.resize(pendingChildren_.size() - size);
+        return true;
+    }
+
+    JSONDocument& document_;
+
+    /// Name of the next value.
+    const char* key_{};
+    unsigned keySize_{};
+    /// Indices of open arrays and objects.
+    ea::vector<unsigned> openContainers_;
+    /// Indices of children of open arrays and objects.
+    ea::vector<unsigned> pendingChildren_;
+    /// Indices of children of closed arrays and objects.
+    ea::vector<unsigned> childIndices_;
+};
+
+const JSONDocumentValue JSONDocumentValue::EMPTY;
+
+const JSONDocumentValue* JSONDocumentValue::Find(ea::string_view key) const
+{
+    if (!IsObject())
+        return nullptr;
+
+    if (size_ >= MinIndexedObjectSize)
+    {
+        // The last member with matching name precedes the upper bound
+        const JSONDocumentValue* const* sortedBegin = children_ + size_;
+        const JSONDocumentValue* const* sortedEnd = sortedBegin + size_;
+        const auto iter = ea::upper_bound(sortedBegin, sortedEnd, key,
+            [](ea::string_view lhs, const JSONDocumentValue* rhs) { return lhs < rhs->GetKey(); });
+        if (iter != sortedBegin && (*(iter - 1))->GetKey() == key)
+            return *(iter - 1);
+        return nullptr;
+    }
+
+    for (unsigned i = size_; i > 0; --i)
+    {
+        const JSONDocumentValue* child = children_[i - 1];
+        if (child->GetKey() == key)
+            return child;
+    }
+    return nullptr;
+}
+
+const JSONDocumentValue& JSONDocumentValue::Get(ea::string_view key) const
+{
+    const JSONDocumentValue* child = Find(key);
+    return child ? *child : EMPTY;
+}
+
+JSONValue JSONDocumentValue::ToJSONValue() const
+{
+    switch (type_)
+    {
+    case JSON_BOOL:
+        return JSONValue{ bool_ };
+
+    case JSON_NUMBER:
+        // JSONValue cannot store 64-bit integers, they are converted to double like in JSONFile
+        if (numberType_ == JSONNT_INT && int_ >= M_MIN_INT && int_ <= M_MAX_INT)
+            return JSONValue{ static_cast<int>(int_) };
+        else if (numberType_ == JSONNT_UINT && uint_ <= M_MAX_UNSIGNED)
+            return JSONValue{ static_cast<unsigned>(uint_) };
+        else
+            return JSONValue{ GetDouble() };
+
+    case JSON_STRING:
+        return JSONValue{ ea::string{ GetString() } };
+
+    case JSON_ARRAY:
+    {
+        JSONValue result{ JSON_ARRAY };
+        result.Resize(size_);
+        for (unsigned i = 0; i < size_; ++i)
+            result[i] = children_[i]->ToJSONValue();
+        return result;
+    }
+
+    case JSON_OBJECT:
+    {
+        JSONValue result{ JSON_OBJECT };
+        for (unsigned i = 0; i < size_; ++i)
+            result.Set(ea::string{ children_[i]->GetKey() }, children_[i]->ToJSONValue());
+        return result;
+    }
+
+    case JSON_NULL:
+    default:
+        return JSONValue{};
+    }
+}
+
+JSONDocument::JSONDocument() = default;
+
+JSONDocument::~JSONDocument() = default;
+
+bool JSONDocument::Load(Deserializer& source)
+{
+    URHO3D_PROFILE("LoadJSONDocument");
+
+    Clear();
+    name_ = source.GetName();
+
+    const unsigned dataSize = source.GetSize() - source.GetPosition();
+    buffer_.resize(dataSize + 1);
+    if (source.Read(buffer_.data(), dataSize) != dataSize)
+    {
+        URHO3D_LOGERROR("Could not read JSON data from {}", name_);
+        Clear();
+        return false;
+    }
+    buffer_[dataSize] = '\0';
+
+    return ParseBuffer();
+}
+
+bool JSONDocument::Parse(ea::string_view text, ea::string_view name)
+{
+    Clear();
+    name_ = name;
+
+    buffer_.resize(text.size() + 1);
+    ea::copy(text.begin(), text.end(), buffer_.begin());
+    buffer_[text.size()] = '\0';
+
+    return ParseBuffer();
+}
+
+void JSONDocument::Clear()
+{
+    name_.clear();
+    buffer_.clear();
+    values_.clear();
+    children_.clear();
+}
+
+unsigned JSONDocument::GetMemoryUse() const
+{
+    return buffer_.capacity() + values_.capacity() * sizeof(JSONDocumentValue)
+        + children_.capacity() * sizeof(const JSONDocumentValue*);
+}
+
+bool JSONDocument::ParseBuffer()
+{
+    using namespace rapidjson;
+    static constexpr unsigned flags = kParseInsituFlag | kParseCommentsFlag | kParseTrailingCommasFlag;
+
+    JSONDocumentBuilder builder(*this);
+    Reader reader;
+    InsituStringStream stream(buffer_.data());
+    const ParseResult result = reader.Parse<flags>(stream, builder);
+    if (result.IsError())
+    {
+        URHO3D_LOGERROR("Could not parse JSON data from {}: {} at offset {}",
+            name_, GetParseError_En(result.Code()), result.Offset());
+        Clear();
+        return false;
+    }
+
+    builder.Finalize();
+    return true;
+}
+
+}
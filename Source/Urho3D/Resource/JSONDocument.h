@@ -0,0 +1,186 @@
+//
+// Copyright (c) 2021-2022 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include "../Core/NonCopyable.h"
+#include "../Resource/JSONValue.h"
+
+#include <EASTL/string_view.h>
+#include <EASTL/vector.h>
+
+namespace Urho3D
+{
+
+class Deserializer;
+
+/// Read-only JSON value stored in JSONDocument. Strings reference the source buffer of the document.
+class URHO3D_API JSONDocumentValue
+{
+    friend class JSONDocument;
+    friend class JSONDocumentBuilder;
+
+public:
+    /// Return value type.
+    JSONValueType GetValueType() const { return type_; }
+    /// Return number type.
+    JSONNumberType GetNumberType() const { return numberType_; }
+
+    /// Check is null.
+    bool IsNull() const { return type_ == JSON_NULL; }
+    /// Check is boolean.
+    bool IsBool() const { return type_ == JSON_BOOL; }
+    /// Check is number.
+    bool IsNumber() const { return type_ == JSON_NUMBER; }
+    /// Check is string.
+    bool IsString() const { return type_ == JSON_STRING; }
+    /// Check is array.
+    bool IsArray() const { return type_ == JSON_ARRAY; }
+    /// Check is object.
+    bool IsObject() const { return type_ == JSON_OBJECT; }
+
+    /// Return boolean value.
+    bool GetBool(bool defaultValue = false) const { return IsBool() ? bool_ : defaultValue; }
+    /// Return integer value.
+    int GetInt(int defaultValue = 0) const { return GetNumber<int>(defaultValue); }
+    /// Return unsigned integer value.
+    unsigned GetUInt(unsigned defaultValue = 0) const { return GetNumber<unsigned>(defaultValue); }
+    /// Return 64-bit integer value.
+    long long GetInt64(long long defaultValue = 0) const { return GetNumber<long long>(defaultValue); }
+    /// Return 64-bit unsigned integer value.
+    unsigned long long GetUInt64(unsigned long long defaultValue = 0) const { return GetNumber<unsigned long long>(defaultValue); }
+    /// Return float value.
+    float GetFloat(float defaultValue = 0.0f) const { return GetNumber<float>(defaultValue); }
+    /// Return double value.
+    double GetDouble(double defaultValue = 0.0) const { return GetNumber<double>(defaultValue); }
+    /// Return string value. The string is null-terminated.
+    ea::string_view GetString(ea::string_view defaultValue = {}) const { return IsString() ? ea::string_view{ string_, size_ } : defaultValue; }
+    /// Return name of the value if it is a member of object. The name is null-terminated.
+    ea::string_view GetKey() const { return key_ ? ea::string_view{ key_, keySize_ } : ea::string_view{}; }
+
+    /// Return size of array or number of members in object.
+    unsigned Size() const { return IsArray() || IsObject() ? size_ : 0; }
+    /// Return element of array or member of object by index.
+    const JSONDocumentValue& operator [](unsigned index) const { return Get(index); }
+    /// Return element of array or member of object by index.
+    const JSONDocumentValue& Get(unsigned index) const { return index < Size() ? *children_[index] : EMPTY; }
+    /// Return member of object by name or null if not found. The last member wins if names are duplicated.
+    const JSONDocumentValue* Find(ea::string_view key) const;
+    /// Return member of object by name.
+    const JSONDocumentValue& Get(ea::string_view key) const;
+    /// Return whether object contains member with given name.
+    bool Contains(ea::string_view key) const { return Find(key) != nullptr; }
+
+    /// Copy value into mutable JSON value.
+    JSONValue ToJSONValue() const;
+
+    /// Empty JSON value.
+    static const JSONDocumentValue EMPTY;
+    /// Objects with at least this number of members are searched by name via sorted index.
+    static constexpr unsigned MinIndexedObjectSize = 16;
+
+private:
+    /// Return number converted to given type.
+    template <class T> T GetNumber(T defaultValue) const
+    {
+        switch (IsNumber() ? numberType_ : JSONNT_NAN)
+        {
+        case JSONNT_INT: return static_cast<T>(int_);
+        case JSONNT_UINT: return static_cast<T>(uint_);
+        case JSONNT_FLOAT_DOUBLE: return static_cast<T>(number_);
+        default: return defaultValue;
+        }
+    }
+
+    /// Value type.
+    JSONValueType type_{ JSON_NULL };
+    /// Number type.
+    JSONNumberType numberType_{ JSONNT_NAN };
+    /// String length or number of children.
+    unsigned size_{};
+    /// Name length.
+    unsigned keySize_{};
+    /// Name if the value is a member of object.
+    const char* key_{};
+    union
+    {
+        /// Floating point number value.
+        double number_{};
+        /// Signed integer value, stored exactly.
+        long long int_;
+        /// Unsigned integer value, stored exactly.
+        unsigned long long uint_;
+        /// Boolean value.
+        bool bool_;
+        /// String value.
+        const char* string_;
+        /// Children of array or object. Large objects also have children sorted by name stored after them.
+        const JSONDocumentValue* const* children_;
+        /// Offset of children, used while document is being parsed.
+        unsigned childrenOffset_;
+    };
+};
+
+/// Read-only JSON document parsed in place.
+/// All values are stored in one array and strings are not copied from the source buffer,
+/// so the document is much cheaper to load than JSONFile.
+class URHO3D_API JSONDocument : public NonCopyable
+{
+    friend class JSONDocumentBuilder;
+
+public:
+    /// Construct empty document.
+    JSONDocument();
+    /// Destruct.
+    ~JSONDocument();
+
+    /// Read and parse document from stream. Return true if successful.
+    bool Load(Deserializer& source);
+    /// Parse document from string. The string is copied. Return true if successful.
+    bool Parse(ea::string_view text, ea::string_view name = {});
+    /// Clear document.
+    void Clear();
+
+    /// Return name of the document source.
+    const ea::string& GetName() const { return name_; }
+    /// Return root value.
+    const JSONDocumentValue& GetRoot() const { return values_.empty() ? JSONDocumentValue::EMPTY : values_.front(); }
+    /// Return total number of values in the document.
+    unsigned GetNumValues() const { return values_.size(); }
+    /// Return memory used by the document, including source buffer.
+    unsigned GetMemoryUse() const;
+
+private:
+    /// Parse content of the buffer in place.
+    bool ParseBuffer();
+
+    /// Name of the document source.
+    ea::string name_;
+    /// Source buffer. Strings of values point into it.
+    ea::vector<char> buffer_;
+    /// Values in depth-first order.
+    ea::vector<JSONDocumentValue> values_;
+    /// Children of all arrays and objects.
+    ea::vector<const JSONDocumentValue*> children_;
+};
+
+}
@@ -30,6 +30,8 @@
 #include "../IO/ArchiveSerialization.h"
 #include "../Resource/JSONValue.h"
 
+#include <atomic>
+
 namespace Urho3D
 {
 
@@ -88,6 +90,8 @@ public:
     void SetMemoryUse(unsigned size);
     /// Reset last used timer.
     void ResetUseTimer();
+    /// Set frame number when the resource was last used. Called by ResourceCache. Is thread-safe.
+    void SetLastUsedFrame(unsigned frame) { lastUsedFrame_.store(frame, std::memory_order_relaxed); }
     /// Set the asynchronous loading state. Called by ResourceCache. Resources in the middle of asynchronous loading are not normally returned to user.
     void SetAsyncLoadState(AsyncLoadState newState);
     /// Set absolute file name.
@@ -108,6 +112,9 @@ public:
     /// @property
     unsigned GetUseTimer();
 
+    /// Return frame number when the resource was last used, as counted by ResourceCache.
+    unsigned GetLastUsedFrame() const { return lastUsedFrame_.load(std::memory_order_relaxed); }
+
     /// Return the asynchronous loading state.
     AsyncLoadState GetAsyncLoadState() const { return asyncLoadState_; }
 
@@ -125,6 +132,8 @@ private:
     Timer useTimer_;
     /// Memory use in bytes.
     unsigned memoryUse_;
+    /// Last used frame number.
+    std::atomic<unsigned> lastUsedFrame_{};
     /// Asynchronous loading state.
     AsyncLoadState asyncLoadState_;
 };
@@ -44,6 +44,8 @@
 
 #include "../DebugNew.h"
 
+#include <EASTL/sort.h>
+
 #include <cstdio>
 
 namespace Urho3D
@@ -190,7 +192,8 @@ bool ResourceCache::AddManualResource(Resource* resource)
     }
 
     resource->ResetUseTimer();
-    resourceGroups_[resource->GetType()].resources_[resource->GetNameHash()] = resource;
+    MarkResourceStored(resource);
+    StoreResource(resource->GetType(), resource);
     UpdateResourceGroup(resource->GetType());
     return true;
 }
@@ -268,6 +271,7 @@ void ResourceCache::ReleaseResource(StringHash type, const ea::string& name, boo
     // If other references exist, do not release, unless forced
     if ((existingRes.Refs() == 1 && existingRes.WeakRefs() == 0) || force)
     {
+        lookupTable_.Remove(type, nameHash);
         resourceGroups_[type].resources_.erase(nameHash);
         UpdateResourceGroup(type);
     }
@@ -292,6 +296,7 @@ void ResourceCache::ReleaseResource(const ea::string& resourceName, bool force)
                     // If other references exist, do not release, unless forced
                     if ((current->second.Refs() == 1 && current->second.WeakRefs() == 0) || force)
                     {
+                        lookupTable_.Remove(i->first, current->first);
                         j = i->second.resources_.erase(current);
                         released = true;
                         continue;
@@ -320,6 +325,7 @@ void ResourceCache::ReleaseResources(StringHash type, bool force)
             // If other references exist, do not release, unless forced
             if ((current->second.Refs() == 1 && current->second.WeakRefs() == 0) || force)
             {
+                lookupTable_.Remove(type, current->first);
                 i->second.resources_.erase(current);
                 released = true;
             }
@@ -346,6 +352,7 @@ void ResourceCache::ReleaseResources(StringHash type, const ea::string& partialN
                 // If other references exist, do not release, unless forced
                 if ((current->second.Refs() == 1 && current->second.WeakRefs() == 0) || force)
                 {
+                    lookupTable_.Remove(i->first, current->first);
                     i->second.resources_.erase(current);
                     released = true;
                 }
@@ -378,6 +385,7 @@ void ResourceCache::ReleaseResources(const ea::string& partialName, bool force)
                     // If other references exist, do not release, unless forced
                     if ((current->second.Refs() == 1 && current->second.WeakRefs() == 0) || force)
                     {
+                        lookupTable_.Remove(i->first, current->first);
                         i->second.resources_.erase(current);
                         released = true;
                     }
@@ -407,6 +415,7 @@ void ResourceCache::ReleaseAllResources(bool force)
                 // If other references exist, do not release, unless forced
                 if ((current->second.Refs() == 1 && current->second.WeakRefs() == 0) || force)
                 {
+                    lookupTable_.Remove(i->first, current->first);
                     i->second.resources_.erase(current);
                     released = true;
                 }
@@ -495,6 +504,23 @@ void ResourceCache::SetMemoryBudget(StringHash type, unsigned long long budget)
     resourceGroups_[type].memoryBudget_ = budget;
 }
 
+void ResourceCache::SetResidencyBudget(unsigned long long softBudget, unsigned long long hardBudget)
+{
+    softResidencyBudget_ = softBudget;
+    hardResidencyBudget_ = hardBudget;
+    overHardResidencyBudget_ = false;
+}
+
+void ResourceCache::ResetResidencyStats()
+{
+    const ResourceResidencyStats oldStats = residencyStats_;
+    residencyStats_ = {};
+    residencyStats_.memoryUse_ = oldStats.memoryUse_;
+    residencyStats_.evictableMemoryUse_ = oldStats.evictableMemoryUse_;
+    residencyStats_.numResources_ = oldStats.numResources_;
+    evictedResources_.clear();
+}
+
 void ResourceCache::SetAutoReloadResources(bool enable)
 {
     if (enable != autoReloadResources_)
@@ -590,26 +616,36 @@ SharedPtr<File> ResourceCache::GetFile(const ea::string& name, bool sendEventOnF
     return SharedPtr<File>();
 }
 
-Resource* ResourceCache::GetExistingResource(StringHash type, const ea::string& name)
+Resource* ResourceCache::GetExistingResource(StringHash type, const ea::string& name) const
 {
     ea::string sanitatedName = SanitateResourceName(name);
 
-    if (!Thread::IsMainThread())
-    {
-        URHO3D_LOGERROR("Attempted to get resource " + sanitatedName + " from outside the main thread");
-        return nullptr;
-    }
-
     // If empty name, return null pointer immediately
     if (sanitatedName.empty())
         return nullptr;
 
     StringHash nameHash(sanitatedName);
 
-    const SharedPtr<Resource>& existing = type == StringHash::ZERO ? FindResource(type, nameHash) : FindResource(nameHash);
+    Resource* existing = type != StringHash::ZERO ? lookupTable_.Find(type, nameHash) : lookupTable_.Find(nameHash);
+    if (existing)
+        MarkResourceUsed(existing);
     return existing;
 }
 
+Resource* ResourceCache::GetOrRequestResource(StringHash type, const ea::string& name)
+{
+    if (Resource* existing = GetExistingResource(type, name))
+        return existing;
+
+#ifdef URHO3D_THREADING
+    BackgroundLoadResource(type, name);
+    return nullptr;
+#else
+    // When threading not supported, there is no other thread to request from
+    return GetResource(type, name);
+#endif
+}
+
 Resource* ResourceCache::GetResource(StringHash type, const ea::string& name, bool sendEventOnFailure)
 {
     ea::string sanitatedName = SanitateResourceName(name);
@@ -633,7 +669,10 @@ Resource* ResourceCache::GetResource(StringHash type, const ea::string& name, bo
 
     const SharedPtr<Resource>& existing = FindResource(type, nameHash);
     if (existing)
+    {
+        MarkResourceUsed(existing);
         return existing;
+    }
 
     SharedPtr<Resource> resource;
     // Make sure the pointer is non-null and is a Resource subclass
@@ -681,7 +720,8 @@ Resource* ResourceCache::GetResource(StringHash type, const ea::string& name, bo
 
     // Store to cache
     resource->ResetUseTimer();
-    resourceGroups_[type].resources_[nameHash] = resource;
+    MarkResourceStored(resource);
+    StoreResource(type, resource);
     UpdateResourceGroup(type);
 
     return resource;
@@ -697,7 +737,7 @@ bool ResourceCache::BackgroundLoadResource(StringHash type, const ea::string& na
 
     // First check if already exists as a loaded resource
     StringHash nameHash(sanitatedName);
-    if (FindResource(type, nameHash) != noResource)
+    if (lookupTable_.Find(type, nameHash))
         return false;
 
     return backgroundLoader_->QueueResource(type, sanitatedName, sendEventOnFailure, caller);
@@ -1026,6 +1066,23 @@ ea::string ResourceCache::PrintMemoryUsage() const
     return output;
 }
 
+ea::string ResourceCache::PrintResidencyStats() const
+{
+    const ResourceResidencyStats& stats = residencyStats_;
+    const auto budgetString = [](unsigned long long budget) { return budget ? GetFileSizeString(budget) : ea::string("-"); };
+
+    ea::string output;
+    output += Format("Residency budget      soft {}, hard {}, min unused frames {}\n",
+        budgetString(softResidencyBudget_), budgetString(hardResidencyBudget_), residencyMinUnusedFrames_);
+    output += Format("Memory use            {} in {} resources, {} evictable\n",
+        GetFileSizeString(stats.memoryUse_), stats.numResources_, GetFileSizeString(stats.evictableMemoryUse_));
+    output += Format("Evictions             {} soft, {} hard, {} total\n",
+        stats.numSoftEvictions_, stats.numHardEvictions_, GetFileSizeString(stats.evictedMemory_));
+    output += Format("Reloads after evict   {}\n", stats.numReloads_);
+    output += Format("Frames over hard      {}\n", stats.numFramesOverHardBudget_);
+    return output;
+}
+
 const SharedPtr<Resource>& ResourceCache::FindResource(StringHash type, StringHash nameHash)
 {
     MutexLock lock(resourceMutex_);
@@ -1074,6 +1131,7 @@ void ResourceCache::ReleasePackageResources(PackageFile* package, bool force)
                 // If other references exist, do not release, unless forced
                 if ((k->second.Refs() == 1 && k->second.WeakRefs() == 0) || force)
                 {
+                    lookupTable_.Remove(j->first, k->first);
                     j->second.resources_.erase(k);
                     affectedGroups.insert(j->first);
                 }
@@ -1119,6 +1177,7 @@ void ResourceCache::UpdateResourceGroup(StringHash type)
         {
             URHO3D_LOGDEBUG("Resource group " + oldestResource->second->GetTypeName() + " over memory budget, releasing resource " +
                      oldestResource->second->GetName());
+            lookupTable_.Remove(type, oldestResource->first);
             i->second.resources_.erase(oldestResource);
         }
         else
@@ -1126,8 +1185,127 @@ void ResourceCache::UpdateResourceGroup(StringHash type)
     }
 }
 
+void ResourceCache::StoreResource(StringHash type, Resource* resource)
+{
+    const StringHash nameHash = resource->GetNameHash();
+    resourceGroups_[type].resources_[nameHash] = resource;
+    lookupTable_.Add(type, nameHash, resource);
+}
+
+void ResourceCache::MarkResourceStored(Resource* resource)
+{
+    MarkResourceUsed(resource);
+    if (evictedResources_.erase(resource->GetNameHash()))
+        ++residencyStats_.numReloads_;
+}
+
+void ResourceCache::UpdateResidency()
+{
+    if (!softResidencyBudget_ && !hardResidencyBudget_)
+        return;
+
+    URHO3D_PROFILE("UpdateResidency");
+
+    ResourceResidencyStats& stats = residencyStats_;
+    stats.memoryUse_ = 0;
+    stats.evictableMemoryUse_ = 0;
+    stats.numResources_ = 0;
+
+    // Resources referenced outside of the cache are in use, only the rest can be evicted
+    evictionCandidates_.clear();
+    for (auto& [type, group] : resourceGroups_)
+    {
+        for (auto& [nameHash, resource] : group.resources_)
+        {
+            const unsigned memoryUse = resource->GetMemoryUse();
+            stats.memoryUse_ += memoryUse;
+            ++stats.numResources_;
+
+            if (resource.Refs() > 1)
+                MarkResourceUsed(resource);
+            else if (resource->GetAsyncLoadState() == ASYNC_DONE)
+            {
+                stats.evictableMemoryUse_ += memoryUse;
+                evictionCandidates_.push_back(resource);
+            }
+        }
+    }
+
+    const auto isOverBudget = [&](unsigned long long budget) { return budget && stats.memoryUse_ > budget; };
+    if (!isOverBudget(softResidencyBudget_) && !isOverBudget(hardResidencyBudget_))
+    {
+        overHardResidencyBudget_ = false;
+        return;
+    }
+
+    ea::sort(evictionCandidates_.begin(), evictionCandidates_.end(),
+        [](const Resource* lhs, const Resource* rhs) { return lhs->GetLastUsedFrame() < rhs->GetLastUsedFrame(); });
+
+    ea::hash_set<StringHash> affectedGroups;
+    unsigned numEvicted = 0;
+    unsigned long long evictedMemory = 0;
+    for (Resource* resource : evictionCandidates_)
+    {
+        const bool overHardBudget = isOverBudget(hardResidencyBudget_);
+        if (!overHardBudget && !isOverBudget(softResidencyBudget_))
+            break;
+
+        // Candidates are sorted, so the rest of them were used recently too
+        if (!overHardBudget && GetCurrentFrame() - resource->GetLastUsedFrame() < residencyMinUnusedFrames_)
+            break;
+
+        const unsigned memoryUse = resource->GetMemoryUse();
+        const StringHash type = resource->GetType();
+        const StringHash nameHash = resource->GetNameHash();
+
+        URHO3D_LOGDEBUG("Resource cache over {} memory budget, evicting resource {}",
+            overHardBudget ? "hard" : "soft", resource->GetName());
+
+        if (overHardBudget)
+            ++stats.numHardEvictions_;
+        else
+            ++stats.numSoftEvictions_;
+        stats.evictedMemory_ += memoryUse;
+        stats.memoryUse_ -= memoryUse;
+        stats.evictableMemoryUse_ -= memoryUse;
+        --stats.numResources_;
+        ++numEvicted;
+        evictedMemory += memoryUse;
+
+        // Resource is destroyed here
+        evictedResources_.insert(nameHash);
+        affectedGroups.insert(type);
+        lookupTable_.Remove(type, nameHash);
+        resourceGroups_[type].resources_.erase(nameHash);
+    }
+    evictionCandidates_.clear();
+
+    for (StringHash type : affectedGroups)
+        UpdateResourceGroup(type);
+
+    if (numEvicted > 0)
+    {
+        URHO3D_LOGDEBUG("Evicted {} resources ({}), memory use {}", numEvicted, GetFileSizeString(evictedMemory),
+            GetFileSizeString(stats.memoryUse_));
+    }
+
+    const bool overHardBudget = isOverBudget(hardResidencyBudget_);
+    if (overHardBudget)
+    {
+        ++stats.numFramesOverHardBudget_;
+        if (!overHardResidencyBudget_)
+        {
+            URHO3D_LOGWARNING("Resources in use exceed hard memory budget: {} of {}", GetFileSizeString(stats.memoryUse_),
+                GetFileSizeString(hardResidencyBudget_));
+        }
+    }
+    overHardResidencyBudget_ = overHardBudget;
+}
+
 void ResourceCache::HandleBeginFrame(StringHash eventType, VariantMap& eventData)
 {
+    currentFrame_.fetch_add(1, std::memory_order_relaxed);
+
     for (unsigned i = 0; i < fileWatchers_.size(); ++i)
     {
         FileChange change;
@@ -1159,6 +1337,8 @@ void ResourceCache::HandleBeginFrame(StringHash eventType, VariantMap& eventData
         backgroundLoader_->FinishResources(finishBackgroundResourcesMs_);
     }
 #endif
+
+    UpdateResidency();
 }
 
 File* ResourceCache::SearchResourceDirs(const ea::string& name)
@@ -1390,10 +1570,11 @@ bool ResourceCache::RenameResource(const ea::string& source, const ea::string& d
                 ignoreResourceAutoReload_.emplace_back(resource->GetName());
             }
 
+            lookupTable_.Remove(groupPair.first, resource->GetNameHash());
             groupPair.second.resources_.erase(resource->GetNameHash());
             resource->SetName(newName);
             resource->SetAbsoluteFileName(newNativeFileName);
-            groupPair.second.resources_[resource->GetNameHash()] = resource;
+            StoreResource(groupPair.first, resource);
             movedAny = true;
 
             using namespace ResourceRenamed;
@@ -1436,6 +1617,7 @@ void ResourceCache::RouteResourceName(ea::string& name, ResourceRequest requestT
 
 void ResourceCache::Clear()
 {
+    lookupTable_.Clear();
     resourceGroups_.clear();
     dependentResources_.clear();
 }
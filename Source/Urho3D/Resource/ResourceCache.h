@@ -31,6 +31,7 @@
 #include "../Core/Mutex.h"
 #include "../IO/File.h"
 #include "../Resource/Resource.h"
+#include "../Resource/ResourceLookupTable.h"
 
 namespace Urho3D
 {
@@ -60,6 +61,27 @@ struct ResourceGroup
     ea::unordered_map<StringHash, SharedPtr<Resource> > resources_;
 };
 
+/// Statistics of resource residency management.
+struct ResourceResidencyStats
+{
+    /// Memory used by all resources in the cache.
+    unsigned long long memoryUse_{};
+    /// Memory used by resources which are not referenced outside of the cache and can be evicted.
+    unsigned long long evictableMemoryUse_{};
+    /// Number of resources in the cache.
+    unsigned numResources_{};
+    /// Number of resources evicted because soft budget was exceeded.
+    unsigned numSoftEvictions_{};
+    /// Number of resources evicted because hard budget was exceeded.
+    unsigned numHardEvictions_{};
+    /// Total memory of evicted resources.
+    unsigned long long evictedMemory_{};
+    /// Number of evicted resources that were loaded again.
+    unsigned numReloads_{};
+    /// Number of frames when memory use stayed over hard budget after eviction.
+    unsigned numFramesOverHardBudget_{};
+};
+
 /// Resource request types.
 enum ResourceRequest
 {
@@ -128,6 +150,19 @@ public:
     /// Set memory budget for a specific resource type, default 0 is unlimited.
     /// @property
     void SetMemoryBudget(StringHash type, unsigned long long budget);
+    /// Set soft and hard memory budgets for all resources, default 0 is unlimited. Checked once per frame.
+    /// Over soft budget, resources unused for minimum number of frames are evicted, least recently used first.
+    /// Over hard budget, least recently used resources are evicted regardless of how recently they were used.
+    /// Only resources not referenced outside of the cache are evicted, use ResourceHandle to refer to evictable resources.
+    void SetResidencyBudget(unsigned long long softBudget, unsigned long long hardBudget);
+    /// Set number of frames a resource should stay unused before it may be evicted due to soft budget. Default 60.
+    /// @property
+    void SetResidencyMinUnusedFrames(unsigned frames) { residencyMinUnusedFrames_ = frames; }
+    /// Mark resource as used in current frame. Resources returned by GetResource and GetExistingResource are marked automatically.
+    /// Is thread-safe.
+    void MarkResourceUsed(Resource* resource) const { resource->SetLastUsedFrame(GetCurrentFrame()); }
+    /// Reset residency statistics. Memory use is kept.
+    void ResetResidencyStats();
     /// Enable or disable automatic reloading of resources as files are modified. Default false.
     /// @property
     void SetAutoReloadResources(bool enable);
@@ -156,13 +191,16 @@ public:
     SharedPtr<Resource> GetTempResource(StringHash type, const ea::string& name, bool sendEventOnFailure = true);
     /// Background load a resource. An event will be sent when complete. Return true if successfully stored to the load queue, false if eg. already exists. Can be called from outside the main thread.
     bool BackgroundLoadResource(StringHash type, const ea::string& name, bool sendEventOnFailure = true, Resource* caller = nullptr);
+    /// Return an already loaded resource of specific type & name. If not loaded yet, queue background loading and return null. Can be called from outside the main thread.
+    Resource* GetOrRequestResource(StringHash type, const ea::string& name);
     /// Return number of pending background-loaded resources.
     /// @property
     unsigned GetNumBackgroundLoadResources() const;
     /// Return all loaded resources of a specific type.
     void GetResources(ea::vector<Resource*>& result, StringHash type) const;
     /// Return an already loaded resource of specific type & name, or null if not found. Will not load if does not exist. Specifying zero type will search all types.
-    Resource* GetExistingResource(StringHash type, const ea::string& name);
+    /// Can be called from outside the main thread. Returned resource stays valid until it is released on the main thread, so outside the main thread it should be used only while the main thread cannot release resources, eg. in WorkQueue tasks the main thread waits for.
+    Resource* GetExistingResource(StringHash type, const ea::string& name) const;
 
     /// Return all loaded resources.
     const ea::unordered_map<StringHash, ResourceGroup>& GetAllResources() const { return resourceGroups_; }
@@ -178,7 +216,9 @@ public:
     /// Template version of returning a resource by name.
     template <class T> T* GetResource(const ea::string& name, bool sendEventOnFailure = true);
     /// Template version of returning an existing resource by name.
-    template <class T> T* GetExistingResource(const ea::string& name);
+    template <class T> T* GetExistingResource(const ea::string& name) const;
+    /// Template version of returning an existing resource by name or queueing it for background loading.
+    template <class T> T* GetOrRequestResource(const ea::string& name);
     /// Template version of loading a resource without storing it to the cache.
     template <class T> SharedPtr<T> GetTempResource(const ea::string& name, bool sendEventOnFailure = true);
     /// Template version of releasing a resource by name.
@@ -201,6 +241,20 @@ public:
     /// Return full absolute file name of resource if possible, or empty if not found.
     ea::string GetResourceFileName(const ea::string& name) const;
 
+    /// Return soft memory budget for all resources.
+    /// @property
+    unsigned long long GetSoftResidencyBudget() const { return softResidencyBudget_; }
+    /// Return hard memory budget for all resources.
+    /// @property
+    unsigned long long GetHardResidencyBudget() const { return hardResidencyBudget_; }
+    /// Return number of frames a resource should stay unused before it may be evicted due to soft budget.
+    /// @property
+    unsigned GetResidencyMinUnusedFrames() const { return residencyMinUnusedFrames_; }
+    /// Return current frame number used for resource usage tracking.
+    unsigned GetCurrentFrame() const { return currentFrame_.load(std::memory_order_relaxed); }
+    /// Return residency statistics. Memory use is updated once per frame if any residency budget is set.
+    const ResourceResidencyStats& GetResidencyStats() const { return residencyStats_; }
+
     /// Return whether automatic resource reloading is enabled.
     /// @property
     bool GetAutoReloadResources() const { return autoReloadResources_; }
@@ -233,6 +287,8 @@ public:
 
     /// Returns a formatted string containing the memory actively used.
     ea::string PrintMemoryUsage() const;
+    /// Returns a formatted string containing residency budgets and statistics.
+    ea::string PrintResidencyStats() const;
     /// Get the number of resource directories
     unsigned GetNumResourceDirs() const { return resourceDirs_.size(); }
     /// Get resource directory at a given index
@@ -263,6 +319,12 @@ private:
     void ReleasePackageResources(PackageFile* package, bool force = false);
     /// Update a resource group. Recalculate memory use and release resources if over memory budget.
     void UpdateResourceGroup(StringHash type);
+    /// Store resource to its group and lookup table.
+    void StoreResource(StringHash type, Resource* resource);
+    /// Track usage of resource just stored to the cache.
+    void MarkResourceStored(Resource* resource);
+    /// Evict least recently used resources if over residency budget.
+    void UpdateResidency();
     /// Handle begin frame event. Automatic resource reloads and the finalization of background loaded resources are processed here.
     void HandleBeginFrame(StringHash eventType, VariantMap& eventData);
     /// Search FileSystem for file.
@@ -272,8 +334,10 @@ private:
 
     /// Mutex for thread-safe access to the resource directories, resource packages and resource dependencies.
     mutable Mutex resourceMutex_;
-    /// Resources by type.
+    /// Resources by type. Modified and iterated only on the main thread.
     ea::unordered_map<StringHash, ResourceGroup> resourceGroups_;
+    /// Resources by type and name, for lookup from any thread. Kept in sync with resource groups.
+    ResourceLookupTable lookupTable_;
     /// Resource load directories.
     ea::vector<ea::string> resourceDirs_;
     /// File watchers for resource directories, if automatic reloading enabled.
@@ -298,14 +362,36 @@ private:
     int finishBackgroundResourcesMs_;
     /// List of resources that will not be auto-reloaded if reloading event triggers.
     ea::vector<ea::string> ignoreResourceAutoReload_;
+    /// Current frame number used for resource usage tracking.
+    std::atomic<unsigned> currentFrame_{};
+    /// Soft memory budget for all resources.
+    unsigned long long softResidencyBudget_{};
+    /// Hard memory budget for all resources.
+    unsigned long long hardResidencyBudget_{};
+    /// Number of frames a resource should stay unused before it may be evicted due to soft budget.
+    unsigned residencyMinUnusedFrames_{60};
+    /// Residency statistics.
+    ResourceResidencyStats residencyStats_;
+    /// Whether memory use was over hard budget after last eviction.
+    bool overHardResidencyBudget_{};
+    /// Names of evicted resources, used to count reloads.
+    ea::hash_set<StringHash> evictedResources_;
+    /// Eviction candidates. Kept to avoid allocations.
+    ea::vector<Resource*> evictionCandidates_;
 };
 
-template <class T> T* ResourceCache::GetExistingResource(const ea::string& name)
+template <class T> T* ResourceCache::GetExistingResource(const ea::string& name) const
 {
     StringHash type = T::GetTypeStatic();
     return static_cast<T*>(GetExistingResource(type, name));
 }
 
+template <class T> T* ResourceCache::GetOrRequestResource(const ea::string& name)
+{
+    StringHash type = T::GetTypeStatic();
+    return static_cast<T*>(GetOrRequestResource(type, name));
+}
+
 template <class T> T* ResourceCache::GetResource(const ea::string& name, bool sendEventOnFailure)
 {
     StringHash type = T::GetTypeStatic();
@@ -0,0 +1,106 @@
+//
+// Copyright (c) 2021-2022 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#pragma once
+
+#include "../Container/Ptr.h"
+#include "../Resource/ResourceCache.h"
+
+namespace Urho3D
+{
+
+/// Reference to a resource that does not keep it resident in the resource cache.
+/// When the resource is evicted, it is loaded again in background on next use. Can be used only from the main thread.
+template <class T> class ResourceHandle
+{
+public:
+    /// Construct empty.
+    ResourceHandle() = default;
+    /// Construct from resource name.
+    ResourceHandle(ResourceCache* cache, const ea::string& name)
+        : cache_(cache)
+        , name_(name)
+    {
+    }
+    /// Construct from resource stored in the resource cache.
+    explicit ResourceHandle(T* resource)
+        : cache_(resource ? resource->template GetSubsystem<ResourceCache>() : nullptr)
+        , name_(resource ? resource->GetName() : EMPTY_STRING)
+        , resource_(resource)
+    {
+    }
+
+    /// Return resource and mark it as used if it is resident. Otherwise queue background loading and return null.
+    T* Get()
+    {
+        if (T* resource = Acquire())
+            return resource;
+
+        if (cache_ && !name_.empty())
+            cache_->template BackgroundLoadResource<T>(name_);
+        return nullptr;
+    }
+
+    /// Return resource and mark it as used. Load it immediately if it is not resident.
+    T* GetOrLoad()
+    {
+        if (T* resource = Acquire())
+            return resource;
+
+        if (!cache_ || name_.empty())
+            return nullptr;
+
+        resource_ = cache_->template GetResource<T>(name_);
+        return resource_;
+    }
+
+    /// Return whether the resource was resident when last used and was not evicted since.
+    bool IsResident() const { return resource_ != nullptr; }
+    /// Return resource name.
+    const ea::string& GetName() const { return name_; }
+
+private:
+    /// Return resident resource and mark it as used.
+    T* Acquire()
+    {
+        if (!cache_)
+            return nullptr;
+
+        // Resource may have been loaded again since last use
+        if (!resource_ && !name_.empty())
+            resource_ = cache_->template GetExistingResource<T>(name_);
+
+        if (resource_)
+            cache_->MarkResourceUsed(resource_);
+        return resource_;
+    }
+
+    /// Resource cache.
+    WeakPtr<ResourceCache> cache_;
+    /// Resource name.
+    ea::string name_;
+    /// Resource, expires when evicted.
+    WeakPtr<T> resource_;
+};
+
+}
@@ -0,0 +1,98 @@
+//
+// Copyright (c) 2021-2022 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "../Precompiled.h"
+
+#include "../Resource/ResourceLookupTable.h"
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+void ResourceLookupTable::Add(StringHash type, StringHash nameHash, Resource* resource)
+{
+    Shard& shard = GetShard(nameHash);
+    MutexLock lock(shard.mutex_);
+
+    const auto range = shard.resources_.equal_range(nameHash);
+    for (auto iter = range.first; iter != range.second; ++iter)
+    {
+        if (iter->second.first == type)
+        {
+            iter->second.second = resource;
+            return;
+        }
+    }
+    shard.resources_.emplace(nameHash, ea::make_pair(type, resource));
+}
+
+void ResourceLookupTable::Remove(StringHash type, StringHash nameHash)
+{
+    Shard& shard = GetShard(nameHash);
+    MutexLock lock(shard.mutex_);
+
+    const auto range = shard.resources_.equal_range(nameHash);
+    for (auto iter = range.first; iter != range.second; ++iter)
+    {
+        if (iter->second.first == type)
+        {
+            shard.resources_.erase(iter);
+            return;
+        }
+    }
+}
+
+void ResourceLookupTable::Clear()
+{
+    for (Shard& shard : shards_)
+    {
+        MutexLock lock(shard.mutex_);
+        shard.resources_.clear();
+    }
+}
+
+Resource* ResourceLookupTable::Find(StringHash type, StringHash nameHash) const
+{
+    const Shard& shard = GetShard(nameHash);
+    MutexLock lock(shard.mutex_);
+
+    const auto range = shard.resources_.equal_range(nameHash);
+    for (auto iter = range.first; iter != range.second; ++iter)
+    {
+        if (iter->second.first == type)
+            return iter->second.second;
+    }
+    return nullptr;
+}
+
+Resource* ResourceLookupTable::Find(StringHash nameHash) const
+{
+    const Shard& shard = GetShard(nameHash);
+    MutexLock lock(shard.mutex_);
+
+    const auto iter = shard.resources_.find(nameHash);
+    return iter != shard.resources_.end() ? iter->second.second : nullptr;
+}
+
+}
@@ -0,0 +1,78 @@
+//
+// Copyright (c) 2021-2022 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#pragma once
+
+#include "../Core/Mutex.h"
+#include "../Math/StringHash.h"
+
+#include <EASTL/unordered_map.h>
+
+namespace Urho3D
+{
+
+class Resource;
+
+/// Thread-safe lookup table of resources by type and name. Split into independently locked shards,
+/// so concurrent lookups of different resources rarely contend for the same lock.
+/// Does not own resources: the owner should remove a resource from the table before destroying it.
+class URHO3D_API ResourceLookupTable
+{
+public:
+    /// Number of shards.
+    static constexpr unsigned NumShards = 32;
+
+    /// Add resource or replace existing one with the same type and name.
+    void Add(StringHash type, StringHash nameHash, Resource* resource);
+    /// Remove resource.
+    void Remove(StringHash type, StringHash nameHash);
+    /// Remove all resources.
+    void Clear();
+
+    /// Return resource of specific type and name, or null if not found.
+    Resource* Find(StringHash type, StringHash nameHash) const;
+    /// Return resource of any type with given name, or null if not found.
+    Resource* Find(StringHash nameHash) const;
+
+private:
+    /// Resources with names mapped to the same shard.
+    struct alignas(64) Shard
+    {
+        /// Lock for the shard.
+        mutable SpinLockMutex mutex_;
+        /// Resources by name, several resources of different types may share the name.
+        ea::unordered_multimap<StringHash, ea::pair<StringHash, Resource*>> resources_;
+    };
+
+    /// Return shard for resource name.
+    Shard& GetShard(StringHash nameHash) { return shards_[GetShardIndex(nameHash)]; }
+    /// Return shard for resource name.
+    const Shard& GetShard(StringHash nameHash) const { return shards_[GetShardIndex(nameHash)]; }
+    /// Return shard index for resource name.
+    static unsigned GetShardIndex(StringHash nameHash) { return (nameHash.Value() * 2654435761u) >> 27; }
+
+    /// Shards.
+    Shard shards_[NumShards];
+};
+
+}
@@ -22,6 +22,7 @@
 
 #include "../Core/StringUtils.h"
 #include "../IO/ArchiveSerialization.h"
+#include "../IO/Deserializer.h"
 #include "../Resource/XMLArchive.h"
 
 namespace Urho3D
@@ -259,4 +260,267 @@ URHO3D_XML_IN_IMPL(ea::string, GetAttribute);
 
 #undef URHO3D_XML_IN_IMPL
 
+XMLStreamInputArchiveBlock::XMLStreamInputArchiveBlock(
+    const char* name, ArchiveBlockType type, XMLStreamReader* reader)
+    : ArchiveBlockBase(name, type)
+    , reader_(reader)
+{
+    // Attributes should outlive the start tag of the element
+    if (type_ == ArchiveBlockType::Unordered)
+    {
+        const unsigned numAttributes = reader_->GetNumAttributes();
+        attributes_.reserve(numAttributes);
+        for (unsigned i = 0; i < numAttributes; ++i)
+        {
+            const char* value = reader_->GetAttributeValue(i);
+            attributes_.emplace_back(reader_->GetAttributeNameHash(i), attributeValues_.size());
+            attributeValues_.insert(attributeValues_.end(), value, value + strlen(value) + 1);
+        }
+    }
+}
+
+unsigned XMLStreamInputArchiveBlock::CalculateSizeHint(ArchiveBase& archive)
+{
+    if (type_ != ArchiveBlockType::Array)
+        return 0;
+
+    if (!PeekChild())
+    {
+        CheckReader(archive, "");
+        return 0;
+    }
+
+    const XMLStreamPosition position = reader_->SavePosition();
+    unsigned count = 0;
+    while (PeekChild())
+    {
+        ++count;
+        if (!reader_->SkipElement())
+            break;
+        hasPendingChild_ = false;
+    }
+
+    CheckReader(archive, "");
+    if (!reader_->RestorePosition(position))
+        CheckReader(archive, "");
+
+    hasPendingChild_ = true;
+    isFinished_ = false;
+    return count;
+}
+
+void XMLStreamInputArchiveBlock::ReadElement(ArchiveBase& archive, const char* elementName)
+{
+    const bool found = type_ == ArchiveBlockType::Unordered ? FindChild(elementName, true) : PeekChild();
+    if (!found)
+    {
+        CheckReader(archive, elementName);
+        throw archive.ElementNotFoundException(elementName);
+    }
+
+    hasPendingChild_ = false;
+}
+
+const char* XMLStreamInputArchiveBlock::ReadAttribute(ArchiveBase& archive, const char* elementName) const
+{
+    const StringHash nameHash{elementName};
+    for (const auto& [attributeName, valueOffset] : attributes_)
+    {
+        if (attributeName == nameHash)
+            return attributeValues_.data() + valueOffset;
+    }
+    throw archive.ElementNotFoundException(elementName);
+}
+
+bool XMLStreamInputArchiveBlock::HasElementOrBlock(const char* name) const
+{
+    const StringHash nameHash{name};
+    for (const auto& [attributeName, valueOffset] : attributes_)
+    {
+        if (attributeName == nameHash)
+            return true;
+    }
+    return FindChild(nameHash, false);
+}
+
+void XMLStreamInputArchiveBlock::Close(ArchiveBase& archive)
+{
+    // Skip unread children
+    while (PeekChild())
+    {
+        if (!reader_->SkipElement())
+            break;
+        hasPendingChild_ = false;
+    }
+
+    if (!isFinished_)
+    {
+        CheckReader(archive, "");
+        throw archive.UnexpectedEOFException("");
+    }
+}
+
+bool XMLStreamInputArchiveBlock::PeekChild() const
+{
+    while (!hasPendingChild_ && !isFinished_)
+    {
+        switch (reader_->Next())
+        {
+        case XMLStreamEvent::StartElement:
+            hasPendingChild_ = true;
+            break;
+
+        case XMLStreamEvent::EndElement:
+            isFinished_ = true;
+            break;
+
+        case XMLStreamEvent::Text:
+            break;
+
+        default:
+            return false;
+        }
+    }
+    return hasPendingChild_;
+}
+
+bool XMLStreamInputArchiveBlock::FindChild(StringHash name, bool consume) const
+{
+    if (!PeekChild())
+        return false;
+
+    // Fast path: children are read in document order
+    if (reader_->GetNameHash() == name)
+        return true;
+
+    const XMLStreamPosition position = reader_->SavePosition();
+    bool found = false;
+    while (reader_->SkipElement())
+    {
+        hasPendingChild_ = false;
+        if (!PeekChild())
+            break;
+
+        if (reader_->GetNameHash() == name)
+        {
+            found = true;
+            break;
+        }
+    }
+
+    if (!found || !consume)
+    {
+        reader_->RestorePosition(position);
+        hasPendingChild_ = true;
+        isFinished_ = false;
+    }
+
+    return found;
+}
+
+void XMLStreamInputArchiveBlock::CheckReader(ArchiveBase& archive, const char* elementName) const
+{
+    if (reader_->GetEvent() == XMLStreamEvent::Error)
+    {
+        throw ArchiveException("Failed to read XML before '{}/{}': {}",
+            archive.GetCurrentBlockPath(), elementName, reader_->GetError());
+    }
+}
+
+XMLStreamInputArchive::XMLStreamInputArchive(
+    Context* context, Deserializer& source, bool serializeRootName, unsigned chunkSize)
+    : ArchiveBaseT(context)
+    , source_(source)
+    , reader_(source, chunkSize)
+    , serializeRootName_(serializeRootName)
+{
+}
+
+ea::string_view XMLStreamInputArchive::GetName() const
+{
+    return source_.GetName();
+}
+
+void XMLStreamInputArchive::BeginBlock(const char* name, unsigned& sizeHint, bool safe, ArchiveBlockType type)
+{
+    CheckBeforeBlock(name);
+    CheckBlockOrElementName(name);
+
+    // Open root block
+    if (stack_.empty())
+    {
+        if (reader_.Next() != XMLStreamEvent::StartElement)
+        {
+            throw ArchiveException("Failed to read XML root element '{}' of '{}': {}",
+                name, GetName(), reader_.GetError());
+        }
+
+        if (serializeRootName_ && reader_.GetNameHash() != StringHash{name})
+            throw ElementNotFoundException(name);
+
+        stack_.push_back(Block{ name, type, &reader_ });
+        sizeHint = GetCurrentBlock().CalculateSizeHint(*this);
+        return;
+    }
+
+    GetCurrentBlock().ReadElement(*this, name);
+    stack_.push_back(Block{ name, type, &reader_ });
+    sizeHint = GetCurrentBlock().CalculateSizeHint(*this);
+}
+
+void XMLStreamInputArchive::SerializeBytes(const char* name, void* bytes, unsigned size)
+{
+    tempString_ = ReadValue(name);
+    ReadBytesFromHexString(name, tempString_, bytes, size);
+}
+
+void XMLStreamInputArchive::SerializeVLE(const char* name, unsigned& value)
+{
+    value = ToUInt(ReadValue(name));
+}
+
+const char* XMLStreamInputArchive::ReadValue(const char* name)
+{
+    CheckBeforeElement(name);
+    CheckBlockOrElementName(name);
+
+    Block& block = GetCurrentBlock();
+    if (block.GetType() == ArchiveBlockType::Unordered)
+        return block.ReadAttribute(*this, name);
+
+    // Value is stored in child element, it's read and skipped right away
+    static const StringHash valueAttribute{"value"};
+    block.ReadElement(*this, name);
+    const char* value = reader_.FindAttribute(valueAttribute);
+    tempString_ = value ? value : "";
+    if (!reader_.SkipElement())
+    {
+        throw ArchiveException("Failed to read XML element '{}/{}': {}",
+            GetCurrentBlockPath(), name, reader_.GetError());
+    }
+    return tempString_.c_str();
+}
+
+// Generate serialization implementation (XML stream input)
+#define URHO3D_XML_STREAM_IN_IMPL(type, function) \
+    void XMLStreamInputArchive::Serialize(const char* name, type& value) \
+    { \
+        value = function(ReadValue(name)); \
+    }
+
+URHO3D_XML_STREAM_IN_IMPL(bool, ToBool);
+URHO3D_XML_STREAM_IN_IMPL(signed char, ToInt);
+URHO3D_XML_STREAM_IN_IMPL(short, ToInt);
+URHO3D_XML_STREAM_IN_IMPL(int, ToInt);
+URHO3D_XML_STREAM_IN_IMPL(long long, ToInt64);
+URHO3D_XML_STREAM_IN_IMPL(unsigned char, ToUInt);
+URHO3D_XML_STREAM_IN_IMPL(unsigned short, ToUInt);
+URHO3D_XML_STREAM_IN_IMPL(unsigned int, ToUInt);
+URHO3D_XML_STREAM_IN_IMPL(unsigned long long, ToUInt64);
+URHO3D_XML_STREAM_IN_IMPL(float, ToFloat);
+URHO3D_XML_STREAM_IN_IMPL(double, ToDouble);
+URHO3D_XML_STREAM_IN_IMPL(ea::string, ea::string);
+
+#undef URHO3D_XML_STREAM_IN_IMPL
+
 } // namespace Urho3D
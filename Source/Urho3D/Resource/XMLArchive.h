@@ -25,6 +25,7 @@
 #include "../IO/ArchiveBase.h"
 #include "../Resource/XMLElement.h"
 #include "../Resource/XMLFile.h"
+#include "../Resource/XMLStreamReader.h"
 
 #include <EASTL/hash_set.h>
 
@@ -202,4 +203,89 @@ private:
     XMLAttributeReference ReadElementOrAttribute(const char* name);
 };
 
+/// XML stream input archive block.
+class URHO3D_API XMLStreamInputArchiveBlock : public ArchiveBlockBase
+{
+public:
+    XMLStreamInputArchiveBlock(const char* name, ArchiveBlockType type, XMLStreamReader* reader);
+
+    /// Return size hint. Children of array block are counted by reading ahead.
+    unsigned CalculateSizeHint(ArchiveBase& archive);
+    /// Read child element and move reader to it.
+    void ReadElement(ArchiveBase& archive, const char* elementName);
+    /// Read attribute of block element (for Unordered blocks only).
+    const char* ReadAttribute(ArchiveBase& archive, const char* elementName) const;
+
+    bool IsUnorderedAccessSupported() const { return type_ == ArchiveBlockType::Unordered; }
+    bool HasElementOrBlock(const char* name) const;
+    void Close(ArchiveBase& archive);
+
+private:
+    /// Move reader to the next unread child. Return false if there are no more children or on error.
+    bool PeekChild() const;
+    /// Find unread child with given name, reading ahead if needed. Reader is left at found child or restored.
+    bool FindChild(StringHash name, bool consume) const;
+    /// Throw exception if reader has failed.
+    void CheckReader(ArchiveBase& archive, const char* elementName) const;
+
+    XMLStreamReader* reader_{};
+
+    /// Attribute names and offsets of values (for Unordered blocks only).
+    ea::vector<ea::pair<StringHash, unsigned>> attributes_;
+    /// Attribute values (for Unordered blocks only).
+    ea::vector<char> attributeValues_;
+
+    /// Whether the reader is at the unread child. Reader state is advanced lazily.
+    mutable bool hasPendingChild_{};
+    /// Whether the end of the block element is read.
+    mutable bool isFinished_{};
+};
+
+/// XML input archive that reads XML directly from stream without creating the document.
+/// Children of Unordered blocks should be read in document order for best performance,
+/// other children are found by reading ahead and seeking back.
+class URHO3D_API XMLStreamInputArchive : public ArchiveBaseT<XMLStreamInputArchiveBlock, true, true>
+{
+public:
+    /// Construct from stream. Source should outlive the archive.
+    XMLStreamInputArchive(Context* context, Deserializer& source, bool serializeRootName = false,
+        unsigned chunkSize = XMLStreamReader::DefaultChunkSize);
+
+    /// Return reader.
+    const XMLStreamReader& GetReader() const { return reader_; }
+
+    /// @name Archive implementation
+    /// @{
+    ea::string_view GetName() const override;
+
+    void BeginBlock(const char* name, unsigned& sizeHint, bool safe, ArchiveBlockType type) final;
+
+    void Serialize(const char* name, bool& value) final;
+    void Serialize(const char* name, signed char& value) final;
+    void Serialize(const char* name, unsigned char& value) final;
+    void Serialize(const char* name, short& value) final;
+    void Serialize(const char* name, unsigned short& value) final;
+    void Serialize(const char* name, int& value) final;
+    void Serialize(const char* name, unsigned int& value) final;
+    void Serialize(const char* name, long long& value) final;
+    void Serialize(const char* name, unsigned long long& value) final;
+    void Serialize(const char* name, float& value) final;
+    void Serialize(const char* name, double& value) final;
+    void Serialize(const char* name, ea::string& value) final;
+
+    void SerializeBytes(const char* name, void* bytes, unsigned size) final;
+    void SerializeVLE(const char* name, unsigned& value) final;
+    /// @}
+
+private:
+    /// Read attribute (for Unordered blocks only) or value of the element.
+    const char* ReadValue(const char* name);
+
+    Deserializer& source_;
+    XMLStreamReader reader_;
+    const bool serializeRootName_{};
+
+    ea::string tempString_;
+};
+
 }
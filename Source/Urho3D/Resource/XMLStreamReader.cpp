@@ -0,0 +1,707 @@
+//
+// Copyright (c) 2021-2022 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "../Precompiled.h"
+
+#include "../Core/StringUtils.h"
+#include "../IO/Deserializer.h"
+#include "../Resource/XMLStreamReader.h"
+
+#include <EASTL/algorithm.h>
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+namespace
+{
+
+/// Max length of supported entity, e.g. "&#x10FFFF;".
+const unsigned maxEntityLength = 12;
+
+bool IsXMLSpace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+const char* SkipSpace(const char* begin, const char* end)
+{
+    return ea::find_if(begin, end, [](char c) { return !IsXMLSpace(c); });
+}
+
+template <class T>
+void AppendUTF8(T& dest, unsigned codePoint)
+{
+    if (codePoint < 0x80)
+        dest.push_back(static_cast<char>(codePoint));
+    else if (codePoint < 0x800)
+    {
+        dest.push_back(static_cast<char>(0xc0 | (codePoint >> 6)));
+        dest.push_back(static_cast<char>(0x80 | (codePoint & 0x3f)));
+    }
+    else if (codePoint < 0x10000)
+    {
+        dest.push_back(static_cast<char>(0xe0 | (codePoint >> 12)));
+        dest.push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3f)));
+        dest.push_back(static_cast<char>(0x80 | (codePoint & 0x3f)));
+    }
+    else
+    {
+        dest.push_back(static_cast<char>(0xf0 | (codePoint >> 18)));
+        dest.push_back(static_cast<char>(0x80 | ((codePoint >> 12) & 0x3f)));
+        dest.push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3f)));
+        dest.push_back(static_cast<char>(0x80 | (codePoint & 0x3f)));
+    }
+}
+
+/// Decode entity at the beginning of the range. Return number of consumed bytes or 0 if entity is malformed.
+unsigned DecodeEntity(const char* begin, const char* end, unsigned& codePoint)
+{
+    end = ea::min(end, begin + maxEntityLength);
+    const char* semicolon = ea::find(begin, end, ';');
+    if (semicolon == end)
+        return 0;
+
+    const ea::string_view entity(begin + 1, semicolon - begin - 1);
+    if (entity == "lt")
+        codePoint = '<';
+    else if (entity == "gt")
+        codePoint = '>';
+    else if (entity == "amp")
+        codePoint = '&';
+    else if (entity == "quot")
+        codePoint = '"';
+    else if (entity == "apos")
+        codePoint = '\'';
+    else if (entity.size() >= 2 && entity[0] == '#')
+    {
+        const bool isHex = entity[1] == 'x';
+        const ea::string_view digits = entity.substr(isHex ? 2 : 1);
+        if (digits.empty())
+            return 0;
+
+        codePoint = 0;
+        for (const char c : digits)
+        {
+            unsigned digit{};
+            if (c >= '0' && c <= '9')
+                digit = c - '0';
+            else if (isHex && c >= 'a' && c <= 'f')
+                digit = c - 'a' + 10;
+            else if (isHex && c >= 'A' && c <= 'F')
+                digit = c - 'A' + 10;
+            else
+                return 0;
+
+            codePoint = codePoint * (isHex ? 16 : 10) + digit;
+            if (codePoint > 0x10ffff)
+                return 0;
+        }
+    }
+    else
+        return 0;
+
+    return semicolon - begin + 1;
+}
+
+/// Append decoded attribute value. Whitespace characters are converted to spaces like pugixml does.
+bool AppendAttributeValue(ea::vector<char>& dest, const char* begin, const char* end)
+{
+    const auto isSpecial = [](char c) { return c == '&' || c == '\r' || c == '\n' || c == '\t'; };
+    while (begin != end)
+    {
+        const char* special = ea::find_if(begin, end, isSpecial);
+        dest.insert(dest.end(), begin, special);
+        begin = special;
+        if (begin == end)
+            break;
+
+        if (*begin == '&')
+        {
+            unsigned codePoint{};
+            const unsigned length = DecodeEntity(begin, end, codePoint);
+            if (!length)
+                return false;
+
+            AppendUTF8(dest, codePoint);
+            begin += length;
+        }
+        else
+        {
+            dest.push_back(' ');
+            if (*begin == '\r' && begin + 1 != end && begin[1] == '\n')
+                ++begin;
+            ++begin;
+        }
+    }
+    return true;
+}
+
+}
+
+XMLStreamReader::XMLStreamReader(Deserializer& source, unsigned chunkSize)
+    : source_(source)
+    , chunkSize_(ea::max(chunkSize, 64u))
+    , bufferOffset_(source.GetPosition())
+    , tokenOffset_(source.GetPosition())
+{
+    buffer_.resize(chunkSize_);
+}
+
+XMLStreamEvent XMLStreamReader::Next()
+{
+    if (event_ == XMLStreamEvent::EndDocument || event_ == XMLStreamEvent::Error)
+        return event_;
+
+    if (selfClosingPending_)
+    {
+        selfClosingPending_ = false;
+        selfClosingEnd_ = true;
+        attributes_.clear();
+        openElements_.pop_back();
+        event_ = XMLStreamEvent::EndElement;
+        return event_;
+    }
+
+    selfClosingEnd_ = false;
+    while (true)
+    {
+        tokenOffset_ = bufferOffset_ + position_;
+        if (!EnsureAvailable(1))
+        {
+            if (!hasRoot_)
+                SetError("Document has no root element");
+            else if (!openElements_.empty())
+                SetError("Unexpected end of document");
+            else
+                event_ = XMLStreamEvent::EndDocument;
+            return event_;
+        }
+
+        if (buffer_[position_] != '<')
+        {
+            bool hasContent = false;
+            if (!ReadText(hasContent))
+                return event_;
+
+            // Text outside of the root element is ignored
+            if (!hasContent || openElements_.empty())
+                continue;
+
+            event_ = XMLStreamEvent::Text;
+            return event_;
+        }
+
+        if (!EnsureAvailable(2))
+        {
+            SetError("Unterminated tag");
+            return event_;
+        }
+
+        const char nextChar = buffer_[position_ + 1];
+        if (nextChar == '/')
+        {
+            ReadEndTag();
+            return event_;
+        }
+        else if (nextChar == '?')
+        {
+            position_ += 2;
+            if (!SkipUntil("?>"))
+                return event_;
+        }
+        else if (nextChar == '!')
+        {
+            if (StartsWith("<!--"))
+            {
+                position_ += 4;
+                if (!SkipUntil("-->"))
+                    return event_;
+            }
+            else if (StartsWith("<![CDATA["))
+            {
+                position_ += 9;
+                if (!ReadCData())
+                    return event_;
+
+                if (!text_.empty() && !openElements_.empty())
+                {
+                    event_ = XMLStreamEvent::Text;
+                    return event_;
+                }
+            }
+            else if (!SkipDeclaration())
+                return event_;
+        }
+        else
+        {
+            ReadStartTag();
+            return event_;
+        }
+    }
+}
+
+bool XMLStreamReader::SkipElement()
+{
+    if (event_ != XMLStreamEvent::StartElement)
+        return false;
+
+    if (selfClosingPending_)
+        return Next() == XMLStreamEvent::EndElement;
+
+    // Nested tags are only counted: names are not hashed and attributes are not decoded
+    unsigned depth = 0;
+    while (true)
+    {
+        const char* begin = buffer_.data() + position_;
+        const char* end = buffer_.data() + end_;
+        const char* tagBegin = ea::find(begin, end, '<');
+        position_ += tagBegin - begin;
+        if (position_ == end_)
+        {
+            if (!Refill())
+                return SetError("Unexpected end of document");
+            continue;
+        }
+
+        tokenOffset_ = bufferOffset_ + position_;
+        if (!EnsureAvailable(2))
+            return SetError("Unterminated tag");
+
+        const char nextChar = buffer_[position_ + 1];
+        if (nextChar == '/' && depth == 0)
+            return ReadEndTag();
+        else if (nextChar == '?')
+        {
+            position_ += 2;
+            if (!SkipUntil("?>"))
+                return false;
+        }
+        else if (nextChar == '!')
+        {
+            if (StartsWith("<!--"))
+            {
+                position_ += 4;
+                if (!SkipUntil("-->"))
+                    return false;
+            }
+            else if (StartsWith("<![CDATA["))
+            {
+                position_ += 9;
+                if (!SkipUntil("]]>"))
+                    return false;
+            }
+            else if (!SkipDeclaration())
+                return false;
+        }
+        else
+        {
+            const unsigned tagEnd = FindTagEnd();
+            if (tagEnd == M_MAX_UNSIGNED)
+                return SetError("Unterminated tag");
+
+            if (nextChar == '/')
+                --depth;
+            else if (buffer_[position_ + tagEnd - 1] != '/')
+                ++depth;
+            position_ += tagEnd + 1;
+        }
+    }
+}
+
+XMLStreamPosition XMLStreamReader::SavePosition() const
+{
+    XMLStreamPosition result;
+    result.offset_ = tokenOffset_;
+    result.event_ = event_;
+    result.openElements_ = openElements_;
+    result.selfClosingEnd_ = selfClosingEnd_;
+    result.hasRoot_ = hasRoot_;
+
+    // Restore state before the token
+    if (event_ == XMLStreamEvent::StartElement)
+        result.openElements_.pop_back();
+    else if (event_ == XMLStreamEvent::EndElement && !selfClosingEnd_)
+        result.openElements_.push_back(name_.nameHash_);
+
+    if (event_ == XMLStreamEvent::StartElement || selfClosingEnd_)
+        result.hasRoot_ = !result.openElements_.empty();
+
+    return result;
+}
+
+bool XMLStreamReader::RestorePosition(const XMLStreamPosition& position)
+{
+    // Seek only if the position is not buffered anymore
+    if (position.offset_ >= bufferOffset_ && position.offset_ <= bufferOffset_ + end_)
+        position_ = position.offset_ - bufferOffset_;
+    else
+    {
+        if (source_.Seek(position.offset_) != position.offset_)
+            return SetError("Source cannot seek");
+
+        bufferOffset_ = position.offset_;
+        position_ = 0;
+        end_ = 0;
+        sourceEof_ = false;
+    }
+
+    event_ = XMLStreamEvent::None;
+    tokenOffset_ = position.offset_;
+    openElements_ = position.openElements_;
+    selfClosingPending_ = false;
+    selfClosingEnd_ = false;
+    hasRoot_ = position.hasRoot_;
+    error_.clear();
+
+    if (position.event_ == XMLStreamEvent::None)
+        return true;
+
+    Next();
+    if (position.selfClosingEnd_)
+        Next();
+    return event_ == position.event_;
+}
+
+ea::string_view XMLStreamReader::GetAttributeName(unsigned index) const
+{
+    const NameEntry& attribute = attributes_[index];
+    return { storage_.data() + attribute.nameOffset_, attribute.nameLength_ };
+}
+
+const char* XMLStreamReader::FindAttribute(StringHash name) const
+{
+    for (const NameEntry& attribute : attributes_)
+    {
+        if (attribute.nameHash_ == name)
+            return storage_.data() + attribute.valueOffset_;
+    }
+    return nullptr;
+}
+
+unsigned XMLStreamReader::GetMemoryUse() const
+{
+    return buffer_.capacity() + storage_.capacity() + text_.capacity()
+        + attributes_.capacity() * sizeof(NameEntry) + openElements_.capacity() * sizeof(StringHash);
+}
+
+bool XMLStreamReader::Refill()
+{
+    if (sourceEof_)
+        return false;
+
+    // Move unread data to the beginning of the buffer, grow the buffer only if it's full
+    if (position_ > 0)
+    {
+        ea::copy(buffer_.begin() + position_, buffer_.begin() + end_, buffer_.begin());
+        bufferOffset_ += position_;
+        end_ -= position_;
+        position_ = 0;
+    }
+
+    if (end_ == buffer_.size())
+        buffer_.resize(buffer_.size() + chunkSize_);
+
+    const unsigned numBytesRead = source_.Read(buffer_.data() + end_, buffer_.size() - end_);
+    if (numBytesRead == 0)
+    {
+        sourceEof_ = true;
+        return false;
+    }
+
+    end_ += numBytesRead;
+    return true;
+}
+
+bool XMLStreamReader::EnsureAvailable(unsigned size)
+{
+    while (end_ - position_ < size)
+    {
+        if (!Refill())
+            return false;
+    }
+    return true;
+}
+
+unsigned XMLStreamReader::FindTagEnd()
+{
+    unsigned offset = 1;
+    char quote = 0;
+    while (true)
+    {
+        const char* begin = buffer_.data() + position_;
+        const char* end = buffer_.data() + end_;
+        for (const char* ptr = begin + offset; ptr != end; ++ptr)
+        {
+            if (quote)
+            {
+                ptr = ea::find(ptr, end, quote);
+                if (ptr == end)
+                    break;
+                quote = 0;
+            }
+            else
+            {
+                ptr = ea::find_if(ptr, end, [](char c) { return c == '>' || c == '"' || c == '\''; });
+                if (ptr == end)
+                    break;
+                if (*ptr == '>')
+                    return ptr - begin;
+                quote = *ptr;
+            }
+        }
+
+        offset = end_ - position_;
+        if (!Refill())
+            return M_MAX_UNSIGNED;
+    }
+}
+
+bool XMLStreamReader::StartsWith(ea::string_view substring)
+{
+    return EnsureAvailable(substring.size())
+        && ea::string_view(buffer_.data() + position_, substring.size()) == substring;
+}
+
+bool XMLStreamReader::ReadText(bool& hasContent)
+{
+    text_.clear();
+    hasContent = false;
+    while (true)
+    {
+        if (position_ == end_ && !Refill())
+            return true;
+
+        const char* begin = buffer_.data() + position_;
+        const char* end = buffer_.data() + end_;
+        const char* stop = ea::find_if(begin, end, [](char c) { return c == '<' || c == '&'; });
+
+        if (!hasContent)
+            hasContent = ea::any_of(begin, stop, [](char c) { return !IsXMLSpace(c); });
+        text_.append(begin, stop);
+        position_ += stop - begin;
+
+        if (stop == end)
+            continue;
+        if (*stop == '<')
+            return true;
+
+        EnsureAvailable(maxEntityLength);
+        unsigned codePoint{};
+        const unsigned length = DecodeEntity(buffer_.data() + position_, buffer_.data() + end_, codePoint);
+        if (!length)
+            return SetError("Malformed entity");
+
+        AppendUTF8(text_, codePoint);
+        position_ += length;
+        hasContent = true;
+    }
+}
+
+bool XMLStreamReader::ReadStartTag()
+{
+    const unsigned tagEnd = FindTagEnd();
+    if (tagEnd == M_MAX_UNSIGNED)
+        return SetError("Unterminated start tag");
+
+    const char* ptr = buffer_.data() + position_ + 1;
+    const char* end = buffer_.data() + position_ + tagEnd;
+
+    const bool isSelfClosing = *(end - 1) == '/';
+    if (isSelfClosing)
+        --end;
+
+    storage_.clear();
+    attributes_.clear();
+
+    const char* nameEnd = ea::find_if(ptr, end, IsXMLSpace);
+    if (nameEnd == ptr)
+        return SetError("Element name is empty");
+
+    name_ = StoreName(ptr, nameEnd);
+    ptr = nameEnd;
+
+    while (true)
+    {
+        ptr = SkipSpace(ptr, end);
+        if (ptr == end)
+            break;
+
+        const char* attributeNameEnd = ea::find_if(ptr, end, [](char c) { return IsXMLSpace(c) || c == '='; });
+        if (attributeNameEnd == ptr)
+            return SetError("Attribute name is empty");
+
+        NameEntry attribute = StoreName(ptr, attributeNameEnd);
+
+        ptr = SkipSpace(attributeNameEnd, end);
+        if (ptr == end || *ptr != '=')
+            return SetError("Attribute value is missing");
+
+        ptr = SkipSpace(ptr + 1, end);
+        if (ptr == end || (*ptr != '"' && *ptr != '\''))
+            return SetError("Attribute value is not quoted");
+
+        const char quote = *ptr++;
+        const char* valueEnd = ea::find(ptr, end, quote);
+        if (valueEnd == end)
+            return SetError("Attribute value is not terminated");
+
+        attribute.valueOffset_ = storage_.size();
+        if (!AppendAttributeValue(storage_, ptr, valueEnd))
+            return SetError("Malformed entity");
+        storage_.push_back('\0');
+
+        attributes_.push_back(attribute);
+        ptr = valueEnd + 1;
+    }
+
+    if (hasRoot_ && openElements_.empty())
+        return SetError("Document has multiple root elements");
+
+    position_ += tagEnd + 1;
+    openElements_.push_back(name_.nameHash_);
+    hasRoot_ = true;
+    selfClosingPending_ = isSelfClosing;
+    event_ = XMLStreamEvent::StartElement;
+    return true;
+}
+
+bool XMLStreamReader::ReadEndTag()
+{
+    const unsigned tagEnd = FindTagEnd();
+    if (tagEnd == M_MAX_UNSIGNED)
+        return SetError("Unterminated end tag");
+
+    const char* begin = buffer_.data() + position_ + 2;
+    const char* end = buffer_.data() + position_ + tagEnd;
+    while (end != begin && IsXMLSpace(*(end - 1)))
+        --end;
+
+    storage_.clear();
+    attributes_.clear();
+    name_ = StoreName(begin, end);
+
+    if (openElements_.empty() || openElements_.back() != name_.nameHash_)
+        return SetError("Mismatched end tag");
+
+    position_ += tagEnd + 1;
+    openElements_.pop_back();
+    event_ = XMLStreamEvent::EndElement;
+    return true;
+}
+
+bool XMLStreamReader::ReadCData()
+{
+    static const ea::string_view terminator = "]]>";
+
+    text_.clear();
+    while (true)
+    {
+        const ea::string_view data(buffer_.data() + position_, end_ - position_);
+        const auto index = data.find(terminator);
+        if (index != ea::string_view::npos)
+        {
+            text_.append(data.data(), data.data() + index);
+            position_ += index + terminator.size();
+            return true;
+        }
+
+        // Keep the tail that may contain the beginning of the terminator
+        const unsigned tailSize = ea::min<unsigned>(data.size(), terminator.size() - 1);
+        text_.append(data.data(), data.data() + data.size() - tailSize);
+        position_ = end_ - tailSize;
+
+        if (!Refill())
+            return SetError("Unterminated CDATA section");
+    }
+}
+
+bool XMLStreamReader::SkipUntil(ea::string_view terminator)
+{
+    while (true)
+    {
+        const ea::string_view data(buffer_.data() + position_, end_ - position_);
+        const auto index = data.find(terminator);
+        if (index != ea::string_view::npos)
+        {
+            position_ += index + terminator.size();
+            return true;
+        }
+
+        // Keep the tail that may contain the beginning of the terminator
+        const unsigned tailSize = ea::min<unsigned>(data.size(), terminator.size() - 1);
+        position_ = end_ - tailSize;
+
+        if (!Refill())
+            return SetError("Unterminated comment or processing instruction");
+    }
+}
+
+bool XMLStreamReader::SkipDeclaration()
+{
+    position_ += 2;
+
+    int bracketDepth = 0;
+    char quote = 0;
+    while (true)
+    {
+        if (position_ == end_ && !Refill())
+            return SetError("Unterminated declaration");
+
+        const char c = buffer_[position_++];
+        if (quote)
+        {
+            if (c == quote)
+                quote = 0;
+        }
+        else if (c == '"' || c == '\'')
+            quote = c;
+        else if (c == '[')
+            ++bracketDepth;
+        else if (c == ']')
+            --bracketDepth;
+        else if (c == '>' && bracketDepth <= 0)
+            return true;
+    }
+}
+
+XMLStreamReader::NameEntry XMLStreamReader::StoreName(const char* begin, const char* end)
+{
+    NameEntry entry;
+    entry.nameOffset_ = storage_.size();
+    entry.nameLength_ = end - begin;
+    entry.nameHash_ = StringHash(ea::string_view(begin, entry.nameLength_));
+    storage_.insert(storage_.end(), begin, end);
+    storage_.push_back('\0');
+    return entry;
+}
+
+bool XMLStreamReader::SetError(ea::string_view message)
+{
+    error_ = Format("{} at offset {}", message, bufferOffset_ + position_);
+    event_ = XMLStreamEvent::Error;
+    return false;
+}
+
+}
@@ -0,0 +1,196 @@
+//
+// Copyright (c) 2021-2022 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#pragma once
+
+#include "../Core/NonCopyable.h"
+#include "../Math/StringHash.h"
+
+#include <EASTL/string.h>
+#include <EASTL/string_view.h>
+#include <EASTL/vector.h>
+
+namespace Urho3D
+{
+
+class Deserializer;
+
+/// Event produced by XMLStreamReader.
+enum class XMLStreamEvent
+{
+    /// Nothing is read yet.
+    None,
+    /// Start tag of element. Name and attributes are available.
+    StartElement,
+    /// End tag of element. Name is available. Self-closing elements produce it too.
+    EndElement,
+    /// Text or CDATA content inside element that is not whitespace-only.
+    Text,
+    /// End of document.
+    EndDocument,
+    /// Document is malformed or truncated.
+    Error
+};
+
+/// Position of XMLStreamReader that can be restored later.
+struct XMLStreamPosition
+{
+    /// Offset of current token in source stream.
+    unsigned offset_{};
+    /// Current event.
+    XMLStreamEvent event_{};
+    /// Hashes of elements open before current token.
+    ea::vector<StringHash> openElements_;
+    /// Whether current event is end of self-closing element.
+    bool selfClosingEnd_{};
+    /// Whether the root element is already read.
+    bool hasRoot_{};
+};
+
+/// Pull parser that reads XML from Deserializer in chunks.
+/// Memory use is bounded by chunk size, length of the longest tag or text and nesting depth.
+/// Names of elements and attributes are hashed as they are read.
+/// Predefined and numeric entities are decoded. Declarations, comments and processing instructions are skipped.
+class URHO3D_API XMLStreamReader : public NonCopyable
+{
+public:
+    /// Default size of read chunk.
+    static constexpr unsigned DefaultChunkSize = 16 * 1024;
+
+    /// Construct. Source should outlive the reader.
+    explicit XMLStreamReader(Deserializer& source, unsigned chunkSize = DefaultChunkSize);
+
+    /// Read next event.
+    XMLStreamEvent Next();
+    /// Skip current element and all its children. Should be called at StartElement.
+    /// Reader is left at EndElement of the skipped element. Return false on error.
+    bool SkipElement();
+
+    /// Return current position.
+    XMLStreamPosition SavePosition() const;
+    /// Restore position and re-read the event at it. Source should support seeking. Return false on error.
+    bool RestorePosition(const XMLStreamPosition& position);
+
+    /// Return current event.
+    XMLStreamEvent GetEvent() const { return event_; }
+    /// Return name of current element.
+    ea::string_view GetName() const { return { storage_.data() + name_.nameOffset_, name_.nameLength_ }; }
+    /// Return hash of name of current element.
+    StringHash GetNameHash() const { return name_.nameHash_; }
+    /// Return number of attributes of current element.
+    unsigned GetNumAttributes() const { return attributes_.size(); }
+    /// Return name of attribute.
+    ea::string_view GetAttributeName(unsigned index) const;
+    /// Return hash of name of attribute.
+    StringHash GetAttributeNameHash(unsigned index) const { return attributes_[index].nameHash_; }
+    /// Return null-terminated decoded value of attribute.
+    const char* GetAttributeValue(unsigned index) const { return storage_.data() + attributes_[index].valueOffset_; }
+    /// Return null-terminated decoded value of attribute with given name, or null if not found.
+    const char* FindAttribute(StringHash name) const;
+    /// Return decoded text content.
+    const ea::string& GetText() const { return text_; }
+    /// Return number of open elements, including the current one at StartElement.
+    unsigned GetDepth() const { return openElements_.size(); }
+    /// Return error message.
+    const ea::string& GetError() const { return error_; }
+    /// Return current size of internal buffers in bytes.
+    unsigned GetMemoryUse() const;
+
+private:
+    /// Name of element or attribute stored in storage_.
+    struct NameEntry
+    {
+        unsigned nameOffset_{};
+        unsigned nameLength_{};
+        StringHash nameHash_;
+        unsigned valueOffset_{};
+    };
+
+    /// Read more data to the buffer, moving or growing it if needed. Return false if no more data.
+    bool Refill();
+    /// Ensure that given number of bytes is available in buffer. Return false if end of stream is reached.
+    bool EnsureAvailable(unsigned size);
+    /// Return offset of the end of the tag, taking quotes into account, or M_MAX_UNSIGNED.
+    unsigned FindTagEnd();
+    /// Return whether buffer at current position starts with substring.
+    bool StartsWith(ea::string_view substring);
+
+    /// Read text until the next tag. Return false on error.
+    bool ReadText(bool& hasContent);
+    /// Read start tag.
+    bool ReadStartTag();
+    /// Read end tag.
+    bool ReadEndTag();
+    /// Read CDATA section.
+    bool ReadCData();
+    /// Skip bytes until the end of the substring.
+    bool SkipUntil(ea::string_view terminator);
+    /// Skip declaration.
+    bool SkipDeclaration();
+    /// Store name to storage.
+    NameEntry StoreName(const char* begin, const char* end);
+    /// Set error and return false.
+    bool SetError(ea::string_view message);
+
+    /// Source stream.
+    Deserializer& source_;
+    /// Minimal size of read chunk.
+    const unsigned chunkSize_{};
+
+    /// Buffered bytes of source.
+    ea::vector<char> buffer_;
+    /// Offset of the first buffered byte in source.
+    unsigned bufferOffset_{};
+    /// Current position in buffer.
+    unsigned position_{};
+    /// End of valid data in buffer.
+    unsigned end_{};
+    /// Whether the source is exhausted.
+    bool sourceEof_{};
+
+    /// Current event.
+    XMLStreamEvent event_{};
+    /// Offset of the token of current event in source.
+    unsigned tokenOffset_{};
+    /// Hashes of open elements.
+    ea::vector<StringHash> openElements_;
+    /// Whether the end of current self-closing element is pending.
+    bool selfClosingPending_{};
+    /// Whether current event is end of self-closing element.
+    bool selfClosingEnd_{};
+    /// Whether the root element is already read.
+    bool hasRoot_{};
+
+    /// Storage for names and decoded values of current element.
+    ea::vector<char> storage_;
+    /// Name of current element.
+    NameEntry name_;
+    /// Attributes of current element.
+    ea::vector<NameEntry> attributes_;
+    /// Text content.
+    ea::string text_;
+    /// Error message.
+    ea::string error_;
+};
+
+}
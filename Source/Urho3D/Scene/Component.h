@@ -73,6 +73,10 @@ public:
     virtual void GetDependencyNodes(ea::vector<Node*>& dest);
     /// Visualize the component as debug geometry.
     virtual void DrawDebugGeometry(DebugRenderer* debug, bool depthTest);
+    /// Perform update queued by Scene::QueueParallelUpdate. Called from worker threads, should not modify scene.
+    virtual void ParallelUpdate() { }
+    /// Apply results of parallel update. Called from the main thread in component ID order.
+    virtual void CommitParallelUpdate() { }
 
     /// Set enabled/disabled state.
     /// @property
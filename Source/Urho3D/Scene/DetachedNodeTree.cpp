@@ -0,0 +1,270 @@
+//
+// Copyright (c) 2021-2022 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "../Precompiled.h"
+
+#include "../Core/Context.h"
+#include "../Core/WorkQueue.h"
+#include "../IO/Deserializer.h"
+#include "../IO/Log.h"
+#include "../IO/MemoryBuffer.h"
+#include "../Resource/ResourceCache.h"
+#include "../Scene/Component.h"
+#include "../Scene/DetachedNodeTree.h"
+#include "../Scene/Scene.h"
+#include "../Scene/SceneResolver.h"
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+namespace
+{
+
+/// Queue resources referenced by attribute value for background loading.
+void RequestResources(ResourceCache* cache, const Variant& value)
+{
+    if (value.GetType() == VAR_RESOURCEREF)
+    {
+        const ResourceRef& ref = value.GetResourceRef();
+        cache->BackgroundLoadResource(ref.type_, ref.name_);
+    }
+    else if (value.GetType() == VAR_RESOURCEREFLIST)
+    {
+        const ResourceRefList& refList = value.GetResourceRefList();
+        for (const ea::string& name : refList.names_)
+            cache->BackgroundLoadResource(refList.type_, name);
+    }
+}
+
+/// Set attributes of object in the same order as Serializable::Load reads them.
+void ApplyAttributeValues(Serializable* object, const ea::vector<Variant>& values)
+{
+    const ea::vector<AttributeInfo>* attributes = object->GetAttributes();
+    if (!attributes)
+        return;
+
+    object->OnBeginLoadAttributes();
+    unsigned valueIndex = 0;
+    for (const AttributeInfo& attr : *attributes)
+    {
+        if (!attr.ShouldLoad())
+            continue;
+
+        if (valueIndex >= values.size())
+            break;
+
+        object->OnSetAttribute(attr, values[valueIndex++]);
+    }
+    object->OnEndLoadAttributes();
+}
+
+}
+
+bool DetachedNodeTree::Load(Context* context, Deserializer& source)
+{
+    nodes_.clear();
+    return LoadNode(context, source, M_MAX_UNSIGNED);
+}
+
+bool DetachedNodeTree::LoadNode(Context* context, Deserializer& source, unsigned parentIndex)
+{
+    const unsigned nodeIndex = nodes_.size();
+    nodes_.emplace_back();
+    nodes_.back().id_ = source.ReadUInt();
+    nodes_.back().parentIndex_ = parentIndex;
+
+    if (const ea::vector<AttributeInfo>* attributes = context->GetAttributes(Node::GetTypeStatic()))
+    {
+        for (const AttributeInfo& attr : *attributes)
+        {
+            if (!attr.ShouldLoad())
+                continue;
+
+            if (source.IsEof())
+            {
+                URHO3D_LOGERROR("Could not load Node, stream not open or at end");
+                return false;
+            }
+
+            nodes_[nodeIndex].attributes_.push_back(source.ReadVariant(attr.type_, context));
+        }
+    }
+
+    const unsigned numComponents = source.ReadVLE();
+    nodes_[nodeIndex].components_.resize(numComponents);
+    ByteVector componentData;
+    for (ComponentData& component : nodes_[nodeIndex].components_)
+    {
+        componentData.resize(source.ReadVLE());
+        if (source.Read(componentData.data(), componentData.size()) != componentData.size())
+        {
+            URHO3D_LOGERROR("Could not load component, stream not open or at end");
+            return false;
+        }
+
+        // Do not abort if component fails to load, as the component buffer is nested and we can skip to the next
+        LoadComponent(context, componentData, component);
+    }
+
+    const unsigned numChildren = source.ReadVLE();
+    for (unsigned i = 0; i < numChildren; ++i)
+    {
+        if (!LoadNode(context, source, nodeIndex))
+            return false;
+    }
+
+    return true;
+}
+
+bool DetachedNodeTree::LoadComponent(Context* context, const ByteVector& data, ComponentData& component)
+{
+    MemoryBuffer source(data);
+    component.type_ = source.ReadStringHash();
+    component.id_ = source.ReadUInt();
+
+    // Unknown components store raw data
+    if (context->GetTypeName(component.type_).empty())
+    {
+        component.unknownData_ = data;
+        return true;
+    }
+
+    const ea::vector<AttributeInfo>* attributes = context->GetAttributes(component.type_);
+    if (!attributes)
+        return true;
+
+    auto cache = context->GetSubsystem<ResourceCache>();
+    for (const AttributeInfo& attr : *attributes)
+    {
+        if (!attr.ShouldLoad())
+            continue;
+
+        if (source.IsEof())
+        {
+            URHO3D_LOGERROR("Could not load {}, stream not open or at end", context->GetTypeName(component.type_));
+            return false;
+        }
+
+        Variant& value = component.attributes_.push_back();
+        value = source.ReadVariant(attr.type_, context);
+        if (cache)
+            RequestResources(cache, value);
+    }
+
+    return true;
+}
+
+Node* DetachedNodeTree::Instantiate(Node* parent, SceneResolver& resolver) const
+{
+    ea::vector<Node*> createdNodes;
+    createdNodes.reserve(nodes_.size());
+
+    for (const NodeData& nodeData : nodes_)
+    {
+        Node* parentNode = nodeData.parentIndex_ != M_MAX_UNSIGNED ? createdNodes[nodeData.parentIndex_] : parent;
+        Node* node = parentNode->CreateChild(nodeData.id_, Scene::IsReplicatedID(nodeData.id_) ? REPLICATED : LOCAL);
+        resolver.AddNode(nodeData.id_, node);
+        createdNodes.push_back(node);
+
+        ApplyAttributeValues(node, nodeData.attributes_);
+
+        for (const ComponentData& componentData : nodeData.components_)
+        {
+            if (!componentData.unknownData_.empty())
+            {
+                MemoryBuffer componentBuffer(componentData.unknownData_);
+                node->LoadComponent(componentBuffer, resolver);
+                continue;
+            }
+
+            const CreateMode mode = Scene::IsReplicatedID(componentData.id_) ? REPLICATED : LOCAL;
+            Component* component = node->CreateComponent(componentData.type_, mode, componentData.id_);
+            if (!component)
+                continue;
+
+            resolver.AddComponent(componentData.id_, component);
+            ApplyAttributeValues(component, componentData.attributes_);
+        }
+    }
+
+    return !createdNodes.empty() ? createdNodes.front() : nullptr;
+}
+
+DetachedNodeTreeQueue::DetachedNodeTreeQueue(Context* context, ByteVector data, unsigned numTrees)
+    : context_(context)
+    , data_(ea::move(data))
+    , source_(data_)
+    , numTrees_(numTrees)
+{
+}
+
+void DetachedNodeTreeQueue::StartDeserialization(const ea::shared_ptr<DetachedNodeTreeQueue>& queue, WorkQueue* workQueue)
+{
+    if (!workQueue || workQueue->GetNumThreads() == 0 || queue->isDeserializedInBackground_)
+        return;
+
+    queue->isDeserializedInBackground_ = true;
+    workQueue->AddWorkItem([queue](unsigned /*threadIndex*/)
+    {
+        while (!queue->isCancelled_ && queue->DeserializeNextTree())
+        {
+        }
+    });
+}
+
+bool DetachedNodeTreeQueue::PopTree(DetachedNodeTree& tree)
+{
+    if (!isDeserializedInBackground_ && deserializedTrees_.empty())
+        DeserializeNextTree();
+
+    MutexLock lock(mutex_);
+    if (deserializedTrees_.empty())
+        return false;
+
+    tree = ea::move(deserializedTrees_.front());
+    deserializedTrees_.pop_front();
+    return true;
+}
+
+bool DetachedNodeTreeQueue::DeserializeNextTree()
+{
+    if (numDeserializedTrees_ >= numTrees_ || isFailed_)
+        return false;
+
+    DetachedNodeTree tree;
+    if (!tree.Load(context_, source_))
+    {
+        URHO3D_LOGERROR("Failed to deserialize node tree");
+        isFailed_ = true;
+        return false;
+    }
+
+    ++numDeserializedTrees_;
+
+    MutexLock lock(mutex_);
+    deserializedTrees_.push_back(ea::move(tree));
+    return true;
+}
+
+}
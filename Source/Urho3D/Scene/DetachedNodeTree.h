@@ -0,0 +1,150 @@
+//
+// Copyright (c) 2021-2022 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include "../Container/ByteVector.h"
+#include "../Core/Mutex.h"
+#include "../Core/Variant.h"
+#include "../IO/MemoryBuffer.h"
+
+#include <EASTL/deque.h>
+#include <EASTL/shared_ptr.h>
+#include <EASTL/vector.h>
+
+#include <atomic>
+
+namespace Urho3D
+{
+
+class Context;
+class Deserializer;
+class Node;
+class SceneResolver;
+class WorkQueue;
+
+/// Node hierarchy deserialized from binary data without creating nodes and components.
+/// Deserialization doesn't touch the scene, so it may be performed on a worker thread.
+/// Node and component attributes are parsed and referenced resources are queued for background loading.
+/// Objects are created on the main thread because constructors and attribute setters may access
+/// main-thread-only subsystems, e.g. subscribe to events or get resources.
+class URHO3D_API DetachedNodeTree
+{
+public:
+    /// Deserialized component.
+    struct ComponentData
+    {
+        /// Component type.
+        StringHash type_;
+        /// Component ID stored in the data.
+        unsigned id_{};
+        /// Values of component attributes that should be loaded, in order of attributes.
+        ea::vector<Variant> attributes_;
+        /// Binary data of component of unknown type, loaded as UnknownComponent.
+        ByteVector unknownData_;
+    };
+
+    /// Deserialized node.
+    struct NodeData
+    {
+        /// Node ID stored in the data.
+        unsigned id_{};
+        /// Index of parent node in the tree, M_MAX_UNSIGNED for root.
+        unsigned parentIndex_{M_MAX_UNSIGNED};
+        /// Values of node attributes that should be loaded, in order of attributes.
+        ea::vector<Variant> attributes_;
+        /// Components.
+        ea::vector<ComponentData> components_;
+    };
+
+    /// Deserialize node with children in the same format as Node::Load. ID of root node should be the first in the data.
+    /// Return true if successful.
+    bool Load(Context* context, Deserializer& source);
+    /// Create nodes and components as children of parent node and remember them in the resolver.
+    /// Should be called from the main thread. Return root node.
+    Node* Instantiate(Node* parent, SceneResolver& resolver) const;
+
+    /// Return nodes in order of creation, parents are always before children.
+    const ea::vector<NodeData>& GetNodes() const { return nodes_; }
+
+private:
+    /// Deserialize node and its children recursively.
+    bool LoadNode(Context* context, Deserializer& source, unsigned parentIndex);
+    /// Deserialize component from its binary data.
+    bool LoadComponent(Context* context, const ByteVector& data, ComponentData& component);
+
+    /// Nodes.
+    ea::vector<NodeData> nodes_;
+};
+
+/// Sequence of node trees stored one after another in binary data, e.g. root-level children of the scene.
+/// Trees are deserialized ahead of instantiation on a worker thread if possible, or on demand otherwise.
+class URHO3D_API DetachedNodeTreeQueue
+{
+public:
+    /// Construct with binary data of trees.
+    DetachedNodeTreeQueue(Context* context, ByteVector data, unsigned numTrees);
+
+    /// Start deserialization on a worker thread. Does nothing if there are no worker threads.
+    /// Queue is kept alive until deserialization is finished or cancelled.
+    static void StartDeserialization(const ea::shared_ptr<DetachedNodeTreeQueue>& queue, WorkQueue* workQueue);
+    /// Cancel deserialization on a worker thread.
+    void Cancel() { isCancelled_ = true; }
+
+    /// Pop next deserialized tree. Return false if the tree is not ready yet or there are no more trees.
+    /// Tree is deserialized immediately if deserialization on a worker thread was not started.
+    bool PopTree(DetachedNodeTree& tree);
+
+    /// Return whether the deserialization failed.
+    bool IsFailed() const { return isFailed_; }
+    /// Return total number of trees.
+    unsigned GetNumTrees() const { return numTrees_; }
+
+private:
+    /// Deserialize next tree. Return false if failed or there are no more trees.
+    bool DeserializeNextTree();
+
+    /// Context.
+    Context* context_{};
+    /// Binary data.
+    const ByteVector data_;
+    /// Reader of binary data.
+    MemoryBuffer source_;
+    /// Total number of trees.
+    const unsigned numTrees_{};
+    /// Number of deserialized trees.
+    unsigned numDeserializedTrees_{};
+
+    /// Whether the deserialization is performed on a worker thread.
+    bool isDeserializedInBackground_{};
+    /// Whether the deserialization on a worker thread is cancelled.
+    std::atomic<bool> isCancelled_{};
+    /// Whether the deserialization failed.
+    std::atomic<bool> isFailed_{};
+
+    /// Mutex for deserialized trees.
+    Mutex mutex_;
+    /// Deserialized trees that are not popped yet.
+    ea::deque<DetachedNodeTree> deserializedTrees_;
+};
+
+}
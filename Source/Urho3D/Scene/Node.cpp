@@ -80,7 +80,7 @@ Node::~Node()
 
 void Node::RegisterObject(Context* context)
 {
-    context->RegisterFactory<Node>();
+    context->RegisterPooledFactory<Node>();
 
     URHO3D_ACCESSOR_ATTRIBUTE("Is Enabled", IsEnabled, SetEnabled, bool, true, AM_DEFAULT);
     URHO3D_ACCESSOR_ATTRIBUTE("Name", GetName, SetName, ea::string, EMPTY_STRING, AM_DEFAULT);
@@ -866,6 +866,11 @@ void Node::SetOwner(Connection* owner)
 
 void Node::MarkDirty()
 {
+    // Only the topmost dirty node is reported, its children are visited by batched transform update
+    if (!dirty_ && scene_ && (!parent_ || !parent_->dirty_))
+        scene_->MarkTransformDirty(this);
+
+    const bool deferNotification = scene_ && scene_->IsDeferredDirtyNotification();
     Node *cur = this;
     for (;;)
     {
@@ -887,7 +892,10 @@ void Node::MarkDirty()
             Component *c = i->Get();
             if (c)
             {
-                c->OnMarkedDirty(cur);
+                if (deferNotification)
+                    scene_->DelayedMarkedDirty(c, cur);
+                else
+                    c->OnMarkedDirty(cur);
                 ++i;
             }
             // If listener has expired, erase from list (swap with the last element to avoid O(n^2) behavior)
@@ -968,6 +976,9 @@ void Node::AddChild(Node* node, unsigned index)
         scene_->NodeAdded(node);
 
     node->parent_ = this;
+    // Node that is already dirty is not reported by MarkDirty, but it may have left the dirty subtree
+    if (scene_ && node->IsDirty())
+        scene_->MarkTransformDirty(node);
     node->MarkDirty();
     node->MarkNetworkUpdate();
     // If the child node has components, also mark network update on them to ensure they have a valid NetworkState
@@ -1825,17 +1836,7 @@ bool Node::Load(Deserializer& source, SceneResolver& resolver, bool loadChildren
     for (unsigned i = 0; i < numComponents; ++i)
     {
         VectorBuffer compBuffer(source, source.ReadVLE());
-        StringHash compType = compBuffer.ReadStringHash();
-        unsigned compID = compBuffer.ReadUInt();
-
-        Component* newComponent = SafeCreateComponent(EMPTY_STRING, compType,
-            (mode == REPLICATED && Scene::IsReplicatedID(compID)) ? REPLICATED : LOCAL, rewriteIDs ? 0 : compID);
-        if (newComponent)
-        {
-            resolver.AddComponent(compID, newComponent);
-            // Do not abort if component fails to load, as the component buffer is nested and we can skip to the next
-            newComponent->Load(compBuffer);
-        }
+        LoadComponent(compBuffer, resolver, rewriteIDs, mode);
     }
 
     if (!loadChildren)
@@ -1855,6 +1856,22 @@ bool Node::Load(Deserializer& source, SceneResolver& resolver, bool loadChildren
     return true;
 }
 
+Component* Node::LoadComponent(Deserializer& source, SceneResolver& resolver, bool rewriteIDs, CreateMode mode)
+{
+    StringHash compType = source.ReadStringHash();
+    unsigned compID = source.ReadUInt();
+
+    Component* newComponent = SafeCreateComponent(EMPTY_STRING, compType,
+        (mode == REPLICATED && Scene::IsReplicatedID(compID)) ? REPLICATED : LOCAL, rewriteIDs ? 0 : compID);
+    if (newComponent)
+    {
+        resolver.AddComponent(compID, newComponent);
+        // Do not abort if component fails to load, as the component buffer is nested and we can skip to the next
+        newComponent->Load(source);
+    }
+    return newComponent;
+}
+
 bool Node::LoadXML(const XMLElement& source, SceneResolver& resolver, bool loadChildren, bool rewriteIDs, CreateMode mode, bool removeComponents)
 {
     // Remove all children and components first in case this is not a fresh load
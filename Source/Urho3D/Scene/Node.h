@@ -77,6 +77,7 @@ class URHO3D_API Node : public Animatable
     URHO3D_OBJECT(Node, Animatable);
 
     friend class Connection;
+    friend class SceneTransformHierarchy;
 
 public:
     /// Construct.
@@ -677,6 +678,8 @@ public:
     /// Load components and optionally load child nodes.
     bool Load(Deserializer& source, SceneResolver& resolver, bool loadChildren = true, bool rewriteIDs = false,
         CreateMode mode = REPLICATED);
+    /// Load single component from binary data of the component. Return created component.
+    Component* LoadComponent(Deserializer& source, SceneResolver& resolver, bool rewriteIDs = false, CreateMode mode = REPLICATED);
     /// Load components from XML data and optionally load child nodes.
     bool LoadXML(const XMLElement& source, SceneResolver& resolver, bool loadChildren = true, bool rewriteIDs = false,
         CreateMode mode = REPLICATED, bool removeComponents = true);
@@ -0,0 +1,525 @@
+//
+// Copyright (c) 2021-2022 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "../Precompiled.h"
+
+#include "../Core/Context.h"
+#include "../Core/Profiler.h"
+#include "../IO/Deserializer.h"
+#include "../IO/FileSystem.h"
+#include "../IO/Log.h"
+#include "../Resource/JSONFile.h"
+#include "../Resource/XMLFile.h"
+#include "../Scene/Component.h"
+#include "../Scene/Prefab.h"
+#include "../Scene/Scene.h"
+#include "../Scene/SceneResolver.h"
+
+#include <PugiXml/pugixml.hpp>
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+namespace
+{
+
+/// Return index of enum value or empty variant if not found.
+Variant ParseEnumValue(const AttributeInfo& attr, const ea::string& value)
+{
+    int enumValue = 0;
+    for (const char** enumPtr = attr.enumNames_; *enumPtr; ++enumPtr, ++enumValue)
+    {
+        if (!value.comparei(*enumPtr))
+            return enumValue;
+    }
+
+    URHO3D_LOGWARNING("Unknown enum value " + value + " in attribute " + attr.name_);
+    return Variant::EMPTY;
+}
+
+/// Return whether the attribute references node or component by ID.
+bool IsIDAttribute(const AttributeInfo& attr)
+{
+    return !!(attr.mode_ & (AM_NODEID | AM_COMPONENTID | AM_NODEIDVECTOR));
+}
+
+/// Set attributes of created object the same way as Serializable::LoadXML and Serializable::LoadJSON do.
+template <class T>
+void ApplyAttributeValues(Serializable* object, const T& attributeValues)
+{
+    const ea::vector<AttributeInfo>* attributes = object->GetAttributes();
+    if (!attributes)
+        return;
+
+    object->OnBeginLoadAttributes();
+    for (const auto& attributeValue : attributeValues)
+    {
+        if (attributeValue.index_ < attributes->size())
+            object->OnSetAttribute(attributes->at(attributeValue.index_), attributeValue.value_);
+    }
+    object->OnEndLoadAttributes();
+}
+
+}
+
+Prefab::Prefab(Context* context)
+    : Resource(context)
+{
+}
+
+Prefab::~Prefab() = default;
+
+void Prefab::RegisterObject(Context* context)
+{
+    context->RegisterFactory<Prefab>();
+}
+
+bool Prefab::BeginLoad(Deserializer& source)
+{
+    Reset();
+
+    bool success = false;
+    if (GetExtension(source.GetName()) == ".json")
+    {
+        loadJSONFile_ = MakeShared<JSONFile>(context_);
+        success = loadJSONFile_->Load(source);
+    }
+    else
+    {
+        loadXMLFile_ = MakeShared<XMLFile>(context_);
+        success = loadXMLFile_->Load(source);
+    }
+
+    SetMemoryUse(source.GetSize());
+    return success;
+}
+
+bool Prefab::EndLoad()
+{
+    bool success = false;
+    if (loadXMLFile_)
+        success = LoadXML(loadXMLFile_->GetRoot());
+    else if (loadJSONFile_)
+        success = LoadJSON(loadJSONFile_->GetRoot());
+
+    loadXMLFile_ = nullptr;
+    loadJSONFile_ = nullptr;
+    return success;
+}
+
+bool Prefab::LoadXML(const XMLElement& source)
+{
+    Reset();
+
+    if (source.IsNull())
+    {
+        URHO3D_LOGERROR("Could not load prefab, null source element");
+        return false;
+    }
+
+    isCompiled_ = CompileNodeXML(source, M_MAX_UNSIGNED);
+    if (isCompiled_)
+        ResolveIDAttributes();
+    else
+    {
+        Reset();
+        source_.xmlFile_ = MakeShared<XMLFile>(context_);
+        source_.xmlFile_->GetDocument()->append_copy(pugi::xml_node(source.GetNode()));
+    }
+
+    nodeIDs_.clear();
+    componentIDs_.clear();
+    return true;
+}
+
+bool Prefab::LoadJSON(const JSONValue& source)
+{
+    Reset();
+
+    if (source.IsNull())
+    {
+        URHO3D_LOGERROR("Could not load prefab, null JSON source element");
+        return false;
+    }
+
+    isCompiled_ = CompileNodeJSON(source, M_MAX_UNSIGNED);
+    if (isCompiled_)
+        ResolveIDAttributes();
+    else
+    {
+        Reset();
+        source_.json_ = source;
+    }
+
+    nodeIDs_.clear();
+    componentIDs_.clear();
+    return true;
+}
+
+Node* Prefab::Instantiate(Node* parent, const Vector3& position, const Quaternion& rotation, CreateMode mode) const
+{
+    URHO3D_PROFILE("InstantiatePrefab");
+
+    if (!parent)
+    {
+        URHO3D_LOGERROR("Could not instantiate prefab without parent node");
+        return nullptr;
+    }
+
+    Node* node = isCompiled_ ? InstantiateCompiled(parent, mode) : InstantiateSource(parent, mode);
+    if (!node)
+        return nullptr;
+
+    node->SetTransform(position, rotation);
+    node->ApplyAttributes();
+    return node;
+}
+
+void Prefab::Reset()
+{
+    isCompiled_ = false;
+    nodes_.clear();
+    components_.clear();
+    idAttributes_.clear();
+    source_ = {};
+    nodeIDs_.clear();
+    componentIDs_.clear();
+}
+
+bool Prefab::CompileNodeXML(const XMLElement& source, unsigned parentIndex)
+{
+    // Animations are owned by the instance and cannot be shared
+    if (source.HasChild("objectanimation") || source.HasChild("attributeanimation"))
+        return false;
+
+    const unsigned nodeIndex = nodes_.size();
+    const unsigned nodeID = source.GetUInt("id");
+    nodes_.emplace_back();
+    nodeIDs_.push_back(nodeID);
+
+    nodes_[nodeIndex].parentIndex_ = parentIndex;
+    nodes_[nodeIndex].isReplicated_ = Scene::IsReplicatedID(nodeID);
+    if (!CompileAttributesXML(source, Node::GetTypeStatic(), nodes_[nodeIndex].attributes_))
+        return false;
+
+    nodes_[nodeIndex].firstComponent_ = components_.size();
+    for (XMLElement compElem = source.GetChild("component"); compElem; compElem = compElem.GetNext("component"))
+    {
+        if (compElem.HasChild("objectanimation") || compElem.HasChild("attributeanimation"))
+            return false;
+
+        const ea::string typeName = compElem.GetAttribute("type");
+        const StringHash type{ typeName };
+        if (!AddComponent(type, typeName, compElem.GetUInt("id")))
+            return false;
+        if (!CompileAttributesXML(compElem, type, components_.back().attributes_))
+            return false;
+        ++nodes_[nodeIndex].numComponents_;
+    }
+
+    for (XMLElement childElem = source.GetChild("node"); childElem; childElem = childElem.GetNext("node"))
+    {
+        if (!CompileNodeXML(childElem, nodeIndex))
+            return false;
+    }
+
+    return true;
+}
+
+bool Prefab::CompileNodeJSON(const JSONValue& source, unsigned parentIndex)
+{
+    // Animations are owned by the instance and cannot be shared
+    if (!source.Get("objectanimation").IsNull() || !source.Get("attributeanimation").IsNull())
+        return false;
+
+    const unsigned nodeIndex = nodes_.size();
+    const unsigned nodeID = source.Get("id").GetUInt();
+    nodes_.emplace_back();
+    nodeIDs_.push_back(nodeID);
+
+    nodes_[nodeIndex].parentIndex_ = parentIndex;
+    nodes_[nodeIndex].isReplicated_ = Scene::IsReplicatedID(nodeID);
+    if (!CompileAttributesJSON(source, Node::GetTypeStatic(), nodes_[nodeIndex].attributes_))
+        return false;
+
+    nodes_[nodeIndex].firstComponent_ = components_.size();
+    for (const JSONValue& compVal : source.Get("components").GetArray())
+    {
+        if (!compVal.Get("objectanimation").IsNull() || !compVal.Get("attributeanimation").IsNull())
+            return false;
+
+        const ea::string& typeName = compVal.Get("type").GetString();
+        const StringHash type{ typeName };
+        if (!AddComponent(type, typeName, compVal.Get("id").GetUInt()))
+            return false;
+        if (!CompileAttributesJSON(compVal, type, components_.back().attributes_))
+            return false;
+        ++nodes_[nodeIndex].numComponents_;
+    }
+
+    for (const JSONValue& childVal : source.Get("children").GetArray())
+    {
+        if (!CompileNodeJSON(childVal, nodeIndex))
+            return false;
+    }
+
+    return true;
+}
+
+bool Prefab::CompileAttributesXML(const XMLElement& source, StringHash type, ea::vector<AttributeValue>& attributes) const
+{
+    const ea::vector<AttributeInfo>* typeAttributes = context_->GetAttributes(type);
+    if (!typeAttributes)
+        return true;
+
+    for (XMLElement attrElem = source.GetChild("attribute"); attrElem; attrElem = attrElem.GetNext("attribute"))
+    {
+        const ea::string name = attrElem.GetAttribute("name");
+        const auto iter = ea::find_if(typeAttributes->begin(), typeAttributes->end(),
+            [&](const AttributeInfo& attr) { return attr.ShouldLoad() && attr.name_ == name; });
+        if (iter == typeAttributes->end())
+        {
+            URHO3D_LOGWARNING("Unknown attribute " + name + " in XML data");
+            continue;
+        }
+
+        const AttributeInfo& attr = *iter;
+        Variant value = attr.enumNames_ && attr.type_ == VAR_INT
+            ? ParseEnumValue(attr, attrElem.GetAttribute("value"))
+            : attrElem.GetVariantValue(attr.type_, context_);
+
+        if (!value.IsEmpty())
+            attributes.push_back({ static_cast<unsigned>(iter - typeAttributes->begin()), ea::move(value) });
+    }
+
+    return true;
+}
+
+bool Prefab::CompileAttributesJSON(const JSONValue& source, StringHash type, ea::vector<AttributeValue>& attributes) const
+{
+    const ea::vector<AttributeInfo>* typeAttributes = context_->GetAttributes(type);
+    if (!typeAttributes)
+        return true;
+
+    const JSONValue& attributesValue = source.Get("attributes");
+    if (!attributesValue.IsObject())
+        return true;
+
+    for (unsigned index = 0; index < typeAttributes->size(); ++index)
+    {
+        const AttributeInfo& attr = typeAttributes->at(index);
+        if (!attr.ShouldLoad())
+            continue;
+
+        const JSONValue& jsonValue = attributesValue[attr.name_];
+        if (jsonValue.GetValueType() == JSON_NULL)
+            continue;
+
+        Variant value = attr.enumNames_ && attr.type_ == VAR_INT
+            ? ParseEnumValue(attr, jsonValue.GetString())
+            : jsonValue.GetVariantValue(attr.type_, context_);
+
+        if (!value.IsEmpty())
+            attributes.push_back({ index, ea::move(value) });
+    }
+
+    return true;
+}
+
+bool Prefab::AddComponent(StringHash type, const ea::string& typeName, unsigned id)
+{
+    // Unknown components are stored as raw data and cannot be compiled
+    if (context_->GetTypeName(type).empty())
+        return false;
+
+    ComponentDesc& desc = components_.emplace_back();
+    desc.type_ = type;
+    desc.isReplicated_ = Scene::IsReplicatedID(id);
+    componentIDs_.push_back(id);
+    return true;
+}
+
+void Prefab::ResolveIDAttributes()
+{
+    ea::unordered_map<unsigned, unsigned> nodeIndices;
+    for (unsigned i = 0; i < nodeIDs_.size(); ++i)
+        nodeIndices[nodeIDs_[i]] = i;
+
+    ea::unordered_map<unsigned, unsigned> componentIndices;
+    for (unsigned i = 0; i < componentIDs_.size(); ++i)
+        componentIndices[componentIDs_[i]] = i;
+
+    const auto findIndex = [](const ea::unordered_map<unsigned, unsigned>& indices, unsigned id)
+    {
+        const auto iter = indices.find(id);
+        return iter != indices.end() ? iter->second : M_MAX_UNSIGNED;
+    };
+
+    for (unsigned componentIndex = 0; componentIndex < components_.size(); ++componentIndex)
+    {
+        const ComponentDesc& desc = components_[componentIndex];
+        const ea::vector<AttributeInfo>* typeAttributes = context_->GetAttributes(desc.type_);
+        if (!typeAttributes)
+            continue;
+
+        for (const AttributeValue& attributeValue : desc.attributes_)
+        {
+            const AttributeInfo& attr = typeAttributes->at(attributeValue.index_);
+            if (!IsIDAttribute(attr))
+                continue;
+
+            IDAttribute idAttribute;
+            idAttribute.componentIndex_ = componentIndex;
+            idAttribute.attributeIndex_ = attributeValue.index_;
+            idAttribute.isNodeID_ = !(attr.mode_ & AM_COMPONENTID);
+            idAttribute.isVector_ = !!(attr.mode_ & AM_NODEIDVECTOR);
+
+            if (idAttribute.isVector_)
+            {
+                const VariantVector& oldNodeIDs = attributeValue.value_.GetVariantVector();
+                if (oldNodeIDs.empty())
+                    continue;
+
+                // The first element stores the number of IDs
+                idAttribute.vectorSize_ = oldNodeIDs[0].GetUInt();
+                for (unsigned i = 1; i < oldNodeIDs.size(); ++i)
+                {
+                    const unsigned oldNodeID = oldNodeIDs[i].GetUInt();
+                    const unsigned nodeIndex = findIndex(nodeIndices, oldNodeID);
+                    if (nodeIndex == M_MAX_UNSIGNED)
+                        URHO3D_LOGWARNING("Could not resolve node ID " + ea::to_string(oldNodeID));
+                    idAttribute.targetIndices_.push_back(nodeIndex);
+                }
+            }
+            else
+            {
+                const unsigned oldID = attributeValue.value_.GetUInt();
+                if (!oldID)
+                    continue;
+
+                const unsigned targetIndex = findIndex(idAttribute.isNodeID_ ? nodeIndices : componentIndices, oldID);
+                if (targetIndex == M_MAX_UNSIGNED)
+                {
+                    URHO3D_LOGWARNING("Could not resolve {} ID {}", idAttribute.isNodeID_ ? "node" : "component", oldID);
+                    continue;
+                }
+                idAttribute.targetIndices_.push_back(targetIndex);
+            }
+
+            idAttributes_.push_back(ea::move(idAttribute));
+        }
+    }
+}
+
+Node* Prefab::InstantiateCompiled(Node* parent, CreateMode mode) const
+{
+    ea::vector<Node*> createdNodes;
+    ea::vector<Component*> createdComponents;
+    createdNodes.reserve(nodes_.size());
+    createdComponents.reserve(components_.size());
+
+    for (unsigned nodeIndex = 0; nodeIndex < nodes_.size(); ++nodeIndex)
+    {
+        const NodeDesc& nodeDesc = nodes_[nodeIndex];
+        const bool isRoot = nodeIndex == 0;
+
+        // Root node is created in requested mode, the same as in Scene::InstantiateXML
+        Node* nodeParent = isRoot ? parent : createdNodes[nodeDesc.parentIndex_];
+        const CreateMode nodeMode = isRoot ? mode : (mode == REPLICATED && nodeDesc.isReplicated_) ? REPLICATED : LOCAL;
+        Node* node = nodeParent->CreateChild(0, nodeMode);
+        createdNodes.push_back(node);
+        ApplyAttributeValues(node, nodeDesc.attributes_);
+
+        for (unsigned i = 0; i < nodeDesc.numComponents_; ++i)
+        {
+            const ComponentDesc& componentDesc = components_[nodeDesc.firstComponent_ + i];
+            const CreateMode componentMode = (mode == REPLICATED && componentDesc.isReplicated_) ? REPLICATED : LOCAL;
+            Component* component = node->CreateComponent(componentDesc.type_, componentMode);
+            createdComponents.push_back(component);
+            if (component)
+                ApplyAttributeValues(component, componentDesc.attributes_);
+        }
+    }
+
+    for (const IDAttribute& idAttribute : idAttributes_)
+    {
+        Component* component = createdComponents[idAttribute.componentIndex_];
+        if (!component)
+            continue;
+
+        if (idAttribute.isVector_)
+        {
+            VariantVector newIDs;
+            newIDs.reserve(idAttribute.targetIndices_.size() + 1);
+            newIDs.push_back(idAttribute.vectorSize_);
+            for (unsigned nodeIndex : idAttribute.targetIndices_)
+                newIDs.push_back(nodeIndex != M_MAX_UNSIGNED ? createdNodes[nodeIndex]->GetID() : 0);
+            component->SetAttribute(idAttribute.attributeIndex_, newIDs);
+        }
+        else if (idAttribute.isNodeID_)
+        {
+            Node* node = createdNodes[idAttribute.targetIndices_[0]];
+            component->SetAttribute(idAttribute.attributeIndex_, node->GetID());
+        }
+        else if (Component* targetComponent = createdComponents[idAttribute.targetIndices_[0]])
+        {
+            component->SetAttribute(idAttribute.attributeIndex_, targetComponent->GetID());
+        }
+    }
+
+    return createdNodes.empty() ? nullptr : createdNodes[0];
+}
+
+Node* Prefab::InstantiateSource(Node* parent, CreateMode mode) const
+{
+    SceneResolver resolver;
+    Node* node = nullptr;
+    bool success = false;
+    if (source_.xmlFile_)
+    {
+        const XMLElement source = source_.xmlFile_->GetRoot();
+        node = parent->CreateChild(0, mode);
+        resolver.AddNode(source.GetUInt("id"), node);
+        success = node->LoadXML(source, resolver, true, true, mode);
+    }
+    else if (!source_.json_.IsNull())
+    {
+        node = parent->CreateChild(0, mode);
+        resolver.AddNode(source_.json_.Get("id").GetUInt(), node);
+        success = node->LoadJSON(source_.json_, resolver, true, true, mode);
+    }
+
+    if (!success)
+    {
+        if (node)
+            node->Remove();
+        return nullptr;
+    }
+
+    resolver.Resolve();
+    return node;
+}
+
+}
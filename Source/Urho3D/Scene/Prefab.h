@@ -0,0 +1,167 @@
+//
+// Copyright (c) 2021-2022 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#pragma once
+
+#include "../Core/Variant.h"
+#include "../Math/Quaternion.h"
+#include "../Math/Vector3.h"
+#include "../Resource/JSONValue.h"
+#include "../Resource/Resource.h"
+#include "../Scene/Node.h"
+
+#include <EASTL/vector.h>
+
+namespace Urho3D
+{
+
+class Component;
+class JSONFile;
+class XMLElement;
+class XMLFile;
+
+/// Node hierarchy compiled into flat instantiation plan.
+/// Prefab is loaded from the same XML or JSON data as Scene::InstantiateXML and Scene::InstantiateJSON,
+/// but the data is parsed and node and component IDs are resolved only once.
+/// Prefabs that use object or attribute animations or unknown component types are instantiated from source data.
+class URHO3D_API Prefab : public Resource
+{
+    URHO3D_OBJECT(Prefab, Resource);
+
+public:
+    /// Construct.
+    explicit Prefab(Context* context);
+    /// Destruct.
+    ~Prefab() override;
+    /// Register object factory.
+    /// @nobind
+    static void RegisterObject(Context* context);
+
+    /// Load resource from stream. May be called from a worker thread. Return true if successful.
+    bool BeginLoad(Deserializer& source) override;
+    /// Finish resource loading. Always called from the main thread. Return true if successful.
+    bool EndLoad() override;
+
+    /// Compile from XML data. Return true if successful.
+    bool LoadXML(const XMLElement& source);
+    /// Compile from JSON data. Return true if successful.
+    bool LoadJSON(const JSONValue& source);
+
+    /// Instantiate prefab as child of given node. Return root node if successful.
+    Node* Instantiate(Node* parent, const Vector3& position, const Quaternion& rotation, CreateMode mode = REPLICATED) const;
+
+    /// Return whether the prefab is compiled. Prefab that is not compiled is instantiated from source data.
+    bool IsCompiled() const { return isCompiled_; }
+    /// Return number of nodes in compiled prefab.
+    unsigned GetNumNodes() const { return nodes_.size(); }
+    /// Return number of components in compiled prefab.
+    unsigned GetNumComponents() const { return components_.size(); }
+
+private:
+    /// Attribute value stored in the plan.
+    struct AttributeValue
+    {
+        /// Index of attribute in the list of type attributes.
+        unsigned index_{};
+        /// Parsed attribute value.
+        Variant value_;
+    };
+
+    /// Component stored in the plan.
+    struct ComponentDesc
+    {
+        StringHash type_;
+        bool isReplicated_{};
+        ea::vector<AttributeValue> attributes_;
+    };
+
+    /// Node stored in the plan. Nodes are stored in the order of creation, parents are always before children.
+    struct NodeDesc
+    {
+        unsigned parentIndex_{ M_MAX_UNSIGNED };
+        bool isReplicated_{};
+        ea::vector<AttributeValue> attributes_;
+        unsigned firstComponent_{};
+        unsigned numComponents_{};
+    };
+
+    /// Node or component ID attribute that is resolved after all objects are created.
+    struct IDAttribute
+    {
+        unsigned componentIndex_{};
+        unsigned attributeIndex_{};
+        /// Referenced node or component indices. Single element unless attribute is a node ID vector.
+        ea::vector<unsigned> targetIndices_;
+        /// Number of IDs stored in the first element of node ID vector.
+        unsigned vectorSize_{};
+        bool isNodeID_{};
+        bool isVector_{};
+    };
+
+    /// Source data for not compiled prefab.
+    struct SourceData
+    {
+        SharedPtr<XMLFile> xmlFile_;
+        JSONValue json_;
+    };
+
+    /// Reset compiled data.
+    void Reset();
+    /// Compile from XML or JSON data.
+    /// @{
+    bool CompileNodeXML(const XMLElement& source, unsigned parentIndex);
+    bool CompileNodeJSON(const JSONValue& source, unsigned parentIndex);
+    bool CompileAttributesXML(const XMLElement& source, StringHash type, ea::vector<AttributeValue>& attributes) const;
+    bool CompileAttributesJSON(const JSONValue& source, StringHash type, ea::vector<AttributeValue>& attributes) const;
+    bool AddComponent(StringHash type, const ea::string& typeName, unsigned id);
+    /// @}
+    /// Resolve IDs of nodes and components after all of them are compiled.
+    void ResolveIDAttributes();
+    /// Instantiate prefab from compiled plan.
+    Node* InstantiateCompiled(Node* parent, CreateMode mode) const;
+    /// Instantiate prefab from source data.
+    Node* InstantiateSource(Node* parent, CreateMode mode) const;
+
+    /// Whether the prefab is compiled.
+    bool isCompiled_{};
+    /// Compiled plan.
+    /// @{
+    ea::vector<NodeDesc> nodes_;
+    ea::vector<ComponentDesc> components_;
+    ea::vector<IDAttribute> idAttributes_;
+    /// @}
+    /// Source data.
+    SourceData source_;
+    /// Original IDs of nodes and components, used only during compilation.
+    /// @{
+    ea::vector<unsigned> nodeIDs_;
+    ea::vector<unsigned> componentIDs_;
+    /// @}
+
+    /// XML file used while loading.
+    SharedPtr<XMLFile> loadXMLFile_;
+    /// JSON file used while loading.
+    SharedPtr<JSONFile> loadJSONFile_;
+};
+
+}
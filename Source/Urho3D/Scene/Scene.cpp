@@ -25,6 +25,7 @@
 #include "../Core/Context.h"
 #include "../Core/CoreEvents.h"
 #include "../Core/Profiler.h"
+#include "../Core/Thread.h"
 #include "../Core/WorkQueue.h"
 #include "../Graphics/Texture2D.h"
 #include "../IO/Archive.h"
@@ -37,7 +38,9 @@
 #include "../Resource/JSONFile.h"
 #include "../Scene/CameraViewport.h"
 #include "../Scene/Component.h"
+#include "../Scene/DetachedNodeTree.h"
 #include "../Scene/ObjectAnimation.h"
+#include "../Scene/Prefab.h"
 #include "../Scene/ReplicationState.h"
 #include "../Scene/Scene.h"
 #include "../Scene/SceneEvents.h"
@@ -61,6 +64,7 @@ static const float DEFAULT_SNAP_THRESHOLD = 5.0f;
 
 Scene::Scene(Context* context) :
     Node(context),
+    transformHierarchy_(this),
     replicatedNodeID_(FIRST_REPLICATED_ID),
     replicatedComponentID_(FIRST_REPLICATED_ID),
     localNodeID_(FIRST_LOCAL_ID),
@@ -427,8 +431,20 @@ bool Scene::LoadAsync(File* file, LoadMode mode)
             return false;
         }
 
-        // Then prepare to load child nodes in the async updates
+        // Then deserialize child nodes on worker thread if possible and instantiate them in the async updates
         asyncProgress_.totalNodes_ = file->ReadVLE();
+
+        ByteVector nodesData(file->GetSize() - file->GetPosition());
+        if (file->Read(nodesData.data(), nodesData.size()) != nodesData.size())
+        {
+            URHO3D_LOGERROR("Could not read scene content from " + file->GetName());
+            StopAsyncLoading();
+            return false;
+        }
+
+        asyncProgress_.nodeTreeQueue_ = ea::make_shared<DetachedNodeTreeQueue>(
+            context_, ea::move(nodesData), asyncProgress_.totalNodes_);
+        DetachedNodeTreeQueue::StartDeserialization(asyncProgress_.nodeTreeQueue_, GetSubsystem<WorkQueue>());
     }
     else
     {
@@ -584,6 +600,11 @@ void Scene::StopAsyncLoading()
     asyncProgress_.xmlElement_ = XMLElement::EMPTY;
     asyncProgress_.jsonIndex_ = 0;
     asyncProgress_.resources_.clear();
+    if (asyncProgress_.nodeTreeQueue_)
+    {
+        asyncProgress_.nodeTreeQueue_->Cancel();
+        asyncProgress_.nodeTreeQueue_ = nullptr;
+    }
     resolver_.Reset();
 }
 
@@ -674,6 +695,14 @@ Node* Scene::InstantiateJSON(Deserializer& source, const Vector3& position, cons
     return InstantiateJSON(json->GetRoot(), position, rotation, mode);
 }
 
+Node* Scene::Instantiate(const Prefab* prefab, const Vector3& position, const Quaternion& rotation, CreateMode mode)
+{
+    if (!prefab)
+        return nullptr;
+
+    return prefab->Instantiate(this, position, rotation, mode);
+}
+
 void Scene::Clear(bool clearReplicated, bool clearLocal)
 {
     StopAsyncLoading();
@@ -852,6 +881,9 @@ void Scene::Update(float timeStep)
     // Update scene attribute animation.
     SendEvent(E_ATTRIBUTEANIMATIONUPDATE, eventData);
 
+    // Scene subsystems should see nodes moved during update
+    NotifyDirtyComponents();
+
     // Update scene subsystems. If a physics world is present, it will be updated, triggering fixed timestep logic updates
     SendEvent(E_SCENESUBSYSTEMUPDATE, eventData);
 
@@ -872,6 +904,14 @@ void Scene::Update(float timeStep)
     // Post-update variable timestep logic
     SendEvent(E_SCENEPOSTUPDATE, eventData);
 
+    // Heavy work queued during update (for example animation sampling) is done in parallel
+    UpdateParallelComponents();
+    NotifyDirtyComponents();
+
+    // Recalculate world transforms of nodes moved during update
+    if (batchedTransformUpdate_)
+        UpdateTransforms();
+
     // Note: using a float for elapsed time accumulation is inherently inaccurate. The purpose of this value is
     // primarily to update material animation effects, as it is available to shaders. It can be reset by calling
     // SetElapsedTime()
@@ -891,22 +931,115 @@ void Scene::EndThreadedUpdate()
         return;
 
     threadedUpdate_ = false;
+    NotifyDirtyComponents();
+}
 
-    if (!delayedDirtyComponents_.empty())
-    {
-        URHO3D_PROFILE("EndThreadedUpdate");
+void Scene::UpdateTransforms()
+{
+    URHO3D_PROFILE("UpdateTransforms");
 
-        for (auto i = delayedDirtyComponents_.begin(); i !=
-            delayedDirtyComponents_.end(); ++i)
-            (*i)->OnMarkedDirty((*i)->GetNode());
-        delayedDirtyComponents_.clear();
-    }
+    transformHierarchy_.Update(GetSubsystem<WorkQueue>());
 }
 
 void Scene::DelayedMarkedDirty(Component* component)
+{
+    DelayedMarkedDirty(component, component->GetNode());
+}
+
+void Scene::DelayedMarkedDirty(Component* component, Node* node)
 {
     MutexLock lock(sceneMutex_);
-    delayedDirtyComponents_.push_back(component);
+
+    const auto key = ea::make_pair(component, node);
+    const auto iter = delayedDirtyComponentIndices_.find(key);
+    if (iter == delayedDirtyComponentIndices_.end())
+    {
+        delayedDirtyComponentIndices_.emplace(key, delayedDirtyComponents_.size());
+        delayedDirtyComponents_.emplace_back(WeakPtr<Component>(component), WeakPtr<Node>(node));
+        return;
+    }
+
+    // Address may be reused by new object if queued one was destroyed
+    auto& entry = delayedDirtyComponents_[iter->second];
+    if (entry.first.Get() != component || entry.second.Get() != node)
+        entry = { WeakPtr<Component>(component), WeakPtr<Node>(node) };
+}
+
+void Scene::NotifyDirtyComponents()
+{
+    if (delayedDirtyComponents_.empty())
+        return;
+
+    URHO3D_PROFILE("NotifyDirtyComponents");
+
+    // Components may queue more notifications while being notified, including notifications for already notified
+    // components. They are processed in the next round. Limit the number of rounds in case of feedback loops
+    static const unsigned maxRounds = 8;
+    ea::vector<ea::pair<WeakPtr<Component>, WeakPtr<Node>>> components;
+    for (unsigned round = 0; round < maxRounds && !delayedDirtyComponents_.empty(); ++round)
+    {
+        {
+            MutexLock lock(sceneMutex_);
+            components.swap(delayedDirtyComponents_);
+            delayedDirtyComponentIndices_.clear();
+        }
+
+        for (const auto& [component, node] : components)
+        {
+            if (component && node)
+                component->OnMarkedDirty(node);
+        }
+        components.clear();
+    }
+}
+
+void Scene::QueueParallelUpdate(Component* component)
+{
+    if (!component)
+        return;
+
+    if (!Thread::IsMainThread())
+    {
+        URHO3D_LOGERROR("Scene::QueueParallelUpdate() can not be called from worker threads");
+        return;
+    }
+
+    parallelUpdateComponents_.emplace_back(component);
+}
+
+void Scene::UpdateParallelComponents()
+{
+    if (parallelUpdateComponents_.empty())
+        return;
+
+    URHO3D_PROFILE("UpdateParallelComponents");
+
+    // Components may queue themselves again while committing, they will be updated on the next frame
+    ea::vector<WeakPtr<Component>> components = ea::move(parallelUpdateComponents_);
+    parallelUpdateComponents_.clear();
+
+    // Sort components so the order of commits doesn't depend on scheduling of worker threads
+    ea::erase_if(components, [](const WeakPtr<Component>& component) { return !component; });
+    ea::sort(components.begin(), components.end(),
+        [](const WeakPtr<Component>& lhs, const WeakPtr<Component>& rhs) { return lhs->GetID() < rhs->GetID(); });
+    components.erase(ea::unique(components.begin(), components.end()), components.end());
+
+    auto* workQueue = GetSubsystem<WorkQueue>();
+    ForEachParallel(workQueue, components,
+        [](unsigned /*index*/, const WeakPtr<Component>& component) { component->ParallelUpdate(); });
+
+    for (const WeakPtr<Component>& component : components)
+    {
+        if (component)
+            component->CommitParallelUpdate();
+    }
+}
+
+void Scene::SetDeferredDirtyNotification(bool enable)
+{
+    deferredDirtyNotification_ = enable;
+    if (!deferredDirtyNotification_)
+        NotifyDirtyComponents();
 }
 
 unsigned Scene::GetFreeNodeID(CreateMode mode)
@@ -984,6 +1117,8 @@ void Scene::NodeAdded(Node* node)
         oldScene->NodeRemoved(node);
 
     node->SetScene(this);
+    if (node->IsDirty())
+        MarkTransformDirty(node);
 
     // If the new node has an ID of zero (default), assign a replicated ID now
     unsigned id = node->GetID();
@@ -1303,10 +1438,17 @@ void Scene::UpdateAsyncLoading()
         }
         else // Load from binary
         {
-            unsigned nodeID = asyncProgress_.file_->ReadUInt();
-            Node* newNode = CreateChild(nodeID, IsReplicatedID(nodeID) ? REPLICATED : LOCAL);
-            resolver_.AddNode(nodeID, newNode);
-            newNode->Load(*asyncProgress_.file_, resolver_);
+            DetachedNodeTreeQueue* nodeTreeQueue = asyncProgress_.nodeTreeQueue_.get();
+            DetachedNodeTree nodeTree;
+            if (!nodeTreeQueue->PopTree(nodeTree))
+            {
+                // Stop loading nodes on failure, otherwise wait for worker thread
+                if (nodeTreeQueue->IsFailed())
+                    asyncProgress_.totalNodes_ = asyncProgress_.loadedNodes_;
+                break;
+            }
+
+            nodeTree.Instantiate(this, resolver_);
         }
 
         ++asyncProgress_.loadedNodes_;
@@ -1621,6 +1763,7 @@ void RegisterSceneLibrary(Context* context)
 {
     ValueAnimation::RegisterObject(context);
     ObjectAnimation::RegisterObject(context);
+    Prefab::RegisterObject(context);
     Node::RegisterObject(context);
     Scene::RegisterObject(context);
     SmoothedTransform::RegisterObject(context);
@@ -24,6 +24,7 @@
 
 #pragma once
 
+#include <EASTL/shared_ptr.h>
 #include <EASTL/span.h>
 #include <EASTL/unique_ptr.h>
 
@@ -32,12 +33,15 @@
 #include "../Resource/JSONFile.h"
 #include "../Scene/Node.h"
 #include "../Scene/SceneResolver.h"
+#include "../Scene/SceneTransformHierarchy.h"
 
 namespace Urho3D
 {
 
+class DetachedNodeTreeQueue;
 class File;
 class PackageFile;
+class Prefab;
 class Texture2D;
 
 static const unsigned FIRST_REPLICATED_ID = 0x1;
@@ -72,6 +76,9 @@ struct AsyncProgress
     /// Current JSON child array and for JSON mode.
     unsigned jsonIndex_;
 
+    /// Root-level child nodes deserialized ahead of instantiation for binary mode.
+    ea::shared_ptr<DetachedNodeTreeQueue> nodeTreeQueue_;
+
     /// Current load mode.
     LoadMode mode_;
     /// Resource name hashes left to load.
@@ -172,6 +179,8 @@ public:
         (const JSONValue& source, const Vector3& position, const Quaternion& rotation, CreateMode mode = REPLICATED);
     /// Instantiate scene content from JSON data. Return root node if successful.
     Node* InstantiateJSON(Deserializer& source, const Vector3& position, const Quaternion& rotation, CreateMode mode = REPLICATED);
+    /// Instantiate compiled prefab. Return root node if successful.
+    Node* Instantiate(const Prefab* prefab, const Vector3& position, const Quaternion& rotation, CreateMode mode = REPLICATED);
 
     /// Clear scene completely of either replicated, local or all nodes and components.
     void Clear(bool clearReplicated = true, bool clearLocal = true);
@@ -193,6 +202,13 @@ public:
     /// Set maximum milliseconds per frame to spend on async scene loading.
     /// @property
     void SetAsyncLoadingMs(int ms);
+    /// Set whether world transforms of dirty nodes are recalculated in one batched pass at the end of scene update.
+    /// @property
+    void SetBatchedTransformUpdate(bool enable) { batchedTransformUpdate_ = enable; }
+    /// Set whether listeners of dirty nodes are notified at scene sync points instead of immediately.
+    /// Each listener is notified once per node between sync points. Pending notifications are sent when disabled.
+    /// @property
+    void SetDeferredDirtyNotification(bool enable);
     /// Add a required package file for networking. To be called on the server.
     void AddRequiredPackageFile(PackageFile* package);
     /// Clear required package files.
@@ -219,6 +235,12 @@ public:
     /// Return whether updates are enabled.
     /// @property
     bool IsUpdateEnabled() const { return updateEnabled_; }
+    /// Return whether world transforms of dirty nodes are recalculated in one batched pass at the end of scene update.
+    /// @property
+    bool IsBatchedTransformUpdate() const { return batchedTransformUpdate_; }
+    /// Return whether listeners of dirty nodes are notified at scene sync points instead of immediately.
+    /// @property
+    bool IsDeferredDirtyNotification() const { return deferredDirtyNotification_; }
 
     /// Return whether an asynchronous loading operation is in progress.
     /// @property
@@ -275,6 +297,18 @@ public:
     void EndThreadedUpdate();
     /// Add a component to the delayed dirty notify queue. Is thread-safe.
     void DelayedMarkedDirty(Component* component);
+    /// Add a component to the delayed dirty notify queue for given dirty node. Duplicates are ignored. Is thread-safe.
+    void DelayedMarkedDirty(Component* component, Node* node);
+    /// Notify components in the delayed dirty notify queue.
+    void NotifyDirtyComponents();
+    /// Queue a component for parallel update after scene post-update. Duplicates are ignored.
+    void QueueParallelUpdate(Component* component);
+    /// Recalculate world transforms of all dirty nodes in one batched pass.
+    void UpdateTransforms();
+    /// Add node which became dirty while its parent was not to batched transform update. Is thread-safe.
+    void MarkTransformDirty(Node* node) { if (batchedTransformUpdate_) transformHierarchy_.MarkNodeDirty(node); }
+    /// Return transform hierarchy used for batched transform update.
+    const SceneTransformHierarchy& GetTransformHierarchy() const { return transformHierarchy_; }
 
     /// Return threaded update flag.
     bool IsThreadedUpdate() const { return threadedUpdate_; }
@@ -324,6 +358,8 @@ private:
     void UpdateAsyncLoading();
     /// Finish asynchronous loading.
     void FinishAsyncLoading();
+    /// Perform queued parallel updates of components and commit them in deterministic order.
+    void UpdateParallelComponents();
     /// Finish loading. Sets the scene filename and checksum.
     void FinishLoading(Deserializer* source);
     /// Finish saving. Sets the scene filename and checksum.
@@ -358,6 +394,8 @@ private:
     AsyncProgress asyncProgress_;
     /// Node and component ID resolver for asynchronous loading.
     SceneResolver resolver_;
+    /// Transform hierarchy for batched transform update.
+    SceneTransformHierarchy transformHierarchy_;
     /// Source file name.
     mutable ea::string fileName_;
     /// Required package files for networking.
@@ -368,10 +406,14 @@ private:
     ea::hash_set<unsigned> networkUpdateNodes_;
     /// Components to check for attribute changes on the next network update.
     ea::hash_set<unsigned> networkUpdateComponents_;
-    /// Delayed dirty notification queue for components.
-    ea::vector<Component*> delayedDirtyComponents_;
+    /// Delayed dirty notification queue for components and their dirty nodes.
+    ea::vector<ea::pair<WeakPtr<Component>, WeakPtr<Node>>> delayedDirtyComponents_;
+    /// Indices of components and nodes in the delayed dirty notification queue.
+    ea::unordered_map<ea::pair<Component*, Node*>, unsigned> delayedDirtyComponentIndices_;
     /// Mutex for the delayed dirty notification queue.
     Mutex sceneMutex_;
+    /// Components queued for parallel update.
+    ea::vector<WeakPtr<Component>> parallelUpdateComponents_;
     /// Preallocated event data map for smoothing update events.
     VariantMap smoothingData_;
     /// Next free non-local node ID.
@@ -400,6 +442,10 @@ private:
     bool asyncLoading_;
     /// Threaded update flag.
     bool threadedUpdate_;
+    /// Batched transform update flag.
+    bool batchedTransformUpdate_{};
+    /// Deferred dirty notification flag.
+    bool deferredDirtyNotification_{};
 
     /// Lightmap textures names.
     ResourceRefList lightmaps_;
@@ -0,0 +1,233 @@
+//
+// Copyright (c) 2021-2022 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "../Precompiled.h"
+
+#include "../Core/WorkQueue.h"
+#include "../Scene/Scene.h"
+#include "../Scene/SceneTransformHierarchy.h"
+
+#include <EASTL/sort.h>
+#include <EASTL/unordered_set.h>
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+SceneTransformHierarchy::SceneTransformHierarchy(Scene* scene)
+    : scene_(scene)
+{
+}
+
+void SceneTransformHierarchy::MarkNodeDirty(Node* node)
+{
+    MutexLock lock(dirtyNodesMutex_);
+    dirtyNodes_.emplace_back(node);
+}
+
+void SceneTransformHierarchy::Update(WorkQueue* workQueue)
+{
+    CollectRoots();
+    BuildHierarchy();
+
+    const unsigned numNodes = nodes_.size();
+    ProcessNodes(workQueue, 0, numNodes,
+        [this](unsigned beginIndex, unsigned endIndex) { GatherNodes(beginIndex, endIndex); });
+
+    // Roots of dirty subtrees are never pending
+    for (unsigned level = 1; level + 1 < levelOffsets_.size(); ++level)
+    {
+        ProcessNodes(workQueue, levelOffsets_[level], levelOffsets_[level + 1],
+            [this](unsigned beginIndex, unsigned endIndex) { PropagateTransforms(beginIndex, endIndex); });
+    }
+
+    ProcessNodes(workQueue, 0, numNodes,
+        [this](unsigned beginIndex, unsigned endIndex) { ScatterNodes(beginIndex, endIndex); });
+
+    numUpdatedNodes_ = static_cast<unsigned>(ea::count_if(nodeStates_.begin(), nodeStates_.end(),
+        [](NodeState state) { return state != NodeState::Clean; }));
+}
+
+void SceneTransformHierarchy::CollectRoots()
+{
+    ea::vector<WeakPtr<Node>> dirtyNodes;
+    {
+        MutexLock lock(dirtyNodesMutex_);
+        dirtyNodes.swap(dirtyNodes_);
+    }
+
+    roots_.clear();
+    for (const WeakPtr<Node>& node : dirtyNodes)
+    {
+        // Node may have been removed from the scene after being marked dirty
+        if (node && node != scene_ && node->GetScene() == scene_)
+            roots_.push_back(node);
+    }
+
+    ea::sort(roots_.begin(), roots_.end());
+    roots_.erase(ea::unique(roots_.begin(), roots_.end()), roots_.end());
+
+    // Node may have been marked dirty again after its world transform was evaluated lazily,
+    // in this case it is already covered by the subtree of its ancestor
+    const ea::unordered_set<Node*> rootSet(roots_.begin(), roots_.end());
+    ea::erase_if(roots_, [&](Node* node)
+    {
+        for (Node* parent = node->parent_; parent && parent != scene_; parent = parent->parent_)
+        {
+            if (rootSet.contains(parent))
+                return true;
+        }
+        return false;
+    });
+
+    // Parent of the root may be dirty if it was dirtied before batched update was enabled
+    for (Node* node : roots_)
+    {
+        Node* parent = node->parent_;
+        if (parent && parent != scene_ && parent->dirty_)
+            parent->GetWorldTransform();
+    }
+}
+
+void SceneTransformHierarchy::BuildHierarchy()
+{
+    nodes_.clear();
+    parentIndices_.clear();
+    levelOffsets_.clear();
+
+    // Breadth-first traversal keeps parents before children and each depth level contiguous
+    levelOffsets_.push_back(0);
+    for (Node* root : roots_)
+    {
+        nodes_.push_back(root);
+        parentIndices_.push_back(M_MAX_UNSIGNED);
+    }
+
+    unsigned levelBegin = 0;
+    while (levelBegin < nodes_.size())
+    {
+        const unsigned levelEnd = nodes_.size();
+        levelOffsets_.push_back(levelEnd);
+
+        // Children of clean nodes are visited too, they may stay dirty after lazy evaluation of the parent
+        for (unsigned index = levelBegin; index < levelEnd; ++index)
+        {
+            for (Node* child : nodes_[index]->GetChildren())
+            {
+                nodes_.push_back(child);
+                parentIndices_.push_back(index);
+            }
+        }
+        levelBegin = levelEnd;
+    }
+
+    const unsigned numNodes = nodes_.size();
+    nodeStates_.resize(numNodes);
+    localTransforms_.resize(numNodes);
+    localRotations_.resize(numNodes);
+    worldTransforms_.resize(numNodes);
+    worldRotations_.resize(numNodes);
+}
+
+template <class T>
+void SceneTransformHierarchy::ProcessNodes(WorkQueue* workQueue, unsigned beginIndex, unsigned endIndex, const T& callback)
+{
+    const unsigned numNodes = endIndex - beginIndex;
+    if (workQueue && workQueue->GetNumThreads() > 0 && numNodes >= 2 * MinNodesPerThread)
+    {
+        ForEachParallel(workQueue, MinNodesPerThread, numNodes,
+            [&](unsigned chunkBegin, unsigned chunkEnd) { callback(beginIndex + chunkBegin, beginIndex + chunkEnd); });
+    }
+    else
+        callback(beginIndex, endIndex);
+}
+
+void SceneTransformHierarchy::GatherNodes(unsigned beginIndex, unsigned endIndex)
+{
+    for (unsigned index = beginIndex; index < endIndex; ++index)
+    {
+        const Node* node = nodes_[index];
+        if (!node->dirty_)
+        {
+            // World transform of clean node is needed for its children
+            worldTransforms_[index] = node->worldTransform_;
+            worldRotations_[index] = node->worldRotation_;
+            nodeStates_[index] = NodeState::Clean;
+            continue;
+        }
+
+        if (parentIndices_[index] != M_MAX_UNSIGNED)
+        {
+            localTransforms_[index] = node->GetTransform();
+            localRotations_[index] = node->rotation_;
+            nodeStates_[index] = NodeState::PendingUpdate;
+            continue;
+        }
+
+        const Node* parent = node->parent_;
+        if (node->IsTransformHierarchyRoot())
+        {
+            worldTransforms_[index] = node->GetTransform();
+            worldRotations_[index] = node->rotation_;
+        }
+        else
+        {
+            worldTransforms_[index] = parent->worldTransform_ * node->GetTransform();
+            worldRotations_[index] = parent->worldRotation_ * node->rotation_;
+        }
+        nodeStates_[index] = NodeState::Updated;
+    }
+}
+
+void SceneTransformHierarchy::PropagateTransforms(unsigned beginIndex, unsigned endIndex)
+{
+    for (unsigned index = beginIndex; index < endIndex; ++index)
+    {
+        if (nodeStates_[index] != NodeState::PendingUpdate)
+            continue;
+
+        const unsigned parentIndex = parentIndices_[index];
+        assert(nodeStates_[parentIndex] != NodeState::PendingUpdate);
+
+        worldTransforms_[index] = worldTransforms_[parentIndex] * localTransforms_[index];
+        worldRotations_[index] = worldRotations_[parentIndex] * localRotations_[index];
+        nodeStates_[index] = NodeState::Updated;
+    }
+}
+
+void SceneTransformHierarchy::ScatterNodes(unsigned beginIndex, unsigned endIndex)
+{
+    for (unsigned index = beginIndex; index < endIndex; ++index)
+    {
+        if (nodeStates_[index] == NodeState::Clean)
+            continue;
+
+        const Node* node = nodes_[index];
+        node->worldTransform_ = worldTransforms_[index];
+        node->worldRotation_ = worldRotations_[index];
+        node->dirty_ = false;
+    }
+}
+
+}
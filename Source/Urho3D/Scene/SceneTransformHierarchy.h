@@ -0,0 +1,116 @@
+//
+// Copyright (c) 2021-2022 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#pragma once
+
+#include "../Container/Ptr.h"
+#include "../Core/Mutex.h"
+#include "../Math/Matrix3x4.h"
+#include "../Math/Quaternion.h"
+
+#include <EASTL/vector.h>
+
+namespace Urho3D
+{
+
+class Node;
+class Scene;
+class WorkQueue;
+
+/// Dirty subtrees of the scene stored in contiguous arrays sorted by node depth.
+/// Used to recalculate world transforms of dirty nodes in one linear pass instead of lazy per-node updates.
+/// Only subtrees of nodes reported by MarkNodeDirty are visited, so the cost scales with the number of dirty nodes.
+class URHO3D_API SceneTransformHierarchy
+{
+public:
+    /// Min number of nodes processed by one thread. Smaller hierarchy levels are processed in calling thread.
+    static const unsigned MinNodesPerThread = 1024;
+
+    /// Construct.
+    explicit SceneTransformHierarchy(Scene* scene);
+
+    /// Add node which became dirty while its parent was not. Is thread-safe.
+    void MarkNodeDirty(Node* node);
+    /// Recalculate world transforms of all dirty nodes and store them in nodes.
+    void Update(WorkQueue* workQueue);
+
+    /// Return number of nodes visited by last update.
+    unsigned GetNumNodes() const { return nodes_.size(); }
+    /// Return number of nodes updated by last update.
+    unsigned GetNumUpdatedNodes() const { return numUpdatedNodes_; }
+
+private:
+    /// State of node within update.
+    enum class NodeState : unsigned char
+    {
+        Clean,
+        Updated,
+        PendingUpdate
+    };
+
+    /// Collect roots of dirty subtrees, skipping nodes removed from the scene and nodes nested in other roots.
+    void CollectRoots();
+    /// Build arrays from dirty subtrees.
+    void BuildHierarchy();
+    /// Process range of nodes with callback in multiple threads if possible.
+    template <class T>
+    void ProcessNodes(WorkQueue* workQueue, unsigned beginIndex, unsigned endIndex, const T& callback);
+    /// Collect transforms of nodes. Nodes with up-to-date parents are updated immediately.
+    void GatherNodes(unsigned beginIndex, unsigned endIndex);
+    /// Calculate world transforms of pending nodes from world transforms of parents.
+    void PropagateTransforms(unsigned beginIndex, unsigned endIndex);
+    /// Store world transforms of updated nodes in nodes.
+    void ScatterNodes(unsigned beginIndex, unsigned endIndex);
+
+    /// Scene.
+    Scene* scene_{};
+
+    /// Nodes marked dirty since last update.
+    ea::vector<WeakPtr<Node>> dirtyNodes_;
+    /// Mutex for dirty nodes.
+    Mutex dirtyNodesMutex_;
+    /// Roots of dirty subtrees for current update.
+    ea::vector<Node*> roots_;
+
+    /// Nodes of dirty subtrees sorted by depth.
+    ea::vector<Node*> nodes_;
+    /// Offsets of depth levels in nodes array. Last element is the number of nodes.
+    ea::vector<unsigned> levelOffsets_;
+    /// Parent indices, M_MAX_UNSIGNED for roots of dirty subtrees.
+    ea::vector<unsigned> parentIndices_;
+    /// Node states within current update.
+    ea::vector<NodeState> nodeStates_;
+    /// Local transforms of pending nodes.
+    ea::vector<Matrix3x4> localTransforms_;
+    /// Local rotations of pending nodes.
+    ea::vector<Quaternion> localRotations_;
+    /// World transforms of visited nodes.
+    ea::vector<Matrix3x4> worldTransforms_;
+    /// World rotations of visited nodes.
+    ea::vector<Quaternion> worldRotations_;
+
+    /// Number of nodes updated by last update.
+    unsigned numUpdatedNodes_{};
+};
+
+}
@@ -323,8 +323,7 @@ bool Serializable::Load(Deserializer& source)
             return false;
         }
 
-        Variant varValue = source.ReadVariant(attr.type_, context_);
-        OnSetAttribute(attr, varValue);
+        ReadAttributeBinary(attr, source);
     }
 
     return true;
@@ -344,9 +343,7 @@ bool Serializable::Save(Serializer& dest) const
         if (!attr.ShouldSave())
             continue;
 
-        OnGetAttribute(attr, value);
-
-        if (!dest.WriteVariantData(value))
+        if (!WriteAttributeBinary(attr, dest, value))
         {
             URHO3D_LOGERROR("Could not save " + GetTypeName() + ", writing to stream failed");
             return false;
@@ -990,7 +987,7 @@ bool Serializable::ReadDeltaUpdate(Deserializer& source)
             const AttributeInfo& attr = attributes->at(i);
             if (!(interceptMask & (1ULL << i)))
             {
-                OnSetAttribute(attr, source.ReadVariant(attr.type_));
+                ReadAttributeBinary(attr, source);
                 changed = true;
             }
             else
@@ -1030,7 +1027,7 @@ bool Serializable::ReadLatestDataUpdate(Deserializer& source)
         {
             if (!(interceptMask & (1ULL << i)))
             {
-                OnSetAttribute(attr, source.ReadVariant(attr.type_));
+                ReadAttributeBinary(attr, source);
                 changed = true;
             }
             else
@@ -1051,6 +1048,24 @@ bool Serializable::ReadLatestDataUpdate(Deserializer& source)
     return changed;
 }
 
+void Serializable::ReadAttributeBinary(const AttributeInfo& attr, Deserializer& source)
+{
+    // Instance default requires the value as Variant anyway
+    if (attr.accessor_ && attr.accessor_->HasBinaryAccess() && !setInstanceDefault_ && IsTypedAttributeAccessEnabled())
+        attr.accessor_->ReadBinary(this, source);
+    else
+        OnSetAttribute(attr, source.ReadVariant(attr.type_, context_));
+}
+
+bool Serializable::WriteAttributeBinary(const AttributeInfo& attr, Serializer& dest, Variant& tempValue) const
+{
+    if (attr.accessor_ && attr.accessor_->HasBinaryAccess() && IsTypedAttributeAccessEnabled())
+        return attr.accessor_->WriteBinary(this, dest);
+
+    OnGetAttribute(attr, tempValue);
+    return dest.WriteVariantData(tempValue);
+}
+
 Variant Serializable::GetAttribute(unsigned index) const
 {
     Variant ret;
@@ -24,8 +24,11 @@
 
 #include "../Core/Attribute.h"
 #include "../Core/Object.h"
+#include "../IO/Deserializer.h"
+#include "../IO/Serializer.h"
 
 #include <cstddef>
+#include <type_traits>
 
 namespace Urho3D
 {
@@ -33,8 +36,6 @@ namespace Urho3D
 class Archive;
 class ArchiveBlock;
 class Connection;
-class Deserializer;
-class Serializer;
 class XMLElement;
 class JSONValue;
 class ObjectReflection;
@@ -91,10 +92,20 @@ public:
 
     /// Apply attribute changes that can not be applied immediately. Called after scene load or a network update.
     virtual void ApplyAttributes() { }
+    /// Called before and after attributes are set from serialized data without Load, LoadXML or LoadJSON,
+    /// e.g. when compiled Prefab is instantiated.
+    /// @{
+    virtual void OnBeginLoadAttributes() { }
+    virtual void OnEndLoadAttributes() { }
+    /// @}
 
     /// Return whether should save default-valued attributes into XML. Default false.
     virtual bool SaveDefaultAttributes(const AttributeInfo& attr) const { return false; }
 
+    /// Return whether attributes may be loaded and saved as binary data through typed accessors, bypassing OnSetAttribute and OnGetAttribute.
+    /// Should return false if OnSetAttribute or OnGetAttribute is overridden.
+    virtual bool IsTypedAttributeAccessEnabled() const { return true; }
+
     /// Mark for attribute check on the next network update.
     virtual void MarkNetworkUpdate() { }
 
@@ -158,6 +169,11 @@ public:
     NetworkState* GetNetworkState() const { return networkState_.get(); }
 
 protected:
+    /// Read attribute from binary stream and apply it.
+    void ReadAttributeBinary(const AttributeInfo& attr, Deserializer& source);
+    /// Write attribute to binary stream. Return true if successful.
+    bool WriteAttributeBinary(const AttributeInfo& attr, Serializer& dest, Variant& tempValue) const;
+
     /// Network attribute state.
     ea::unique_ptr<NetworkState> networkState_;
 
@@ -200,6 +216,148 @@ private:
     TSetFunction setFunction_;
 };
 
+/// Binary serialization of attribute values that matches Variant serialization of the corresponding VariantType.
+/// Types without specialization are not supported and are always serialized through Variant.
+template <class T, class Enable = void>
+struct AttributeBinaryTraits
+{
+    static constexpr bool IsSupported = false;
+    static void Read(Deserializer& source, T& value) {}
+    static bool Write(Serializer& dest, const T& value) { return false; }
+};
+
+#define URHO3D_DEFINE_ATTRIBUTE_BINARY_TRAITS(type, readFunction, writeFunction) \
+    template <> struct AttributeBinaryTraits<type> \
+    { \
+        static constexpr bool IsSupported = true; \
+        static void Read(Deserializer& source, type& value) { value = source.readFunction(); } \
+        static bool Write(Serializer& dest, const type& value) { return dest.writeFunction(value); } \
+    }
+
+URHO3D_DEFINE_ATTRIBUTE_BINARY_TRAITS(bool, ReadBool, WriteBool);
+URHO3D_DEFINE_ATTRIBUTE_BINARY_TRAITS(float, ReadFloat, WriteFloat);
+URHO3D_DEFINE_ATTRIBUTE_BINARY_TRAITS(double, ReadDouble, WriteDouble);
+URHO3D_DEFINE_ATTRIBUTE_BINARY_TRAITS(Vector2, ReadVector2, WriteVector2);
+URHO3D_DEFINE_ATTRIBUTE_BINARY_TRAITS(Vector3, ReadVector3, WriteVector3);
+URHO3D_DEFINE_ATTRIBUTE_BINARY_TRAITS(Vector4, ReadVector4, WriteVector4);
+URHO3D_DEFINE_ATTRIBUTE_BINARY_TRAITS(Quaternion, ReadQuaternion, WriteQuaternion);
+URHO3D_DEFINE_ATTRIBUTE_BINARY_TRAITS(Color, ReadColor, WriteColor);
+URHO3D_DEFINE_ATTRIBUTE_BINARY_TRAITS(ea::string, ReadString, WriteString);
+URHO3D_DEFINE_ATTRIBUTE_BINARY_TRAITS(ResourceRef, ReadResourceRef, WriteResourceRef);
+URHO3D_DEFINE_ATTRIBUTE_BINARY_TRAITS(ResourceRefList, ReadResourceRefList, WriteResourceRefList);
+URHO3D_DEFINE_ATTRIBUTE_BINARY_TRAITS(StringVector, ReadStringVector, WriteStringVector);
+URHO3D_DEFINE_ATTRIBUTE_BINARY_TRAITS(Rect, ReadRect, WriteRect);
+URHO3D_DEFINE_ATTRIBUTE_BINARY_TRAITS(IntRect, ReadIntRect, WriteIntRect);
+URHO3D_DEFINE_ATTRIBUTE_BINARY_TRAITS(IntVector2, ReadIntVector2, WriteIntVector2);
+URHO3D_DEFINE_ATTRIBUTE_BINARY_TRAITS(IntVector3, ReadIntVector3, WriteIntVector3);
+URHO3D_DEFINE_ATTRIBUTE_BINARY_TRAITS(Matrix3, ReadMatrix3, WriteMatrix3);
+URHO3D_DEFINE_ATTRIBUTE_BINARY_TRAITS(Matrix3x4, ReadMatrix3x4, WriteMatrix3x4);
+URHO3D_DEFINE_ATTRIBUTE_BINARY_TRAITS(Matrix4, ReadMatrix4, WriteMatrix4);
+
+#undef URHO3D_DEFINE_ATTRIBUTE_BINARY_TRAITS
+
+/// Integer types are stored as VAR_INT or VAR_INT64 depending on size.
+template <class T>
+struct AttributeBinaryTraits<T, std::enable_if_t<std::is_integral_v<T> && !std::is_same_v<T, bool>>>
+{
+    static constexpr bool IsSupported = sizeof(T) <= sizeof(long long);
+    static constexpr bool Is64Bit = sizeof(T) > sizeof(int);
+
+    static void Read(Deserializer& source, T& value)
+    {
+        if constexpr (Is64Bit)
+            value = static_cast<T>(source.ReadInt64());
+        else
+            value = static_cast<T>(source.ReadInt());
+    }
+
+    static bool Write(Serializer& dest, const T& value)
+    {
+        if constexpr (Is64Bit)
+            return dest.WriteInt64(static_cast<long long>(value));
+        else
+            return dest.WriteInt(static_cast<int>(value));
+    }
+};
+
+/// StringHash is stored as VAR_INT.
+template <>
+struct AttributeBinaryTraits<StringHash>
+{
+    static constexpr bool IsSupported = true;
+    static void Read(Deserializer& source, StringHash& value) { value = StringHash(source.ReadUInt()); }
+    static bool Write(Serializer& dest, const StringHash& value) { return dest.WriteUInt(value.Value()); }
+};
+
+/// Template implementation of the variant attribute accessor with typed binary access.
+/// Variant functors are used for generic access, typed functors are used for binary serialization if supported by AttributeBinaryTraits.
+template <class TClassType, class TValueType, class TGetFunction, class TSetFunction, class TTypedGetFunction, class TTypedSetFunction>
+class TypedAttributeAccessorImpl : public VariantAttributeAccessorImpl<TClassType, TGetFunction, TSetFunction>
+{
+public:
+    using Traits = AttributeBinaryTraits<TValueType>;
+    using TypedGetResult = decltype(ea::declval<TTypedGetFunction>()(ea::declval<const TClassType&>()));
+    static constexpr bool IsSupported = Traits::IsSupported && std::is_convertible_v<TypedGetResult, TValueType>;
+
+    /// Construct.
+    TypedAttributeAccessorImpl(TGetFunction getFunction, TSetFunction setFunction,
+        TTypedGetFunction typedGetFunction, TTypedSetFunction typedSetFunction)
+        : VariantAttributeAccessorImpl<TClassType, TGetFunction, TSetFunction>(getFunction, setFunction)
+        , typedGetFunction_(typedGetFunction)
+        , typedSetFunction_(typedSetFunction)
+    {
+    }
+
+    /// Return whether the binary access is supported.
+    bool HasBinaryAccess() const override { return IsSupported; }
+
+    /// Read value from binary stream and invoke typed setter function.
+    void ReadBinary(Serializable* ptr, Deserializer& source) override
+    {
+        if constexpr (IsSupported)
+        {
+            assert(ptr);
+            auto classPtr = static_cast<TClassType*>(ptr);
+            TValueType value{};
+            Traits::Read(source, value);
+            typedSetFunction_(*classPtr, value);
+        }
+    }
+
+    /// Invoke typed getter function and write value to binary stream.
+    bool WriteBinary(const Serializable* ptr, Serializer& dest) const override
+    {
+        if constexpr (IsSupported)
+        {
+            assert(ptr);
+            const auto classPtr = static_cast<const TClassType*>(ptr);
+            const TValueType& value = typedGetFunction_(*classPtr);
+            return Traits::Write(dest, value);
+        }
+        else
+            return false;
+    }
+
+private:
+    /// Typed get functor.
+    TTypedGetFunction typedGetFunction_;
+    /// Typed set functor.
+    TTypedSetFunction typedSetFunction_;
+};
+
+/// Make variant attribute accessor implementation with typed binary access.
+/// \tparam TClassType Serializable class type.
+/// \tparam TValueType Attribute value type.
+/// \tparam TTypedGetFunction Functional object with call signature `TValueType typedGetFunction(const TClassType& self)`
+/// \tparam TTypedSetFunction Functional object with call signature `void typedSetFunction(TClassType& self, const TValueType& value)`
+template <class TClassType, class TValueType, class TGetFunction, class TSetFunction, class TTypedGetFunction, class TTypedSetFunction>
+SharedPtr<AttributeAccessor> MakeTypedAttributeAccessor(TGetFunction getFunction, TSetFunction setFunction,
+    TTypedGetFunction typedGetFunction, TTypedSetFunction typedSetFunction)
+{
+    return SharedPtr<AttributeAccessor>(new TypedAttributeAccessorImpl<TClassType, TValueType,
+        TGetFunction, TSetFunction, TTypedGetFunction, TTypedSetFunction>(getFunction, setFunction, typedGetFunction, typedSetFunction));
+}
+
 /// Make variant attribute accessor implementation.
 /// \tparam TClassType Serializable class type.
 /// \tparam TGetFunction Functional object with call signature `void getFunction(const TClassType& self, Variant& value)`
@@ -211,14 +369,18 @@ SharedPtr<AttributeAccessor> MakeVariantAttributeAccessor(TGetFunction getFuncti
 }
 
 /// Make member attribute accessor.
-#define URHO3D_MAKE_MEMBER_ATTRIBUTE_ACCESSOR(typeName, variable) Urho3D::MakeVariantAttributeAccessor<ClassName>( \
+#define URHO3D_MAKE_MEMBER_ATTRIBUTE_ACCESSOR(typeName, variable) Urho3D::MakeTypedAttributeAccessor<ClassName, typeName >( \
     [](const ClassName& self, Urho3D::Variant& value) { value = self.variable; }, \
-    [](ClassName& self, const Urho3D::Variant& value) { self.variable = value.Get<typeName>(); })
+    [](ClassName& self, const Urho3D::Variant& value) { self.variable = value.Get<typeName>(); }, \
+    [](const ClassName& self) -> const auto& { return self.variable; }, \
+    [](ClassName& self, const typeName& value) { self.variable = value; })
 
 /// Make member attribute accessor with custom post-set callback.
-#define URHO3D_MAKE_MEMBER_ATTRIBUTE_ACCESSOR_EX(typeName, variable, postSetCallback) Urho3D::MakeVariantAttributeAccessor<ClassName>( \
+#define URHO3D_MAKE_MEMBER_ATTRIBUTE_ACCESSOR_EX(typeName, variable, postSetCallback) Urho3D::MakeTypedAttributeAccessor<ClassName, typeName >( \
     [](const ClassName& self, Urho3D::Variant& value) { value = self.variable; }, \
-    [](ClassName& self, const Urho3D::Variant& value) { self.variable = value.Get<typeName>(); self.postSetCallback(); })
+    [](ClassName& self, const Urho3D::Variant& value) { self.variable = value.Get<typeName>(); self.postSetCallback(); }, \
+    [](const ClassName& self) -> const auto& { return self.variable; }, \
+    [](ClassName& self, const typeName& value) { self.variable = value; self.postSetCallback(); })
 
 /// Make custom member attribute accessor.
 #define URHO3D_MAKE_CUSTOM_MEMBER_ATTRIBUTE_ACCESSOR(typeName, variable) Urho3D::MakeVariantAttributeAccessor<ClassName>( \
@@ -226,24 +388,32 @@ SharedPtr<AttributeAccessor> MakeVariantAttributeAccessor(TGetFunction getFuncti
     [](ClassName& self, const Urho3D::Variant& value) { self.variable = value.GetCustom<typeName>(); })
 
 /// Make get/set attribute accessor.
-#define URHO3D_MAKE_GET_SET_ATTRIBUTE_ACCESSOR(getFunction, setFunction, typeName) Urho3D::MakeVariantAttributeAccessor<ClassName>( \
+#define URHO3D_MAKE_GET_SET_ATTRIBUTE_ACCESSOR(getFunction, setFunction, typeName) Urho3D::MakeTypedAttributeAccessor<ClassName, typeName >( \
     [](const ClassName& self, Urho3D::Variant& value) { value = self.getFunction(); }, \
-    [](ClassName& self, const Urho3D::Variant& value) { self.setFunction(value.Get<typeName>()); })
+    [](ClassName& self, const Urho3D::Variant& value) { self.setFunction(value.Get<typeName>()); }, \
+    [](const ClassName& self) -> decltype(auto) { return self.getFunction(); }, \
+    [](ClassName& self, const typeName& value) { self.setFunction(value); })
 
 /// Make member enum attribute accessor.
-#define URHO3D_MAKE_MEMBER_ENUM_ATTRIBUTE_ACCESSOR(variable) Urho3D::MakeVariantAttributeAccessor<ClassName>( \
+#define URHO3D_MAKE_MEMBER_ENUM_ATTRIBUTE_ACCESSOR(variable) Urho3D::MakeTypedAttributeAccessor<ClassName, int>( \
     [](const ClassName& self, Urho3D::Variant& value) { value = static_cast<int>(self.variable); }, \
-    [](ClassName& self, const Urho3D::Variant& value) { self.variable = static_cast<decltype(self.variable)>(value.Get<int>()); })
+    [](ClassName& self, const Urho3D::Variant& value) { self.variable = static_cast<decltype(self.variable)>(value.Get<int>()); }, \
+    [](const ClassName& self) { return static_cast<int>(self.variable); }, \
+    [](ClassName& self, const int& value) { self.variable = static_cast<decltype(self.variable)>(value); })
 
 /// Make member enum attribute accessor with custom post-set callback.
-#define URHO3D_MAKE_MEMBER_ENUM_ATTRIBUTE_ACCESSOR_EX(variable, postSetCallback) Urho3D::MakeVariantAttributeAccessor<ClassName>( \
+#define URHO3D_MAKE_MEMBER_ENUM_ATTRIBUTE_ACCESSOR_EX(variable, postSetCallback) Urho3D::MakeTypedAttributeAccessor<ClassName, int>( \
     [](const ClassName& self, Urho3D::Variant& value) { value = static_cast<int>(self.variable); }, \
-    [](ClassName& self, const Urho3D::Variant& value) { self.variable = static_cast<decltype(self.variable)>(value.Get<int>()); self.postSetCallback(); })
+    [](ClassName& self, const Urho3D::Variant& value) { self.variable = static_cast<decltype(self.variable)>(value.Get<int>()); self.postSetCallback(); }, \
+    [](const ClassName& self) { return static_cast<int>(self.variable); }, \
+    [](ClassName& self, const int& value) { self.variable = static_cast<decltype(self.variable)>(value); self.postSetCallback(); })
 
 /// Make get/set enum attribute accessor.
-#define URHO3D_MAKE_GET_SET_ENUM_ATTRIBUTE_ACCESSOR(getFunction, setFunction, typeName) Urho3D::MakeVariantAttributeAccessor<ClassName>( \
+#define URHO3D_MAKE_GET_SET_ENUM_ATTRIBUTE_ACCESSOR(getFunction, setFunction, typeName) Urho3D::MakeTypedAttributeAccessor<ClassName, int>( \
     [](const ClassName& self, Urho3D::Variant& value) { value = static_cast<int>(self.getFunction()); }, \
-    [](ClassName& self, const Urho3D::Variant& value) { self.setFunction(static_cast<typeName>(value.Get<int>())); })
+    [](ClassName& self, const Urho3D::Variant& value) { self.setFunction(static_cast<typeName>(value.Get<int>())); }, \
+    [](const ClassName& self) { return static_cast<int>(self.getFunction()); }, \
+    [](ClassName& self, const int& value) { self.setFunction(static_cast<typeName>(value)); })
 
 /// Make fake accessor for an action.
 #define URHO3D_MAKE_ACTION_LABEL_ACCESSOR(action, label) Urho3D::MakeVariantAttributeAccessor<ClassName>( \
@@ -2483,6 +2483,8 @@ private:
         modelView->RecalculateBoneBoundingBoxes();
         modelView->RepairBoneWeights();
         modelView->Normalize();
+        if (base_.GetSettings().quantizeVertices_)
+            modelView->QuantizeVertexFormats();
         return modelView;
     }
 
@@ -3226,6 +3228,7 @@ void SerializeValue(Archive& archive, const char* name, GLTFImporterSettings& va
     SerializeValue(archive, "highRenderQuality", value.highRenderQuality_);
     SerializeValue(archive, "offsetMatrixError", value.offsetMatrixError_);
     SerializeValue(archive, "keyFrameTimeError", value.keyFrameTimeError_);
+    SerializeValue(archive, "quantizeVertices", value.quantizeVertices_);
 }
 
 GLTFImporter::GLTFImporter(Context* context, const GLTFImporterSettings& settings)
@@ -48,6 +48,9 @@ struct GLTFImporterSettings
     bool highRenderQuality_{ true };
     float offsetMatrixError_{ 0.00002f };
     float keyFrameTimeError_{ M_EPSILON };
+
+    /// Whether to pack vertex elements into compact formats, see ModelVertexQuantization.
+    bool quantizeVertices_{ false };
 };
 
 URHO3D_API void SerializeValue(Archive& archive, const char* name, GLTFImporterSettings& value);